@@ -0,0 +1,334 @@
+/**
+ * @file cfar_bench.c
+ * @brief Host reference check and benchmark of the CFAR detection (cfar.c) on synthetic targets.
+ *
+ * Generates range-Doppler maps with Rayleigh distributed noise and point
+ * targets of a given SNR (each spilling into its neighbour cells, as a windowed
+ * FFT does) and runs all CFAR modes on them:
+ *
+ * - reference: a straightforward implementation of the detector (direct sums,
+ *   full sort for the ordered statistic) has to produce exactly the same
+ *   detection list as Cfar_process(),
+ * - detection performance: share of targets found (within one cell) and false
+ *   alarms per map,
+ * - run time per map and the size of the detection TLV compared to the heat map
+ *   and the dense range profile.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -I minimal_rangeproc_impl/include host/cfar_bench.c minimal_rangeproc_impl/src/cfar.c \
+ *     minimal_rangeproc_impl/src/fixed_math.c -lm -o cfar_bench
+ * ./cfar_bench [num range bins] [num doppler bins] [target SNR in dB] [num maps] [threshold in dB]
+ * @endcode
+ *
+ * The ordered statistic estimates a higher noise level than the mean (rank 12
+ * of 16 is the 75th percentile), so CFAR_MODE_OS needs a lower threshold for
+ * the same false alarm rate, e.g. 8 dB instead of 12 dB.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "cfar.h"
+#include "fixed_math.h"
+#include "frame_protocol.h"
+
+#define NUM_TARGETS         (8U)
+#define MAX_DETECTIONS      (4096U)
+#define NOISE_LEVEL         (200.0)     // mean magnitude of the noise
+
+/*! @brief One synthetic target */
+typedef struct {
+    uint32_t rangeBin;
+    uint32_t dopplerBin;
+} Target;
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static uint16_t toCell(double v) {
+    return (v > 65535.0) ? 0xFFFFU : (uint16_t) v;
+}
+
+/* noise with Rayleigh distributed magnitude, targets with neighbours at -9 dB along range and Doppler */
+static void genMap(uint16_t *map, uint32_t numRange, uint32_t numDoppler, double snrDb, Target *targets) {
+    const double sigma = NOISE_LEVEL / sqrt(M_PI / 2.0);
+    const double amp   = NOISE_LEVEL * pow(10.0, snrDb / 20.0);
+    uint32_t     i, t;
+
+    for (i = 0; i < numRange * numDoppler; i++) {
+        map[i] = toCell(sigma * sqrt(-2.0 * log(uniform())));
+    }
+    for (t = 0; t < NUM_TARGETS; t++) {
+        /* keep the targets apart, so each can be attributed to one detection */
+        uint32_t r = (numRange / NUM_TARGETS) * t + 2U + (uint32_t) (uniform() * (numRange / NUM_TARGETS - 4U));
+        uint32_t d = (uint32_t) (uniform() * numDoppler);
+
+        targets[t].rangeBin   = r;
+        targets[t].dopplerBin = d;
+        map[r * numDoppler + d] = toCell(amp);
+        map[(r - 1U) * numDoppler + d] = toCell(map[(r - 1U) * numDoppler + d] + amp * 0.35);
+        map[(r + 1U) * numDoppler + d] = toCell(map[(r + 1U) * numDoppler + d] + amp * 0.35);
+        if (numDoppler > 2U) {
+            map[r * numDoppler + (d + 1U) % numDoppler] =
+                toCell(map[r * numDoppler + (d + 1U) % numDoppler] + amp * 0.35);
+            map[r * numDoppler + (d + numDoppler - 1U) % numDoppler] =
+                toCell(map[r * numDoppler + (d + numDoppler - 1U) % numDoppler] + amp * 0.35);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * reference implementation
+ * --------------------------------------------------------------------------- */
+
+static int cmpU16(const void *a, const void *b) {
+    return (int) *(const uint16_t *) a - (int) *(const uint16_t *) b;
+}
+
+/* noise estimate (sum, num) of cell idx of the line x[k * stride], 0 <= k < n */
+static void refNoise(const Cfar_Config *cfg, const uint16_t *x, uint32_t stride, uint32_t n, uint32_t idx,
+                     uint32_t trainLen, int cyclic, uint64_t *sum, uint32_t *num) {
+    uint16_t cells[2U * CFAR_MAX_TRAIN_LEN];
+    uint64_t sumL = 0U, sumR = 0U;
+    uint32_t numL = 0U, numR = 0U, j;
+    int64_t  pos;
+
+    for (j = cfg->guardLen + 1U; j <= cfg->guardLen + trainLen; j++) {
+        pos = (int64_t) idx - j;
+        if (cyclic || pos >= 0) {
+            pos = (pos + n) % n;
+            cells[numL + numR] = x[pos * stride];
+            sumL += x[pos * stride];
+            numL++;
+        }
+        pos = (int64_t) idx + j;
+        if (cyclic || pos < (int64_t) n) {
+            pos = pos % n;
+            cells[numL + numR] = x[pos * stride];
+            sumR += x[pos * stride];
+            numR++;
+        }
+    }
+
+    *sum = sumL + sumR;
+    *num = numL + numR;
+    if (*num == 0U) {
+        return;
+    }
+    if (cfg->mode == CFAR_MODE_OS) {
+        qsort(cells, *num, sizeof(uint16_t), cmpU16);
+        *sum = cells[cfg->osRank * *num / (2U * cfg->trainLen)];
+        *num = 1U;
+    } else if ((cfg->mode != CFAR_MODE_CA) && (numL > 0U) && (numR > 0U)) {
+        double meanL = (double) sumL / numL, meanR = (double) sumR / numR;
+        int    left  = (cfg->mode == CFAR_MODE_CAGO) ? (meanL > meanR) : (meanL <= meanR);
+
+        *sum = left ? sumL : sumR;
+        *num = left ? numL : numR;
+    }
+}
+
+static int refDetected(const Cfar_Config *cfg, uint16_t cell, uint64_t sum, uint32_t num) {
+    return (num > 0U) && ((uint64_t) cell * num * 256U > sum * cfg->thresholdScaleQ8);
+}
+
+static int refPeak(const uint16_t *x, uint32_t stride, uint32_t n, uint32_t idx, int cyclic) {
+    uint16_t cell = x[idx * stride];
+
+    if (n < 2U) {
+        return 1;
+    }
+    if ((idx > 0U || cyclic) && x[((idx + n - 1U) % n) * stride] >= cell) {
+        return 0;
+    }
+    return !((idx + 1U < n || cyclic) && x[((idx + 1U) % n) * stride] > cell);
+}
+
+static uint32_t refProcess(const Cfar_Config *cfg, const uint16_t *map, uint32_t numRange, uint32_t numDoppler,
+                           Cfar_Detection *det) {
+    uint32_t numDet = 0U, r, d, dopplerTrain = 0U;
+    uint64_t sum;
+    uint32_t num;
+
+    if (cfg->dopplerCheck && numDoppler > 1U && (numDoppler - 1U) / 2U > cfg->guardLen) {
+        dopplerTrain = (numDoppler - 1U) / 2U - cfg->guardLen;
+        dopplerTrain = (dopplerTrain < cfg->trainLen) ? dopplerTrain : cfg->trainLen;
+    }
+    for (r = 0; r < numRange; r++) {
+        for (d = 0; d < numDoppler; d++) {
+            uint16_t cell = map[r * numDoppler + d];
+            uint64_t dSum;
+            uint32_t dNum;
+            int32_t  snr;
+
+            refNoise(cfg, &map[d], numDoppler, numRange, r, cfg->trainLen, 0, &sum, &num);
+            if (!refDetected(cfg, cell, sum, num)) {
+                continue;
+            }
+            if (cfg->peakGrouping && (!refPeak(&map[d], numDoppler, numRange, r, 0) ||
+                                      !refPeak(&map[r * numDoppler], 1U, numDoppler, d, 1))) {
+                continue;
+            }
+            if (dopplerTrain > 0U) {
+                refNoise(cfg, &map[r * numDoppler], 1U, numDoppler, d, dopplerTrain, 1, &dSum, &dNum);
+                if (!refDetected(cfg, cell, dSum, dNum)) {
+                    continue;
+                }
+            }
+            snr = (sum == 0U) ? INT16_MAX :
+                  ((FixedMath_log2Q8((uint64_t) cell * num) - FixedMath_log2Q8(sum)) * 24660) / 4096;
+            det[numDet].rangeBin   = (uint16_t) r;
+            det[numDet].dopplerBin = (uint16_t) d;
+            det[numDet].magnitude  = cell;
+            det[numDet].snrDbQ8    = (int16_t) snr;
+            numDet++;
+        }
+    }
+    return numDet;
+}
+
+/* ---------------------------------------------------------------------------
+ * benchmark
+ * --------------------------------------------------------------------------- */
+
+static double nowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+static int checkLog2(void) {
+    uint64_t x;
+
+    for (x = 1U; x < 1000000U; x = x * 3U / 2U + 1U) {
+        int32_t expect = (int32_t) floor(log2((double) x) * 256.0);
+        int32_t got    = FixedMath_log2Q8(x);
+        if (got < expect - 1 || got > expect) {
+            printf("FixedMath_log2Q8(%llu) = %d, expected %d\n", (unsigned long long) x, got, expect);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static const char *const modeNames[] = {"CA", "CAGO", "CASO", "OS"};
+    uint32_t       numRange   = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 256U;
+    uint32_t       numDoppler = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 32U;
+    double         snrDb      = (argc > 3) ? strtod(argv[3], NULL) : 15.0;
+    uint32_t       numMaps    = (argc > 4) ? (uint32_t) strtoul(argv[4], NULL, 10) : 200U;
+    double         thrDb      = (argc > 5) ? strtod(argv[5], NULL) : 12.0;
+    uint32_t       thrQ8      = (uint32_t) (pow(10.0, thrDb / 20.0) * 256.0 + 0.5);
+    uint16_t      *map;
+    void          *workspace;
+    Cfar_Detection *det, *refDet;
+    Target         targets[NUM_TARGETS];
+    uint32_t       mode;
+    int            failed = 0;
+
+    if (numRange < 8U * NUM_TARGETS || numDoppler == 0U || numRange > 0xFFFFU || numDoppler > 0xFFFFU ||
+        thrQ8 == 0U) {
+        fprintf(stderr, "usage: %s [num range bins >= %u] [num doppler bins] [target SNR in dB] [num maps] "
+                "[threshold in dB]\n",
+                argv[0], 8U * NUM_TARGETS);
+        return 1;
+    }
+    map       = (uint16_t *) malloc(numRange * numDoppler * sizeof(uint16_t));
+    workspace = malloc(Cfar_workspaceSize(numRange));
+    det       = (Cfar_Detection *) malloc(MAX_DETECTIONS * sizeof(Cfar_Detection));
+    refDet    = (Cfar_Detection *) malloc(MAX_DETECTIONS * sizeof(Cfar_Detection));
+    if (map == NULL || workspace == NULL || det == NULL || refDet == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (checkLog2() != 0) {
+        return 1;
+    }
+
+    printf("%u range bins x %u doppler bins, %u targets at %.1f dB, %u maps, guard 2, train 8, threshold %.1f dB\n",
+           numRange, numDoppler, NUM_TARGETS, snrDb, numMaps, thrDb);
+    printf("mode   found    false alarms/map   us/map   detections TLV   vs heat map %u B, range profile %u B\n",
+           (unsigned) FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_Heatmap) + numRange * numDoppler * sizeof(uint16_t)),
+           (unsigned) FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_RangeProfile) + numRange * 4U));
+
+    for (mode = CFAR_MODE_CA; mode <= CFAR_MODE_OS; mode++) {
+        Cfar_Config cfg;
+        Cfar_Result result;
+        uint64_t    numFound = 0U, numFalse = 0U, numDet = 0U;
+        double      time = 0.0, t0;
+        uint32_t    m, i, t;
+
+        memset(&cfg, 0, sizeof(cfg));
+        cfg.mode             = (Cfar_Mode) mode;
+        cfg.guardLen         = 2U;
+        cfg.trainLen         = 8U;
+        cfg.osRank           = 12U;
+        cfg.thresholdScaleQ8 = thrQ8;
+        cfg.dopplerCheck     = 1U;
+        cfg.peakGrouping     = 1U;
+
+        gRandState = 0x2545F4914F6CDD1DULL;
+        for (m = 0; m < numMaps; m++) {
+            genMap(map, numRange, numDoppler, snrDb, targets);
+
+            t0 = nowUs();
+            if (Cfar_process(&cfg, map, numRange, numDoppler, workspace, det, MAX_DETECTIONS, &result) != CFAR_SUCCESS) {
+                fprintf(stderr, "Cfar_process failed\n");
+                return 1;
+            }
+            time += nowUs() - t0;
+
+            if (result.numDetections != refProcess(&cfg, map, numRange, numDoppler, refDet) ||
+                memcmp(det, refDet, result.numDetections * sizeof(Cfar_Detection)) != 0) {
+                if (!failed) {
+                    printf("%s: detection list differs from the reference in map %u\n", modeNames[mode], m);
+                }
+                failed = 1;
+            }
+
+            numDet += result.numDetections;
+            for (i = 0; i < result.numDetections; i++) {
+                int hit = 0;
+                for (t = 0; t < NUM_TARGETS; t++) {
+                    uint32_t dd = (det[i].dopplerBin + numDoppler - targets[t].dopplerBin) % numDoppler;
+                    if (abs((int) det[i].rangeBin - (int) targets[t].rangeBin) <= 1 &&
+                        (dd <= 1U || dd == numDoppler - 1U)) {
+                        hit = 1;
+                    }
+                }
+                numFalse += hit ? 0U : 1U;
+            }
+            for (t = 0; t < NUM_TARGETS; t++) {
+                for (i = 0; i < result.numDetections; i++) {
+                    if (det[i].rangeBin == targets[t].rangeBin && det[i].dopplerBin == targets[t].dopplerBin) {
+                        numFound++;
+                        break;
+                    }
+                }
+            }
+        }
+
+        printf("%-5s  %5.1f %%  %16.2f   %6.1f   %6.1f B\n", modeNames[mode],
+               100.0 * numFound / ((double) numMaps * NUM_TARGETS), (double) numFalse / numMaps, time / numMaps,
+               FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_DetectionList)) + (double) numDet / numMaps *
+               sizeof(FrameProto_Detection));
+    }
+
+    printf("optimized vs reference: %s\n", failed ? "MISMATCH" : "identical");
+    free(map);
+    free(workspace);
+    free(det);
+    free(refDet);
+    return failed;
+}
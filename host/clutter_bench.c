@@ -0,0 +1,245 @@
+/**
+ * @file clutter_bench.c
+ * @brief Host equivalence check and benchmark of the static clutter removal (clutter_removal.c).
+ *
+ * Generates a sequence of radar cubes with strong static reflectors, one
+ * moving target and complex Gaussian noise, and runs ClutterRemoval_process()
+ * on them in both modes:
+ *
+ * - equivalence: a plain per-sample implementation (no packed arithmetic) has
+ *   to produce a bit-exact copy of the output on every frame, including
+ *   saturated samples,
+ * - suppression: power of the static reflectors (zero Doppler of their range
+ *   bins) and of the mover (its Doppler bin) after the stage, relative to the input,
+ * - run time per frame.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/clutter_bench.c \
+ *     minimal_rangeproc_impl/src/clutter_removal.c -lm -o clutter_bench
+ * ./clutter_bench [num chirps] [num range bins] [num frames] [EMA shift]
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "clutter_removal.h"
+
+#define NUM_ANTENNAS        (6U)
+#define NUM_CLUTTER         (4U)
+#define CLUTTER_AMP         (12000.0)   // strong enough to saturate some samples with the mover
+#define MOVER_AMP           (300.0)
+#define MOVER_DOPPLER       (0.25)      // cycles per chirp
+#define NOISE_SIGMA         (20.0)      // per real and imaginary part
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gauss(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t toSample(double v) {
+    return (int16_t) ((v > 32767.0) ? 32767 : ((v < -32768.0) ? -32768 : lround(v)));
+}
+
+/* static reflectors with fixed phases per antenna, the mover with a random start phase per frame */
+static void genCube(RadarCube_View *cube, const uint32_t *clutterBins, const double *clutterPhase, uint32_t moverBin) {
+    const double moverPhase = 2.0 * M_PI * uniform();
+    uint32_t     c, a, r, k;
+
+    for (c = 0; c < cube->numChirps; c++) {
+        for (a = 0; a < cube->numAntennas; a++) {
+            for (r = 0; r < cube->numRangeBins; r++) {
+                cmplx16ImRe_t *s  = RadarCube_at(cube, c, a, r);
+                double         re = NOISE_SIGMA * gauss(), im = NOISE_SIGMA * gauss();
+
+                for (k = 0; k < NUM_CLUTTER; k++) {
+                    if (r == clutterBins[k]) {
+                        re += CLUTTER_AMP * cos(clutterPhase[k] + a);
+                        im += CLUTTER_AMP * sin(clutterPhase[k] + a);
+                    }
+                }
+                if (r == moverBin) {
+                    re += MOVER_AMP * cos(moverPhase + 2.0 * M_PI * MOVER_DOPPLER * c + 0.5 * a);
+                    im += MOVER_AMP * sin(moverPhase + 2.0 * M_PI * MOVER_DOPPLER * c + 0.5 * a);
+                }
+                s->real = toSample(re);
+                s->imag = toSample(im);
+            }
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * plain reference: one sample and one component at a time
+ * --------------------------------------------------------------------------- */
+
+static int32_t refRound(int32_t sum, int32_t n) {
+    return (sum >= 0) ? ((sum + n / 2) / n) : -((-sum + n / 2) / n);
+}
+
+static int16_t refSat(int32_t v) {
+    return (int16_t) ((v > 32767) ? 32767 : ((v < -32768) ? -32768 : v));
+}
+
+static void refProcess(const ClutterRemoval_Config *cfg, RadarCube_View *cube, int32_t *background, int *valid) {
+    uint32_t a, r, c;
+
+    for (a = 0; a < cube->numAntennas; a++) {
+        for (r = 0; r < cube->numRangeBins; r++) {
+            int32_t  sumRe = 0, sumIm = 0, bgRe, bgIm;
+            int32_t *bg    = &background[2U * (a * cube->numRangeBins + r)];
+
+            for (c = 0; c < cube->numChirps; c++) {
+                sumRe += RadarCube_at(cube, c, a, r)->real;
+                sumIm += RadarCube_at(cube, c, a, r)->imag;
+            }
+            bgRe = refRound(sumRe, (int32_t) cube->numChirps);
+            bgIm = refRound(sumIm, (int32_t) cube->numChirps);
+            if (cfg->mode == CLUTTER_REMOVAL_MODE_EMA) {
+                bg[0] = *valid ? bg[0] + ((bgIm * 256 - bg[0]) >> cfg->emaShift) : bgIm * 256;
+                bg[1] = *valid ? bg[1] + ((bgRe * 256 - bg[1]) >> cfg->emaShift) : bgRe * 256;
+                bgIm  = (bg[0] + 128) >> 8;
+                bgRe  = (bg[1] + 128) >> 8;
+            }
+            for (c = 0; c < cube->numChirps; c++) {
+                cmplx16ImRe_t *s = RadarCube_at(cube, c, a, r);
+                s->real = refSat(s->real - bgRe);
+                s->imag = refSat(s->imag - bgIm);
+            }
+        }
+    }
+    *valid = (cfg->mode == CLUTTER_REMOVAL_MODE_EMA);
+}
+
+/* ---------------------------------------------------------------------------
+ * benchmark
+ * --------------------------------------------------------------------------- */
+
+/* power at a Doppler frequency (cycles per chirp) of a range bin, summed over the antennas */
+static double dopplerPower(const RadarCube_View *cube, uint32_t rangeBin, double doppler) {
+    double   power = 0.0;
+    uint32_t a, c;
+
+    for (a = 0; a < cube->numAntennas; a++) {
+        double re = 0.0, im = 0.0;
+        for (c = 0; c < cube->numChirps; c++) {
+            const cmplx16ImRe_t *s   = RadarCube_at(cube, c, a, rangeBin);
+            double               phi = -2.0 * M_PI * doppler * c;
+            re += s->real * cos(phi) - s->imag * sin(phi);
+            im += s->real * sin(phi) + s->imag * cos(phi);
+        }
+        power += re * re + im * im;
+    }
+    return power;
+}
+
+int main(int argc, char **argv) {
+    uint32_t              numChirps = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 32U;
+    uint32_t              numBins   = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 64U;
+    uint32_t              numFrames = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : 50U;
+    uint32_t              emaShift  = (argc > 4) ? (uint32_t) strtoul(argv[4], NULL, 10) : 3U;
+    uint32_t              numSamples = numChirps * NUM_ANTENNAS * numBins;
+    uint32_t              clutterBins[NUM_CLUTTER];
+    double                clutterPhase[NUM_CLUTTER];
+    cmplx16ImRe_t        *in, *out, *ref;
+    int32_t              *state, *refState;
+    RadarCube_View        cubeOut, cubeRef, cubeIn;
+    ClutterRemoval_Config cfg;
+    ClutterRemoval_Obj    obj;
+    uint32_t              mode, i, k, moverBin;
+    int                   failed = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.emaShift     = emaShift;
+    cfg.numChirps    = numChirps;
+    cfg.numAntennas  = NUM_ANTENNAS;
+    cfg.numRangeBins = numBins;
+    cfg.mode         = CLUTTER_REMOVAL_MODE_MEAN;
+    if ((numFrames == 0U) || (numBins < 2U * NUM_CLUTTER + 2U) ||
+        (ClutterRemoval_init(&obj, &cfg, NULL) != CLUTTER_REMOVAL_SUCCESS)) {
+        fprintf(stderr, "usage: %s [num chirps] [num range bins >= %u] [num frames] [EMA shift 0..%u]\n", argv[0],
+                2U * NUM_CLUTTER + 2U, CLUTTER_REMOVAL_MAX_EMA_SHIFT);
+        return 1;
+    }
+    in       = (cmplx16ImRe_t *) malloc(numSamples * sizeof(cmplx16ImRe_t));
+    out      = (cmplx16ImRe_t *) malloc(numSamples * sizeof(cmplx16ImRe_t));
+    ref      = (cmplx16ImRe_t *) malloc(numSamples * sizeof(cmplx16ImRe_t));
+    cfg.mode = CLUTTER_REMOVAL_MODE_EMA;
+    state    = (int32_t *) malloc(ClutterRemoval_stateSize(&cfg));
+    refState = (int32_t *) malloc(ClutterRemoval_stateSize(&cfg));
+    if ((in == NULL) || (out == NULL) || (ref == NULL) || (state == NULL) || (refState == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    RadarCube_initView(&cubeIn, in, numChirps, NUM_ANTENNAS, numBins);
+    RadarCube_initView(&cubeOut, out, numChirps, NUM_ANTENNAS, numBins);
+    RadarCube_initView(&cubeRef, ref, numChirps, NUM_ANTENNAS, numBins);
+    for (k = 0; k < NUM_CLUTTER; k++) {
+        clutterBins[k]  = 1U + k * (numBins / NUM_CLUTTER);
+        clutterPhase[k] = 2.0 * M_PI * uniform();
+    }
+    moverBin = clutterBins[1] + 1U;     // next to a wall
+
+    printf("%u chirps x %u antennas x %u range bins, %u frames, %u static reflectors, mover at bin %u\n", numChirps,
+           NUM_ANTENNAS, numBins, numFrames, NUM_CLUTTER, moverBin);
+
+    for (mode = CLUTTER_REMOVAL_MODE_MEAN; mode <= CLUTTER_REMOVAL_MODE_EMA; mode++) {
+        double   clutterIn = 0.0, clutterOut = 0.0, moverIn = 0.0, moverOut = 0.0, time = 0.0;
+        uint32_t mismatches = 0U;
+        int      refValid   = 0;
+
+        cfg.mode = (ClutterRemoval_Mode) mode;
+        ClutterRemoval_init(&obj, &cfg, state);
+        for (i = 0; i < numFrames; i++) {
+            double t0;
+
+            genCube(&cubeIn, clutterBins, clutterPhase, moverBin);
+            memcpy(out, in, numSamples * sizeof(cmplx16ImRe_t));
+            memcpy(ref, in, numSamples * sizeof(cmplx16ImRe_t));
+
+            t0 = (double) clock();
+            if (ClutterRemoval_process(&obj, &cubeOut) != CLUTTER_REMOVAL_SUCCESS) {
+                printf("ClutterRemoval_process failed\n");
+                return 1;
+            }
+            time += (double) clock() - t0;
+
+            refProcess(&cfg, &cubeRef, refState, &refValid);
+            for (k = 0; k < numSamples; k++) {
+                mismatches += ((out[k].real != ref[k].real) || (out[k].imag != ref[k].imag)) ? 1U : 0U;
+            }
+            for (k = 0; k < NUM_CLUTTER; k++) {
+                clutterIn  += dopplerPower(&cubeIn, clutterBins[k], 0.0);
+                clutterOut += dopplerPower(&cubeOut, clutterBins[k], 0.0);
+            }
+            moverIn  += dopplerPower(&cubeIn, moverBin, MOVER_DOPPLER);
+            moverOut += dopplerPower(&cubeOut, moverBin, MOVER_DOPPLER);
+        }
+
+        printf("%-20s clutter %6.1f dB  mover %5.2f dB  %u mismatches against the reference  %.2f us per frame\n",
+               (mode == CLUTTER_REMOVAL_MODE_MEAN) ? "mean over chirps" : "exponential average",
+               10.0 * log10(clutterOut / clutterIn), 10.0 * log10(moverOut / moverIn), mismatches,
+               time / CLOCKS_PER_SEC / numFrames * 1e6);
+        failed |= (mismatches != 0U) ? 1 : 0;
+    }
+
+    free(in);
+    free(out);
+    free(ref);
+    free(state);
+    free(refState);
+    return failed;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file cube_ring_bench.c
+ * @brief Host stress test and benchmark of the radar cube ring (cube_ring.c).
+ *
+ * - sequence: deterministic checks on one thread: frames are numbered in
+ *   order, pinned frames survive any number of publishes, the producer drops
+ *   frames once all other slots are pinned and reuses the oldest free slot,
+ * - concurrency: a producer thread writes every sample of a frame with its
+ *   sequence number and publishes it, reader threads pin the latest frame or
+ *   one up to depth - 2 frames older, check that every sample still carries
+ *   the sequence number of the handle (twice, before and after a pause) and
+ *   release it. A torn or overwritten frame counts as mismatch,
+ * - run time of publish and acquire/release.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/cube_ring_bench.c \
+ *     minimal_rangeproc_impl/src/cube_ring.c -lpthread -o cube_ring_bench
+ * ./cube_ring_bench [depth] [num readers] [num frames]
+ * @endcode
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "cube_ring.h"
+
+#define NUM_CHIRPS          (4U)
+#define NUM_ANTENNAS        (6U)
+#define NUM_RANGE_BINS      (64U)
+
+typedef struct Bench_t
+{
+    CubeRing_Obj      ring;
+    volatile uint32_t done;
+} Bench;
+
+typedef struct Reader_t
+{
+    Bench   *bench;
+    uint32_t id;
+    uint32_t numReads;
+    uint32_t numMisses;
+    uint32_t numMismatches;
+    double   time;
+} Reader;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void fillFrame(const RadarCube_View *cube, uint32_t seq) {
+    uint32_t n, len = cube->numChirps * cube->numAntennas * cube->numRangeBins;
+
+    for (n = 0; n < len; n++) {
+        cube->data[n].real = (int16_t) (seq & 0xFFFFU);
+        cube->data[n].imag = (int16_t) (seq >> 16);
+    }
+}
+
+static uint32_t checkFrame(const RadarCube_View *cube, uint32_t seq) {
+    uint32_t n, len = cube->numChirps * cube->numAntennas * cube->numRangeBins;
+
+    for (n = 0; n < len; n++) {
+        if (((uint32_t) (uint16_t) cube->data[n].real | ((uint32_t) (uint16_t) cube->data[n].imag << 16)) != seq) {
+            return 1U;
+        }
+    }
+    return 0U;
+}
+
+static void *readerTask(void *arg) {
+    Reader  *r    = (Reader *) arg;
+    Bench   *b    = r->bench;
+    uint64_t rand = 0x9E3779B97F4A7C15ULL * (r->id + 1U);
+
+    while (__atomic_load_n(&b->done, __ATOMIC_SEQ_CST) == 0U) {
+        CubeRing_Handle h;
+        uint32_t        latest = CubeRing_latest(&b->ring);
+        uint32_t        age, seq;
+        double          t0;
+
+        rand ^= rand << 13;
+        rand ^= rand >> 7;
+        rand ^= rand << 17;
+        age = (uint32_t) (rand % (b->ring.cfg.depth - 1U));
+        seq = latest - age;
+        if ((latest == 0U) || (age >= latest)) {
+            continue;
+        }
+        t0 = now();
+        if (CubeRing_acquire(&b->ring, seq, &h) != CUBE_RING_SUCCESS) {
+            r->numMisses++;
+            continue;
+        }
+        r->time += now() - t0;
+        r->numMismatches += checkFrame(&h.cube, seq);
+        sched_yield();
+        r->numMismatches += checkFrame(&h.cube, seq);
+        t0 = now();
+        CubeRing_release(&b->ring, &h);
+        r->time += now() - t0;
+        r->numReads++;
+    }
+    return NULL;
+}
+
+/* deterministic checks on one thread, returns the number of failed checks */
+static uint32_t sequenceTest(uint32_t depth, void *mem) {
+    CubeRing_Config cfg = { depth, NUM_CHIRPS, NUM_ANTENNAS, NUM_RANGE_BINS };
+    CubeRing_Obj    ring;
+    CubeRing_Handle pinned[CUBE_RING_MAX_DEPTH], h;
+    RadarCube_View  cube;
+    uint32_t        failed = 0U, k;
+
+    CubeRing_init(&ring, &cfg, mem);
+    failed += (CubeRing_latest(&ring) != 0U) ? 1U : 0U;
+    failed += (CubeRing_acquire(&ring, 1U, &h) != CUBE_RING_ENOENT) ? 1U : 0U;
+
+    /* pin frames 1 .. depth - 1, then every publish has to fail without touching them */
+    for (k = 1U; k < depth; k++) {
+        CubeRing_writeView(&ring, &cube);
+        fillFrame(&cube, k);
+        failed += (CubeRing_publish(&ring) != CUBE_RING_SUCCESS) ? 1U : 0U;
+        failed += (CubeRing_latest(&ring) != k) ? 1U : 0U;
+        failed += (CubeRing_acquire(&ring, k, &pinned[k]) != CUBE_RING_SUCCESS) ? 1U : 0U;
+    }
+    for (k = 0; k < 3U; k++) {
+        CubeRing_writeView(&ring, &cube);
+        fillFrame(&cube, 0xDEADU);
+        failed += (CubeRing_publish(&ring) != CUBE_RING_EBUSY) ? 1U : 0U;
+    }
+    failed += (ring.numDropped != 3U) ? 1U : 0U;
+    failed += (CubeRing_latest(&ring) != depth - 1U) ? 1U : 0U;
+    for (k = 1U; k < depth; k++) {
+        failed += checkFrame(&pinned[k].cube, k);
+    }
+
+    /* release frame 2 (or 1): the next publish reuses its slot, the older pinned frames stay */
+    k = (depth > 2U) ? 2U : 1U;
+    CubeRing_release(&ring, &pinned[k]);
+    CubeRing_writeView(&ring, &cube);
+    fillFrame(&cube, depth);
+    failed += (CubeRing_publish(&ring) != CUBE_RING_SUCCESS) ? 1U : 0U;
+    failed += (CubeRing_acquire(&ring, k, &h) != CUBE_RING_ENOENT) ? 1U : 0U;
+    failed += (CubeRing_acquire(&ring, depth, &h) != CUBE_RING_SUCCESS) ? 1U : 0U;
+    failed += checkFrame(&h.cube, depth);
+    CubeRing_release(&ring, &h);
+    CubeRing_writeView(&ring, &cube);
+    failed += (cube.data != pinned[k].cube.data) ? 1U : 0U;
+    for (k = 1U; k < depth; k++) {
+        if (pinned[k].seq != 0U) {
+            failed += checkFrame(&pinned[k].cube, k);
+            CubeRing_release(&ring, &pinned[k]);
+        }
+    }
+    return failed;
+}
+
+int main(int argc, char **argv) {
+    uint32_t        depth      = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 4U;
+    uint32_t        numReaders = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 3U;
+    uint32_t        numFrames  = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : 200000U;
+    CubeRing_Config cfg        = { depth, NUM_CHIRPS, NUM_ANTENNAS, NUM_RANGE_BINS };
+    Bench           bench;
+    Reader         *readers;
+    pthread_t      *threads;
+    void           *mem;
+    double          publishTime = 0.0, readTime = 0.0;
+    uint32_t        numReads = 0U, numMisses = 0U, mismatches = 0U, failed, k;
+
+    mem = malloc(CubeRing_memSize(&cfg));
+    if ((mem == NULL) || (numReaders == 0U) || (CubeRing_init(&bench.ring, &cfg, mem) != CUBE_RING_SUCCESS)) {
+        fprintf(stderr, "usage: %s [depth 2..%u] [num readers >= 1] [num frames]\n", argv[0], CUBE_RING_MAX_DEPTH);
+        return 1;
+    }
+    printf("%u slots of %u chirps x %u antennas x %u range bins (%u B), %u readers, %u frames\n", depth, NUM_CHIRPS,
+           NUM_ANTENNAS, NUM_RANGE_BINS, CubeRing_memSize(&cfg) / depth, numReaders, numFrames);
+
+    failed = sequenceTest(depth, mem);
+    printf("sequence checks: %u failed\n", failed);
+
+    readers = (Reader *) calloc(numReaders, sizeof(Reader));
+    threads = (pthread_t *) calloc(numReaders, sizeof(pthread_t));
+    if ((readers == NULL) || (threads == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    CubeRing_init(&bench.ring, &cfg, mem);
+    bench.done = 0U;
+    for (k = 0; k < numReaders; k++) {
+        readers[k].bench = &bench;
+        readers[k].id    = k;
+        pthread_create(&threads[k], NULL, readerTask, &readers[k]);
+    }
+    for (k = 1U; k <= numFrames; k++) {
+        RadarCube_View cube;
+        double         t0;
+
+        CubeRing_writeView(&bench.ring, &cube);
+        fillFrame(&cube, bench.ring.latestSeq + 1U);
+        t0 = now();
+        if (CubeRing_publish(&bench.ring) != CUBE_RING_SUCCESS) {
+            k--;
+        }
+        publishTime += now() - t0;
+    }
+    __atomic_store_n(&bench.done, 1U, __ATOMIC_SEQ_CST);
+    for (k = 0; k < numReaders; k++) {
+        pthread_join(threads[k], NULL);
+        numReads   += readers[k].numReads;
+        numMisses  += readers[k].numMisses;
+        mismatches += readers[k].numMismatches;
+        readTime   += readers[k].time;
+    }
+
+    printf("%u frames published, %u dropped (all other slots pinned)\n", numFrames, bench.ring.numDropped);
+    printf("%u frames read, %u overtaken before pinned, %u mismatches\n", numReads, numMisses, mismatches);
+    printf("publish %.3f us  acquire + release %.3f us\n", publishTime / (numFrames + bench.ring.numDropped) * 1e6,
+           (numReads != 0U) ? readTime / numReads * 1e6 : 0.0);
+
+    free(readers);
+    free(threads);
+    free(mem);
+    return ((failed != 0U) || (mismatches != 0U)) ? 1 : 0;
+}
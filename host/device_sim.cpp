@@ -0,0 +1,457 @@
+/**
+ * @file device_sim.cpp
+ * @brief Simulates the UART output of the sensor on a pseudo-terminal.
+ *
+ * Emits frames in the frame format of frame_protocol.h (frame header, TLVs,
+ * CRC) on a pty, so receivers, plotters and benchmarks can be run without a
+ * device. The frames are either
+ *
+ * - replayed unchanged from a recording (see frame_record.cpp), with all TLVs
+ *   the recorded firmware sent, or
+ * - generated from synthetic range profiles with the dimensions of defines.h.
+ *   These only carry the range profile and TX statistics TLVs; the other TLVs
+ *   the firmware sends depending on proc_config.h (range ROI, duty cycle, heat
+ *   map, detections, point cloud, peaks, integrated profile, micro-Doppler,
+ *   ...) are not simulated.
+ *
+ * Timing follows the device: a frame is produced every frame period
+ * (CLI_FRAME_PERIOD unless overridden) and its bytes are paced at the line rate
+ * of the baud rate (8N1). As on the device, a frame which is due while the
+ * previous one is still being sent is dropped and counted in the TX statistics.
+ * Bit errors, dropped bytes and burst losses can be injected on the line.
+ *
+ * Build and run from the repository root:
+ * @code
+ * g++ -O2 -Wall -I minimal_rangeproc_impl/include host/device_sim.cpp \
+ *     -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c \
+ *     -o device_sim
+ * ./device_sim -l /tmp/ttyRadar                   # synthetic profiles, prints the pty name
+ * ./device_sim -l /tmp/ttyRadar -r capture.rec -p 10 -b 3000000 --ber 1e-6 --burst 0.01:200
+ * ./device_sim -o capture.bin -n 1000 -p 0 -b 0  # write a synthetic capture as fast as possible
+ * ./frame_dump /tmp/ttyRadar
+ * @endcode
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "frame_packer.h"
+#include "frame_protocol.h"
+#include "recording.hpp"
+
+namespace {
+
+struct Options {
+    const char *recording  = nullptr;
+    const char *defines    = "minimal_rangeproc_impl/include/defines.h";
+    const char *link       = nullptr;
+    const char *output     = nullptr;
+    double      periodMs   = -1.0;     /* < 0: from defines.h or the recording */
+    long        baudRate   = 115200L;  /* 0: unpaced */
+    uint64_t    numFrames  = 0;        /* 0: endless */
+    double      ber        = 0.0;
+    double      dropRate   = 0.0;
+    double      burstRate  = 0.0;
+    uint32_t    burstLen   = 0;
+    uint32_t    seed       = 1U;
+};
+
+struct Stats {
+    uint64_t framesQueued  = 0;
+    uint64_t framesSent    = 0;
+    uint64_t framesDropped = 0;
+    uint64_t bytesSent     = 0;
+    uint64_t bitErrors     = 0;
+    uint64_t bytesDropped  = 0;
+    uint64_t bursts        = 0;
+    uint64_t bytesOverflow = 0;
+};
+
+volatile std::sig_atomic_t gStop = 0;
+
+void onSignal(int) {
+    gStop = 1;
+}
+
+double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+void sleepUntil(double t) {
+    struct timespec ts;
+    ts.tv_sec  = static_cast<time_t>(t);
+    ts.tv_nsec = static_cast<long>((t - static_cast<double>(ts.tv_sec)) * 1e9);
+    while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) && !gStop) {
+    }
+}
+
+/* Source of the frames: replayed from a recording or synthesized */
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+    /* Writes the next frame to buf, returns its length (0: no more frames) */
+    virtual size_t next(std::vector<uint8_t> &buf, const Stats &stats) = 0;
+};
+
+class RecordingSource : public FrameSource {
+public:
+    bool open(const char *path) { return reader_.open(path) && (reader_.numFrames() > 0U); }
+
+    const radar::RecordingReader &reader() const { return reader_; }
+
+    size_t next(std::vector<uint8_t> &buf, const Stats &) override {
+        radar::FrameView frame = reader_.frame(pos_);
+        pos_ = (pos_ + 1U) % reader_.numFrames();
+        buf.assign(frame.data, frame.data + frame.size);
+        return frame.size;
+    }
+
+private:
+    radar::RecordingReader reader_;
+    size_t                 pos_ = 0;
+};
+
+/*
+ * Range profiles of a few point targets (sinc shaped peaks, one of them slowly
+ * moving), a decaying near-range leakage and noise, packed as in uart_packFrame().
+ */
+class SyntheticSource : public FrameSource {
+public:
+    SyntheticSource(const Recording_Config &cfg, uint32_t seed) : cfg_(cfg), rng_(seed) {}
+
+    size_t next(std::vector<uint8_t> &buf, const Stats &stats) override {
+        const uint32_t           numBins = cfg_.numRangeBins;
+        FramePacker              packer;
+        FrameProto_Header        header;
+        FrameProto_RangeProfile *profile;
+        FrameProto_TxStats      *txStats;
+        std::normal_distribution<double> noise(0.0, 20.0);
+
+        buf.resize(sizeof(FrameProto_Header) + 2U * sizeof(FrameProto_TlvHeader) + sizeof(FrameProto_RangeProfile) +
+                   numBins * 4U + sizeof(FrameProto_TxStats) + FRAME_PROTO_CRC_SIZE + 8U);
+
+        std::memset(&header, 0, sizeof(header));
+        header.frameCount         = frameCount_++;
+        header.timestamp          = static_cast<uint32_t>(nowSeconds() * 40e6);
+        header.numRangeBins       = static_cast<uint16_t>(numBins);
+        header.numDopplerChirps   = static_cast<uint16_t>(cfg_.numDopplerChirps);
+        header.numVirtualAntennas = static_cast<uint8_t>(cfg_.numVirtualAntennas);
+
+        FramePacker_init(&packer, buf.data(), static_cast<uint32_t>(buf.size()));
+        FrameProto_begin(&packer, &header);
+        profile = static_cast<FrameProto_RangeProfile *>(
+            FrameProto_addTlv(&packer, FRAME_PROTO_TLV_RANGE_PROFILE, sizeof(FrameProto_RangeProfile) + numBins * 4U));
+        profile->chirpIdx   = 1U;
+        profile->antennaIdx = 0U;
+        profile->startBin   = 0U;
+        profile->numBins    = static_cast<uint16_t>(numBins);
+
+        const double targets[3][2] = {
+            {0.2 * numBins + 0.1 * numBins * std::sin(header.frameCount * 0.05), 1500.0},
+            {0.45 * numBins, 900.0},
+            {0.7 * numBins, 400.0},
+        };
+        int16_t *samples = reinterpret_cast<int16_t *>(profile + 1);
+        for (uint32_t bin = 0; bin < numBins; bin++) {
+            double re = 2000.0 * std::exp(-static_cast<double>(bin)) + noise(rng_);
+            double im = noise(rng_);
+            for (const auto &t : targets) {
+                double x   = M_PI * (bin - t[0]);
+                double amp = t[1] * ((std::fabs(x) < 1e-9) ? 1.0 : std::sin(x) / x);
+                re += amp * std::cos(t[0]);
+                im += amp * std::sin(t[0]);
+            }
+            /* cmplx16ImRe_t: imaginary part first */
+            samples[2U * bin]      = clamp(im);
+            samples[2U * bin + 1U] = clamp(re);
+        }
+
+        txStats = static_cast<FrameProto_TxStats *>(
+            FrameProto_addTlv(&packer, FRAME_PROTO_TLV_TX_STATS, sizeof(FrameProto_TxStats)));
+        txStats->numFramesQueued  = static_cast<uint32_t>(stats.framesQueued);
+        txStats->numFramesSent    = static_cast<uint32_t>(stats.framesSent);
+        txStats->numFramesDropped = static_cast<uint32_t>(stats.framesDropped);
+
+        return FrameProto_end(&packer);
+    }
+
+    /* Frames which are dropped still advance the frame counter, as on the device */
+    void skip() { frameCount_++; }
+
+private:
+    static int16_t clamp(double v) {
+        return static_cast<int16_t>((v > 32767.0) ? 32767.0 : ((v < -32768.0) ? -32768.0 : v));
+    }
+
+    Recording_Config cfg_;
+    std::mt19937     rng_;
+    uint32_t         frameCount_ = 1U;
+};
+
+/* Line between the simulated device and the receiver, with pacing and error injection */
+class Line {
+public:
+    Line(int fd, const Options &opt, Stats &stats) : fd_(fd), opt_(opt), stats_(stats), rng_(opt.seed + 1U) {}
+
+    /* Sends a frame paced at the line rate, returns the time the last byte leaves the line */
+    double send(std::vector<uint8_t> &frame, size_t len, double start) {
+        const size_t chunk     = 64U;
+        double       byteTime  = (opt_.baudRate > 0) ? (10.0 / static_cast<double>(opt_.baudRate)) : 0.0;
+        double       t         = start;
+
+        inject(frame, len);
+        for (size_t off = 0; (off < len) && !gStop; off += chunk) {
+            size_t n = ((len - off) < chunk) ? (len - off) : chunk;
+            if (byteTime > 0.0) {
+                sleepUntil(t);
+                t += static_cast<double>(n) * byteTime;
+            }
+            writeChunk(frame.data() + off, n);
+        }
+        return t;
+    }
+
+private:
+    /* Applies bit errors, byte drops and bursts in place, shortens len accordingly */
+    void inject(std::vector<uint8_t> &frame, size_t &len) {
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+        if (opt_.ber > 0.0) {
+            /* distance to the next bit error is geometric */
+            std::geometric_distribution<uint64_t> gap(opt_.ber);
+            for (uint64_t bit = gap(rng_); bit < len * 8U; bit += gap(rng_) + 1U) {
+                frame[bit / 8U] ^= static_cast<uint8_t>(1U << (bit % 8U));
+                stats_.bitErrors++;
+            }
+        }
+        if ((opt_.burstRate > 0.0) && (uni(rng_) < opt_.burstRate) && (len > 0U)) {
+            size_t start = static_cast<size_t>(uni(rng_) * static_cast<double>(len));
+            size_t n     = ((len - start) < opt_.burstLen) ? (len - start) : opt_.burstLen;
+            frame.erase(frame.begin() + start, frame.begin() + start + n);
+            len -= n;
+            stats_.bytesDropped += n;
+            stats_.bursts++;
+        }
+        if (opt_.dropRate > 0.0) {
+            size_t out = 0;
+            for (size_t i = 0; i < len; i++) {
+                if (uni(rng_) < opt_.dropRate) {
+                    stats_.bytesDropped++;
+                } else {
+                    frame[out++] = frame[i];
+                }
+            }
+            len = out;
+        }
+    }
+
+    /* Bytes which do not fit into the pty (nobody reading) are lost, as on a real UART */
+    void writeChunk(const uint8_t *data, size_t n) {
+        while (n > 0U) {
+            ssize_t w = write(fd_, data, n);
+            if (w > 0) {
+                stats_.bytesSent += static_cast<uint64_t>(w);
+                data += w;
+                n    -= static_cast<size_t>(w);
+            } else if ((w < 0) && (errno == EINTR)) {
+                continue;
+            } else {
+                stats_.bytesOverflow += n;
+                return;
+            }
+        }
+    }
+
+    int                 fd_;
+    const Options      &opt_;
+    Stats              &stats_;
+    std::mt19937_64     rng_;
+};
+
+/* Opens a pty in raw mode, the slave is kept open so the line does not hang up without a reader */
+int openPty(std::string &slaveName, int &slaveFd) {
+    struct termios tio;
+    int            fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0)) {
+        return -1;
+    }
+    slaveName = ptsname(fd);
+    slaveFd   = open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+    if ((slaveFd >= 0) && (tcgetattr(slaveFd, &tio) == 0)) {
+        cfmakeraw(&tio);
+        tcsetattr(slaveFd, TCSANOW, &tio);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+void usage(const char *name) {
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  -r <recording>   replay a recording instead of synthetic range profiles\n"
+                 "  -d <defines.h>   configuration of the synthetic profiles and frame period\n"
+                 "  -p <ms>          frame period (default: CLI_FRAME_PERIOD, 0: as fast as the line allows)\n"
+                 "  -b <baud>        line rate (default 115200, 0: unpaced)\n"
+                 "  -n <frames>      number of frames (default: endless)\n"
+                 "  -l <path>        symlink to the pty\n"
+                 "  -o <file>        write to a file instead of a pty (- for stdout)\n"
+                 "  --ber <rate>     bit error rate\n"
+                 "  --drop <rate>    probability of a byte to be lost\n"
+                 "  --burst <p>:<n>  probability of a frame to lose a burst of n bytes\n"
+                 "  --seed <n>       seed of the noise and error generators\n",
+                 name);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    static const struct option longOptions[] = {
+        {"ber", required_argument, nullptr, 'e'},
+        {"drop", required_argument, nullptr, 'x'},
+        {"burst", required_argument, nullptr, 'u'},
+        {"seed", required_argument, nullptr, 's'},
+        {nullptr, 0, nullptr, 0},
+    };
+    Options opt;
+    Stats   stats;
+    int     c;
+
+    while ((c = getopt_long(argc, argv, "r:d:p:b:n:l:o:h", longOptions, nullptr)) != -1) {
+        switch (c) {
+            case 'r': opt.recording = optarg; break;
+            case 'd': opt.defines   = optarg; break;
+            case 'p': opt.periodMs  = std::strtod(optarg, nullptr); break;
+            case 'b': opt.baudRate  = std::strtol(optarg, nullptr, 10); break;
+            case 'n': opt.numFrames = std::strtoull(optarg, nullptr, 10); break;
+            case 'l': opt.link      = optarg; break;
+            case 'o': opt.output    = optarg; break;
+            case 'e': opt.ber       = std::strtod(optarg, nullptr); break;
+            case 'x': opt.dropRate  = std::strtod(optarg, nullptr); break;
+            case 's': opt.seed      = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10)); break;
+            case 'u':
+                if (std::sscanf(optarg, "%lf:%u", &opt.burstRate, &opt.burstLen) != 2) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    /* frame source */
+    RecordingSource  recording;
+    Recording_Config cfg;
+    FrameSource     *source;
+    if (opt.recording != nullptr) {
+        if (!recording.open(opt.recording)) {
+            std::fprintf(stderr, "cannot open recording %s\n", opt.recording);
+            return 1;
+        }
+        cfg = recording.reader().header().config;
+    } else if (!radar::readDefines(opt.defines, cfg)) {
+        std::fprintf(stderr, "cannot read the configuration from %s\n", opt.defines);
+        return 1;
+    }
+    SyntheticSource synthetic(cfg, opt.seed);
+    source = (opt.recording != nullptr) ? static_cast<FrameSource *>(&recording) : &synthetic;
+    if (opt.periodMs < 0.0) {
+        opt.periodMs = cfg.framePeriodMs;
+    }
+
+    /* output */
+    int         fd      = -1;
+    int         slaveFd = -1;
+    std::string slaveName;
+    if (opt.output != nullptr) {
+        fd = (std::strcmp(opt.output, "-") == 0) ? STDOUT_FILENO : open(opt.output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    } else {
+        fd = openPty(slaveName, slaveFd);
+        if ((fd >= 0) && (opt.link != nullptr)) {
+            unlink(opt.link);
+            if (symlink(slaveName.c_str(), opt.link) != 0) {
+                std::perror("symlink");
+            }
+        }
+        std::fprintf(stderr, "device on %s%s%s\n", slaveName.c_str(), (opt.link != nullptr) ? " -> " : "",
+                     (opt.link != nullptr) ? opt.link : "");
+    }
+    if (fd < 0) {
+        std::fprintf(stderr, "cannot open output: %s\n", std::strerror(errno));
+        return 1;
+    }
+    std::fprintf(stderr, "frame period %.1f ms, %ld baud, %u range bins\n", opt.periodMs, opt.baudRate, cfg.numRangeBins);
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    Line                 line(fd, opt, stats);
+    std::vector<uint8_t> frame;
+    double               due      = nowSeconds();
+    double               lineFree = due;
+    double               lastLog  = due;
+
+    while (!gStop && ((opt.numFrames == 0U) || (stats.framesQueued < opt.numFrames))) {
+        sleepUntil(due);
+        stats.framesQueued++;
+        if (lineFree > due + 1e-6) {
+            /* previous frame still on the line: dropped like in the pipelined firmware */
+            stats.framesDropped++;
+            synthetic.skip();
+        } else {
+            size_t len = source->next(frame, stats);
+            if (len == 0U) {
+                break;
+            }
+            lineFree = line.send(frame, len, (lineFree > due) ? lineFree : due);
+            stats.framesSent++;
+        }
+        due += opt.periodMs * 1e-3;
+        if (due < lineFree && opt.periodMs <= 0.0) {
+            due = lineFree;
+        }
+
+        if (nowSeconds() - lastLog >= 5.0) {
+            lastLog = nowSeconds();
+            std::fprintf(stderr, "frames %llu sent %llu dropped %llu  bytes %llu  bit errors %llu  bytes lost %llu  overflow %llu\n",
+                         static_cast<unsigned long long>(stats.framesQueued),
+                         static_cast<unsigned long long>(stats.framesSent),
+                         static_cast<unsigned long long>(stats.framesDropped),
+                         static_cast<unsigned long long>(stats.bytesSent),
+                         static_cast<unsigned long long>(stats.bitErrors),
+                         static_cast<unsigned long long>(stats.bytesDropped),
+                         static_cast<unsigned long long>(stats.bytesOverflow));
+        }
+    }
+
+    std::fprintf(stderr, "frames %llu sent %llu dropped %llu  bytes %llu  bit errors %llu  bytes lost %llu (%llu bursts)  overflow %llu\n",
+                 static_cast<unsigned long long>(stats.framesQueued),
+                 static_cast<unsigned long long>(stats.framesSent),
+                 static_cast<unsigned long long>(stats.framesDropped),
+                 static_cast<unsigned long long>(stats.bytesSent),
+                 static_cast<unsigned long long>(stats.bitErrors),
+                 static_cast<unsigned long long>(stats.bytesDropped),
+                 static_cast<unsigned long long>(stats.bursts),
+                 static_cast<unsigned long long>(stats.bytesOverflow));
+    if ((opt.link != nullptr) && (opt.output == nullptr)) {
+        unlink(opt.link);
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file doa_bench.c
+ * @brief Host accuracy check and benchmark of the direction of arrival estimation (doa.c).
+ *
+ * Generates radar cubes with one point target per trial at a random range bin,
+ * Doppler bin, azimuth and elevation on the virtual array of proc_config.h
+ * (APP_DOA_ANT_ROWS / APP_DOA_ANT_COLS, 2 TX x 3 RX, 4 Doppler chirps), plus
+ * complex Gaussian noise, and runs Doa_process() on the target cell:
+ *
+ * - accuracy: RMS and maximum error of sin(azimuth) and sin(elevation)
+ *   against the true direction,
+ * - reference: a double precision implementation of the same estimator has to
+ *   agree with the fixed-point one within MAX_REF_DIFF_LSB at SNRs of 20 dB and
+ *   more (at low SNR the peak may land in a different bin),
+ * - TDM: the error of moving targets without the Doppler phase compensation,
+ * - run time per detection.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/doa_bench.c minimal_rangeproc_impl/src/doa.c \
+ *     minimal_rangeproc_impl/src/fixed_math.c -lm -o doa_bench
+ * ./doa_bench [SNR per sample in dB] [num trials] [azimuth FFT size]
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "doa.h"
+#include "fixed_math.h"
+#include "proc_config.h"
+
+#define NUM_RX              (3U)
+#define NUM_TX              (2U)
+#define NUM_CHIRPS          (4U)
+#define NUM_RANGE_BINS      (64U)
+#define MAX_SIN_AZIMUTH     (0.8)
+#define MAX_SIN_ELEVATION   (0.5)
+#define NOISE_SIGMA         (30.0)      // per real and imaginary part
+#define MAX_REF_DIFF_LSB    (100.0)     // Q15, about 0.003 in sin(angle)
+
+/*! @brief Direction and motion of one synthetic target */
+typedef struct {
+    uint32_t rangeBin;
+    uint32_t dopplerBin;
+    double   sinAz;
+    double   sinEl;
+} Target;
+
+/*! @brief Errors against the true direction */
+typedef struct {
+    double   sumSqAz, sumSqEl, maxAz, maxEl;
+    uint32_t num;
+} Errors;
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gauss(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t toSample(double v) {
+    return (int16_t) ((v > 32767.0) ? 32767 : ((v < -32768.0) ? -32768 : lround(v)));
+}
+
+/* noise everywhere, the target in one range bin; TDM: TX t transmits t / NUM_TX chirp periods later */
+static void genCube(const Doa_Config *cfg, RadarCube_View *cube, const Target *target, double amp, int tdm) {
+    const int32_t signedBin = (target->dopplerBin < cfg->dopplerFftSize / 2U) ?
+                              (int32_t) target->dopplerBin : (int32_t) target->dopplerBin - (int32_t) cfg->dopplerFftSize;
+    const double  phase0 = 2.0 * M_PI * uniform();
+    uint32_t      c, a, r;
+
+    for (c = 0; c < cube->numChirps; c++) {
+        for (a = 0; a < cube->numAntennas; a++) {
+            for (r = 0; r < cube->numRangeBins; r++) {
+                cmplx16ImRe_t *s  = RadarCube_at(cube, c, a, r);
+                double         re = NOISE_SIGMA * gauss(), im = NOISE_SIGMA * gauss();
+
+                if (r == target->rangeBin) {
+                    double t   = c + (tdm ? (double) (a / cfg->numRxAntennas) / NUM_TX : 0.0);
+                    double phi = phase0 + M_PI * (cfg->antCol[a] * target->sinAz + cfg->antRow[a] * target->sinEl) +
+                                 2.0 * M_PI * signedBin * t / cfg->dopplerFftSize;
+                    re += amp * cos(phi);
+                    im += amp * sin(phi);
+                }
+                s->real = toSample(re);
+                s->imag = toSample(im);
+            }
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * double precision reference of the same estimator
+ * --------------------------------------------------------------------------- */
+
+static void refEstimate(const Doa_Config *cfg, const RadarCube_View *cube, uint32_t rangeBin, uint32_t dopplerBin,
+                        double *sinAz, double *sinEl) {
+    const uint32_t M = cfg->azimuthFftSize;
+    const int32_t  signedBin = (dopplerBin < cfg->dopplerFftSize / 2U) ?
+                               (int32_t) dopplerBin : (int32_t) dopplerBin - (int32_t) cfg->dopplerFftSize;
+    double         xRe[DOA_MAX_VIRTUAL_ANTENNAS], xIm[DOA_MAX_VIRTUAL_ANTENNAS];
+    double         mag[DOA_MAX_AZIMUTH_FFT_SIZE], bin, offset = 0.0, denom;
+    double         yRe[2] = {0.0, 0.0}, yIm[2] = {0.0, 0.0};
+    uint32_t       a, c, k, peak = 0, numRows = 0;
+
+    for (a = 0; a < cfg->numVirtualAntennas; a++) {
+        double tx = cfg->tdmCompensation ? (double) (a / cfg->numRxAntennas) / NUM_TX : 0.0;
+
+        xRe[a] = 0.0;
+        xIm[a] = 0.0;
+        for (c = 0; c < cfg->numDopplerChirps; c++) {
+            const cmplx16ImRe_t *s   = RadarCube_at(cube, c, a, rangeBin);
+            double               phi = -2.0 * M_PI * dopplerBin * c / cfg->dopplerFftSize;
+            xRe[a] += s->real * cos(phi) - s->imag * sin(phi);
+            xIm[a] += s->real * sin(phi) + s->imag * cos(phi);
+        }
+        if (tx > 0.0) {
+            double phi = -2.0 * M_PI * signedBin * tx / cfg->dopplerFftSize;
+            double re  = xRe[a] * cos(phi) - xIm[a] * sin(phi);
+            xIm[a] = xRe[a] * sin(phi) + xIm[a] * cos(phi);
+            xRe[a] = re;
+        }
+        numRows = (cfg->antRow[a] + 1U > numRows) ? cfg->antRow[a] + 1U : numRows;
+    }
+
+    for (k = 0; k < M; k++) {
+        double power = 0.0;
+        for (uint32_t row = 0; row < numRows; row++) {
+            double re = 0.0, im = 0.0;
+            for (a = 0; a < cfg->numVirtualAntennas; a++) {
+                double phi = -2.0 * M_PI * k * cfg->antCol[a] / M;
+                if (cfg->antRow[a] == row) {
+                    re += xRe[a] * cos(phi) - xIm[a] * sin(phi);
+                    im += xRe[a] * sin(phi) + xIm[a] * cos(phi);
+                }
+            }
+            power += re * re + im * im;
+        }
+        mag[k] = sqrt(power);
+        peak   = (mag[k] > mag[peak]) ? k : peak;
+    }
+    denom = mag[(peak + M - 1U) % M] - 2.0 * mag[peak] + mag[(peak + 1U) % M];
+    if (denom < 0.0) {
+        offset = 0.5 * (mag[(peak + M - 1U) % M] - mag[(peak + 1U) % M]) / denom;
+        offset = (offset > 0.5) ? 0.5 : ((offset < -0.5) ? -0.5 : offset);
+    }
+    bin    = ((peak < M / 2U) ? (double) peak : (double) peak - M) + offset;
+    *sinAz = 2.0 * bin / M;
+
+    *sinEl = 0.0;
+    if (numRows >= 2U) {
+        for (a = 0; a < cfg->numVirtualAntennas; a++) {
+            double phi = -2.0 * M_PI * bin * cfg->antCol[a] / M;
+            if (cfg->antRow[a] < 2U) {
+                yRe[cfg->antRow[a]] += xRe[a] * cos(phi) - xIm[a] * sin(phi);
+                yIm[cfg->antRow[a]] += xRe[a] * sin(phi) + xIm[a] * cos(phi);
+            }
+        }
+        *sinEl = atan2(yIm[1] * yRe[0] - yRe[1] * yIm[0], yRe[1] * yRe[0] + yIm[1] * yIm[0]) / M_PI;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * benchmark
+ * --------------------------------------------------------------------------- */
+
+static void addError(Errors *e, double az, double el) {
+    e->sumSqAz += az * az;
+    e->sumSqEl += el * el;
+    e->maxAz    = (fabs(az) > e->maxAz) ? fabs(az) : e->maxAz;
+    e->maxEl    = (fabs(el) > e->maxEl) ? fabs(el) : e->maxEl;
+    e->num++;
+}
+
+static void printErrors(const char *name, const Errors *e) {
+    printf("%-34s sin(az) rms %.4f max %.4f   sin(el) rms %.4f max %.4f\n", name, sqrt(e->sumSqAz / e->num), e->maxAz,
+           sqrt(e->sumSqEl / e->num), e->maxEl);
+}
+
+int main(int argc, char **argv) {
+    static const uint8_t antRows[] = APP_DOA_ANT_ROWS;
+    static const uint8_t antCols[] = APP_DOA_ANT_COLS;
+    double               snrDb     = (argc > 1) ? strtod(argv[1], NULL) : 10.0;
+    uint32_t             numTrials = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 2000U;
+    uint32_t             fftSize   = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : APP_DOA_AZIMUTH_FFT_SIZE;
+    double               amp       = NOISE_SIGMA * sqrt(2.0) * pow(10.0, snrDb / 20.0);
+    cmplx16ImRe_t       *cubeData;
+    RadarCube_View       cube;
+    Doa_Config           cfg, cfgNoComp;
+    Doa_Obj              doa, doaNoComp;
+    Errors               errTruth, errRef, errNoComp;
+    double               time = 0.0, maxRefLsb = 0.0;
+    uint32_t             i;
+    int                  tdm;
+    int                  failed = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.numVirtualAntennas = NUM_TX * NUM_RX;
+    cfg.numRxAntennas      = NUM_RX;
+    cfg.numDopplerChirps   = NUM_CHIRPS;
+    cfg.dopplerFftSize     = NUM_CHIRPS;
+    cfg.azimuthFftSize     = fftSize;
+    memcpy(cfg.antRow, antRows, sizeof(antRows));
+    memcpy(cfg.antCol, antCols, sizeof(antCols));
+    if ((numTrials == 0U) || (sizeof(antRows) != NUM_TX * NUM_RX) || (Doa_init(&doa, &cfg) != DOA_SUCCESS)) {
+        fprintf(stderr, "usage: %s [SNR per sample in dB] [num trials] [azimuth FFT size 4..%u]\n", argv[0],
+                DOA_MAX_AZIMUTH_FFT_SIZE);
+        return 1;
+    }
+    cubeData = (cmplx16ImRe_t *) malloc(NUM_CHIRPS * NUM_TX * NUM_RX * NUM_RANGE_BINS * sizeof(cmplx16ImRe_t));
+    if (cubeData == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    RadarCube_initView(&cube, cubeData, NUM_CHIRPS, NUM_TX * NUM_RX, NUM_RANGE_BINS);
+
+    /* atan2 over the full circle */
+    for (i = 0; i < 3600U; i++) {
+        double  phi = (i - 1800.0) * M_PI / 1800.0;
+        int16_t q   = FixedMath_atan2Q15((int64_t) (1e9 * sin(phi)), (int64_t) (1e9 * cos(phi)));
+        double  d   = fabs(q - phi / M_PI * 32768.0);
+
+        if ((d > 2.0) && (d < 65534.0)) {
+            printf("FixedMath_atan2Q15 at %.1f deg: %d, expected %.1f\n", phi * 180.0 / M_PI, q, phi / M_PI * 32768.0);
+            failed = 1;
+        }
+    }
+
+    printf("%u x %u virtual array, %u chirps, azimuth FFT %u, SNR %.1f dB per sample (%.1f dB after integration), "
+           "%u trials\n", NUM_TX, NUM_RX, NUM_CHIRPS, fftSize, snrDb,
+           snrDb + 10.0 * log10((double) NUM_CHIRPS * NUM_TX * NUM_RX), numTrials);
+
+    for (tdm = 0; tdm <= 1; tdm++) {
+        memset(&errTruth, 0, sizeof(errTruth));
+        memset(&errRef, 0, sizeof(errRef));
+        memset(&errNoComp, 0, sizeof(errNoComp));
+        cfg.tdmCompensation = (uint32_t) tdm;
+        cfgNoComp = cfg;
+        cfgNoComp.tdmCompensation = 0U;
+        Doa_init(&doa, &cfg);
+        Doa_init(&doaNoComp, &cfgNoComp);
+
+        for (i = 0; i < numTrials; i++) {
+            Target         target;
+            Cfar_Detection det;
+            Doa_Point      point;
+            double         t0, az, el, refAz, refEl;
+
+            target.rangeBin   = 1U + (uint32_t) (uniform() * (NUM_RANGE_BINS - 2U));
+            target.dopplerBin = (uint32_t) (uniform() * NUM_CHIRPS);
+            target.sinAz      = MAX_SIN_AZIMUTH * (2.0 * uniform() - 1.0);
+            target.sinEl      = MAX_SIN_ELEVATION * (2.0 * uniform() - 1.0);
+            genCube(&cfg, &cube, &target, amp, tdm);
+
+            memset(&det, 0, sizeof(det));
+            det.rangeBin   = (uint16_t) target.rangeBin;
+            det.dopplerBin = (uint16_t) target.dopplerBin;
+
+            t0 = (double) clock();
+            if (Doa_process(&doa, &cube, &det, 1U, &point) != DOA_SUCCESS) {
+                printf("Doa_process failed\n");
+                return 1;
+            }
+            time += (double) clock() - t0;
+
+            az = point.sinAzimuthQ15 / 32768.0;
+            el = point.sinElevationQ15 / 32768.0;
+            addError(&errTruth, az - target.sinAz, el - target.sinEl);
+            refEstimate(&cfg, &cube, det.rangeBin, det.dopplerBin, &refAz, &refEl);
+            addError(&errRef, az - refAz, el - refEl);
+            if (snrDb >= 20.0) {
+                double lsb = fmax(fabs(az - refAz), fabs(el - refEl)) * 32768.0;
+                maxRefLsb  = (lsb > maxRefLsb) ? lsb : maxRefLsb;
+            }
+
+            if (tdm) {
+                Doa_process(&doaNoComp, &cube, &det, 1U, &point);
+                addError(&errNoComp, point.sinAzimuthQ15 / 32768.0 - target.sinAz,
+                         point.sinElevationQ15 / 32768.0 - target.sinEl);
+            }
+        }
+
+        printf("%s\n", tdm ? "TDM MIMO" : "BPM (no Doppler phase between TX)");
+        printErrors("  vs true direction", &errTruth);
+        printErrors("  vs double precision estimator", &errRef);
+        if (tdm) {
+            printErrors("  vs true, without TDM compensation", &errNoComp);
+        }
+    }
+    printf("%.2f us per detection\n", time / CLOCKS_PER_SEC / (2.0 * numTrials) * 1e6);
+    if (snrDb >= 20.0) {
+        printf("fixed point vs double: max %.1f LSB Q15 (limit %.0f)\n", maxRefLsb, MAX_REF_DIFF_LSB);
+        failed |= (maxRefLsb > MAX_REF_DIFF_LSB) ? 1 : 0;
+    }
+
+    free(cubeData);
+    return failed;
+}
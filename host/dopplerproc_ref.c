@@ -0,0 +1,138 @@
+/**
+ * @file dopplerproc_ref.c
+ * @brief Fixed-point host reference model of the Doppler stage (see dopplerproc_ref.h).
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dopplerproc_ref.h"
+
+void DopplerProcRef_defaultConfig(DopplerProcRef_Config *cfg, uint32_t numDopplerChirps, uint32_t numRangeBins,
+                                  uint32_t numVirtualAntennas) {
+    uint32_t fftSize = 2U;
+
+    while (fftSize < numDopplerChirps) {
+        fftSize <<= 1;
+    }
+    memset(cfg, 0, sizeof(DopplerProcRef_Config));
+    cfg->numDopplerChirps              = numDopplerChirps;
+    cfg->numRangeBins                  = numRangeBins;
+    cfg->numVirtualAntennas            = numVirtualAntennas;
+    cfg->fftSize                       = fftSize;
+    cfg->windowType                    = HWA_FFT_REF_WIN_HANNING;
+    cfg->windowQFormat                 = 17U;
+    cfg->fftOutputDivShift             = 0U;
+    cfg->numLastButterflyStagesToScale = 0U;
+    cfg->twiddleQFormat                = 20U;
+    cfg->datapathBits                  = 24U;
+}
+
+int32_t DopplerProcRef_init(DopplerProcRef *ref, const DopplerProcRef_Config *cfg) {
+    uint32_t  half = (cfg->numDopplerChirps + 1U) / 2U;
+    uint32_t *winHalf;
+    uint32_t  i;
+    int32_t   retVal;
+
+    memset(ref, 0, sizeof(DopplerProcRef));
+    if ((cfg->numDopplerChirps == 0U) || (cfg->numDopplerChirps > cfg->fftSize) || (cfg->numRangeBins == 0U) ||
+        (cfg->numVirtualAntennas == 0U) || (cfg->windowQFormat > 30U)) {
+        return DOPPLERPROC_REF_EINVAL;
+    }
+    retVal = HwaFftRef_init(&ref->fft, cfg->fftSize, cfg->numLastButterflyStagesToScale, cfg->twiddleQFormat,
+                            cfg->datapathBits);
+    if (retVal != HWA_FFT_REF_SUCCESS) {
+        return (retVal == HWA_FFT_REF_ENOMEM) ? DOPPLERPROC_REF_ENOMEM : DOPPLERPROC_REF_EINVAL;
+    }
+
+    ref->cfg    = *cfg;
+    ref->window = (int32_t *) malloc(cfg->numDopplerChirps * sizeof(int32_t));
+    ref->sum    = (uint32_t *) malloc(cfg->fftSize * sizeof(uint32_t));
+    winHalf     = (uint32_t *) malloc(half * sizeof(uint32_t));
+    if ((ref->window == NULL) || (ref->sum == NULL) || (winHalf == NULL)) {
+        free(winHalf);
+        DopplerProcRef_deinit(ref);
+        return DOPPLERPROC_REF_ENOMEM;
+    }
+
+    if (cfg->numDopplerChirps == 1U) {
+        winHalf[0] = (1U << cfg->windowQFormat) - 1U;
+    } else {
+        HwaFftRef_genWindow(winHalf, cfg->numDopplerChirps, half, cfg->windowType, cfg->windowQFormat);
+    }
+    for (i = 0; i < cfg->numDopplerChirps; i++) {
+        ref->window[i] = (int32_t) winHalf[(i < half) ? i : (cfg->numDopplerChirps - 1U - i)];
+    }
+    free(winHalf);
+    return DOPPLERPROC_REF_SUCCESS;
+}
+
+void DopplerProcRef_deinit(DopplerProcRef *ref) {
+    HwaFftRef_deinit(&ref->fft);
+    free(ref->window);
+    free(ref->sum);
+    memset(ref, 0, sizeof(DopplerProcRef));
+}
+
+/* floor(sqrt(re^2 + im^2)), exact for the 24-bit datapath */
+static uint32_t DopplerProcRef_magnitude(int32_t re, int32_t im) {
+    uint64_t power = (uint64_t) ((int64_t) re * re) + (uint64_t) ((int64_t) im * im);
+    uint64_t mag   = (uint64_t) sqrt((double) power);
+
+    while (mag * mag > power) {
+        mag--;
+    }
+    while ((mag + 1U) * (mag + 1U) <= power) {
+        mag++;
+    }
+    return (uint32_t) mag;
+}
+
+int32_t DopplerProcRef_process(DopplerProcRef *ref, const RadarCube_View *cube, uint16_t *heatmap) {
+    const DopplerProcRef_Config *cfg     = &ref->cfg;
+    const uint32_t               numAnt  = cfg->numVirtualAntennas;
+    const uint32_t               numFfts = cfg->numRangeBins * numAnt;
+    const uint32_t               wq      = cfg->windowQFormat;
+    uint32_t                     f, c, l, k;
+
+    if ((cube->numChirps != cfg->numDopplerChirps) || (cube->numAntennas != numAnt) ||
+        (cube->numRangeBins != cfg->numRangeBins)) {
+        return DOPPLERPROC_REF_EINVAL;
+    }
+
+    /* FFTs of all (range bin, antenna) pairs, HWA_FFT_REF_BATCH at a time, antennas of a bin consecutive */
+    for (f = 0; f < numFfts; f += HWA_FFT_REF_BATCH) {
+        uint32_t lanes = ((numFfts - f) < HWA_FFT_REF_BATCH) ? (numFfts - f) : HWA_FFT_REF_BATCH;
+
+        HwaFftRef_clear(&ref->fft);
+        for (l = 0; l < lanes; l++) {
+            RadarCube_Slice x = RadarCube_chirpSlice(cube, (f + l) % numAnt, (f + l) / numAnt);
+            for (c = 0; c < cfg->numDopplerChirps; c++) {
+                const cmplx16ImRe_t *s = RadarCube_sliceAt(&x, c);
+                HwaFftRef_load(&ref->fft, l, c, HwaFftRef_roundShift((int64_t) s->real * ref->window[c], wq),
+                               HwaFftRef_roundShift((int64_t) s->imag * ref->window[c], wq));
+            }
+        }
+
+        HwaFftRef_run(&ref->fft);
+
+        for (l = 0; l < lanes; l++) {
+            uint32_t ant = (f + l) % numAnt;
+            uint32_t bin = (f + l) / numAnt;
+
+            for (k = 0; k < cfg->fftSize; k++) {
+                uint32_t mag = DopplerProcRef_magnitude(HwaFftRef_re(&ref->fft, l, k), HwaFftRef_im(&ref->fft, l, k));
+                mag = (uint32_t) HwaFftRef_roundShift(mag, cfg->fftOutputDivShift);
+                mag = (mag > 0xFFFFU) ? 0xFFFFU : mag;
+                ref->sum[k] = ((ant == 0U) ? 0U : ref->sum[k]) + mag;
+            }
+            if (ant == numAnt - 1U) {
+                for (k = 0; k < cfg->fftSize; k++) {
+                    heatmap[bin * cfg->fftSize + k] = (uint16_t) (ref->sum[k] / numAnt);
+                }
+            }
+        }
+    }
+    return DOPPLERPROC_REF_SUCCESS;
+}
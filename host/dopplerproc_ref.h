@@ -0,0 +1,135 @@
+#ifndef DOPPLERPROC_REF_H
+#define DOPPLERPROC_REF_H
+
+/**
+ * @file dopplerproc_ref.h
+ * @brief Fixed-point host reference model of the Doppler stage (doppler_proc.c).
+ *
+ * Computes the range-Doppler heat map from a radar cube in
+ * DPIF_RADARCUBE_FORMAT_6 (see radar_cube.h) like DopplerProc_process():
+ *
+ * 1. Window: the numDopplerChirps samples of every range bin and virtual antenna
+ *    times the symmetric window of mathUtils_genWindow() in Q windowQFormat,
+ *    rounded back to the sample scale.
+ * 2. Doppler FFT of size fftSize (zero-padded) on the HWA FFT model of hwa_fft_ref.h.
+ * 3. Magnitude, rounding right shift by fftOutputDivShift and saturation to
+ *    16 bit (HWA magnitude mode with 16-bit unsigned output).
+ * 4. Non-coherent integration: mean of the magnitudes over all virtual
+ *    antennas, Heatmap[range][doppler] of uint16_t, Doppler bins in FFT order
+ *    (bin 0 is zero velocity).
+ *
+ * The magnitude is modeled as floor(sqrt(re^2 + im^2)) of the full precision
+ * FFT output; as for rangeproc_ref.h this has to be confirmed with golden
+ * vectors captured on the device.
+ *
+ * Host only, needs -DHOST_BUILD for radar_cube.h.
+ */
+
+#include <stdint.h>
+
+#include "hwa_fft_ref.h"
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define DOPPLERPROC_REF_SUCCESS         (0)
+#define DOPPLERPROC_REF_EINVAL          (-1)
+#define DOPPLERPROC_REF_ENOMEM          (-2)
+
+/*!
+ * @brief Parameters of the modeled stage, named as in DopplerProc_Config.
+ */
+typedef struct DopplerProcRef_Config_t
+{
+    /*! @brief Number of Doppler chirps of the radar cube */
+    uint32_t numDopplerChirps;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief FFT size, a power of two >= numDopplerChirps */
+    uint32_t fftSize;
+
+    /*! @brief Window type (APP_DOPPLER_WINDOW) */
+    HwaFftRef_Window windowType;
+
+    /*! @brief Q format of the window (DPC_OBJDET_QFORMAT_DOPPLER_FFT) */
+    uint32_t windowQFormat;
+
+    /*! @brief Right shift of the magnitude (APP_DOPPLER_FFT_OUTPUT_DIV_SHIFT) */
+    uint32_t fftOutputDivShift;
+
+    /*! @brief Number of last butterfly stages scaling by 1/2 */
+    uint32_t numLastButterflyStagesToScale;
+
+    /*! @brief Q format of the twiddle factors */
+    uint32_t twiddleQFormat;
+
+    /*! @brief Word length of the FFT datapath in bits */
+    uint32_t datapathBits;
+} DopplerProcRef_Config;
+
+/*!
+ * @brief State of the reference model.
+ */
+typedef struct DopplerProcRef_t
+{
+    /*! @brief Configuration */
+    DopplerProcRef_Config cfg;
+
+    /*! @brief Doppler FFT, its path can be changed with HwaFftRef_setPath() */
+    HwaFftRef fft;
+
+    /*! @brief Window, numDopplerChirps entries (both halves) */
+    int32_t *window;
+
+    /*! @brief Sum of the magnitudes over the antennas of one range bin, fftSize entries */
+    uint32_t *sum;
+} DopplerProcRef;
+
+/**
+ * @brief Fills a configuration with the defaults of proc_config.h.
+ *
+ * @param[out] cfg                Configuration.
+ * @param[in]  numDopplerChirps   Number of Doppler chirps of the radar cube.
+ * @param[in]  numRangeBins       Number of range bins of the radar cube.
+ * @param[in]  numVirtualAntennas Number of virtual antennas of the radar cube.
+ */
+void DopplerProcRef_defaultConfig(DopplerProcRef_Config *cfg, uint32_t numDopplerChirps, uint32_t numRangeBins,
+                                  uint32_t numVirtualAntennas);
+
+/**
+ * @brief Allocates the tables and buffers of the model, selects the fastest available path.
+ *
+ * @return DOPPLERPROC_REF_SUCCESS, DOPPLERPROC_REF_EINVAL or DOPPLERPROC_REF_ENOMEM.
+ */
+int32_t DopplerProcRef_init(DopplerProcRef *ref, const DopplerProcRef_Config *cfg);
+
+/**
+ * @brief Frees the tables and buffers.
+ */
+void DopplerProcRef_deinit(DopplerProcRef *ref);
+
+/**
+ * @brief Computes the range-Doppler heat map of a radar cube.
+ *
+ * @param[in]  cube    Radar cube matching the configuration.
+ * @param[out] heatmap Heat map [numRangeBins][fftSize].
+ *
+ * @return DOPPLERPROC_REF_SUCCESS, DOPPLERPROC_REF_EINVAL if the cube does not match the configuration.
+ */
+int32_t DopplerProcRef_process(DopplerProcRef *ref, const RadarCube_View *cube, uint16_t *heatmap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DOPPLERPROC_REF_H */
@@ -0,0 +1,328 @@
+/**
+ * @file frame_decoder.hpp
+ * @brief Streaming decoder of the UART frame format (see frame_protocol.h).
+ *
+ * Bytes can be fed in chunks of arbitrary size. The decoder searches for the
+ * magic word, validates header and CRC and hands every valid frame to a
+ * callback. After a transmission error it skips to the next magic word, so a
+ * single corrupted frame costs exactly one frame.
+ *
+ * See `frame_receiver.hpp` for reading from a tty, file or pipe.
+ *
+ * Needs `frame_protocol.c` for the CRC, see `frame_dump.cpp` for a build command.
+ */
+
+#ifndef FRAME_DECODER_HPP
+#define FRAME_DECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) && !defined(FRAME_DECODER_NO_SIMD)
+#include <emmintrin.h>
+#endif
+
+#include "frame_protocol.h"
+
+namespace radar {
+
+/*! @brief Magic word as it appears on the wire (little endian 16-bit words) */
+static const uint8_t kFrameMagic[FRAME_PROTO_MAGIC_WORDS * 2] = {
+    FRAME_PROTO_MAGIC_0 & 0xFF, FRAME_PROTO_MAGIC_0 >> 8,
+    FRAME_PROTO_MAGIC_1 & 0xFF, FRAME_PROTO_MAGIC_1 >> 8,
+    FRAME_PROTO_MAGIC_2 & 0xFF, FRAME_PROTO_MAGIC_2 >> 8,
+    FRAME_PROTO_MAGIC_3 & 0xFF, FRAME_PROTO_MAGIC_3 >> 8,
+};
+
+/*! @brief One TLV of a frame, pointing into the frame */
+struct TlvView {
+    uint32_t       type;
+    uint32_t       length;
+    const uint8_t *payload;
+};
+
+/*! @brief A validated frame; only valid during the callback it is passed to */
+struct FrameView {
+    FrameProto_Header header;
+    const uint8_t    *data;
+    size_t            size;
+
+    /**
+     * @brief Calls f(const TlvView &) for every TLV of the frame.
+     *
+     * @return false if the TLV list is inconsistent with the frame length.
+     */
+    template <class F>
+    bool forEachTlv(F &&f) const {
+        size_t offset = header.headerLen;
+        size_t end    = size - FRAME_PROTO_CRC_SIZE;
+
+        for (uint32_t i = 0; i < header.numTlvs; i++) {
+            FrameProto_TlvHeader tlv;
+            size_t               padded;
+
+            if (offset + sizeof(tlv) > end) {
+                return false;
+            }
+            std::memcpy(&tlv, data + offset, sizeof(tlv));
+            offset += sizeof(tlv);
+            padded = (static_cast<size_t>(tlv.length) + 3U) & ~static_cast<size_t>(3U);
+            if (offset + padded > end) {
+                return false;
+            }
+            f(TlvView{tlv.type, tlv.length, data + offset});
+            offset += padded;
+        }
+        return true;
+    }
+
+    /** @brief Returns the first TLV of the given type, payload is NULL if there is none. */
+    TlvView findTlv(uint32_t type) const {
+        TlvView found{type, 0, nullptr};
+        forEachTlv([&](const TlvView &tlv) {
+            if ((tlv.type == type) && (found.payload == nullptr)) {
+                found = tlv;
+            }
+        });
+        return found;
+    }
+};
+
+/*! @brief Counters of the decoder */
+struct DecoderStats {
+    uint64_t bytesReceived = 0;
+    uint64_t bytesSkipped  = 0;
+    uint64_t framesValid   = 0;
+    uint64_t headerErrors  = 0;
+    uint64_t crcErrors     = 0;
+    /*! @brief Frames missing according to gaps in the frame counter */
+    uint64_t framesLost    = 0;
+};
+
+/**
+ * @brief Checks whether a header describes a frame this decoder can handle.
+ *
+ * The header check rejects a corrupted totalLen before the decoder waits for
+ * that many bytes, so resynchronization does not stall for up to maxFrameLen.
+ */
+inline bool isHeaderValid(const FrameProto_Header &header, size_t maxFrameLen) {
+    return (header.version == FRAME_PROTO_VERSION) &&
+           (header.headerCheck == FrameProto_headerCheck(&header)) &&
+           (header.headerLen >= sizeof(FrameProto_Header)) &&
+           (header.totalLen >= static_cast<uint32_t>(header.headerLen) + FRAME_PROTO_CRC_SIZE) &&
+           (header.totalLen <= maxFrameLen);
+}
+
+/**
+ * @brief Checks the CRC32 at the end of a complete frame.
+ */
+inline bool isCrcValid(const uint8_t *frame, size_t size) {
+    uint32_t crc;
+    uint32_t expected;
+
+    crc = FrameProto_crc32(0U, frame, static_cast<uint32_t>(size - FRAME_PROTO_CRC_SIZE));
+    std::memcpy(&expected, frame + size - FRAME_PROTO_CRC_SIZE, sizeof(expected));
+    return crc == expected;
+}
+
+/**
+ * @brief Finds the first (possibly partial) magic word in a byte range.
+ *
+ * With SSE2 16 candidate positions are tested at once against the first two
+ * bytes of the magic word, which is selective enough that the full comparison
+ * is rarely needed. A partial match at the end of the data is returned as well,
+ * so the caller keeps the bytes until more data arrives. Define
+ * FRAME_DECODER_NO_SIMD to force the portable memchr() search.
+ *
+ * @return Pointer to the match, NULL if there is none.
+ */
+inline const uint8_t *findMagic(const uint8_t *p, size_t len) {
+    const uint8_t *end = p + len;
+
+#if defined(__SSE2__) && !defined(FRAME_DECODER_NO_SIMD)
+    const __m128i first  = _mm_set1_epi8(static_cast<char>(kFrameMagic[0]));
+    const __m128i second = _mm_set1_epi8(static_cast<char>(kFrameMagic[1]));
+
+    while (end - p >= 17) {
+        __m128i  a    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i  b    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, second))));
+
+        while (mask != 0U) {
+            const uint8_t *candidate = p + __builtin_ctz(mask);
+            size_t         avail     = static_cast<size_t>(end - candidate);
+            size_t         cmp       = (avail < sizeof(kFrameMagic)) ? avail : sizeof(kFrameMagic);
+
+            if (std::memcmp(candidate, kFrameMagic, cmp) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1U;
+        }
+        p += 16;
+    }
+#endif
+
+    while (p < end) {
+        p = static_cast<const uint8_t *>(std::memchr(p, kFrameMagic[0], static_cast<size_t>(end - p)));
+        if (p == nullptr) {
+            return nullptr;
+        }
+        size_t avail = static_cast<size_t>(end - p);
+        size_t cmp   = (avail < sizeof(kFrameMagic)) ? avail : sizeof(kFrameMagic);
+        if (std::memcmp(p, kFrameMagic, cmp) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Streaming frame decoder.
+ *
+ * The receive buffer has a fixed capacity of at least two maximum frames.
+ * Received bytes are written directly into it (writeBuffer() / commit()), frames
+ * are handed out as views into the buffer, and only the tail of an incomplete
+ * frame is moved to the front when the end of the buffer is reached. So the
+ * buffer behaves like a ring buffer whose content is always contiguous.
+ */
+class FrameDecoder {
+public:
+    explicit FrameDecoder(size_t maxFrameLen = 64U * 1024U, size_t capacity = 0)
+        : maxFrameLen_(maxFrameLen),
+          buf_((capacity > 2U * maxFrameLen) ? capacity : 2U * maxFrameLen) {}
+
+    /**
+     * @brief Returns the free space at the end of the receive buffer.
+     *
+     * @param[out] space Number of bytes which may be written, at least capacity - maxFrameLen.
+     */
+    uint8_t *writeBuffer(size_t &space) {
+        if (end_ == buf_.size()) {
+            compact();
+        }
+        space = buf_.size() - end_;
+        return buf_.data() + end_;
+    }
+
+    /**
+     * @brief Decodes bytes written to writeBuffer(), calls onFrame(const FrameView &) for every complete frame.
+     *
+     * @return Number of frames decoded.
+     */
+    template <class Callback>
+    size_t commit(size_t len, Callback &&onFrame) {
+        size_t numFrames = 0;
+
+        end_ += len;
+        stats_.bytesReceived += len;
+
+        while (true) {
+            size_t         avail = end_ - pos_;
+            const uint8_t *p     = buf_.data() + pos_;
+            const uint8_t *magic = findMagic(p, avail);
+
+            if (magic == nullptr) {
+                stats_.bytesSkipped += avail;
+                pos_ += avail;
+                break;
+            }
+            stats_.bytesSkipped += static_cast<size_t>(magic - p);
+            pos_ += static_cast<size_t>(magic - p);
+            avail = end_ - pos_;
+
+            if (avail < sizeof(FrameProto_Header)) {
+                break;
+            }
+
+            FrameView frame;
+            std::memcpy(&frame.header, magic, sizeof(FrameProto_Header));
+            if (!isHeaderValid(frame.header, maxFrameLen_)) {
+                stats_.headerErrors++;
+                skipByte();
+                continue;
+            }
+            if (avail < frame.header.totalLen) {
+                break;
+            }
+            frame.data = magic;
+            frame.size = frame.header.totalLen;
+            if (!isCrcValid(frame.data, frame.size)) {
+                stats_.crcErrors++;
+                skipByte();
+                continue;
+            }
+
+            if (haveFrameCount_ && (frame.header.frameCount > lastFrameCount_ + 1U)) {
+                stats_.framesLost += frame.header.frameCount - lastFrameCount_ - 1U;
+            }
+            haveFrameCount_ = true;
+            lastFrameCount_ = frame.header.frameCount;
+            stats_.framesValid++;
+            numFrames++;
+
+            onFrame(static_cast<const FrameView &>(frame));
+            pos_ += frame.size;
+        }
+
+        if (pos_ == end_) {
+            pos_ = 0;
+            end_ = 0;
+        }
+        return numFrames;
+    }
+
+    /**
+     * @brief Feeds received bytes from a separate buffer (one copy), see commit().
+     *
+     * @return Number of frames decoded from this chunk.
+     */
+    template <class Callback>
+    size_t feed(const uint8_t *data, size_t len, Callback &&onFrame) {
+        size_t numFrames = 0;
+
+        while (len > 0U) {
+            size_t   space;
+            uint8_t *dst = writeBuffer(space);
+            size_t   n   = (len < space) ? len : space;
+
+            std::memcpy(dst, data, n);
+            numFrames += commit(n, onFrame);
+            data += n;
+            len  -= n;
+        }
+        return numFrames;
+    }
+
+    size_t maxFrameLen() const { return maxFrameLen_; }
+
+    const DecoderStats &stats() const { return stats_; }
+
+private:
+    void skipByte() {
+        pos_++;
+        stats_.bytesSkipped++;
+    }
+
+    /* moves the unprocessed bytes (less than one frame) to the front */
+    void compact() {
+        std::memmove(buf_.data(), buf_.data() + pos_, end_ - pos_);
+        end_ -= pos_;
+        pos_  = 0;
+    }
+
+    size_t               maxFrameLen_;
+    std::vector<uint8_t> buf_;
+    size_t               pos_ = 0;
+    size_t               end_ = 0;
+    bool                 haveFrameCount_ = false;
+    uint32_t             lastFrameCount_ = 0;
+    DecoderStats         stats_;
+};
+
+} // namespace radar
+
+#endif /* FRAME_DECODER_HPP */
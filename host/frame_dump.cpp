@@ -0,0 +1,194 @@
+/**
+ * @file frame_dump.cpp
+ * @brief Prints the frames received from the sensor (or read from a capture file).
+ *
+ * Build and run from the repository root:
+ * @code
+ * g++ -O2 -Wall -I minimal_rangeproc_impl/include host/frame_dump.cpp \
+ *     -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c \
+ *     -o frame_dump
+ * ./frame_dump /dev/ttyACM1 115200
+ * ./frame_dump capture.bin
+ * @endcode
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "frame_receiver.hpp"
+
+namespace {
+
+void printFrame(const radar::FrameView &frame) {
+    const FrameProto_Header &h = frame.header;
+
+    std::printf("frame %8u  t=%10u  %u bytes  cube %u x %u x %u  tlvs:",
+                h.frameCount, h.timestamp, h.totalLen,
+                h.numDopplerChirps, h.numVirtualAntennas, h.numRangeBins);
+    frame.forEachTlv([](const radar::TlvView &tlv) {
+        if (tlv.type == FRAME_PROTO_TLV_RANGE_ROI && tlv.length >= sizeof(FrameProto_RangeRoi)) {
+            FrameProto_RangeRoi roi;
+            std::memcpy(&roi, tlv.payload, sizeof(roi));
+            std::printf(" [range roi bins %u..%u of %u, %.2f..%.2f m]", roi.startBin,
+                        roi.startBin + roi.numBins - 1U, roi.numRangeBinsTotal, roi.startBin * roi.binSizeUm * 1e-6,
+                        (roi.startBin + roi.numBins) * roi.binSizeUm * 1e-6);
+        } else if (tlv.type == FRAME_PROTO_TLV_RANGE_PROFILE && tlv.length >= sizeof(FrameProto_RangeProfile)) {
+            FrameProto_RangeProfile rp;
+            std::memcpy(&rp, tlv.payload, sizeof(rp));
+            std::printf(" [range profile chirp %u antenna %u bins %u..%u]",
+                        rp.chirpIdx, rp.antennaIdx, rp.startBin, rp.startBin + rp.numBins - 1U);
+        } else if (tlv.type == FRAME_PROTO_TLV_INTEGRATED_RANGE_PROFILE &&
+                   tlv.length >= sizeof(FrameProto_IntegratedProfile)) {
+            FrameProto_IntegratedProfile ip;
+            uint32_t                     valueSize, numValues, peakBin = 0U;
+            double                       peakDb = 0.0, db;
+
+            std::memcpy(&ip, tlv.payload, sizeof(ip));
+            valueSize = (ip.format == 0U) ? sizeof(uint16_t) : sizeof(uint32_t);
+            numValues = std::min<uint32_t>(ip.numBins, (tlv.length - sizeof(ip)) / valueSize);
+            for (uint32_t i = 0; i < numValues; i++) {
+                if (ip.format == 0U) {
+                    uint16_t v;
+                    std::memcpy(&v, tlv.payload + sizeof(ip) + i * valueSize, sizeof(v));
+                    db = 20.0 * std::log10(2.0) * v / 256.0;
+                } else {
+                    uint32_t v;
+                    std::memcpy(&v, tlv.payload + sizeof(ip) + i * valueSize, sizeof(v));
+                    db = (v > 0U) ? 10.0 * std::log10(std::ldexp(static_cast<double>(v), ip.powerShift)) : 0.0;
+                }
+                if (db > peakDb) {
+                    peakDb  = db;
+                    peakBin = i;
+                }
+            }
+            std::printf(" [integrated profile %u samples, peak %.1f dB at bin %u]", ip.numIntegrated, peakDb,
+                        ip.startBin + peakBin);
+        } else if (tlv.type == FRAME_PROTO_TLV_RANGE_PEAKS && tlv.length >= sizeof(FrameProto_PeakList)) {
+            FrameProto_PeakList pl;
+            FrameProto_Peak     peak;
+            uint32_t            numPeaks;
+
+            std::memcpy(&pl, tlv.payload, sizeof(pl));
+            numPeaks = std::min<uint32_t>(pl.numPeaks, (tlv.length - sizeof(pl)) / sizeof(FrameProto_Peak));
+            std::printf(" [%u of %u peaks", numPeaks, pl.numCandidates);
+            for (uint32_t i = 0; i < std::min<uint32_t>(numPeaks, 3U); i++) {
+                std::memcpy(&peak, tlv.payload + sizeof(pl) + i * sizeof(peak), sizeof(peak));
+                std::printf(" %.2f:%.1fdB", peak.rangeBin + peak.offsetQ15 / 32768.0,
+                            20.0 * std::log10(2.0) * peak.log2MagQ8 / 256.0);
+            }
+            std::printf("%s]", (numPeaks > 3U) ? " ..." : "");
+        } else if (tlv.type == FRAME_PROTO_TLV_DUTY_CYCLE && tlv.length >= sizeof(FrameProto_DutyCycle)) {
+            FrameProto_DutyCycle dc;
+            std::memcpy(&dc, tlv.payload, sizeof(dc));
+            std::printf(" [duty cycle %u us: acq %u proc %u idle %u (%.1f%% active)%s]", dc.framePeriodUs,
+                        dc.acquisitionUs, dc.processingUs, dc.idleUs,
+                        (dc.framePeriodUs != 0U) ? 100.0 * (dc.framePeriodUs - dc.idleUs) / dc.framePeriodUs : 0.0,
+                        (dc.lowPowerMode != 0U) ? " DPU low power mode" : "");
+        } else if (tlv.type == FRAME_PROTO_TLV_RECONFIG && tlv.length >= sizeof(FrameProto_Reconfig)) {
+            FrameProto_Reconfig rc;
+            std::memcpy(&rc, tlv.payload, sizeof(rc));
+            std::printf(" [reconfig %u (%u rejected) after frame %u: %u us, uart %u stop %u setup %u dpc %u start %u]",
+                        rc.numReconfigs, rc.numRejected, rc.frameCount, rc.totalUs, rc.uartDrainUs, rc.sensorStopUs,
+                        rc.sensorSetupUs, rc.dpcConfigUs, rc.sensorStartUs);
+        } else if (tlv.type == FRAME_PROTO_TLV_SUBFRAME && tlv.length >= sizeof(FrameProto_SubFrame)) {
+            FrameProto_SubFrame sf;
+            std::memcpy(&sf, tlv.payload, sizeof(sf));
+            std::printf(" [sub-frame %u/%u: slope %.3f MHz/us start %.3f GHz, switch %u us, period %u us, %u overruns]",
+                        sf.subFrame, sf.numSubFrames, sf.slopeKhzPerUs / 1000.0, sf.startFreqMhz / 1000.0, sf.switchUs,
+                        sf.framePeriodUs, sf.numOverruns);
+        } else if (tlv.type == FRAME_PROTO_TLV_RANGE_DOPPLER_HEATMAP && tlv.length >= sizeof(FrameProto_Heatmap)) {
+            FrameProto_Heatmap hm;
+            uint32_t           numCells, peakCell = 0U;
+            uint16_t           peak = 0U, cell;
+
+            std::memcpy(&hm, tlv.payload, sizeof(hm));
+            numCells = std::min<uint32_t>(static_cast<uint32_t>(hm.numRangeBins) * hm.numDopplerBins,
+                                          (tlv.length - sizeof(hm)) / sizeof(uint16_t));
+            for (uint32_t i = 0; i < numCells; i++) {
+                std::memcpy(&cell, tlv.payload + sizeof(hm) + i * sizeof(uint16_t), sizeof(cell));
+                if (cell > peak) {
+                    peak     = cell;
+                    peakCell = i;
+                }
+            }
+            std::printf(" [heatmap %u x %u peak %u at bin %u doppler %u]", hm.numRangeBins, hm.numDopplerBins, peak,
+                        hm.startBin + ((hm.numDopplerBins != 0U) ? peakCell / hm.numDopplerBins : 0U),
+                        (hm.numDopplerBins != 0U) ? peakCell % hm.numDopplerBins : 0U);
+        } else if ((tlv.type == FRAME_PROTO_TLV_DETECTIONS || tlv.type == FRAME_PROTO_TLV_MINOR_MOTION_DETECTIONS) &&
+                   tlv.length >= sizeof(FrameProto_DetectionList)) {
+            FrameProto_DetectionList dl;
+            FrameProto_Detection     d;
+
+            std::memcpy(&dl, tlv.payload, sizeof(dl));
+            std::printf(" [%sdetections %u (+%u discarded)",
+                        (tlv.type == FRAME_PROTO_TLV_MINOR_MOTION_DETECTIONS) ? "minor motion " : "",
+                        dl.numDetections, dl.numDiscarded);
+            if (dl.numDetections > 0U && tlv.length >= sizeof(dl) + sizeof(d)) {
+                std::memcpy(&d, tlv.payload + sizeof(dl), sizeof(d));
+                std::printf(" first bin %u doppler %u snr %.1f dB", d.rangeBin, d.dopplerBin, d.snrDbQ8 / 256.0);
+            }
+            std::printf("]");
+        } else if (tlv.type == FRAME_PROTO_TLV_POINT_CLOUD && tlv.length >= sizeof(FrameProto_PointCloud)) {
+            FrameProto_PointCloud pc;
+            FrameProto_Point      p;
+
+            std::memcpy(&pc, tlv.payload, sizeof(pc));
+            std::printf(" [points %u (+%u discarded)", pc.numPoints, pc.numDiscarded);
+            if (pc.numPoints > 0U && tlv.length >= sizeof(pc) + sizeof(p)) {
+                std::memcpy(&p, tlv.payload + sizeof(pc), sizeof(p));
+                std::printf(" first bin %u doppler %u az %.1f el %.1f deg snr %.1f dB", p.rangeBin, p.dopplerBin,
+                            std::asin(p.sinAzimuthQ15 / 32768.0) * 180.0 / M_PI,
+                            std::asin(p.sinElevationQ15 / 32768.0) * 180.0 / M_PI, p.snrDbQ8 / 256.0);
+            }
+            std::printf("]");
+        } else if (tlv.type == FRAME_PROTO_TLV_MICRO_DOPPLER && tlv.length >= sizeof(FrameProto_MicroDoppler)) {
+            FrameProto_MicroDoppler md;
+            std::memcpy(&md, tlv.payload, sizeof(md));
+            std::printf(" [micro-Doppler bin %u centroid %.2f bw %.2f energy %.1f dB, window %u spread %.2f]",
+                        md.rangeBin, md.centroidQ8 / 256.0, md.bandwidthQ8 / 256.0, md.energyDbQ8 / 256.0,
+                        md.numFrames, md.centroidSpreadQ8 / 256.0);
+        } else if (tlv.type == FRAME_PROTO_TLV_TX_STATS && tlv.length >= sizeof(FrameProto_TxStats)) {
+            FrameProto_TxStats st;
+            std::memcpy(&st, tlv.payload, sizeof(st));
+            std::printf(" [tx queued %u sent %u dropped %u]",
+                        st.numFramesQueued, st.numFramesSent, st.numFramesDropped);
+        } else {
+            std::printf(" [type %u, %u bytes]", tlv.type, tlv.length);
+        }
+    });
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <tty or capture file, - for stdin> [baud rate]\n", argv[0]);
+        return 1;
+    }
+
+    int fd = radar::openStream(argv[1], (argc > 2) ? std::strtol(argv[2], nullptr, 10) : 115200L);
+    if (fd < 0) {
+        std::fprintf(stderr, "cannot open %s: %s\n", argv[1], std::strerror(errno));
+        return 1;
+    }
+
+    radar::FrameReceiver receiver(fd);
+    if (!receiver.run(printFrame)) {
+        std::fprintf(stderr, "read from %s failed: %s\n", argv[1], std::strerror(errno));
+    }
+
+    const radar::DecoderStats &st = receiver.stats();
+    std::printf("bytes %llu (skipped %llu)  frames %llu  lost %llu  header errors %llu  crc errors %llu\n",
+                static_cast<unsigned long long>(st.bytesReceived),
+                static_cast<unsigned long long>(st.bytesSkipped),
+                static_cast<unsigned long long>(st.framesValid),
+                static_cast<unsigned long long>(st.framesLost),
+                static_cast<unsigned long long>(st.headerErrors),
+                static_cast<unsigned long long>(st.crcErrors));
+    return 0;
+}
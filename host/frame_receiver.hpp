@@ -0,0 +1,258 @@
+/**
+ * @file frame_receiver.hpp
+ * @brief Reception of UART frames from a tty, pty, file or pipe.
+ *
+ * FrameReceiver reads large chunks from a file descriptor directly into the
+ * receive buffer of a FrameDecoder and hands out zero-copy frame views through a
+ * callback. ThreadedFrameReceiver runs the same loop in a background thread and
+ * passes the frames to the consumer through a lock-free queue (one copy per
+ * frame into a preallocated slot). Frames which do not fit into the queue are
+ * dropped and counted, the reader never blocks on a slow consumer.
+ *
+ * Needs `frame_protocol.c` for the CRC, see `frame_dump.cpp` for a build command
+ * (add -pthread when ThreadedFrameReceiver is used).
+ */
+
+#ifndef FRAME_RECEIVER_HPP
+#define FRAME_RECEIVER_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "frame_decoder.hpp"
+#include "spsc_queue.hpp"
+
+namespace radar {
+
+inline speed_t toSpeed(long baudRate) {
+    switch (baudRate) {
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        default:      return B0;
+    }
+}
+
+/**
+ * @brief Opens a stream for reading, ttys are put into raw mode.
+ *
+ * @param[in] path     tty, pty, file or "-" for stdin.
+ * @param[in] baudRate Baud rate of a tty, ignored for other streams.
+ *
+ * @return File descriptor, -1 on error (errno is set).
+ */
+inline int openStream(const char *path, long baudRate) {
+    struct termios tio;
+    int            fd;
+
+    fd = (std::strcmp(path, "-") == 0) ? STDIN_FILENO : open(path, O_RDONLY | O_NOCTTY);
+    if ((fd < 0) || !isatty(fd)) {
+        return fd;
+    }
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cc[VMIN]  = 1;
+        tio.c_cc[VTIME] = 0;
+        if (toSpeed(baudRate) != B0) {
+            cfsetispeed(&tio, toSpeed(baudRate));
+            cfsetospeed(&tio, toSpeed(baudRate));
+        }
+        if (tcsetattr(fd, TCSANOW, &tio) == 0) {
+            return fd;
+        }
+    }
+    if (fd != STDIN_FILENO) {
+        int err = errno;
+        close(fd);
+        errno = err;
+    }
+    return -1;
+}
+
+/*! @brief Result of a read from the stream */
+enum class ReadStatus { Ok, Timeout, EndOfStream, Error };
+
+class FrameReceiver {
+public:
+    /**
+     * @param[in] fd          Stream to read from, not closed by the receiver.
+     * @param[in] maxFrameLen Largest accepted frame.
+     * @param[in] readChunk   Largest single read.
+     */
+    explicit FrameReceiver(int fd, size_t maxFrameLen = 64U * 1024U, size_t readChunk = 64U * 1024U)
+        : fd_(fd), readChunk_(readChunk), decoder_(maxFrameLen, maxFrameLen + 2U * readChunk) {}
+
+    /**
+     * @brief Reads once from the stream and decodes, calls onFrame(const FrameView &) for every frame.
+     *
+     * @param[in] timeoutMs Time to wait for data, -1 waits forever.
+     */
+    template <class Callback>
+    ReadStatus poll(Callback &&onFrame, int timeoutMs = -1) {
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        size_t        space;
+        uint8_t      *dst;
+        ssize_t       n;
+
+        if (timeoutMs >= 0) {
+            int ret = ::poll(&pfd, 1, timeoutMs);
+            if (ret == 0) {
+                return ReadStatus::Timeout;
+            }
+            if (ret < 0) {
+                return (errno == EINTR) ? ReadStatus::Timeout : ReadStatus::Error;
+            }
+        }
+
+        dst = decoder_.writeBuffer(space);
+        n   = read(fd_, dst, (space < readChunk_) ? space : readChunk_);
+        if (n > 0) {
+            decoder_.commit(static_cast<size_t>(n), onFrame);
+            return ReadStatus::Ok;
+        }
+        if ((n == 0) || ((n < 0) && (errno == EIO))) {
+            /* EIO: the other side of a pty or a USB tty has gone away */
+            return ReadStatus::EndOfStream;
+        }
+        return ((errno == EINTR) || (errno == EAGAIN)) ? ReadStatus::Ok : ReadStatus::Error;
+    }
+
+    /**
+     * @brief Reads and decodes until the end of the stream or an error.
+     *
+     * @return true at the end of the stream, false on a read error.
+     */
+    template <class Callback>
+    bool run(Callback &&onFrame) {
+        ReadStatus status;
+
+        do {
+            status = poll(onFrame);
+        } while (status == ReadStatus::Ok);
+        return status == ReadStatus::EndOfStream;
+    }
+
+    const DecoderStats &stats() const { return decoder_.stats(); }
+
+private:
+    int          fd_;
+    size_t       readChunk_;
+    FrameDecoder decoder_;
+};
+
+/*! @brief Frame copied into a queue slot */
+struct FrameSlot {
+    std::vector<uint8_t> data;
+    size_t               size = 0;
+
+    FrameProto_Header header() const {
+        FrameProto_Header h;
+        std::memcpy(&h, data.data(), sizeof(h));
+        return h;
+    }
+};
+
+class ThreadedFrameReceiver {
+public:
+    /**
+     * @param[in] fd         Stream to read from, not closed by the receiver.
+     * @param[in] queueDepth Number of frames buffered for the consumer.
+     */
+    explicit ThreadedFrameReceiver(int fd, size_t queueDepth = 16U, size_t maxFrameLen = 64U * 1024U)
+        : receiver_(fd, maxFrameLen), queue_(queueDepth, FrameSlot{std::vector<uint8_t>(maxFrameLen), 0}) {
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    ~ThreadedFrameReceiver() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+
+    ThreadedFrameReceiver(const ThreadedFrameReceiver &) = delete;
+    ThreadedFrameReceiver &operator=(const ThreadedFrameReceiver &) = delete;
+
+    /** @brief Oldest received frame, nullptr if there is none. Release it with pop(). */
+    const FrameSlot *front() { return queue_.front(); }
+
+    void pop() { queue_.pop(); }
+
+    /** @brief True once the reader has stopped (end of stream or read error). */
+    bool finished() const { return finished_.load(std::memory_order_acquire); }
+
+    /** @brief Frames dropped because the queue was full. */
+    uint64_t framesDropped() const { return framesDropped_.load(std::memory_order_relaxed); }
+
+    /** @brief Snapshot of the decoder counters. */
+    DecoderStats stats() const {
+        DecoderStats st;
+        st.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+        st.bytesSkipped  = bytesSkipped_.load(std::memory_order_relaxed);
+        st.framesValid   = framesValid_.load(std::memory_order_relaxed);
+        st.headerErrors  = headerErrors_.load(std::memory_order_relaxed);
+        st.crcErrors     = crcErrors_.load(std::memory_order_relaxed);
+        st.framesLost    = framesLost_.load(std::memory_order_relaxed);
+        return st;
+    }
+
+private:
+    void loop() {
+        auto onFrame = [this](const FrameView &frame) {
+            FrameSlot *slot = queue_.beginPush();
+            if (slot == nullptr) {
+                framesDropped_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            }
+            std::memcpy(slot->data.data(), frame.data, frame.size);
+            slot->size = frame.size;
+            queue_.endPush();
+        };
+
+        while (!stop_.load(std::memory_order_relaxed)) {
+            ReadStatus status = receiver_.poll(onFrame, 100);
+            publishStats();
+            if ((status == ReadStatus::EndOfStream) || (status == ReadStatus::Error)) {
+                break;
+            }
+        }
+        finished_.store(true, std::memory_order_release);
+    }
+
+    void publishStats() {
+        const DecoderStats &st = receiver_.stats();
+        bytesReceived_.store(st.bytesReceived, std::memory_order_relaxed);
+        bytesSkipped_.store(st.bytesSkipped, std::memory_order_relaxed);
+        framesValid_.store(st.framesValid, std::memory_order_relaxed);
+        headerErrors_.store(st.headerErrors, std::memory_order_relaxed);
+        crcErrors_.store(st.crcErrors, std::memory_order_relaxed);
+        framesLost_.store(st.framesLost, std::memory_order_relaxed);
+    }
+
+    FrameReceiver         receiver_;
+    SpscQueue<FrameSlot>  queue_;
+    std::thread           thread_;
+    std::atomic<bool>     stop_{false};
+    std::atomic<bool>     finished_{false};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> bytesReceived_{0};
+    std::atomic<uint64_t> bytesSkipped_{0};
+    std::atomic<uint64_t> framesValid_{0};
+    std::atomic<uint64_t> headerErrors_{0};
+    std::atomic<uint64_t> crcErrors_{0};
+    std::atomic<uint64_t> framesLost_{0};
+};
+
+} // namespace radar
+
+#endif /* FRAME_RECEIVER_HPP */
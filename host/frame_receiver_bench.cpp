@@ -0,0 +1,165 @@
+/**
+ * @file frame_receiver_bench.cpp
+ * @brief Throughput benchmark of the frame receiver.
+ *
+ * Replays a captured byte stream (e.g. `cat /dev/ttyACM1 > capture.bin`) and
+ * reports the throughput in MB/s and frames/s:
+ * - decode: the capture is held in memory and fed to the decoder in chunks,
+ *   which measures the search, validation and CRC alone.
+ * - fd:     the capture is read from the file with FrameReceiver, which adds
+ *   the read() calls.
+ * Without a capture file a synthetic stream (range profile frames with some
+ * noise between them) is generated in memory and written to a temporary file.
+ *
+ * Build and run from the repository root:
+ * @code
+ * g++ -O2 -Wall -I minimal_rangeproc_impl/include host/frame_receiver_bench.cpp \
+ *     -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c \
+ *     -o frame_receiver_bench
+ * ./frame_receiver_bench [capture file] [repetitions]
+ * @endcode
+ * Add -DFRAME_DECODER_NO_SIMD to compare against the portable magic word search.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "frame_receiver.hpp"
+#include "frame_packer.h"
+
+namespace {
+
+const size_t kChunkSize = 4096U;
+
+/* range profile frames of 256 bins with up to 16 bytes of noise in between */
+std::vector<uint8_t> makeSyntheticStream(uint32_t numFrames, uint32_t numBins) {
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> frame(sizeof(FrameProto_Header) + 64U + numBins * 4U);
+    uint32_t             seed = 1U;
+
+    for (uint32_t i = 0; i < numFrames; i++) {
+        FramePacker       packer;
+        FrameProto_Header header;
+        uint32_t          len = sizeof(FrameProto_RangeProfile) + numBins * 4U;
+
+        std::memset(&header, 0, sizeof(header));
+        header.frameCount   = i;
+        header.numRangeBins = static_cast<uint16_t>(numBins);
+        FramePacker_init(&packer, frame.data(), static_cast<uint32_t>(frame.size()));
+        FrameProto_begin(&packer, &header);
+        uint8_t *payload = static_cast<uint8_t *>(FrameProto_addTlv(&packer, FRAME_PROTO_TLV_RANGE_PROFILE, len));
+        for (uint32_t j = 0; j < len; j++) {
+            seed = seed * 1103515245U + 12345U;
+            payload[j] = static_cast<uint8_t>(seed >> 16);
+        }
+        uint32_t frameLen = FrameProto_end(&packer);
+        stream.insert(stream.end(), frame.begin(), frame.begin() + frameLen);
+
+        seed = seed * 1103515245U + 12345U;
+        for (uint32_t j = 0; j < ((seed >> 16) & 15U); j++) {
+            stream.push_back(static_cast<uint8_t>(seed >> (j & 7U)));
+        }
+    }
+    return stream;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char *name, uint64_t bytes, uint64_t frames, double elapsed, const radar::DecoderStats &st) {
+    std::printf("%-7s %9.1f MB/s  %11.0f frames/s  (%llu frames, %llu crc errors, %llu bytes skipped)\n",
+                name, static_cast<double>(bytes) / elapsed * 1e-6, static_cast<double>(frames) / elapsed,
+                static_cast<unsigned long long>(st.framesValid),
+                static_cast<unsigned long long>(st.crcErrors),
+                static_cast<unsigned long long>(st.bytesSkipped));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<uint8_t> stream;
+    std::string          path;
+    int                  repetitions = (argc > 2) ? std::atoi(argv[2]) : 20;
+    uint64_t             checksum    = 0;
+
+    if (argc > 1) {
+        FILE *f = std::fopen(argv[1], "rb");
+        if (f == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", argv[1]);
+            return 1;
+        }
+        uint8_t chunk[kChunkSize];
+        size_t  n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            stream.insert(stream.end(), chunk, chunk + n);
+        }
+        std::fclose(f);
+        path = argv[1];
+    } else {
+        char tmpl[] = "/tmp/frame_receiver_benchXXXXXX";
+        int  fd     = mkstemp(tmpl);
+        stream = makeSyntheticStream(20000U, 256U);
+        if ((fd < 0) || (write(fd, stream.data(), stream.size()) != static_cast<ssize_t>(stream.size()))) {
+            std::fprintf(stderr, "cannot write temporary file\n");
+            return 1;
+        }
+        close(fd);
+        path = tmpl;
+    }
+    std::printf("stream: %zu bytes, %d repetitions, %s magic word search\n", stream.size(), repetitions,
+#if defined(__SSE2__) && !defined(FRAME_DECODER_NO_SIMD)
+                "SSE2");
+#else
+                "portable");
+#endif
+
+    /* decode from memory */
+    {
+        radar::FrameDecoder decoder;
+        auto                onFrame = [&](const radar::FrameView &frame) { checksum += frame.header.frameCount; };
+        auto                start   = std::chrono::steady_clock::now();
+
+        for (int r = 0; r < repetitions; r++) {
+            for (size_t off = 0; off < stream.size(); off += kChunkSize) {
+                size_t len = ((stream.size() - off) < kChunkSize) ? (stream.size() - off) : kChunkSize;
+                decoder.feed(stream.data() + off, len, onFrame);
+            }
+        }
+        const radar::DecoderStats &st = decoder.stats();
+        report("decode", st.bytesReceived, st.framesValid, seconds(start), st);
+    }
+
+    /* read from the file */
+    {
+        radar::DecoderStats total;
+        auto                onFrame = [&](const radar::FrameView &frame) { checksum += frame.header.frameCount; };
+        auto                start   = std::chrono::steady_clock::now();
+
+        for (int r = 0; r < repetitions; r++) {
+            int fd = radar::openStream(path.c_str(), 0);
+            if (fd < 0) {
+                std::fprintf(stderr, "cannot open %s\n", path.c_str());
+                return 1;
+            }
+            radar::FrameReceiver receiver(fd);
+            receiver.run(onFrame);
+            close(fd);
+            total.bytesReceived += receiver.stats().bytesReceived;
+            total.bytesSkipped  += receiver.stats().bytesSkipped;
+            total.framesValid   += receiver.stats().framesValid;
+            total.crcErrors     += receiver.stats().crcErrors;
+        }
+        report("fd", total.bytesReceived, total.framesValid, seconds(start), total);
+    }
+
+    if (argc <= 1) {
+        unlink(path.c_str());
+    }
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file frame_receiver_capi.cpp
+ * @brief C interface of ThreadedFrameReceiver, used by the Python scripts via ctypes.
+ *
+ * Build from the repository root:
+ * @code
+ * g++ -O2 -Wall -shared -fPIC -pthread -I minimal_rangeproc_impl/include host/frame_receiver_capi.cpp \
+ *     -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c -o libframe_receiver.so
+ * @endcode
+ * See `scripts/frame_receiver.py` for the Python side.
+ */
+
+#include <chrono>
+#include <new>
+#include <thread>
+
+#include "frame_receiver.hpp"
+
+namespace {
+
+struct Handle {
+    int                          fd;
+    radar::ThreadedFrameReceiver receiver;
+
+    Handle(int fd_, uint32_t queueDepth) : fd(fd_), receiver(fd_, queueDepth) {}
+};
+
+} // namespace
+
+extern "C" {
+
+/**
+ * @brief Opens a stream (see radar::openStream()) and starts the receiver thread.
+ *
+ * @return Handle, NULL on error.
+ */
+void *frx_open(const char *path, long baudRate, uint32_t queueDepth) {
+    int fd = radar::openStream(path, baudRate);
+    if (fd < 0) {
+        return nullptr;
+    }
+    Handle *h = new (std::nothrow) Handle(fd, (queueDepth > 0U) ? queueDepth : 16U);
+    if (h == nullptr) {
+        close(fd);
+    }
+    return h;
+}
+
+/**
+ * @brief Copies the oldest received frame (header, TLVs and CRC) into buf.
+ *
+ * @param[in] timeoutMs Time to wait for a frame, -1 waits until the end of the stream.
+ *
+ * @return Length of the frame, 0 on timeout, -1 at the end of the stream or on a
+ *         read error, -2 if buf is too small (the frame is dropped).
+ */
+int32_t frx_next(void *handle, uint8_t *buf, uint32_t size, int32_t timeoutMs) {
+    Handle *h        = static_cast<Handle *>(handle);
+    auto    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (true) {
+        const radar::FrameSlot *slot = h->receiver.front();
+        if (slot != nullptr) {
+            int32_t len = static_cast<int32_t>(slot->size);
+            if (slot->size > size) {
+                len = -2;
+            } else {
+                std::memcpy(buf, slot->data.data(), slot->size);
+            }
+            h->receiver.pop();
+            return len;
+        }
+        if (h->receiver.finished()) {
+            /* the queue may have been filled right before the reader stopped */
+            if (h->receiver.front() != nullptr) {
+                continue;
+            }
+            return -1;
+        }
+        if ((timeoutMs >= 0) && (std::chrono::steady_clock::now() >= deadline)) {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * @brief Counters: bytes received, bytes skipped, valid frames, header errors,
+ *        CRC errors, frames lost (frame counter gaps), frames dropped (queue full).
+ */
+void frx_stats(void *handle, uint64_t stats[7]) {
+    Handle             *h  = static_cast<Handle *>(handle);
+    radar::DecoderStats st = h->receiver.stats();
+
+    stats[0] = st.bytesReceived;
+    stats[1] = st.bytesSkipped;
+    stats[2] = st.framesValid;
+    stats[3] = st.headerErrors;
+    stats[4] = st.crcErrors;
+    stats[5] = st.framesLost;
+    stats[6] = h->receiver.framesDropped();
+}
+
+/**
+ * @brief Stops the receiver thread and closes the stream.
+ */
+void frx_close(void *handle) {
+    Handle *h  = static_cast<Handle *>(handle);
+    int     fd = h->fd;
+
+    delete h;
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,127 @@
+/**
+ * @file frame_record.cpp
+ * @brief Records the frames received from the sensor (see recording_format.h).
+ *
+ * Build and run from the repository root:
+ * @code
+ * g++ -O2 -Wall -I minimal_rangeproc_impl/include host/frame_record.cpp \
+ *     -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c \
+ *     -o frame_record
+ * ./frame_record /dev/ttyACM1 capture.rec [-b 115200] [-d minimal_rangeproc_impl/include/defines.h] [-a 4096]
+ * ./frame_record -i capture.rec
+ * @endcode
+ * Recording stops with Ctrl+C or at the end of the input.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "frame_receiver.hpp"
+#include "recording.hpp"
+
+namespace {
+
+volatile std::sig_atomic_t gStop = 0;
+
+void onSignal(int) {
+    gStop = 1;
+}
+
+int printInfo(const char *path) {
+    radar::RecordingReader reader;
+
+    if (!reader.open(path)) {
+        std::fprintf(stderr, "cannot open recording %s: %s\n", path, std::strerror(errno));
+        return 1;
+    }
+    const Recording_Header &h   = reader.header();
+    const Recording_Config &cfg = h.config;
+    std::printf("source: %s, alignment %u, %zu frames\n", h.source, h.alignment, reader.numFrames());
+    std::printf("config: %u ADC samples, %u range bins, %u virtual antennas, %u Doppler chirps, "
+                "frame period %.1f ms, %.2f GHz + %.1f MHz/us\n",
+                cfg.numAdcSamples, cfg.numRangeBins, cfg.numVirtualAntennas, cfg.numDopplerChirps,
+                cfg.framePeriodMs, cfg.startFreqGHz, cfg.chirpSlopeMHzPerUs);
+    if (reader.numFrames() > 0U) {
+        const Recording_IndexEntry &first = reader.entry(0);
+        const Recording_IndexEntry &last  = reader.entry(reader.numFrames() - 1U);
+        std::printf("frames %u .. %u, %.1f s\n", first.frameCount, last.frameCount,
+                    static_cast<double>(last.hostTimeNs - first.hostTimeNs) * 1e-9);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *defines   = "minimal_rangeproc_impl/include/defines.h";
+    long        baudRate  = 115200L;
+    uint32_t    alignment = RECORDING_DEFAULT_ALIGNMENT;
+    const char *args[2]   = {nullptr, nullptr};
+    int         numArgs   = 0;
+
+    if ((argc == 3) && (std::strcmp(argv[1], "-i") == 0)) {
+        return printInfo(argv[2]);
+    }
+    for (int i = 1; i < argc; i++) {
+        if ((std::strcmp(argv[i], "-b") == 0) && (i + 1 < argc)) {
+            baudRate = std::strtol(argv[++i], nullptr, 10);
+        } else if ((std::strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+            defines = argv[++i];
+        } else if ((std::strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+            alignment = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (numArgs < 2) {
+            args[numArgs++] = argv[i];
+        }
+    }
+    if (numArgs != 2) {
+        std::fprintf(stderr, "usage: %s <tty or file, - for stdin> <recording> [-b baud rate] [-d defines.h] [-a alignment]\n"
+                             "       %s -i <recording>\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    Recording_Config cfg;
+    if (!radar::readDefines(defines, cfg)) {
+        std::fprintf(stderr, "warning: cannot read the configuration from %s, recording without it\n", defines);
+        std::memset(&cfg, 0, sizeof(cfg));
+    }
+
+    int fd = radar::openStream(args[0], baudRate);
+    if (fd < 0) {
+        std::fprintf(stderr, "cannot open %s: %s\n", args[0], std::strerror(errno));
+        return 1;
+    }
+    radar::RecordingWriter writer;
+    if (!writer.open(args[1], cfg, args[0], alignment)) {
+        std::fprintf(stderr, "cannot create %s: %s\n", args[1], std::strerror(errno));
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    radar::FrameReceiver receiver(fd);
+    bool                 writeError = false;
+    auto                 onFrame    = [&](const radar::FrameView &frame) {
+        if (!writeError && !writer.append(frame)) {
+            std::fprintf(stderr, "write to %s failed: %s\n", args[1], std::strerror(errno));
+            writeError = true;
+        }
+    };
+    radar::ReadStatus status = radar::ReadStatus::Ok;
+    while (!gStop && !writeError &&
+           ((status == radar::ReadStatus::Ok) || (status == radar::ReadStatus::Timeout))) {
+        status = receiver.poll(onFrame, 200);
+    }
+    writer.close();
+
+    const radar::DecoderStats &st = receiver.stats();
+    std::printf("recorded %llu frames (%llu bytes)  lost %llu  crc errors %llu\n",
+                static_cast<unsigned long long>(writer.numFrames()),
+                static_cast<unsigned long long>(writer.numBytes()),
+                static_cast<unsigned long long>(st.framesLost),
+                static_cast<unsigned long long>(st.crcErrors));
+    return writeError ? 1 : 0;
+}
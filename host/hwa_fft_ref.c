@@ -0,0 +1,368 @@
+/**
+ * @file hwa_fft_ref.c
+ * @brief Fixed-point model of the HWA FFT engine (see hwa_fft_ref.h).
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hwa_fft_ref.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HWA_FFT_REF_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define HWA_FFT_REF_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define PI_ 3.14159265358979323846
+
+void HwaFftRef_genWindow(uint32_t *win, uint32_t winLen, uint32_t winGenLen, HwaFftRef_Window type, uint32_t qFormat) {
+    /* same single precision recursion as mathUtils_genWindow() */
+    float    phi        = (float) (2.0 * PI_ / ((float) winLen - 1.0F));
+    float    oneQformat = (float) (1U << qFormat);
+    float    cosPhi     = cosf(phi), sinPhi = sinf(phi);
+    float    cos2Phi    = cosf(2.0F * phi), sin2Phi = sinf(2.0F * phi);
+    float    ephyR = 1.0F, ephyI = 0.0F;
+    float    e2phyR = 1.0F, e2phyI = 0.0F;
+    float    a0 = 1.0F, a1 = 0.0F, a2 = 0.0F;
+    float    tmpR;
+    int32_t  winVal;
+    uint32_t i;
+
+    if (type == HWA_FFT_REF_WIN_HANNING) {
+        a0 = 0.5F;
+        a1 = 0.5F;
+    } else if (type == HWA_FFT_REF_WIN_BLACKMAN) {
+        a0 = 0.42F;
+        a1 = 0.5F;
+        a2 = 0.08F;
+    }
+
+    for (i = 0; i < winGenLen; i++) {
+        winVal = (int32_t) ((oneQformat * (a0 - a1 * ephyR + a2 * e2phyR)) + 0.5F);
+        if ((float) winVal >= oneQformat) {
+            winVal = (int32_t) oneQformat - 1;
+        }
+        win[i] = (uint32_t) winVal;
+
+        tmpR   = ephyR;
+        ephyR  = ephyR * cosPhi - ephyI * sinPhi;
+        ephyI  = tmpR * sinPhi + ephyI * cosPhi;
+        tmpR   = e2phyR;
+        e2phyR = e2phyR * cos2Phi - e2phyI * sin2Phi;
+        e2phyI = tmpR * sin2Phi + e2phyI * cos2Phi;
+    }
+}
+
+int32_t HwaFftRef_init(HwaFftRef *fft, uint32_t fftSize, uint32_t numLastButterflyStagesToScale,
+                       uint32_t twiddleQFormat, uint32_t datapathBits) {
+    uint32_t one = 1U << twiddleQFormat;
+    uint32_t i, j;
+
+    memset(fft, 0, sizeof(HwaFftRef));
+    if ((fftSize < 2U) || ((fftSize & (fftSize - 1U)) != 0U) || (twiddleQFormat == 0U) || (twiddleQFormat > 30U) ||
+        (datapathBits < 2U) || (datapathBits > 31U)) {
+        return HWA_FFT_REF_EINVAL;
+    }
+    while ((1U << fft->numStages) < fftSize) {
+        fft->numStages++;
+    }
+    if (numLastButterflyStagesToScale > fft->numStages) {
+        return HWA_FFT_REF_EINVAL;
+    }
+    fft->fftSize                       = fftSize;
+    fft->numLastButterflyStagesToScale = numLastButterflyStagesToScale;
+    fft->twiddleQFormat                = twiddleQFormat;
+    fft->datapathBits                  = datapathBits;
+
+    fft->twiddleRe = (int32_t *) malloc((fftSize / 2U) * sizeof(int32_t));
+    fft->twiddleIm = (int32_t *) malloc((fftSize / 2U) * sizeof(int32_t));
+    fft->bitRev    = (uint32_t *) malloc(fftSize * sizeof(uint32_t));
+    fft->workRe    = (int32_t *) aligned_alloc(32, fftSize * HWA_FFT_REF_BATCH * sizeof(int32_t));
+    fft->workIm    = (int32_t *) aligned_alloc(32, fftSize * HWA_FFT_REF_BATCH * sizeof(int32_t));
+    if ((fft->twiddleRe == NULL) || (fft->twiddleIm == NULL) || (fft->bitRev == NULL) || (fft->workRe == NULL) ||
+        (fft->workIm == NULL)) {
+        HwaFftRef_deinit(fft);
+        return HWA_FFT_REF_ENOMEM;
+    }
+
+    for (i = 0; i < fftSize / 2U; i++) {
+        double  angle = -2.0 * PI_ * (double) i / (double) fftSize;
+        int64_t re    = (int64_t) floor(cos(angle) * (double) one + 0.5);
+        int64_t im    = (int64_t) floor(sin(angle) * (double) one + 0.5);
+        fft->twiddleRe[i] = HwaFftRef_sat(re, twiddleQFormat + 1U);
+        fft->twiddleIm[i] = HwaFftRef_sat(im, twiddleQFormat + 1U);
+    }
+
+    for (i = 0; i < fftSize; i++) {
+        uint32_t r = 0U;
+        for (j = 0; j < fft->numStages; j++) {
+            r |= ((i >> j) & 1U) << (fft->numStages - 1U - j);
+        }
+        fft->bitRev[i] = r;
+    }
+
+    fft->path = HWA_FFT_REF_PATH_SCALAR;
+    if (HwaFftRef_setPath(fft, HWA_FFT_REF_PATH_AVX2) != HWA_FFT_REF_SUCCESS) {
+        (void) HwaFftRef_setPath(fft, HWA_FFT_REF_PATH_NEON);
+    }
+    HwaFftRef_clear(fft);
+    return HWA_FFT_REF_SUCCESS;
+}
+
+void HwaFftRef_deinit(HwaFftRef *fft) {
+    free(fft->twiddleRe);
+    free(fft->twiddleIm);
+    free(fft->bitRev);
+    free(fft->workRe);
+    free(fft->workIm);
+    memset(fft, 0, sizeof(HwaFftRef));
+}
+
+int32_t HwaFftRef_setPath(HwaFftRef *fft, HwaFftRef_Path path) {
+    int32_t available = 0;
+
+    switch (path) {
+        case HWA_FFT_REF_PATH_SCALAR:
+            available = 1;
+            break;
+        case HWA_FFT_REF_PATH_AVX2:
+#ifdef HWA_FFT_REF_HAVE_AVX2
+            available = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+            break;
+        case HWA_FFT_REF_PATH_NEON:
+#ifdef HWA_FFT_REF_HAVE_NEON
+            available = 1;
+#endif
+            break;
+        default:
+            break;
+    }
+    if (!available) {
+        return HWA_FFT_REF_EINVAL;
+    }
+    fft->path = path;
+    return HWA_FFT_REF_SUCCESS;
+}
+
+const char *HwaFftRef_pathName(HwaFftRef_Path path) {
+    switch (path) {
+        case HWA_FFT_REF_PATH_SCALAR: return "scalar";
+        case HWA_FFT_REF_PATH_AVX2:   return "avx2";
+        case HWA_FFT_REF_PATH_NEON:   return "neon";
+        default:                      return "unknown";
+    }
+}
+
+void HwaFftRef_clear(HwaFftRef *fft) {
+    memset(fft->workRe, 0, fft->fftSize * HWA_FFT_REF_BATCH * sizeof(int32_t));
+    memset(fft->workIm, 0, fft->fftSize * HWA_FFT_REF_BATCH * sizeof(int32_t));
+}
+
+/*
+ * FFT stages on a batch: radix-2 decimation in time on bit reversed input,
+ * x[a] +/- round(x[b] * w), optional rounding division by 2, saturation to the
+ * datapath width. All paths below perform exactly these operations.
+ */
+static void HwaFftRef_fftScalar(HwaFftRef *fft) {
+    const uint32_t n        = fft->fftSize;
+    const uint32_t tq       = fft->twiddleQFormat;
+    const uint32_t bits     = fft->datapathBits;
+    const int64_t  rnd      = (int64_t) 1 << (tq - 1U);
+    int32_t       *re       = fft->workRe;
+    int32_t       *im       = fft->workIm;
+    uint32_t       stage, len, start, k, l;
+
+    for (stage = 0, len = 2U; len <= n; len <<= 1, stage++) {
+        uint32_t half  = len / 2U;
+        uint32_t step  = n / len;
+        int32_t  scale = (stage >= fft->numStages - fft->numLastButterflyStagesToScale) ? 1 : 0;
+
+        for (start = 0; start < n; start += len) {
+            for (k = 0; k < half; k++) {
+                int64_t  wr = fft->twiddleRe[k * step];
+                int64_t  wi = fft->twiddleIm[k * step];
+                int32_t *ar = &re[(start + k) * HWA_FFT_REF_BATCH];
+                int32_t *ai = &im[(start + k) * HWA_FFT_REF_BATCH];
+                int32_t *br = &re[(start + k + half) * HWA_FFT_REF_BATCH];
+                int32_t *bi = &im[(start + k + half) * HWA_FFT_REF_BATCH];
+
+                for (l = 0; l < HWA_FFT_REF_BATCH; l++) {
+                    int32_t tr = (int32_t) ((br[l] * wr - bi[l] * wi + rnd) >> tq);
+                    int32_t ti = (int32_t) ((br[l] * wi + bi[l] * wr + rnd) >> tq);
+                    int32_t xr0 = ar[l] + tr, xi0 = ai[l] + ti;
+                    int32_t xr1 = ar[l] - tr, xi1 = ai[l] - ti;
+
+                    if (scale) {
+                        xr0 = (xr0 + 1) >> 1;
+                        xi0 = (xi0 + 1) >> 1;
+                        xr1 = (xr1 + 1) >> 1;
+                        xi1 = (xi1 + 1) >> 1;
+                    }
+                    ar[l] = HwaFftRef_sat(xr0, bits);
+                    ai[l] = HwaFftRef_sat(xi0, bits);
+                    br[l] = HwaFftRef_sat(xr1, bits);
+                    bi[l] = HwaFftRef_sat(xi1, bits);
+                }
+            }
+        }
+    }
+}
+
+#ifdef HWA_FFT_REF_HAVE_AVX2
+/* (x * y +/- u * v + rnd) >> shift in every 32-bit lane, 64-bit intermediate */
+__attribute__((target("avx2")))
+static inline __m256i HwaFftRef_mulAcc8(__m256i x, __m256i y, __m256i u, __m256i v, int32_t sub,
+                                           __m256i rnd, __m128i shift) {
+    __m256i even = _mm256_mul_epi32(x, y);
+    __m256i odd  = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+    __m256i even2 = _mm256_mul_epi32(u, v);
+    __m256i odd2  = _mm256_mul_epi32(_mm256_srli_epi64(u, 32), _mm256_srli_epi64(v, 32));
+
+    even = sub ? _mm256_sub_epi64(even, even2) : _mm256_add_epi64(even, even2);
+    odd  = sub ? _mm256_sub_epi64(odd, odd2) : _mm256_add_epi64(odd, odd2);
+    /* the low 32 bits of a logical shift equal those of the arithmetic shift */
+    even = _mm256_srl_epi64(_mm256_add_epi64(even, rnd), shift);
+    odd  = _mm256_sll_epi64(_mm256_srl_epi64(_mm256_add_epi64(odd, rnd), shift), _mm_cvtsi32_si128(32));
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2")))
+static void HwaFftRef_fftAvx2(HwaFftRef *fft) {
+    const uint32_t n      = fft->fftSize;
+    const __m256i  rnd    = _mm256_set1_epi64x((int64_t) 1 << (fft->twiddleQFormat - 1U));
+    const __m128i  shift  = _mm_cvtsi32_si128((int32_t) fft->twiddleQFormat);
+    const __m256i  maxVal = _mm256_set1_epi32((int32_t) ((1U << (fft->datapathBits - 1U)) - 1U));
+    const __m256i  minVal = _mm256_set1_epi32(-(int32_t) (1U << (fft->datapathBits - 1U)));
+    const __m256i  one    = _mm256_set1_epi32(1);
+    int32_t       *re     = fft->workRe;
+    int32_t       *im     = fft->workIm;
+    uint32_t       stage, len, start, k;
+
+    for (stage = 0, len = 2U; len <= n; len <<= 1, stage++) {
+        uint32_t half  = len / 2U;
+        uint32_t step  = n / len;
+        int32_t  scale = (stage >= fft->numStages - fft->numLastButterflyStagesToScale) ? 1 : 0;
+
+        for (start = 0; start < n; start += len) {
+            for (k = 0; k < half; k++) {
+                __m256i  wr = _mm256_set1_epi32(fft->twiddleRe[k * step]);
+                __m256i  wi = _mm256_set1_epi32(fft->twiddleIm[k * step]);
+                int32_t *pa = &re[(start + k) * HWA_FFT_REF_BATCH];
+                int32_t *qa = &im[(start + k) * HWA_FFT_REF_BATCH];
+                int32_t *pb = &re[(start + k + half) * HWA_FFT_REF_BATCH];
+                int32_t *qb = &im[(start + k + half) * HWA_FFT_REF_BATCH];
+                __m256i  ar = _mm256_load_si256((const __m256i *) pa);
+                __m256i  ai = _mm256_load_si256((const __m256i *) qa);
+                __m256i  br = _mm256_load_si256((const __m256i *) pb);
+                __m256i  bi = _mm256_load_si256((const __m256i *) qb);
+                __m256i  tr = HwaFftRef_mulAcc8(br, wr, bi, wi, 1, rnd, shift);
+                __m256i  ti = HwaFftRef_mulAcc8(br, wi, bi, wr, 0, rnd, shift);
+                __m256i  xr0 = _mm256_add_epi32(ar, tr), xi0 = _mm256_add_epi32(ai, ti);
+                __m256i  xr1 = _mm256_sub_epi32(ar, tr), xi1 = _mm256_sub_epi32(ai, ti);
+
+                if (scale) {
+                    xr0 = _mm256_srai_epi32(_mm256_add_epi32(xr0, one), 1);
+                    xi0 = _mm256_srai_epi32(_mm256_add_epi32(xi0, one), 1);
+                    xr1 = _mm256_srai_epi32(_mm256_add_epi32(xr1, one), 1);
+                    xi1 = _mm256_srai_epi32(_mm256_add_epi32(xi1, one), 1);
+                }
+                _mm256_store_si256((__m256i *) pa, _mm256_min_epi32(_mm256_max_epi32(xr0, minVal), maxVal));
+                _mm256_store_si256((__m256i *) qa, _mm256_min_epi32(_mm256_max_epi32(xi0, minVal), maxVal));
+                _mm256_store_si256((__m256i *) pb, _mm256_min_epi32(_mm256_max_epi32(xr1, minVal), maxVal));
+                _mm256_store_si256((__m256i *) qb, _mm256_min_epi32(_mm256_max_epi32(xi1, minVal), maxVal));
+            }
+        }
+    }
+}
+#endif
+
+#ifdef HWA_FFT_REF_HAVE_NEON
+/* (x * y +/- u * v + rnd) >> shift in every 32-bit lane, 64-bit intermediate */
+static inline int32x4_t HwaFftRef_mulAcc4(int32x4_t x, int32_t y, int32x4_t u, int32_t v, int32_t sub,
+                                             int64x2_t rnd, int64x2_t negShift) {
+    int64x2_t lo  = vmull_n_s32(vget_low_s32(x), y);
+    int64x2_t hi  = vmull_n_s32(vget_high_s32(x), y);
+    int64x2_t lo2 = vmull_n_s32(vget_low_s32(u), v);
+    int64x2_t hi2 = vmull_n_s32(vget_high_s32(u), v);
+
+    lo = sub ? vsubq_s64(lo, lo2) : vaddq_s64(lo, lo2);
+    hi = sub ? vsubq_s64(hi, hi2) : vaddq_s64(hi, hi2);
+    lo = vshlq_s64(vaddq_s64(lo, rnd), negShift);
+    hi = vshlq_s64(vaddq_s64(hi, rnd), negShift);
+    return vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+}
+
+static void HwaFftRef_fftNeon(HwaFftRef *fft) {
+    const uint32_t  n        = fft->fftSize;
+    const int64x2_t rnd      = vdupq_n_s64((int64_t) 1 << (fft->twiddleQFormat - 1U));
+    const int64x2_t negShift = vdupq_n_s64(-(int64_t) fft->twiddleQFormat);
+    const int32x4_t maxVal   = vdupq_n_s32((int32_t) ((1U << (fft->datapathBits - 1U)) - 1U));
+    const int32x4_t minVal   = vdupq_n_s32(-(int32_t) (1U << (fft->datapathBits - 1U)));
+    const int32x4_t one      = vdupq_n_s32(1);
+    int32_t        *re       = fft->workRe;
+    int32_t        *im       = fft->workIm;
+    uint32_t        stage, len, start, k, l;
+
+    for (stage = 0, len = 2U; len <= n; len <<= 1, stage++) {
+        uint32_t half  = len / 2U;
+        uint32_t step  = n / len;
+        int32_t  scale = (stage >= fft->numStages - fft->numLastButterflyStagesToScale) ? 1 : 0;
+
+        for (start = 0; start < n; start += len) {
+            for (k = 0; k < half; k++) {
+                int32_t wr = fft->twiddleRe[k * step];
+                int32_t wi = fft->twiddleIm[k * step];
+
+                for (l = 0; l < HWA_FFT_REF_BATCH; l += 4U) {
+                    int32_t  *pa  = &re[(start + k) * HWA_FFT_REF_BATCH + l];
+                    int32_t  *qa  = &im[(start + k) * HWA_FFT_REF_BATCH + l];
+                    int32_t  *pb  = &re[(start + k + half) * HWA_FFT_REF_BATCH + l];
+                    int32_t  *qb  = &im[(start + k + half) * HWA_FFT_REF_BATCH + l];
+                    int32x4_t ar  = vld1q_s32(pa), ai = vld1q_s32(qa);
+                    int32x4_t br  = vld1q_s32(pb), bi = vld1q_s32(qb);
+                    int32x4_t tr  = HwaFftRef_mulAcc4(br, wr, bi, wi, 1, rnd, negShift);
+                    int32x4_t ti  = HwaFftRef_mulAcc4(br, wi, bi, wr, 0, rnd, negShift);
+                    int32x4_t xr0 = vaddq_s32(ar, tr), xi0 = vaddq_s32(ai, ti);
+                    int32x4_t xr1 = vsubq_s32(ar, tr), xi1 = vsubq_s32(ai, ti);
+
+                    if (scale) {
+                        xr0 = vshrq_n_s32(vaddq_s32(xr0, one), 1);
+                        xi0 = vshrq_n_s32(vaddq_s32(xi0, one), 1);
+                        xr1 = vshrq_n_s32(vaddq_s32(xr1, one), 1);
+                        xi1 = vshrq_n_s32(vaddq_s32(xi1, one), 1);
+                    }
+                    vst1q_s32(pa, vminq_s32(vmaxq_s32(xr0, minVal), maxVal));
+                    vst1q_s32(qa, vminq_s32(vmaxq_s32(xi0, minVal), maxVal));
+                    vst1q_s32(pb, vminq_s32(vmaxq_s32(xr1, minVal), maxVal));
+                    vst1q_s32(qb, vminq_s32(vmaxq_s32(xi1, minVal), maxVal));
+                }
+            }
+        }
+    }
+}
+#endif
+
+void HwaFftRef_run(HwaFftRef *fft) {
+    switch (fft->path) {
+#ifdef HWA_FFT_REF_HAVE_AVX2
+        case HWA_FFT_REF_PATH_AVX2:
+            HwaFftRef_fftAvx2(fft);
+            break;
+#endif
+#ifdef HWA_FFT_REF_HAVE_NEON
+        case HWA_FFT_REF_PATH_NEON:
+            HwaFftRef_fftNeon(fft);
+            break;
+#endif
+        default:
+            HwaFftRef_fftScalar(fft);
+            break;
+    }
+}
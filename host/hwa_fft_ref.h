@@ -0,0 +1,201 @@
+#ifndef HWA_FFT_REF_H
+#define HWA_FFT_REF_H
+
+/**
+ * @file hwa_fft_ref.h
+ * @brief Fixed-point model of the HWA FFT engine, shared by the host reference models of the DPUs.
+ *
+ * Complex radix-2 FFT on a saturating datapath of datapathBits (24 on the HWA),
+ * twiddles in Q twiddleQFormat, every product rounded once, optional rounding
+ * division by 2 in the last numLastButterflyStagesToScale stages. Inputs shorter
+ * than fftSize are zero-padded.
+ *
+ * HWA_FFT_REF_BATCH FFTs are computed side by side: the caller loads samples
+ * with HwaFftRef_load() into the lanes of the batch, runs HwaFftRef_run() and
+ * reads the bins with HwaFftRef_re()/HwaFftRef_im(). The SIMD paths (AVX2, NEON)
+ * perform exactly the same integer operations on all lanes at once and are
+ * bit-exact with the scalar path.
+ *
+ * Also generates the windows of mathUtils_genWindow().
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of FFTs computed side by side.
+ */
+#define HWA_FFT_REF_BATCH               (8U)
+
+/**
+ * @brief Return values.
+ */
+#define HWA_FFT_REF_SUCCESS             (0)
+#define HWA_FFT_REF_EINVAL              (-1)
+#define HWA_FFT_REF_ENOMEM              (-2)
+
+/**
+ * @brief Implementations of the FFT stages.
+ */
+typedef enum HwaFftRef_Path_e
+{
+    /*! @brief Portable C */
+    HWA_FFT_REF_PATH_SCALAR = 0,
+
+    /*! @brief x86 AVX2 (selected at run time if the CPU supports it) */
+    HWA_FFT_REF_PATH_AVX2,
+
+    /*! @brief Arm NEON */
+    HWA_FFT_REF_PATH_NEON
+} HwaFftRef_Path;
+
+/**
+ * @brief Window types of mathUtils_genWindow().
+ */
+typedef enum HwaFftRef_Window_e
+{
+    /*! @brief MATHUTILS_WIN_RECT */
+    HWA_FFT_REF_WIN_RECT = 0,
+
+    /*! @brief MATHUTILS_WIN_HANNING */
+    HWA_FFT_REF_WIN_HANNING,
+
+    /*! @brief MATHUTILS_WIN_BLACKMAN */
+    HWA_FFT_REF_WIN_BLACKMAN
+} HwaFftRef_Window;
+
+/*!
+ * @brief Tables and batch buffers of one FFT size.
+ */
+typedef struct HwaFftRef_t
+{
+    /*! @brief FFT size, a power of two */
+    uint32_t fftSize;
+
+    /*! @brief log2(fftSize) */
+    uint32_t numStages;
+
+    /*! @brief Number of last butterfly stages scaling by 1/2 */
+    uint32_t numLastButterflyStagesToScale;
+
+    /*! @brief Q format of the twiddle factors */
+    uint32_t twiddleQFormat;
+
+    /*! @brief Word length of the datapath in bits */
+    uint32_t datapathBits;
+
+    /*! @brief Implementation used by HwaFftRef_run() */
+    HwaFftRef_Path path;
+
+    /*! @brief Twiddle factors exp(-j 2 pi k / fftSize), fftSize / 2 entries */
+    int32_t *twiddleRe;
+    int32_t *twiddleIm;
+
+    /*! @brief Bit reversal permutation, fftSize entries */
+    uint32_t *bitRev;
+
+    /*! @brief Batch of FFTs: [bin][lane] real and imaginary parts */
+    int32_t *workRe;
+    int32_t *workIm;
+} HwaFftRef;
+
+/**
+ * @brief Saturates a value to a signed word length.
+ */
+static inline int32_t HwaFftRef_sat(int64_t v, uint32_t bits) {
+    int64_t max = ((int64_t) 1 << (bits - 1U)) - 1;
+    int64_t min = -((int64_t) 1 << (bits - 1U));
+    return (int32_t) ((v > max) ? max : ((v < min) ? min : v));
+}
+
+/**
+ * @brief Arithmetic right shift with rounding (half up).
+ */
+static inline int64_t HwaFftRef_roundShift(int64_t v, uint32_t shift) {
+    return (shift == 0U) ? v : ((v + ((int64_t) 1 << (shift - 1U))) >> shift);
+}
+
+/**
+ * @brief Generates the first winGenLen values of a symmetric window like mathUtils_genWindow().
+ *
+ * @param[out] win       Window values.
+ * @param[in]  winLen    Length of the whole window.
+ * @param[in]  winGenLen Number of values to generate.
+ * @param[in]  type      Window type.
+ * @param[in]  qFormat   Q format of the values.
+ */
+void HwaFftRef_genWindow(uint32_t *win, uint32_t winLen, uint32_t winGenLen, HwaFftRef_Window type, uint32_t qFormat);
+
+/**
+ * @brief Allocates the tables and the batch buffers, selects the fastest available path.
+ *
+ * @param[out] fft                           FFT to initialize.
+ * @param[in]  fftSize                       FFT size, a power of two >= 2.
+ * @param[in]  numLastButterflyStagesToScale Number of last stages scaling by 1/2.
+ * @param[in]  twiddleQFormat                Q format of the twiddle factors (<= 30).
+ * @param[in]  datapathBits                  Word length of the datapath (<= 31).
+ *
+ * @return HWA_FFT_REF_SUCCESS, HWA_FFT_REF_EINVAL or HWA_FFT_REF_ENOMEM.
+ */
+int32_t HwaFftRef_init(HwaFftRef *fft, uint32_t fftSize, uint32_t numLastButterflyStagesToScale,
+                       uint32_t twiddleQFormat, uint32_t datapathBits);
+
+/**
+ * @brief Frees the tables and buffers.
+ */
+void HwaFftRef_deinit(HwaFftRef *fft);
+
+/**
+ * @brief Selects the implementation.
+ *
+ * @return HWA_FFT_REF_EINVAL if the path is not available on this machine.
+ */
+int32_t HwaFftRef_setPath(HwaFftRef *fft, HwaFftRef_Path path);
+
+/**
+ * @brief Name of an implementation.
+ */
+const char *HwaFftRef_pathName(HwaFftRef_Path path);
+
+/**
+ * @brief Zeroes all lanes of the batch (zero-padding of the inputs).
+ */
+void HwaFftRef_clear(HwaFftRef *fft);
+
+/**
+ * @brief Loads input sample n of one lane, saturated to the datapath.
+ */
+static inline void HwaFftRef_load(HwaFftRef *fft, uint32_t lane, uint32_t n, int64_t re, int64_t im) {
+    uint32_t idx = fft->bitRev[n] * HWA_FFT_REF_BATCH + lane;
+
+    fft->workRe[idx] = HwaFftRef_sat(re, fft->datapathBits);
+    fft->workIm[idx] = HwaFftRef_sat(im, fft->datapathBits);
+}
+
+/**
+ * @brief Computes the FFTs of all lanes of the batch in place.
+ */
+void HwaFftRef_run(HwaFftRef *fft);
+
+/**
+ * @brief Real part of bin k of one lane after HwaFftRef_run().
+ */
+static inline int32_t HwaFftRef_re(const HwaFftRef *fft, uint32_t lane, uint32_t k) {
+    return fft->workRe[k * HWA_FFT_REF_BATCH + lane];
+}
+
+/**
+ * @brief Imaginary part of bin k of one lane after HwaFftRef_run().
+ */
+static inline int32_t HwaFftRef_im(const HwaFftRef *fft, uint32_t lane, uint32_t k) {
+    return fft->workIm[k * HWA_FFT_REF_BATCH + lane];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HWA_FFT_REF_H */
@@ -0,0 +1,236 @@
+/**
+ * @file micro_doppler_bench.c
+ * @brief Host accuracy check and benchmark of the micro-Doppler stage (micro_doppler.c).
+ *
+ * Generates a sequence of radar cubes with a walking target: a torso at a
+ * constant Doppler bin and a limb whose Doppler swings sinusoidally around it
+ * over the frames, both spread over the range gate, plus complex Gaussian
+ * noise. Every frame is run through MicroDoppler_process():
+ *
+ * - reference: a double precision implementation of the same estimator has to
+ *   agree with the fixed-point one (centroid and bandwidth within
+ *   MAX_REF_DIFF_Q8, energy within MAX_REF_DIFF_DB_Q8, spectrogram bytes within
+ *   one step),
+ * - features: the mean of the centroids has to match the Doppler of the torso
+ *   (the limb swings around it), the centroid spread reflects the swing. The
+ *   noise floor pulls the centroid towards zero at low SNR,
+ * - run time per frame.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/micro_doppler_bench.c \
+ *     minimal_rangeproc_impl/src/micro_doppler.c minimal_rangeproc_impl/src/fixed_math.c -lm -o micro_doppler_bench
+ * ./micro_doppler_bench [num Doppler chirps] [FFT size] [num frames] [SNR per sample in dB]
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "micro_doppler.h"
+#include "proc_config.h"
+
+#define NUM_ANTENNAS        (6U)
+#define NUM_RANGE_BINS      (64U)
+#define TARGET_RANGE_BIN    (20U)
+#define NOISE_SIGMA         (30.0)      // per real and imaginary part
+#define TORSO_DOPPLER       (0.1)       // cycles per chirp (Doppler bin / numDopplerChirps)
+#define LIMB_SWING          (0.125)     // amplitude of the limb swing around the torso, cycles per chirp
+#define LIMB_PERIOD_FRAMES  (10.0)
+#define LIMB_REL_AMP        (0.5)       // limb amplitude relative to the torso
+#define MAX_REF_DIFF_Q8     (8)         // 1/32 bin
+#define MAX_REF_DIFF_DB_Q8  (26)        // 0.1 dB
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gauss(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t toSample(double v) {
+    return (int16_t) ((v > 32767.0) ? 32767 : ((v < -32768.0) ? -32768 : lround(v)));
+}
+
+/* torso and limb in the gate around TARGET_RANGE_BIN (Doppler in cycles per chirp) */
+static void genCube(RadarCube_View *cube, double amp, double limbDoppler) {
+    const double doppler[2] = {TORSO_DOPPLER, limbDoppler};
+    const double amps[2]    = {amp, LIMB_REL_AMP * amp};
+    double       phase0[2];
+    uint32_t     c, a, r, t;
+
+    phase0[0] = 2.0 * M_PI * uniform();
+    phase0[1] = 2.0 * M_PI * uniform();
+    for (c = 0; c < cube->numChirps; c++) {
+        for (a = 0; a < cube->numAntennas; a++) {
+            for (r = 0; r < cube->numRangeBins; r++) {
+                cmplx16ImRe_t *s  = RadarCube_at(cube, c, a, r);
+                double         re = NOISE_SIGMA * gauss(), im = NOISE_SIGMA * gauss();
+
+                if ((r + 1U >= TARGET_RANGE_BIN) && (r <= TARGET_RANGE_BIN + 1U)) {
+                    double scale = (r == TARGET_RANGE_BIN) ? 1.0 : 0.5;
+                    for (t = 0; t < 2U; t++) {
+                        double phi = phase0[t] + 0.7 * a + 2.0 * M_PI * doppler[t] * c;
+                        re += scale * amps[t] * cos(phi);
+                        im += scale * amps[t] * sin(phi);
+                    }
+                }
+                s->real = toSample(re);
+                s->imag = toSample(im);
+            }
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * double precision reference of the same estimator
+ * --------------------------------------------------------------------------- */
+
+static void refProcess(const MicroDoppler_Config *cfg, const RadarCube_View *cube, uint32_t firstBin,
+                       double *power, double *centroid, double *bandwidth, double *energyDb) {
+    const uint32_t N = cfg->fftSize;
+    double         total = 0.0, sumK = 0.0, sumVar = 0.0;
+    uint32_t       bin, a, c, k;
+
+    memset(power, 0, N * sizeof(double));
+    for (bin = firstBin; bin < firstBin + cfg->gateLen; bin++) {
+        for (a = 0; a < cfg->numVirtualAntennas; a++) {
+            for (k = 0; k < N; k++) {
+                double re = 0.0, im = 0.0;
+                for (c = 0; c < cfg->numDopplerChirps; c++) {
+                    const cmplx16ImRe_t *s   = RadarCube_at(cube, c, a, bin);
+                    double               w   = 0.5 - 0.5 * cos(2.0 * M_PI * (c + 1U) / (cfg->numDopplerChirps + 1U));
+                    double               phi = -2.0 * M_PI * k * c / N;
+                    re += w * (s->real * cos(phi) - s->imag * sin(phi));
+                    im += w * (s->real * sin(phi) + s->imag * cos(phi));
+                }
+                power[(k + N / 2U) % N] += re * re + im * im;
+            }
+        }
+    }
+    for (k = 0; k < N; k++) {
+        total += power[k];
+        sumK  += ((double) k - N / 2U) * power[k];
+    }
+    *centroid = (total > 0.0) ? sumK / total : 0.0;
+    for (k = 0; k < N; k++) {
+        double d = (double) k - N / 2U - *centroid;
+        sumVar += d * d * power[k];
+    }
+    *bandwidth = (total > 0.0) ? sqrt(sumVar / total) : 0.0;
+    *energyDb  = (total > 0.0) ? 10.0 * log10(total) : 0.0;
+}
+
+/* ---------------------------------------------------------------------------
+ * benchmark
+ * --------------------------------------------------------------------------- */
+
+int main(int argc, char **argv) {
+    uint32_t              numChirps = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 32U;
+    uint32_t              fftSize   = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 2U * numChirps;
+    uint32_t              numFrames = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : 200U;
+    double                snrDb     = (argc > 4) ? strtod(argv[4], NULL) : 20.0;
+    double                amp       = NOISE_SIGMA * sqrt(2.0) * pow(10.0, snrDb / 20.0);
+    double                sumCentroid = 0.0, sumSqCentroid = 0.0, time = 0.0;
+    double                maxDiffCentroid = 0.0, maxDiffBandwidth = 0.0, maxDiffEnergy = 0.0;
+    double                refPower[MICRO_DOPPLER_MAX_FFT_SIZE];
+    cmplx16ImRe_t        *cubeData;
+    RadarCube_View        cube;
+    MicroDoppler_Config   cfg;
+    MicroDoppler_Features f;
+    static MicroDoppler_Obj obj;
+    uint32_t              i, k, maxDiffColumn = 0U;
+    int                   failed = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.numDopplerChirps   = numChirps;
+    cfg.numVirtualAntennas = NUM_ANTENNAS;
+    cfg.numRangeBins       = NUM_RANGE_BINS;
+    cfg.fftSize            = fftSize;
+    cfg.gateLen            = APP_UDOP_GATE_LEN;
+    cfg.windowLen          = APP_UDOP_WINDOW_LEN;
+    cfg.envelopeDb         = APP_UDOP_ENVELOPE_DB;
+    if ((numFrames == 0U) || (MicroDoppler_init(&obj, &cfg) != MICRO_DOPPLER_SUCCESS)) {
+        fprintf(stderr, "usage: %s [num Doppler chirps 1..%u] [FFT size, power of two up to %u] [num frames] "
+                "[SNR per sample in dB]\n", argv[0], MICRO_DOPPLER_MAX_CHIRPS, MICRO_DOPPLER_MAX_FFT_SIZE);
+        return 1;
+    }
+    cubeData = (cmplx16ImRe_t *) malloc(numChirps * NUM_ANTENNAS * NUM_RANGE_BINS * sizeof(cmplx16ImRe_t));
+    if (cubeData == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    RadarCube_initView(&cube, cubeData, numChirps, NUM_ANTENNAS, NUM_RANGE_BINS);
+
+    printf("%u chirps, FFT %u, gate %u bins, window %u frames, SNR %.1f dB per sample, %u frames\n", numChirps,
+           fftSize, cfg.gateLen, cfg.windowLen, snrDb, numFrames);
+
+    for (i = 0; i < numFrames; i++) {
+        double         limbDoppler = TORSO_DOPPLER + LIMB_SWING * sin(2.0 * M_PI * i / LIMB_PERIOD_FRAMES);
+        double         refCentroid, refBandwidth, refEnergy, d, t0;
+        const uint8_t *column;
+
+        genCube(&cube, amp, limbDoppler);
+        t0 = (double) clock();
+        if (MicroDoppler_process(&obj, &cube, TARGET_RANGE_BIN, &f) != MICRO_DOPPLER_SUCCESS) {
+            printf("MicroDoppler_process failed\n");
+            return 1;
+        }
+        time += (double) clock() - t0;
+
+        refProcess(&cfg, &cube, f.rangeBin - cfg.gateLen / 2U, refPower, &refCentroid, &refBandwidth, &refEnergy);
+        d               = fabs(f.centroidQ8 - refCentroid * 256.0);
+        maxDiffCentroid = (d > maxDiffCentroid) ? d : maxDiffCentroid;
+        d                = fabs(f.bandwidthQ8 - refBandwidth * 256.0);
+        maxDiffBandwidth = (d > maxDiffBandwidth) ? d : maxDiffBandwidth;
+        d             = fabs(f.energyDbQ8 - refEnergy * 256.0);
+        maxDiffEnergy = (d > maxDiffEnergy) ? d : maxDiffEnergy;
+
+        column = MicroDoppler_latestColumn(&obj);
+        for (k = 0; k < fftSize; k++) {
+            double   db  = (refPower[k] >= 1.0) ? 20.0 * log10(refPower[k]) : 0.0;
+            uint32_t ref = (db > 255.0) ? 255U : (uint32_t) db;
+            uint32_t dc  = (column[k] > ref) ? column[k] - ref : ref - column[k];
+            maxDiffColumn = (dc > maxDiffColumn) ? dc : maxDiffColumn;
+        }
+
+        sumCentroid   += f.centroidQ8 / 256.0;
+        sumSqCentroid += (f.centroidQ8 / 256.0) * (f.centroidQ8 / 256.0);
+        if (i == numFrames - 1U) {
+            printf("last frame: centroid %.2f bandwidth %.2f envelope %.2f..%.2f energy %.1f dB, "
+                   "window of %u: mean centroid %.2f spread %.2f (bins of the %u point FFT)\n",
+                   f.centroidQ8 / 256.0, f.bandwidthQ8 / 256.0, f.envelopeLowQ8 / 256.0, f.envelopeHighQ8 / 256.0,
+                   f.energyDbQ8 / 256.0, f.numFrames, f.meanCentroidQ8 / 256.0, f.centroidSpreadQ8 / 256.0, fftSize);
+        }
+    }
+
+    {
+        /* the limb swings around the torso */
+        double expected = TORSO_DOPPLER * fftSize;
+        double mean     = sumCentroid / numFrames;
+        double spread   = sqrt(fmax(sumSqCentroid / numFrames - mean * mean, 0.0));
+
+        printf("centroid over all frames: mean %.2f (expected %.2f) spread %.2f bins\n", mean, expected, spread);
+        failed |= (fabs(mean - expected) > 0.25 * fftSize / numChirps) ? 1 : 0;
+        failed |= (spread < 0.1 * LIMB_SWING * fftSize) ? 1 : 0;
+    }
+    printf("fixed point vs double: centroid %.1f bandwidth %.1f LSB Q8 (limit %d), energy %.1f LSB Q8 (limit %d), "
+           "spectrogram %u steps (limit 1)\n", maxDiffCentroid, maxDiffBandwidth, MAX_REF_DIFF_Q8, maxDiffEnergy,
+           MAX_REF_DIFF_DB_Q8, maxDiffColumn);
+    failed |= ((maxDiffCentroid > MAX_REF_DIFF_Q8) || (maxDiffBandwidth > MAX_REF_DIFF_Q8) ||
+               (maxDiffEnergy > MAX_REF_DIFF_DB_Q8) || (maxDiffColumn > 1U)) ? 1 : 0;
+    printf("%.2f us per frame\n", time / CLOCKS_PER_SEC / numFrames * 1e6);
+
+    free(cubeData);
+    return failed;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file peak_picker_bench.c
+ * @brief Host reference check and benchmark of the range peak picker (peak_picker.c).
+ *
+ * Generates range profiles of a few targets at random fractional range bins
+ * (windowed complex tones, DFT in double precision, complex Gaussian noise,
+ * quantized to 16 bits) and runs PeakPicker_process() on them:
+ *
+ * - reference: a plain double precision implementation (powers of all bins,
+ *   local maxima sorted with qsort, same interpolation formulas) has to report
+ *   the same bins; offset, magnitude and phase may differ by the fixed point
+ *   rounding only,
+ * - accuracy: RMS error of the interpolated range of every target for each
+ *   interpolation, with a rectangular and a Blackman range window,
+ * - run time per profile and payload size against the full profile.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/peak_picker_bench.c \
+ *     minimal_rangeproc_impl/src/peak_picker.c minimal_rangeproc_impl/src/fixed_math.c -lm -o peak_picker_bench
+ * ./peak_picker_bench [num range bins] [num profiles] [num peaks] [SNR in dB]
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "frame_protocol.h"
+#include "peak_picker.h"
+
+#define NUM_TARGETS         (3U)
+#define MIN_SEPARATION      (8.0)       // bins between targets
+#define NOISE_SIGMA         (4.0)       // per real and imaginary part, after the DFT
+#define MAX_RANGE_BINS      (1024U)
+
+/*
+ * tolerances against the double reference: fixed point rounding of sqrt, log2
+ * and atan2. The interpolated values (magnitude or log2 power) are rounded to
+ * 1/256, which moves the offset by up to 3/256 / curvature of the parabola.
+ */
+#define TOL_OFFSET_Q15      (64)
+#define TOL_LOG2_MAG_Q8     (2)
+#define TOL_PHASE_Q15       (16)
+
+typedef struct RefPeak_t
+{
+    uint32_t bin;
+    double   power;
+} RefPeak;
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gauss(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t toSample(double v) {
+    return (int16_t) ((v > 32767.0) ? 32767 : ((v < -32768.0) ? -32768 : lround(v)));
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* one target at a random position in each of NUM_TARGETS equal segments (4 bins margin at both ends), at least
+ * MIN_SEPARATION bins apart, amplitude snrDb..snrDb + 6 dB above the noise */
+static void genTargets(uint32_t numBins, double snrDb, double *pos, double *amp, double *phase) {
+    double   segment = (numBins - 8.0) / NUM_TARGETS;
+    uint32_t t;
+
+    for (t = 0; t < NUM_TARGETS; t++) {
+        pos[t]   = 4.0 + t * segment + 0.5 * MIN_SEPARATION + uniform() * (segment - MIN_SEPARATION);
+        amp[t]   = NOISE_SIGMA * pow(10.0, (snrDb + 6.0 * uniform()) / 20.0);
+        phase[t] = 2.0 * M_PI * uniform();
+    }
+}
+
+/* range FFT (DFT) of numBins windowed samples of the targets plus noise */
+static void genProfile(cmplx16ImRe_t *profile, uint32_t numBins, uint32_t blackman, const double *pos,
+                       const double *amp, const double *phase) {
+    static double re[MAX_RANGE_BINS], im[MAX_RANGE_BINS], twRe[MAX_RANGE_BINS], twIm[MAX_RANGE_BINS];
+    double        gain = 0.0;
+    uint32_t      n, k, t;
+
+    for (n = 0; n < numBins; n++) {
+        twRe[n] = cos(2.0 * M_PI * n / numBins);
+        twIm[n] = -sin(2.0 * M_PI * n / numBins);
+    }
+
+    for (n = 0; n < numBins; n++) {
+        double w = 1.0, x = 2.0 * M_PI * n / numBins;
+
+        if (blackman != 0U) {
+            w = 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+        }
+        gain += w;
+        re[n] = 0.0;
+        im[n] = 0.0;
+        for (t = 0; t < NUM_TARGETS; t++) {
+            re[n] += amp[t] * w * cos(2.0 * M_PI * pos[t] * n / numBins + phase[t]);
+            im[n] += amp[t] * w * sin(2.0 * M_PI * pos[t] * n / numBins + phase[t]);
+        }
+    }
+    for (k = 0; k < numBins; k++) {
+        double sumRe = 0.0, sumIm = 0.0;
+
+        for (n = 0; n < numBins; n++) {
+            double c = twRe[(k * n) % numBins], s = twIm[(k * n) % numBins];
+            sumRe += re[n] * c - im[n] * s;
+            sumIm += re[n] * s + im[n] * c;
+        }
+        /* normalized by the window gain: target t peaks at amp[t] */
+        profile[k].real = toSample(sumRe / gain + NOISE_SIGMA * gauss());
+        profile[k].imag = toSample(sumIm / gain + NOISE_SIGMA * gauss());
+    }
+}
+
+static double refPower(const cmplx16ImRe_t *profile, uint32_t k) {
+    return (double) profile[k].real * profile[k].real + (double) profile[k].imag * profile[k].imag;
+}
+
+static int cmpRefPeak(const void *a, const void *b) {
+    const RefPeak *pa = (const RefPeak *) a, *pb = (const RefPeak *) b;
+
+    if (pa->power != pb->power) {
+        return (pa->power < pb->power) ? 1 : -1;
+    }
+    return (pa->bin > pb->bin) ? 1 : -1;
+}
+
+/* plain reference: all local maxima, qsort, interpolation in double precision; returns the number of peaks */
+static uint32_t refProcess(const PeakPicker_Config *cfg, const cmplx16ImRe_t *profile, double *offset,
+                           double *curvature, double *log2Mag, double *phase, uint32_t *bin) {
+    static RefPeak cand[MAX_RANGE_BINS];
+    uint32_t       numCand = 0U, k, n;
+
+    for (k = (cfg->firstBin > 1U) ? cfg->firstBin : 1U; k + 1U < cfg->numRangeBins; k++) {
+        double p = refPower(profile, k);
+        if ((p > refPower(profile, k - 1U)) && (p >= refPower(profile, k + 1U)) && (p >= cfg->minPower)) {
+            cand[numCand].bin   = k;
+            cand[numCand].power = p;
+            numCand++;
+        }
+    }
+    qsort(cand, numCand, sizeof(RefPeak), cmpRefPeak);
+    numCand = (numCand > cfg->maxPeaks) ? cfg->maxPeaks : numCand;
+    for (n = 0; n < numCand; n++) {
+        double a = refPower(profile, cand[n].bin - 1U), b = cand[n].power, c = refPower(profile, cand[n].bin + 1U);
+        double la = log2((a > 0.0) ? a : 1.0), lb = log2(b), lc = log2((c > 0.0) ? c : 1.0), d = 0.0;
+
+        if (cfg->interp == PEAK_PICKER_INTERP_PARABOLIC) {
+            a = sqrt(a);
+            b = sqrt(b);
+            c = sqrt(c);
+        } else {
+            a = la;
+            b = lb;
+            c = lc;
+        }
+        if ((cfg->interp != PEAK_PICKER_INTERP_NONE) && (a - 2.0 * b + c < 0.0)) {
+            d = 0.5 * (a - c) / (a - 2.0 * b + c);
+            d = (d > 0.5) ? 0.5 : ((d < -0.5) ? -0.5 : d);
+        }
+        bin[n]       = cand[n].bin;
+        offset[n]    = d;
+        curvature[n] = fabs(a - 2.0 * b + c);
+        log2Mag[n] = 0.5 * (lb - (la - lc) * d / 4.0);
+        phase[n]   = atan2(profile[cand[n].bin].imag, profile[cand[n].bin].real) / M_PI;
+    }
+    return numCand;
+}
+
+int main(int argc, char **argv) {
+    static const char *interpName[] = { "none", "parabolic", "gaussian" };
+    static const char *windowName[] = { "rectangular", "blackman" };
+    uint32_t           numBins     = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 64U;
+    uint32_t           numProfiles = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 2000U;
+    uint32_t           maxPeaks    = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : 8U;
+    double             snrDb       = (argc > 4) ? atof(argv[4]) : 30.0;
+    PeakPicker_Config  cfg;
+    PeakPicker_Peak    peaks[PEAK_PICKER_MAX_PEAKS];
+    PeakPicker_Result  result;
+    cmplx16ImRe_t     *profiles;
+    double            *pos, *amp, *phase;
+    uint32_t           mismatches = 0U, window, interp, i, t, n;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.numRangeBins = numBins;
+    cfg.maxPeaks     = maxPeaks;
+    cfg.firstBin     = 1U;
+    if ((numBins > MAX_RANGE_BINS) || (numBins < 8U + NUM_TARGETS * (uint32_t) MIN_SEPARATION) || (numProfiles == 0U) ||
+        (PeakPicker_checkConfig(&cfg) != PEAK_PICKER_SUCCESS)) {
+        fprintf(stderr, "usage: %s [num range bins %u..%u] [num profiles] [num peaks 1..%u] [SNR in dB]\n", argv[0],
+                8U + NUM_TARGETS * (uint32_t) MIN_SEPARATION, MAX_RANGE_BINS, PEAK_PICKER_MAX_PEAKS);
+        return 1;
+    }
+    profiles = (cmplx16ImRe_t *) malloc(numProfiles * numBins * sizeof(cmplx16ImRe_t));
+    pos      = (double *) malloc(numProfiles * NUM_TARGETS * sizeof(double));
+    amp      = (double *) malloc(numProfiles * NUM_TARGETS * sizeof(double));
+    phase    = (double *) malloc(numProfiles * NUM_TARGETS * sizeof(double));
+    if ((profiles == NULL) || (pos == NULL) || (amp == NULL) || (phase == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    printf("%u range bins, %u profiles, %u targets at %.0f..%.0f dB SNR, %u peaks\n", numBins, numProfiles,
+           NUM_TARGETS, snrDb, snrDb + 6.0, maxPeaks);
+
+    for (window = 0; window < 2U; window++) {
+        for (i = 0; i < numProfiles; i++) {
+            genTargets(numBins, snrDb, &pos[i * NUM_TARGETS], &amp[i * NUM_TARGETS], &phase[i * NUM_TARGETS]);
+            genProfile(&profiles[i * numBins], numBins, window, &pos[i * NUM_TARGETS], &amp[i * NUM_TARGETS],
+                       &phase[i * NUM_TARGETS]);
+        }
+        printf("%s window:\n", windowName[window]);
+
+        for (interp = PEAK_PICKER_INTERP_NONE; interp <= PEAK_PICKER_INTERP_GAUSSIAN; interp++) {
+            double   sumSqErr = 0.0, t0, time;
+            uint32_t numFound = 0U, numMismatches = 0U;
+
+            cfg.interp = (PeakPicker_Interp) interp;
+
+            /* reference and accuracy */
+            for (i = 0; i < numProfiles; i++) {
+                const cmplx16ImRe_t *profile = &profiles[i * numBins];
+                double               refOffset[PEAK_PICKER_MAX_PEAKS], refLog2Mag[PEAK_PICKER_MAX_PEAKS];
+                double               refPhase[PEAK_PICKER_MAX_PEAKS], refCurvature[PEAK_PICKER_MAX_PEAKS];
+                uint32_t             refBin[PEAK_PICKER_MAX_PEAKS], refNum;
+
+                PeakPicker_process(&cfg, profile, peaks, &result);
+                refNum = refProcess(&cfg, profile, refOffset, refCurvature, refLog2Mag, refPhase, refBin);
+                if (refNum != result.numPeaks) {
+                    numMismatches++;
+                    continue;
+                }
+                for (n = 0; n < refNum; n++) {
+                    int32_t dPhase = (int32_t) lround(refPhase[n] * 32768.0) - peaks[n].phaseQ15;
+                    double  tolOffset = TOL_OFFSET_Q15 + 32768.0 * 3.0 / 256.0 / refCurvature[n];
+
+                    dPhase = (dPhase > 32768) ? dPhase - 65536 : ((dPhase < -32768) ? dPhase + 65536 : dPhase);
+                    if ((peaks[n].rangeBin != refBin[n]) ||
+                        (fabs(refOffset[n] * 32768.0 - peaks[n].offsetQ15) > tolOffset) ||
+                        (abs((int32_t) lround(refLog2Mag[n] * 256.0) - peaks[n].log2MagQ8) > TOL_LOG2_MAG_Q8) ||
+                        (abs(dPhase) > TOL_PHASE_Q15)) {
+                        numMismatches++;
+                        break;
+                    }
+                }
+                /* every target should be among the peaks, take the one closest to it */
+                for (t = 0; t < NUM_TARGETS; t++) {
+                    double target = pos[i * NUM_TARGETS + t], best = 2.0;
+
+                    for (n = 0; n < result.numPeaks; n++) {
+                        double err = peaks[n].rangeBin + peaks[n].offsetQ15 / 32768.0 - target;
+                        best = (fabs(err) < fabs(best)) ? err : best;
+                    }
+                    if (fabs(best) < 1.0) {
+                        numFound++;
+                        sumSqErr += best * best;
+                    }
+                }
+            }
+
+            /* run time */
+            t0 = now();
+            for (i = 0; i < numProfiles; i++) {
+                PeakPicker_process(&cfg, &profiles[i * numBins], peaks, &result);
+            }
+            time = (now() - t0) / numProfiles;
+
+            printf("  %-9s  targets found %5.1f%%  RMS range error %.4f bins  %s  %.2f us/profile\n",
+                   interpName[interp], 100.0 * numFound / (numProfiles * NUM_TARGETS),
+                   (numFound != 0U) ? sqrt(sumSqErr / numFound) : 0.0,
+                   (numMismatches == 0U) ? "matches reference" : "REFERENCE MISMATCH", time * 1e6);
+            mismatches += numMismatches;
+        }
+    }
+
+    printf("payload: %u peaks %u B, full profile %u B\n", maxPeaks,
+           (uint32_t) (FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_PeakList) + maxPeaks * sizeof(FrameProto_Peak))),
+           (uint32_t) (FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_RangeProfile) + numBins * sizeof(cmplx16ImRe_t))));
+    printf("%u reference mismatches\n", mismatches);
+
+    free(profiles);
+    free(pos);
+    free(amp);
+    free(phase);
+    return (mismatches != 0U) ? 1 : 0;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file proc_ref_tool.cpp
+ * @brief Runs the host reference models of the processing chain on raw ADC data.
+ *
+ * Stages: range processing (rangeproc_ref.h) into the radar cube, Doppler
+ * processing (dopplerproc_ref.h) into the range-Doppler heat map. The
+ * dimensions are taken from defines.h (-d) and the range FFT zero-padding of
+ * proc_config.h next to it, the MIMO scheme from CLI_MIMO_SEL unless
+ * overridden with -m, the remaining options default to proc_config.h. The
+ * range window is a table of range_window.h (-r, Blackman as APP_RANGE_WINDOW
+ * by default), which has to be generated for the same number of ADC samples.
+ * With hardware chirp accumulation (CLI_NUM_CHIRPS_ACCUM > 1) the capture holds
+ * the accumulated chirps and the window is scaled down by their growth as with
+ * the default APP_CHIRP_ACCUM_WINDOW_SHIFT.
+ *
+ * - bench:   processes synthetic frames with the scalar and the SIMD path,
+ *            checks that both produce the same outputs and reports the time per
+ *            stage. This is the baseline for the host models of later stages.
+ * - process, heatmap: processes a raw ADC capture (frames of int16
+ *            [chirp][rx][sample]) into radar cubes (frames of cmplx16ImRe_t
+ *            [chirp][antenna][range]) or heat maps (frames of uint16 [range][doppler]).
+ * - compare, compare-heatmap: processes a raw ADC capture and compares the
+ *            result with the outputs dumped from the device (golden vectors),
+ *            exit code 1 on mismatch.
+ *
+ * Build and run from the repository root:
+ * @code
+ * g++ -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/proc_ref_tool.cpp \
+ *     -x c host/hwa_fft_ref.c host/rangeproc_ref.c host/dopplerproc_ref.c -lm -o proc_ref_tool
+ * ./proc_ref_tool bench 200
+ * ./proc_ref_tool -d minimal_rangeproc_impl/include/defines.h process adc.bin cube.bin
+ * ./proc_ref_tool compare adc.bin golden_cube.bin
+ * ./proc_ref_tool -w hanning heatmap adc.bin heatmap.bin
+ * ./proc_ref_tool -r kaiser process adc.bin cube.bin
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <unistd.h>
+
+#include "dopplerproc_ref.h"
+#include "range_window.h"
+#include "rangeproc_ref.h"
+#include "recording.hpp"
+
+namespace {
+
+constexpr const char *kDefaultDefines = "minimal_rangeproc_impl/include/defines.h";
+
+/* CLI_MIMO_SEL is not part of Recording_Config */
+uint32_t readMimoSel(const char *path) {
+    FILE    *f = std::fopen(path, "r");
+    char     line[512];
+    unsigned value = 1U;
+
+    if (f == nullptr) {
+        return value;
+    }
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        if (std::sscanf(line, " #define CLI_MIMO_SEL %u", &value) == 1) {
+            break;
+        }
+    }
+    std::fclose(f);
+    return value;
+}
+
+enum class Stage { Range, Doppler };
+
+/* the processing chain up to the selected stage */
+struct Model {
+    RangeProcRef               range;
+    DopplerProcRef             doppler;
+    std::vector<cmplx16ImRe_t> cubeData;
+    std::vector<uint16_t>      heatmap;
+    RadarCube_View             cube;
+    size_t                     adcSamplesPerFrame;
+
+    Model(const RangeProcRef_Config &rangeCfg, const DopplerProcRef_Config &dopplerCfg) : range(), doppler(), cube() {
+        if ((RangeProcRef_init(&range, &rangeCfg) != RANGEPROC_REF_SUCCESS) ||
+            (DopplerProcRef_init(&doppler, &dopplerCfg) != DOPPLERPROC_REF_SUCCESS)) {
+            std::fprintf(stderr, "invalid configuration\n");
+            std::exit(2);
+        }
+        cubeData.resize(static_cast<size_t>(dopplerCfg.numDopplerChirps) * dopplerCfg.numVirtualAntennas *
+                        dopplerCfg.numRangeBins);
+        heatmap.resize(static_cast<size_t>(dopplerCfg.numRangeBins) * dopplerCfg.fftSize);
+        RadarCube_initView(&cube, cubeData.data(), dopplerCfg.numDopplerChirps, dopplerCfg.numVirtualAntennas,
+                           dopplerCfg.numRangeBins);
+        adcSamplesPerFrame = static_cast<size_t>(rangeCfg.numChirpsPerFrame) * rangeCfg.numRxAntennas *
+                             rangeCfg.numAdcSamples;
+    }
+    ~Model() {
+        RangeProcRef_deinit(&range);
+        DopplerProcRef_deinit(&doppler);
+    }
+
+    void process(const int16_t *adc, Stage last) {
+        RangeProcRef_processFrame(&range, adc, &cube);
+        if (last == Stage::Doppler) {
+            DopplerProcRef_process(&doppler, &cube, heatmap.data());
+        }
+    }
+    void setPath(HwaFftRef_Path path) {
+        HwaFftRef_setPath(&range.fft, path);
+        HwaFftRef_setPath(&doppler.fft, path);
+    }
+    /* output of a stage as 16-bit words */
+    const uint16_t *output(Stage stage) const {
+        return (stage == Stage::Range) ? reinterpret_cast<const uint16_t *>(cubeData.data()) : heatmap.data();
+    }
+    size_t outputWords(Stage stage) const {
+        return (stage == Stage::Range) ? cubeData.size() * 2U : heatmap.size();
+    }
+};
+
+/* a few targets per chirp with phase progression over the chirps, plus noise */
+void synthesize(const RangeProcRef_Config &cfg, uint32_t seed, std::vector<int16_t> &adc) {
+    std::mt19937                     rng(seed);
+    std::normal_distribution<double> noise(0.0, 20.0);
+    const double                     bins[3] = {10.3, 25.0, 47.6};
+    const double                     amps[3] = {4000.0, 1500.0, 600.0};
+    size_t                           i = 0;
+
+    for (uint32_t c = 0; c < cfg.numChirpsPerFrame; c++) {
+        for (uint32_t rx = 0; rx < cfg.numRxAntennas; rx++) {
+            for (uint32_t n = 0; n < cfg.numAdcSamples; n++) {
+                double v = noise(rng);
+                for (int t = 0; t < 3; t++) {
+                    v += amps[t] * std::cos(2.0 * M_PI * bins[t] * n / cfg.fftSize + 0.3 * c + 0.7 * rx * t);
+                }
+                adc[i++] = static_cast<int16_t>(std::lround(std::max(-32768.0, std::min(32767.0, v))));
+            }
+        }
+    }
+}
+
+int bench(const RangeProcRef_Config &rangeCfg, const DopplerProcRef_Config &dopplerCfg, uint32_t numFrames) {
+    constexpr uint32_t   kNumInputs = 8;
+    Model                scalar(rangeCfg, dopplerCfg), simd(rangeCfg, dopplerCfg);
+    std::vector<int16_t> adc(scalar.adcSamplesPerFrame * kNumInputs);
+    size_t               numMismatches = 0;
+
+    for (uint32_t k = 0; k < kNumInputs; k++) {
+        std::vector<int16_t> frame(scalar.adcSamplesPerFrame);
+        synthesize(rangeCfg, k, frame);
+        std::memcpy(&adc[k * scalar.adcSamplesPerFrame], frame.data(), frame.size() * sizeof(int16_t));
+    }
+    scalar.setPath(HWA_FFT_REF_PATH_SCALAR);
+
+    std::printf("%u samples, fft %u, %u bins, %u rx, %u tx, %u chirps, %s, doppler fft %u\n", rangeCfg.numAdcSamples,
+                rangeCfg.fftSize, rangeCfg.numRangeBins, rangeCfg.numRxAntennas, rangeCfg.numTxAntennas,
+                rangeCfg.numChirpsPerFrame, rangeCfg.isBpmEnabled ? "BPM" : "TDM", dopplerCfg.fftSize);
+
+    for (uint32_t k = 0; k < kNumInputs; k++) {
+        scalar.process(&adc[k * scalar.adcSamplesPerFrame], Stage::Doppler);
+        simd.process(&adc[k * scalar.adcSamplesPerFrame], Stage::Doppler);
+        for (Stage stage : {Stage::Range, Stage::Doppler}) {
+            numMismatches += (std::memcmp(scalar.output(stage), simd.output(stage),
+                                          scalar.outputWords(stage) * sizeof(uint16_t)) != 0) ? 1 : 0;
+        }
+    }
+    std::printf("%s vs scalar: %s\n", HwaFftRef_pathName(simd.range.fft.path),
+                (numMismatches == 0) ? "bit-exact" : "MISMATCH");
+
+    for (Model *m : {&scalar, &simd}) {
+        double   t[2] = {0.0, 0.0};
+        for (uint32_t i = 0; i < numFrames; i++) {
+            auto t0 = std::chrono::steady_clock::now();
+            RangeProcRef_processFrame(&m->range, &adc[(i % kNumInputs) * m->adcSamplesPerFrame], &m->cube);
+            auto t1 = std::chrono::steady_clock::now();
+            DopplerProcRef_process(&m->doppler, &m->cube, m->heatmap.data());
+            auto t2 = std::chrono::steady_clock::now();
+            t[0] += std::chrono::duration<double>(t1 - t0).count();
+            t[1] += std::chrono::duration<double>(t2 - t1).count();
+        }
+        std::printf("%-7s range %8.1f frames/s %7.2f MSamples/s %6.1f us/frame, doppler %6.1f us/frame\n",
+                    HwaFftRef_pathName(m->range.fft.path), numFrames / t[0],
+                    numFrames * m->adcSamplesPerFrame / t[0] / 1e6, t[0] / numFrames * 1e6, t[1] / numFrames * 1e6);
+    }
+    return (numMismatches == 0) ? 0 : 1;
+}
+
+int processFile(const RangeProcRef_Config &rangeCfg, const DopplerProcRef_Config &dopplerCfg, Stage stage,
+                const char *adcPath, const char *outPath, bool compare) {
+    Model                 model(rangeCfg, dopplerCfg);
+    std::vector<int16_t>  adc(model.adcSamplesPerFrame);
+    std::vector<uint16_t> golden(model.outputWords(stage));
+    FILE                 *in  = std::fopen(adcPath, "rb");
+    FILE                 *out = std::fopen(outPath, compare ? "rb" : "wb");
+    uint32_t              numFrames = 0, numBadFrames = 0;
+    size_t                numBadSamples = 0;
+    int                   maxDiff = 0;
+
+    if ((in == nullptr) || (out == nullptr)) {
+        std::perror((in == nullptr) ? adcPath : outPath);
+        return 2;
+    }
+    while (std::fread(adc.data(), sizeof(int16_t), adc.size(), in) == adc.size()) {
+        const uint16_t *result = model.output(stage);
+
+        model.process(adc.data(), stage);
+        if (!compare) {
+            std::fwrite(result, sizeof(uint16_t), golden.size(), out);
+        } else {
+            size_t bad = 0;
+            if (std::fread(golden.data(), sizeof(uint16_t), golden.size(), out) != golden.size()) {
+                break;
+            }
+            for (size_t i = 0; i < golden.size(); i++) {
+                /* cube samples are signed, heat map cells unsigned */
+                int d = (stage == Stage::Range) ? std::abs(static_cast<int16_t>(golden[i]) - static_cast<int16_t>(result[i]))
+                                                : std::abs(golden[i] - result[i]);
+                bad += (d != 0) ? 1 : 0;
+                maxDiff = std::max(maxDiff, d);
+            }
+            numBadFrames += (bad != 0) ? 1 : 0;
+            numBadSamples += bad;
+        }
+        numFrames++;
+    }
+    std::fclose(in);
+    std::fclose(out);
+
+    if (!compare) {
+        std::printf("%u frames -> %s (%zu bytes per frame)\n", numFrames, outPath, golden.size() * sizeof(uint16_t));
+        return 0;
+    }
+    std::printf("%u frames compared, %u differ, %zu values differ, max difference %d LSB\n", numFrames,
+                numBadFrames, numBadSamples, maxDiff);
+    return (numBadFrames == 0) ? 0 : 1;
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: proc_ref_tool [-d defines.h] [-m mimoSel] [-s rangeDivShift] [-w rect|hanning|blackman]\n"
+                 "                     [-S dopplerDivShift] [-r hann|hamming|blackman|blackman-harris|kaiser] <mode>\n"
+                 "  bench [frames]\n"
+                 "  process <adc.bin> <cube.bin>      radar cubes\n"
+                 "  heatmap <adc.bin> <heatmap.bin>   range-Doppler heat maps\n"
+                 "  compare <adc.bin> <cube.bin>      against radar cubes from the device\n"
+                 "  compare-heatmap <adc.bin> <heatmap.bin>\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char           *definesPath = kDefaultDefines;
+    long                  mimoSel     = -1, divShift = -1, dopplerDivShift = -1;
+    long                  window      = -1;
+    const uint32_t       *rangeWindow = nullptr;
+    bool                  rangeWindowSet = false;
+    Recording_Config      defs;
+    RangeProcRef_Config   rangeCfg;
+    DopplerProcRef_Config dopplerCfg;
+    int                   opt;
+
+    while ((opt = getopt(argc, argv, "d:m:s:w:S:r:")) != -1) {
+        switch (opt) {
+            case 'd': definesPath = optarg; break;
+            case 'm': mimoSel = std::strtol(optarg, nullptr, 0); break;
+            case 's': divShift = std::strtol(optarg, nullptr, 0); break;
+            case 'S': dopplerDivShift = std::strtol(optarg, nullptr, 0); break;
+            case 'w':
+                window = (std::strcmp(optarg, "rect") == 0)     ? HWA_FFT_REF_WIN_RECT
+                       : (std::strcmp(optarg, "hanning") == 0)  ? HWA_FFT_REF_WIN_HANNING
+                       : (std::strcmp(optarg, "blackman") == 0) ? HWA_FFT_REF_WIN_BLACKMAN : -1;
+                if (window < 0) {
+                    usage();
+                    return 2;
+                }
+                break;
+            case 'r':
+                rangeWindow = (std::strcmp(optarg, "hann") == 0)            ? gRangeWindowHann
+                            : (std::strcmp(optarg, "hamming") == 0)         ? gRangeWindowHamming
+                            : (std::strcmp(optarg, "blackman") == 0)        ? gRangeWindowBlackman
+                            : (std::strcmp(optarg, "blackman-harris") == 0) ? gRangeWindowBlackmanHarris
+                            : (std::strcmp(optarg, "kaiser") == 0)          ? gRangeWindowKaiser : nullptr;
+                if (rangeWindow == nullptr) {
+                    usage();
+                    return 2;
+                }
+                rangeWindowSet = true;
+                break;
+            default: usage(); return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+    if (!radar::readDefines(definesPath, defs)) {
+        std::fprintf(stderr, "%s: cannot read the configuration\n", definesPath);
+        return 2;
+    }
+    RangeProcRef_defaultConfig(&rangeCfg, defs.numAdcSamples,
+                               static_cast<uint32_t>(__builtin_popcount(defs.rxChannelMask)),
+                               static_cast<uint32_t>(__builtin_popcount(defs.txChannelMask)),
+                               radar::numAdcChirps(defs),
+                               (mimoSel >= 0) ? static_cast<uint32_t>(mimoSel) : readMimoSel(definesPath));
+    /* zero-padded range FFT (APP_RANGE_FFT_ZERO_PAD), the ADC samples are loaded into the first inputs */
+    rangeCfg.numRangeBins = defs.numRangeBins;
+    rangeCfg.fftSize      = 2U * defs.numRangeBins;
+    /* range window from flash as on the device (APP_RANGE_WINDOW), only if the tables fit the configuration */
+    if (defs.numAdcSamples == RANGE_WINDOW_NUM_SAMPLES) {
+        rangeCfg.windowTable = rangeWindowSet ? rangeWindow : gRangeWindowBlackman;
+    } else if (rangeWindowSet) {
+        std::fprintf(stderr, "range_window.h was generated for %u ADC samples, not %u\n", RANGE_WINDOW_NUM_SAMPLES,
+                     defs.numAdcSamples);
+        return 2;
+    }
+    /* accumulated samples grow by ceil(log2(numChirpsAccum)) bits, the firmware scales the window down by them */
+    while ((defs.numChirpsAccum > 1U) && ((1U << rangeCfg.windowShift) < defs.numChirpsAccum)) {
+        rangeCfg.windowShift++;
+    }
+    if (divShift >= 0) {
+        rangeCfg.fftOutputDivShift = static_cast<uint32_t>(divShift);
+    }
+    DopplerProcRef_defaultConfig(&dopplerCfg, defs.numDopplerChirps, rangeCfg.numRangeBins, defs.numVirtualAntennas);
+    if (window >= 0) {
+        dopplerCfg.windowType = static_cast<HwaFftRef_Window>(window);
+    }
+    if (dopplerDivShift >= 0) {
+        dopplerCfg.fftOutputDivShift = static_cast<uint32_t>(dopplerDivShift);
+    }
+
+    const char *mode = argv[optind];
+    if (std::strcmp(mode, "bench") == 0) {
+        return bench(rangeCfg, dopplerCfg,
+                     (optind + 1 < argc) ? static_cast<uint32_t>(std::atoi(argv[optind + 1])) : 200U);
+    }
+    if (optind + 2 < argc) {
+        const char *in = argv[optind + 1], *out = argv[optind + 2];
+        if (std::strcmp(mode, "process") == 0)         { return processFile(rangeCfg, dopplerCfg, Stage::Range, in, out, false); }
+        if (std::strcmp(mode, "heatmap") == 0)         { return processFile(rangeCfg, dopplerCfg, Stage::Doppler, in, out, false); }
+        if (std::strcmp(mode, "compare") == 0)         { return processFile(rangeCfg, dopplerCfg, Stage::Range, in, out, true); }
+        if (std::strcmp(mode, "compare-heatmap") == 0) { return processFile(rangeCfg, dopplerCfg, Stage::Doppler, in, out, true); }
+    }
+    usage();
+    return 2;
+}
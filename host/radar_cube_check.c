@@ -0,0 +1,215 @@
+/**
+ * @file radar_cube_check.c
+ * @brief Host check of the radar cube view (radar_cube.h) against the DPIF_RADARCUBE_FORMAT_6 layout.
+ *
+ * Every sample of a cube is tagged with its chirp, antenna and range bin, laid
+ * out as Cube[chirp][antenna][range] the way the Rangeproc DPU writes it. For a
+ * set of cube dimensions (including single chirps, antennas and range bins):
+ *
+ * - index: RadarCube_index() and RadarCube_at() against the plain formula,
+ *   numSamples and the chirp and antenna strides,
+ * - rangeOffset: RadarCube_initView() starts at range bin 0, an offset leaves
+ *   all indices of the view relative to it,
+ * - slices: every sample of all range, antenna and chirp slices (count,
+ *   stride, RadarCube_sliceAt()) carries the expected tag,
+ * - copy: RadarCube_copySlice() of all slices gives the same samples and does
+ *   not write past count; the dimensions cover counts of 1 to 9, i.e. every
+ *   remainder of the 4x unrolled loop and the memcpy() path of range slices.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/radar_cube_check.c -o radar_cube_check
+ * ./radar_cube_check
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+/* guard samples behind the copy destination */
+#define NUM_GUARD           (4U)
+#define GUARD_VALUE         (0x5A5A)
+
+typedef struct Dims_t
+{
+    uint32_t numChirps;
+    uint32_t numAntennas;
+    uint32_t numRangeBins;
+} Dims;
+
+static const Dims gDims[] = {
+    { 1U, 1U, 1U },
+    { 2U, 3U, 5U },
+    { 3U, 2U, 7U },
+    { 4U, 6U, 64U },
+    { 5U, 4U, 9U },
+    { 6U, 5U, 3U },
+    { 7U, 7U, 8U },
+    { 8U, 1U, 2U },
+    { 9U, 8U, 6U },
+    { 16U, 12U, 33U }
+};
+
+static uint32_t gFailures = 0U;
+
+#define CHECK(cond, ...)                                        \
+    do {                                                        \
+        if (!(cond)) {                                          \
+            if (gFailures < 20U) {                              \
+                printf("  FAILED: " __VA_ARGS__);               \
+                printf("\n");                                   \
+            }                                                   \
+            gFailures++;                                        \
+        }                                                       \
+    } while (0)
+
+/* tag of a sample: chirp and antenna in the imaginary part (first in memory), range bin in the real part */
+static cmplx16ImRe_t tag(uint32_t chirp, uint32_t antenna, uint32_t rangeBin) {
+    cmplx16ImRe_t s;
+
+    s.imag = (int16_t) ((chirp << 8) | antenna);
+    s.real = (int16_t) rangeBin;
+    return s;
+}
+
+static int isTag(const cmplx16ImRe_t *s, uint32_t chirp, uint32_t antenna, uint32_t rangeBin) {
+    cmplx16ImRe_t t = tag(chirp, antenna, rangeBin);
+    return (s->imag == t.imag) && (s->real == t.real);
+}
+
+/* FORMAT_6 as written by the DPU, independent of radar_cube.h */
+static void fillCube(cmplx16ImRe_t *data, const Dims *d) {
+    uint32_t c, a, r;
+    size_t   n = 0;
+
+    for (c = 0; c < d->numChirps; c++) {
+        for (a = 0; a < d->numAntennas; a++) {
+            for (r = 0; r < d->numRangeBins; r++) {
+                data[n++] = tag(c, a, r);
+            }
+        }
+    }
+}
+
+static void checkIndex(const RadarCube_View *view) {
+    uint32_t c, a, r;
+
+    CHECK(RadarCube_numSamples(view) == view->numChirps * view->numAntennas * view->numRangeBins, "numSamples");
+    CHECK(RadarCube_antennaStride(view) == view->numRangeBins, "antennaStride");
+    CHECK(RadarCube_chirpStride(view) == view->numAntennas * view->numRangeBins, "chirpStride");
+    for (c = 0; c < view->numChirps; c++) {
+        for (a = 0; a < view->numAntennas; a++) {
+            CHECK(RadarCube_rangeProfile(view, c, a) == &view->data[(c * view->numAntennas + a) * view->numRangeBins],
+                  "rangeProfile(%u, %u)", c, a);
+            for (r = 0; r < view->numRangeBins; r++) {
+                CHECK(RadarCube_index(view, c, a, r) == (c * view->numAntennas + a) * view->numRangeBins + r,
+                      "index(%u, %u, %u)", c, a, r);
+                CHECK(isTag(RadarCube_at(view, c, a, r), c, a, r), "at(%u, %u, %u)", c, a, r);
+            }
+        }
+    }
+}
+
+static void checkRangeOffset(RadarCube_View *view) {
+    RadarCube_View offset = *view;
+    uint32_t       r;
+
+    CHECK(view->rangeOffset == 0U, "initView rangeOffset");
+    // the cube holds range bins [rangeOffset, rangeOffset + numRangeBins) of the FFT, indices stay relative
+    offset.rangeOffset = 17U;
+    for (r = 0; r < view->numRangeBins; r++) {
+        uint32_t c = view->numChirps - 1U, a = view->numAntennas - 1U;
+        CHECK(RadarCube_index(&offset, c, a, r) == RadarCube_index(view, c, a, r), "index with rangeOffset");
+        CHECK(RadarCube_at(&offset, c, a, r) == RadarCube_at(view, c, a, r), "at with rangeOffset");
+    }
+}
+
+/* checks the slice in place and its copy, expected tag of sample i from (c0, a0, r0) plus i times (dc, da, dr) */
+static void checkSlice(const RadarCube_Slice *slice, uint32_t count, uint32_t stride, uint32_t c0, uint32_t a0,
+                       uint32_t r0, uint32_t dc, uint32_t da, uint32_t dr, cmplx16ImRe_t *buf, const char *name) {
+    uint32_t i;
+
+    CHECK(slice->count == count, "%s count %u, expected %u", name, slice->count, count);
+    CHECK(slice->stride == stride, "%s stride %u, expected %u", name, slice->stride, stride);
+    if ((slice->count != count) || (slice->stride != stride)) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        CHECK(isTag(RadarCube_sliceAt(slice, i), c0 + i * dc, a0 + i * da, r0 + i * dr), "%s sliceAt(%u)", name, i);
+    }
+
+    for (i = 0; i < count + NUM_GUARD; i++) {
+        buf[i].imag = GUARD_VALUE;
+        buf[i].real = GUARD_VALUE;
+    }
+    RadarCube_copySlice(slice, buf);
+    for (i = 0; i < count; i++) {
+        CHECK(isTag(&buf[i], c0 + i * dc, a0 + i * da, r0 + i * dr), "%s copySlice(%u) of %u", name, i, count);
+    }
+    for (; i < count + NUM_GUARD; i++) {
+        CHECK((buf[i].imag == GUARD_VALUE) && (buf[i].real == GUARD_VALUE), "%s copySlice wrote past %u", name, count);
+    }
+}
+
+static void checkSlices(const RadarCube_View *view, cmplx16ImRe_t *buf) {
+    RadarCube_Slice slice;
+    uint32_t        c, a, r;
+
+    for (c = 0; c < view->numChirps; c++) {
+        for (a = 0; a < view->numAntennas; a++) {
+            slice = RadarCube_rangeSlice(view, c, a);
+            checkSlice(&slice, view->numRangeBins, 1U, c, a, 0U, 0U, 0U, 1U, buf, "rangeSlice");
+        }
+        for (r = 0; r < view->numRangeBins; r++) {
+            slice = RadarCube_antennaSlice(view, c, r);
+            checkSlice(&slice, view->numAntennas, view->numRangeBins, c, 0U, r, 0U, 1U, 0U, buf, "antennaSlice");
+        }
+    }
+    for (a = 0; a < view->numAntennas; a++) {
+        for (r = 0; r < view->numRangeBins; r++) {
+            slice = RadarCube_chirpSlice(view, a, r);
+            checkSlice(&slice, view->numChirps, view->numAntennas * view->numRangeBins, 0U, a, r, 1U, 0U, 0U, buf,
+                       "chirpSlice");
+        }
+    }
+}
+
+int main(void) {
+    uint32_t k;
+
+    for (k = 0; k < sizeof(gDims) / sizeof(gDims[0]); k++) {
+        const Dims     *d = &gDims[k];
+        uint32_t        numSamples = d->numChirps * d->numAntennas * d->numRangeBins;
+        uint32_t        maxCount = d->numRangeBins;
+        uint32_t        before = gFailures;
+        cmplx16ImRe_t  *data, *buf;
+        RadarCube_View  view;
+
+        maxCount = (d->numAntennas > maxCount) ? d->numAntennas : maxCount;
+        maxCount = (d->numChirps > maxCount) ? d->numChirps : maxCount;
+        data = (cmplx16ImRe_t *) malloc(numSamples * sizeof(cmplx16ImRe_t));
+        buf  = (cmplx16ImRe_t *) malloc((maxCount + NUM_GUARD) * sizeof(cmplx16ImRe_t));
+        if ((data == NULL) || (buf == NULL)) {
+            printf("out of memory\n");
+            return 2;
+        }
+        fillCube(data, d);
+        memset(&view, 0xFF, sizeof(view));
+        RadarCube_initView(&view, data, d->numChirps, d->numAntennas, d->numRangeBins);
+
+        checkIndex(&view);
+        checkRangeOffset(&view);
+        checkSlices(&view, buf);
+        printf("%2u chirps x %2u antennas x %2u range bins: %s\n", d->numChirps, d->numAntennas, d->numRangeBins,
+               (gFailures == before) ? "ok" : "FAILED");
+        free(buf);
+        free(data);
+    }
+
+    printf("%u failures\n", gFailures);
+    return (gFailures != 0U) ? 1 : 0;
+}
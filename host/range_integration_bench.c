@@ -0,0 +1,205 @@
+/**
+ * @file range_integration_bench.c
+ * @brief Host equivalence check and benchmark of the non-coherent range integration (range_integration.c).
+ *
+ * Generates radar cubes with one target of random phase per chirp and antenna
+ * in complex Gaussian noise and runs RangeIntegration_process() on them:
+ *
+ * - equivalence: a plain implementation (one 64-bit power sum per range bin)
+ *   has to produce the same output in both formats, including full scale samples,
+ * - SNR gain: deflection of the target (excess over the mean noise power of
+ *   the other range bins, relative to the standard deviation of the noise
+ *   power) for a single chirp of a single antenna and for the integrated
+ *   profile, the expected gain is 5 * log10(numChirps * numAntennas) dB,
+ * - run time per frame.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -DHOST_BUILD -I minimal_rangeproc_impl/include host/range_integration_bench.c \
+ *     minimal_rangeproc_impl/src/range_integration.c minimal_rangeproc_impl/src/fixed_math.c -lm -o range_integration_bench
+ * ./range_integration_bench [num chirps] [num range bins] [num frames] [SNR per sample in dB]
+ * @endcode
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "fixed_math.h"
+#include "range_integration.h"
+
+#define NUM_ANTENNAS        (6U)
+#define NOISE_SIGMA         (100.0)     // per real and imaginary part
+
+static uint64_t gRandState = 0x2545F4914F6CDD1DULL;
+
+static double uniform(void) {
+    gRandState ^= gRandState << 13;
+    gRandState ^= gRandState >> 7;
+    gRandState ^= gRandState << 17;
+    return ((double) (gRandState >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gauss(void) {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static int16_t toSample(double v) {
+    return (int16_t) ((v > 32767.0) ? 32767 : ((v < -32768.0) ? -32768 : lround(v)));
+}
+
+static void genCube(RadarCube_View *cube, uint32_t targetBin, double targetAmp) {
+    uint32_t c, a, r;
+
+    for (c = 0; c < cube->numChirps; c++) {
+        for (a = 0; a < cube->numAntennas; a++) {
+            double phase = 2.0 * M_PI * uniform();
+
+            for (r = 0; r < cube->numRangeBins; r++) {
+                cmplx16ImRe_t *s  = RadarCube_at(cube, c, a, r);
+                double         re = NOISE_SIGMA * gauss(), im = NOISE_SIGMA * gauss();
+
+                if (r == targetBin) {
+                    re += targetAmp * cos(phase);
+                    im += targetAmp * sin(phase);
+                }
+                s->real = toSample(re);
+                s->imag = toSample(im);
+            }
+        }
+    }
+}
+
+/* plain reference: one 64-bit power sum per range bin */
+static void refProcess(const RangeIntegration_Obj *obj, const RadarCube_View *cube, void *out) {
+    uint32_t r, c, a;
+
+    for (r = 0; r < cube->numRangeBins; r++) {
+        uint64_t sum = 0U;
+
+        for (c = 0; c < cube->numChirps; c++) {
+            for (a = 0; a < cube->numAntennas; a++) {
+                const cmplx16ImRe_t *s = RadarCube_at(cube, c, a, r);
+                sum += (uint64_t) ((int64_t) s->real * s->real + (int64_t) s->imag * s->imag);
+            }
+        }
+        if (obj->cfg.output == RANGE_INTEGRATION_OUTPUT_POWER) {
+            ((uint32_t *) out)[r] = (uint32_t) (sum >> obj->powerShift);
+        } else {
+            ((uint16_t *) out)[r] = (sum == 0U) ? 0U : (uint16_t) (FixedMath_log2Q8(sum) / 2);
+        }
+    }
+}
+
+/* deflection of the target bin: (target - mean noise) / standard deviation of the noise, in dB */
+static double deflectionDb(const double *power, uint32_t numBins, uint32_t targetBin, uint32_t numFrames) {
+    double   sum = 0.0, sumSq = 0.0, n, mean, var;
+    uint32_t i;
+
+    for (i = 0; i < numBins * numFrames; i++) {
+        if ((i % numBins) != targetBin) {
+            sum   += power[i];
+            sumSq += power[i] * power[i];
+        }
+    }
+    n    = (double) (numBins - 1U) * numFrames;
+    mean = sum / n;
+    var  = sumSq / n - mean * mean;
+    sum  = 0.0;
+    for (i = 0; i < numFrames; i++) {
+        sum += power[i * numBins + targetBin];
+    }
+    return 10.0 * log10((sum / numFrames - mean) / sqrt(var));
+}
+
+int main(int argc, char **argv) {
+    uint32_t                numChirps = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 8U;
+    uint32_t                numBins   = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 64U;
+    uint32_t                numFrames = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 10) : 200U;
+    double                  snrDb     = (argc > 4) ? atof(argv[4]) : 0.0;
+    double                  targetAmp = NOISE_SIGMA * sqrt(2.0) * pow(10.0, snrDb / 20.0);
+    uint32_t                targetBin = numBins / 3U;
+    uint32_t                numSamples = numChirps * NUM_ANTENNAS * numBins;
+    RangeIntegration_Config cfg;
+    RangeIntegration_Obj    obj;
+    RadarCube_View          cube;
+    cmplx16ImRe_t          *data;
+    uint32_t               *out, *ref;
+    double                 *single, *integrated, time = 0.0;
+    uint32_t                format, i, k, mismatches = 0U;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.output       = RANGE_INTEGRATION_OUTPUT_POWER;
+    cfg.numChirps    = numChirps;
+    cfg.numAntennas  = NUM_ANTENNAS;
+    cfg.numRangeBins = numBins;
+    if ((numFrames == 0U) || (numBins < 2U) || (RangeIntegration_init(&obj, &cfg) != RANGE_INTEGRATION_SUCCESS)) {
+        fprintf(stderr, "usage: %s [num chirps] [num range bins >= 2] [num frames] [SNR per sample in dB]\n", argv[0]);
+        return 1;
+    }
+    data       = (cmplx16ImRe_t *) malloc(numSamples * sizeof(cmplx16ImRe_t));
+    out        = (uint32_t *) malloc(numBins * sizeof(uint32_t));
+    ref        = (uint32_t *) malloc(numBins * sizeof(uint32_t));
+    single     = (double *) malloc(numBins * numFrames * sizeof(double));
+    integrated = (double *) malloc(numBins * numFrames * sizeof(double));
+    if ((data == NULL) || (out == NULL) || (ref == NULL) || (single == NULL) || (integrated == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    RadarCube_initView(&cube, data, numChirps, NUM_ANTENNAS, numBins);
+
+    printf("%u chirps x %u antennas x %u range bins, %u frames, target at bin %u with %.1f dB SNR per sample\n",
+           numChirps, NUM_ANTENNAS, numBins, numFrames, targetBin, snrDb);
+
+    /* equivalence on full scale samples */
+    for (k = 0; k < numSamples; k++) {
+        data[k].real = (k & 1U) ? 32767 : -32768;
+        data[k].imag = -32768;
+    }
+    for (format = RANGE_INTEGRATION_OUTPUT_LOG2_MAG; format <= RANGE_INTEGRATION_OUTPUT_POWER; format++) {
+        cfg.output = (RangeIntegration_Output) format;
+        RangeIntegration_init(&obj, &cfg);
+        RangeIntegration_process(&obj, &cube, out);
+        refProcess(&obj, &cube, ref);
+        mismatches += (memcmp(out, ref, RangeIntegration_outputSize(&cfg)) != 0) ? 1U : 0U;
+    }
+
+    for (i = 0; i < numFrames; i++) {
+        genCube(&cube, targetBin, targetAmp);
+        for (format = RANGE_INTEGRATION_OUTPUT_LOG2_MAG; format <= RANGE_INTEGRATION_OUTPUT_POWER; format++) {
+            double t0;
+
+            cfg.output = (RangeIntegration_Output) format;
+            RangeIntegration_init(&obj, &cfg);
+            t0 = (double) clock();
+            if (RangeIntegration_process(&obj, &cube, out) != RANGE_INTEGRATION_SUCCESS) {
+                printf("RangeIntegration_process failed\n");
+                return 1;
+            }
+            time += (double) clock() - t0;
+            refProcess(&obj, &cube, ref);
+            mismatches += (memcmp(out, ref, RangeIntegration_outputSize(&cfg)) != 0) ? 1U : 0U;
+        }
+        for (k = 0; k < numBins; k++) {
+            const cmplx16ImRe_t *s = RadarCube_at(&cube, 0, 0, k);
+            single[i * numBins + k]     = (double) s->real * s->real + (double) s->imag * s->imag;
+            integrated[i * numBins + k] = (double) out[k];
+        }
+    }
+
+    printf("single chirp and antenna  deflection %6.2f dB\n", deflectionDb(single, numBins, targetBin, numFrames));
+    printf("integrated (%3u samples)  deflection %6.2f dB  (expected gain %.2f dB)\n", obj.numIntegrated,
+           deflectionDb(integrated, numBins, targetBin, numFrames), 5.0 * log10((double) obj.numIntegrated));
+    printf("%u mismatches against the reference  %.2f us per frame and format\n", mismatches,
+           time / CLOCKS_PER_SEC / numFrames / 2.0 * 1e6);
+
+    free(data);
+    free(out);
+    free(ref);
+    free(single);
+    free(integrated);
+    return (mismatches != 0U) ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file rangeproc_ref.c
+ * @brief Fixed-point host reference model of the Rangeproc HWA chain (see rangeproc_ref.h).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rangeproc_ref.h"
+
+void RangeProcRef_defaultConfig(RangeProcRef_Config *cfg, uint32_t numAdcSamples, uint32_t numRx,
+                                uint32_t numTx, uint32_t numChirps, uint32_t mimoSel) {
+    uint32_t fftSize = 1U;
+
+    while (fftSize < numAdcSamples) {
+        fftSize <<= 1;
+    }
+    memset(cfg, 0, sizeof(RangeProcRef_Config));
+    cfg->numAdcSamples                 = numAdcSamples;
+    cfg->fftSize                       = fftSize;
+    cfg->numRangeBins                  = fftSize / 2U;
+    cfg->numRxAntennas                 = numRx;
+    cfg->numTxAntennas                 = numTx;
+    cfg->numChirpsPerFrame             = numChirps;
+    cfg->isBpmEnabled                  = (mimoSel == 4U) ? 1U : 0U;
+    cfg->fftOutputDivShift             = 2U;
+    cfg->numLastButterflyStagesToScale = 0U;
+    cfg->windowQFormat                 = 17U;
+    cfg->twiddleQFormat                = 20U;
+    cfg->datapathBits                  = 24U;
+}
+
+int32_t RangeProcRef_init(RangeProcRef *ref, const RangeProcRef_Config *cfg) {
+    uint32_t  half = (cfg->numAdcSamples + 1U) / 2U;
+    uint32_t *winHalf;
+    uint32_t  i;
+    int32_t   retVal;
+
+    memset(ref, 0, sizeof(RangeProcRef));
+    if ((cfg->numAdcSamples == 0U) || (cfg->numAdcSamples > cfg->fftSize) || (cfg->numRangeBins > cfg->fftSize / 2U) ||
+        (cfg->numRxAntennas == 0U) || (cfg->numTxAntennas == 0U) ||
+        ((cfg->numChirpsPerFrame % cfg->numTxAntennas) != 0U) ||
+        ((cfg->isBpmEnabled != 0U) && (cfg->numTxAntennas != 2U)) || (cfg->windowQFormat > 30U) ||
+        (cfg->windowShift > cfg->windowQFormat)) {
+        return RANGEPROC_REF_EINVAL;
+    }
+    retVal = HwaFftRef_init(&ref->fft, cfg->fftSize, cfg->numLastButterflyStagesToScale, cfg->twiddleQFormat,
+                            cfg->datapathBits);
+    if (retVal != HWA_FFT_REF_SUCCESS) {
+        return (retVal == HWA_FFT_REF_ENOMEM) ? RANGEPROC_REF_ENOMEM : RANGEPROC_REF_EINVAL;
+    }
+
+    ref->cfg      = *cfg;
+    ref->window   = (int32_t *) malloc(cfg->numAdcSamples * sizeof(int32_t));
+    ref->spectrum = (int32_t *) malloc((size_t) cfg->numChirpsPerFrame * cfg->numRxAntennas *
+                                       cfg->numRangeBins * 2U * sizeof(int32_t));
+    winHalf       = (uint32_t *) malloc(half * sizeof(uint32_t));
+    if ((ref->window == NULL) || (ref->spectrum == NULL) || (winHalf == NULL)) {
+        free(winHalf);
+        RangeProcRef_deinit(ref);
+        return RANGEPROC_REF_ENOMEM;
+    }
+
+    /* symmetric window: the HWA stores the first half (hwaWinSym = 1) */
+    if (cfg->windowTable != NULL) {
+        memcpy(winHalf, cfg->windowTable, half * sizeof(uint32_t));
+    } else {
+        HwaFftRef_genWindow(winHalf, cfg->numAdcSamples, half, HWA_FFT_REF_WIN_BLACKMAN, cfg->windowQFormat);
+    }
+    if (cfg->windowShift > 0U) {
+        for (i = 0; i < half; i++) {
+            winHalf[i] = (winHalf[i] + (1U << (cfg->windowShift - 1U))) >> cfg->windowShift;
+        }
+    }
+    for (i = 0; i < cfg->numAdcSamples; i++) {
+        ref->window[i] = (int32_t) winHalf[(i < half) ? i : (cfg->numAdcSamples - 1U - i)];
+    }
+    free(winHalf);
+    return RANGEPROC_REF_SUCCESS;
+}
+
+void RangeProcRef_deinit(RangeProcRef *ref) {
+    HwaFftRef_deinit(&ref->fft);
+    free(ref->window);
+    free(ref->spectrum);
+    memset(ref, 0, sizeof(RangeProcRef));
+}
+
+/* Output conversion: rounding shift and saturation to 16 bit */
+static int16_t RangeProcRef_output(int64_t v, uint32_t shift) {
+    return (int16_t) HwaFftRef_sat(HwaFftRef_roundShift(v, shift), 16U);
+}
+
+int32_t RangeProcRef_processFrame(RangeProcRef *ref, const int16_t *adc, const RadarCube_View *cube) {
+    const RangeProcRef_Config *cfg     = &ref->cfg;
+    const uint32_t             numFfts = cfg->numChirpsPerFrame * cfg->numRxAntennas;
+    const uint32_t             wq      = cfg->windowQFormat;
+    const uint32_t             bins    = cfg->numRangeBins;
+    uint32_t                   f, i, l, chirp, rx, bin;
+
+    if ((cube->numChirps != cfg->numChirpsPerFrame / cfg->numTxAntennas) ||
+        (cube->numAntennas != cfg->numTxAntennas * cfg->numRxAntennas) || (cube->numRangeBins != bins)) {
+        return RANGEPROC_REF_EINVAL;
+    }
+
+    /* windowing and range FFT of all chirps and RX antennas, HWA_FFT_REF_BATCH at a time */
+    for (f = 0; f < numFfts; f += HWA_FFT_REF_BATCH) {
+        uint32_t lanes = ((numFfts - f) < HWA_FFT_REF_BATCH) ? (numFfts - f) : HWA_FFT_REF_BATCH;
+
+        HwaFftRef_clear(&ref->fft);
+        for (l = 0; l < lanes; l++) {
+            const int16_t *x = &adc[(size_t) (f + l) * cfg->numAdcSamples];
+            for (i = 0; i < cfg->numAdcSamples; i++) {
+                HwaFftRef_load(&ref->fft, l, i, HwaFftRef_roundShift((int64_t) x[i] * ref->window[i], wq), 0);
+            }
+        }
+
+        HwaFftRef_run(&ref->fft);
+
+        for (l = 0; l < lanes; l++) {
+            int32_t *out = &ref->spectrum[(size_t) (f + l) * bins * 2U];
+            for (bin = 0; bin < bins; bin++) {
+                out[2U * bin]      = HwaFftRef_re(&ref->fft, l, bin);
+                out[2U * bin + 1U] = HwaFftRef_im(&ref->fft, l, bin);
+            }
+        }
+    }
+
+    /* MIMO decoding and output conversion into Cube[chirp][antenna][range] */
+    for (chirp = 0; chirp < cfg->numChirpsPerFrame; chirp++) {
+        uint32_t doppler = chirp / cfg->numTxAntennas;
+        uint32_t tx      = chirp % cfg->numTxAntennas;
+
+        for (rx = 0; rx < cfg->numRxAntennas; rx++) {
+            const int32_t *a   = &ref->spectrum[((size_t) chirp * cfg->numRxAntennas + rx) * bins * 2U];
+            cmplx16ImRe_t *out = RadarCube_rangeProfile(cube, doppler, tx * cfg->numRxAntennas + rx);
+
+            if (cfg->isBpmEnabled) {
+                /* chirp pair A = Tx0 + Tx1, B = Tx0 - Tx1: Tx0 = (A + B) / 2, Tx1 = (A - B) / 2 */
+                const int32_t *b = &ref->spectrum[((size_t) (chirp ^ 1U) * cfg->numRxAntennas + rx) * bins * 2U];
+                const int32_t *p = (tx == 0U) ? a : b;
+                const int32_t *q = (tx == 0U) ? b : a;
+                int64_t        sign = (tx == 0U) ? 1 : -1;
+
+                for (bin = 0; bin < bins; bin++) {
+                    int32_t re = HwaFftRef_sat(p[2U * bin] + sign * q[2U * bin], cfg->datapathBits);
+                    int32_t im = HwaFftRef_sat(p[2U * bin + 1U] + sign * q[2U * bin + 1U], cfg->datapathBits);
+                    out[bin].real = RangeProcRef_output(re, cfg->fftOutputDivShift + 1U);
+                    out[bin].imag = RangeProcRef_output(im, cfg->fftOutputDivShift + 1U);
+                }
+            } else {
+                for (bin = 0; bin < bins; bin++) {
+                    out[bin].real = RangeProcRef_output(a[2U * bin], cfg->fftOutputDivShift);
+                    out[bin].imag = RangeProcRef_output(a[2U * bin + 1U], cfg->fftOutputDivShift);
+                }
+            }
+        }
+    }
+    return RANGEPROC_REF_SUCCESS;
+}
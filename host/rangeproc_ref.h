@@ -0,0 +1,158 @@
+#ifndef RANGEPROC_REF_H
+#define RANGEPROC_REF_H
+
+/**
+ * @file rangeproc_ref.h
+ * @brief Fixed-point host reference model of the Rangeproc HWA chain.
+ *
+ * Reproduces the processing configured by RangeProc_config() on raw ADC
+ * samples and writes a radar cube in DPIF_RADARCUBE_FORMAT_6 (see radar_cube.h):
+ *
+ * 1. Window: real 16-bit ADC samples times a symmetric window in Q
+ *    windowQFormat (DPC_OBJDET_QFORMAT_RANGE_FFT), the precomputed table of
+ *    range_window.h selected by the firmware or the Blackman window of
+ *    mathUtils_genWindow(), rounded back to the sample scale. The 24-bit datapath thus has 8 bits of
+ *    headroom for the FFT growth (numLastButterflyStagesToScale = 0).
+ * 2. Range FFT: complex radix-2 FFT of size fftSize on the real input, 24-bit
+ *    saturating datapath, twiddles in Q twiddleQFormat, every product rounded
+ *    once, optional rounding division by 2 in the last stages.
+ * 3. BPM decoding (isBpmEnabled, 2 TX): sum and difference of the two chirps of
+ *    a BPM pair in the 24-bit domain, scaled by 1/2 with the output shift.
+ * 4. Output: rounding right shift by fftOutputDivShift, saturation to 16 bit,
+ *    first numRangeBins bins (real input: half spectrum).
+ *
+ * The FFTs run on the HWA FFT model of hwa_fft_ref.h, HWA_FFT_REF_BATCH
+ * chirps/antennas side by side with a scalar or SIMD (AVX2, NEON) path.
+ *
+ * The rounding and word length choices follow the HWA documentation; they are
+ * collected in RangeProcRef_Config so they can be adjusted once golden vectors
+ * captured on the device are compared against the model.
+ *
+ * Host only, needs -DHOST_BUILD for radar_cube.h.
+ */
+
+#include <stdint.h>
+
+#include "hwa_fft_ref.h"
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define RANGEPROC_REF_SUCCESS           (0)
+#define RANGEPROC_REF_EINVAL            (-1)
+#define RANGEPROC_REF_ENOMEM            (-2)
+
+/*!
+ * @brief Parameters of the modeled chain, named as in DPU_RangeProcHWA_StaticConfig.
+ */
+typedef struct RangeProcRef_Config_t
+{
+    /*! @brief Number of ADC samples per chirp (CLI_NUM_ADC_SAMPLES) */
+    uint32_t numAdcSamples;
+
+    /*! @brief FFT size, a power of two >= numAdcSamples (missing samples are zero) */
+    uint32_t fftSize;
+
+    /*! @brief Number of range bins written to the radar cube, <= fftSize / 2 */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of RX antennas */
+    uint32_t numRxAntennas;
+
+    /*! @brief Number of TX antennas */
+    uint32_t numTxAntennas;
+
+    /*! @brief Number of chirps per frame (all TX antennas) */
+    uint32_t numChirpsPerFrame;
+
+    /*! @brief BPM-MIMO (2 TX antennas) instead of TDM-MIMO */
+    uint32_t isBpmEnabled;
+
+    /*! @brief Right shift of the FFT output (rangeFFTtuning.fftOutputDivShift) */
+    uint32_t fftOutputDivShift;
+
+    /*! @brief Number of last butterfly stages scaling by 1/2 (rangeFFTtuning.numLastButterflyStagesToScale) */
+    uint32_t numLastButterflyStagesToScale;
+
+    /*! @brief Q format of the window (DPC_OBJDET_QFORMAT_RANGE_FFT) */
+    uint32_t windowQFormat;
+
+    /*! @brief First half ((numAdcSamples + 1) / 2 values in windowQFormat) of the window, e.g. a table of
+               range_window.h, NULL: Blackman window of mathUtils_genWindow(). Copied by RangeProcRef_init(). */
+    const uint32_t *windowTable;
+
+    /*! @brief Right shift of the window, rounded, as the firmware scales it for hardware chirp accumulation
+               (APP_CHIRP_ACCUM_WINDOW_SHIFT), 0 by default */
+    uint32_t windowShift;
+
+    /*! @brief Q format of the twiddle factors */
+    uint32_t twiddleQFormat;
+
+    /*! @brief Word length of the FFT datapath in bits */
+    uint32_t datapathBits;
+} RangeProcRef_Config;
+
+/*!
+ * @brief State of the reference model.
+ */
+typedef struct RangeProcRef_t
+{
+    /*! @brief Configuration */
+    RangeProcRef_Config cfg;
+
+    /*! @brief Range FFT, its path can be changed with HwaFftRef_setPath() */
+    HwaFftRef fft;
+
+    /*! @brief Window, numAdcSamples entries (both halves) */
+    int32_t *window;
+
+    /*! @brief FFT output of all chirps and RX antennas of a frame: [chirp][rx][bin][re, im] */
+    int32_t *spectrum;
+} RangeProcRef;
+
+/**
+ * @brief Fills a configuration with the values set by RangeProc_config().
+ *
+ * @param[out] cfg           Configuration.
+ * @param[in]  numAdcSamples CLI_NUM_ADC_SAMPLES.
+ * @param[in]  numRx         Number of RX antennas.
+ * @param[in]  numTx         Number of TX antennas.
+ * @param[in]  numChirps     Chirps per frame (CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST).
+ * @param[in]  mimoSel       CLI_MIMO_SEL (4: BPM).
+ */
+void RangeProcRef_defaultConfig(RangeProcRef_Config *cfg, uint32_t numAdcSamples, uint32_t numRx,
+                                uint32_t numTx, uint32_t numChirps, uint32_t mimoSel);
+
+/**
+ * @brief Allocates the tables and buffers of the model, selects the fastest available path.
+ *
+ * @return RANGEPROC_REF_SUCCESS, RANGEPROC_REF_EINVAL or RANGEPROC_REF_ENOMEM.
+ */
+int32_t RangeProcRef_init(RangeProcRef *ref, const RangeProcRef_Config *cfg);
+
+/**
+ * @brief Frees the tables and buffers.
+ */
+void RangeProcRef_deinit(RangeProcRef *ref);
+
+/**
+ * @brief Processes the ADC samples of one frame into a radar cube.
+ *
+ * @param[in]  adc  ADC samples [chirp][rx][numAdcSamples] of all chirps of the frame.
+ * @param[out] cube Radar cube of numChirpsPerFrame / numTxAntennas chirps,
+ *                  numTxAntennas * numRxAntennas antennas and numRangeBins bins.
+ *
+ * @return RANGEPROC_REF_SUCCESS, RANGEPROC_REF_EINVAL if the cube does not match the configuration.
+ */
+int32_t RangeProcRef_processFrame(RangeProcRef *ref, const int16_t *adc, const RadarCube_View *cube);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RANGEPROC_REF_H */
@@ -0,0 +1,354 @@
+/**
+ * @file recording.hpp
+ * @brief Writing and memory-mapped reading of frame recordings (see recording_format.h).
+ *
+ * RecordingWriter writes every frame with a single pwrite() straight from the
+ * decoder buffer and appends one index entry, nothing is kept in memory.
+ * RecordingReader maps both files read-only and hands out frames as FrameView
+ * pointing into the mapping, so a recording of any length can be accessed in
+ * O(1) per frame without reading it.
+ *
+ * Needs `frame_protocol.c`, see `frame_record.cpp` for a build command.
+ */
+
+#ifndef RECORDING_HPP
+#define RECORDING_HPP
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "frame_decoder.hpp"
+#include "recording_format.h"
+
+namespace radar {
+
+static_assert(sizeof(Recording_Config) == 64, "unexpected Recording_Config layout");
+static_assert(sizeof(Recording_Header) == 160, "unexpected Recording_Header layout");
+static_assert(sizeof(Recording_IndexHeader) == 16, "unexpected Recording_IndexHeader layout");
+static_assert(sizeof(Recording_IndexEntry) == 32, "unexpected Recording_IndexEntry layout");
+
+inline uint64_t hostTimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline std::string indexPath(const std::string &path) {
+    return path + ".idx";
+}
+
+/**
+ * @brief Number of chirps of ADC data per frame: with hardware chirp accumulation (numChirpsAccum > 1) one per
+ *        numChirpsAccum chirps of a burst, as SensorConfig_numAdcChirps().
+ */
+inline uint32_t numAdcChirps(const Recording_Config &cfg) {
+    const uint32_t accum = (cfg.numChirpsAccum > 1U) ? cfg.numChirpsAccum : 1U;
+    return (cfg.numChirpsPerBurst / accum) * cfg.numBurstsPerFrame;
+}
+
+/**
+ * @brief Reads the sensor configuration from defines.h.
+ *
+ * Values which defines.h only holds as an expression are taken from the
+ * "for reference: value N is from config" comment, as generated by
+ * chirp_config_to_defines.py. The zero-padding of the range FFT
+ * (APP_RANGE_FFT_ZERO_PAD) is read from proc_config.h in the same directory,
+ * without it the range FFT is not zero-padded.
+ *
+ * @return false if the file cannot be read or lacks CLI_NUM_ADC_SAMPLES.
+ */
+inline bool readDefines(const char *path, Recording_Config &cfg) {
+    FILE    *f = std::fopen(path, "r");
+    char     line[512];
+    uint32_t numTx, zeroPad = 1U;
+
+    if (f == nullptr) {
+        return false;
+    }
+    std::memset(&cfg, 0, sizeof(cfg));
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        char        name[64];
+        char       *value;
+        const char *ref;
+        double      v;
+        int         nameLen;
+
+        if (std::sscanf(line, " #define %63s %n", name, &nameLen) != 1) {
+            continue;
+        }
+        value = line + nameLen;
+        ref   = std::strstr(value, "value ");
+        if ((ref != nullptr) && (std::strstr(ref, "from config") != nullptr)) {
+            v = std::strtod(ref + 6, nullptr);
+        } else {
+            char *end;
+            v = std::strtod(value, &end);
+            if (end == value) {
+                continue;
+            }
+        }
+
+        if (std::strcmp(name, "CLI_NUM_ADC_SAMPLES") == 0)           { cfg.numAdcSamples       = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_CHA_CFG_RX_BITMASK") == 0)   { cfg.rxChannelMask       = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_CHA_CFG_TX_BITMASK") == 0)   { cfg.txChannelMask       = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_NUM_CHIRPS_PER_BURST") == 0) { cfg.numChirpsPerBurst   = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_NUM_BURSTS_PER_FRAME") == 0) { cfg.numBurstsPerFrame   = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_NUM_CHIRPS_ACCUM") == 0)     { cfg.numChirpsAccum      = static_cast<uint32_t>(v); }
+        else if (std::strcmp(name, "CLI_FRAME_PERIOD") == 0)         { cfg.framePeriodMs       = static_cast<float>(v); }
+        else if (std::strcmp(name, "CLI_START_FREQ") == 0)           { cfg.startFreqGHz        = static_cast<float>(v); }
+        else if (std::strcmp(name, "CLI_CHIRP_SLOPE") == 0)          { cfg.chirpSlopeMHzPerUs  = static_cast<float>(v); }
+        else if (std::strcmp(name, "CLI_CHIRP_RAMP_END_TIME") == 0)  { cfg.rampEndTimeUs       = static_cast<float>(v); }
+        else if (std::strcmp(name, "CLI_CHIRP_IDLE_TIME") == 0)      { cfg.idleTimeUs          = static_cast<float>(v); }
+        else if (std::strcmp(name, "CLI_DIG_OUT_SAMPLING_RATE") == 0) {
+            cfg.adcSamplingRateMsps = (v > 0.0) ? static_cast<float>(100.0 / v) : 0.0F;
+        }
+    }
+    std::fclose(f);
+
+    if (cfg.numAdcSamples == 0U) {
+        return false;
+    }
+    const std::string procConfig = std::string(path).substr(0, std::string(path).find_last_of('/') + 1U) +
+                                   "proc_config.h";
+    if ((f = std::fopen(procConfig.c_str(), "r")) != nullptr) {
+        while (std::fgets(line, sizeof(line), f) != nullptr) {
+            if (std::sscanf(line, " #define APP_RANGE_FFT_ZERO_PAD %u", &zeroPad) == 1) {
+                break;
+            }
+        }
+        std::fclose(f);
+    }
+    /* derived values, as in defines.h and RangeProc_config() */
+    cfg.numRangeBins = 1U;
+    while (cfg.numRangeBins < cfg.numAdcSamples) {
+        cfg.numRangeBins <<= 1;
+    }
+    cfg.numRangeBins = cfg.numRangeBins * zeroPad / 2U;
+    numTx = static_cast<uint32_t>(__builtin_popcount(cfg.txChannelMask));
+    cfg.numVirtualAntennas = static_cast<uint32_t>(__builtin_popcount(cfg.rxChannelMask)) * numTx;
+    if (numTx > 0U) {
+        cfg.numDopplerChirps = numAdcChirps(cfg) / numTx;
+    }
+    return true;
+}
+
+class RecordingWriter {
+public:
+    RecordingWriter() = default;
+    ~RecordingWriter() { close(); }
+
+    RecordingWriter(const RecordingWriter &) = delete;
+    RecordingWriter &operator=(const RecordingWriter &) = delete;
+
+    /**
+     * @brief Creates a recording (data file and index), existing files are replaced.
+     *
+     * @param[in] alignment Alignment of the frames, a power of two >= 64.
+     *
+     * @return false on error (errno is set).
+     */
+    bool open(const std::string &path, const Recording_Config &cfg, const char *source,
+              uint32_t alignment = RECORDING_DEFAULT_ALIGNMENT) {
+        Recording_Header      header;
+        Recording_IndexHeader indexHeader;
+
+        if ((alignment < 64U) || ((alignment & (alignment - 1U)) != 0U)) {
+            errno = EINVAL;
+            return false;
+        }
+        dataFd_  = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        indexFd_ = ::open(indexPath(path).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if ((dataFd_ < 0) || (indexFd_ < 0)) {
+            close();
+            return false;
+        }
+
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+        header.version     = RECORDING_VERSION;
+        header.alignment   = alignment;
+        header.headerSize  = alignUp(sizeof(header), alignment);
+        header.startTimeNs = hostTimeNs();
+        header.config      = cfg;
+        std::snprintf(header.source, sizeof(header.source), "%s", source);
+
+        std::memset(&indexHeader, 0, sizeof(indexHeader));
+        std::memcpy(indexHeader.magic, RECORDING_INDEX_MAGIC, sizeof(indexHeader.magic));
+        indexHeader.version   = RECORDING_VERSION;
+        indexHeader.entrySize = sizeof(Recording_IndexEntry);
+
+        if ((pwrite(dataFd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) ||
+            (write(indexFd_, &indexHeader, sizeof(indexHeader)) != static_cast<ssize_t>(sizeof(indexHeader)))) {
+            close();
+            return false;
+        }
+        alignment_ = alignment;
+        offset_    = header.headerSize;
+        return true;
+    }
+
+    /**
+     * @brief Appends a frame; the data is written before its index entry.
+     *
+     * @return false on a write error (errno is set).
+     */
+    bool append(const FrameView &frame) {
+        Recording_IndexEntry entry;
+
+        if (pwrite(dataFd_, frame.data, frame.size, static_cast<off_t>(offset_)) != static_cast<ssize_t>(frame.size)) {
+            return false;
+        }
+        std::memset(&entry, 0, sizeof(entry));
+        entry.offset     = offset_;
+        entry.length     = static_cast<uint32_t>(frame.size);
+        entry.frameCount = frame.header.frameCount;
+        entry.timestamp  = frame.header.timestamp;
+        entry.hostTimeNs = hostTimeNs();
+        if (write(indexFd_, &entry, sizeof(entry)) != static_cast<ssize_t>(sizeof(entry))) {
+            return false;
+        }
+        offset_ = alignUp(offset_ + frame.size, alignment_);
+        numFrames_++;
+        return true;
+    }
+
+    void close() {
+        if (dataFd_ >= 0) {
+            /* the padding after the last frame is part of the file, so every frame is one full stride */
+            if (ftruncate(dataFd_, static_cast<off_t>(offset_)) != 0) {
+                std::perror("ftruncate");
+            }
+            ::close(dataFd_);
+            dataFd_ = -1;
+        }
+        if (indexFd_ >= 0) {
+            ::close(indexFd_);
+            indexFd_ = -1;
+        }
+    }
+
+    uint64_t numFrames() const { return numFrames_; }
+    uint64_t numBytes() const { return offset_; }
+
+private:
+    static uint64_t alignUp(uint64_t value, uint32_t alignment) {
+        return (value + alignment - 1U) & ~static_cast<uint64_t>(alignment - 1U);
+    }
+
+    int      dataFd_    = -1;
+    int      indexFd_   = -1;
+    uint32_t alignment_ = RECORDING_DEFAULT_ALIGNMENT;
+    uint64_t offset_    = 0;
+    uint64_t numFrames_ = 0;
+};
+
+class RecordingReader {
+public:
+    RecordingReader() = default;
+    ~RecordingReader() { close(); }
+
+    RecordingReader(const RecordingReader &) = delete;
+    RecordingReader &operator=(const RecordingReader &) = delete;
+
+    /**
+     * @brief Maps a recording. Index entries pointing beyond the data file (interrupted recording) are ignored.
+     *
+     * @return false if the files cannot be mapped or are no recording.
+     */
+    bool open(const std::string &path) {
+        close();
+        if (!map(path, data_, dataSize_) || !map(indexPath(path), index_, indexSize_)) {
+            close();
+            return false;
+        }
+        if ((dataSize_ < sizeof(Recording_Header)) || (indexSize_ < sizeof(Recording_IndexHeader)) ||
+            (std::memcmp(header().magic, RECORDING_MAGIC, 8) != 0) || (header().version != RECORDING_VERSION) ||
+            (std::memcmp(index_, RECORDING_INDEX_MAGIC, 8) != 0) ||
+            (reinterpret_cast<const Recording_IndexHeader *>(index_)->entrySize != sizeof(Recording_IndexEntry))) {
+            close();
+            errno = EINVAL;
+            return false;
+        }
+        numFrames_ = (indexSize_ - sizeof(Recording_IndexHeader)) / sizeof(Recording_IndexEntry);
+        while ((numFrames_ > 0U) && (entry(numFrames_ - 1U).offset + entry(numFrames_ - 1U).length > dataSize_)) {
+            numFrames_--;
+        }
+        /* frames are read in order most of the time */
+        madvise(const_cast<uint8_t *>(data_), dataSize_, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    void close() {
+        if (data_ != nullptr) {
+            munmap(const_cast<uint8_t *>(data_), dataSize_);
+        }
+        if (index_ != nullptr) {
+            munmap(const_cast<uint8_t *>(index_), indexSize_);
+        }
+        data_      = nullptr;
+        index_     = nullptr;
+        numFrames_ = 0;
+    }
+
+    const Recording_Header &header() const { return *reinterpret_cast<const Recording_Header *>(data_); }
+
+    size_t numFrames() const { return numFrames_; }
+
+    const Recording_IndexEntry &entry(size_t i) const {
+        return reinterpret_cast<const Recording_IndexEntry *>(index_ + sizeof(Recording_IndexHeader))[i];
+    }
+
+    /** @brief Frame i, pointing into the mapping (valid until close()). */
+    FrameView frame(size_t i) const {
+        FrameView view;
+        const Recording_IndexEntry &e = entry(i);
+
+        view.data = data_ + e.offset;
+        view.size = e.length;
+        std::memcpy(&view.header, view.data, sizeof(view.header));
+        return view;
+    }
+
+private:
+    static bool map(const std::string &path, const uint8_t *&ptr, size_t &size) {
+        struct stat st;
+        int         fd = ::open(path.c_str(), O_RDONLY);
+        void       *p;
+
+        if (fd < 0) {
+            return false;
+        }
+        if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+            ::close(fd);
+            errno = EINVAL;
+            return false;
+        }
+        p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        ptr  = static_cast<const uint8_t *>(p);
+        size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    const uint8_t *data_      = nullptr;
+    size_t         dataSize_  = 0;
+    const uint8_t *index_     = nullptr;
+    size_t         indexSize_ = 0;
+    size_t         numFrames_ = 0;
+};
+
+} // namespace radar
+
+#endif /* RECORDING_HPP */
@@ -0,0 +1,180 @@
+#ifndef RECORDING_FORMAT_H
+#define RECORDING_FORMAT_H
+
+/**
+ * @file recording_format.h
+ * @brief File format of frame recordings (written by frame_record).
+ *
+ * A recording consists of two files (all fields little endian):
+ *
+ * `<name>` (data file):
+ * | Offset                   | Content                                                        |
+ * |--------------------------|----------------------------------------------------------------|
+ * | 0                        | Recording_Header, zero padded to headerSize                    |
+ * | headerSize               | frame 0 as received (frame_protocol.h: header, TLVs, CRC)       |
+ * | multiple of alignment    | frame 1, ...                                                   |
+ *
+ * `<name>.idx` (index):
+ * | Offset                   | Content                                                        |
+ * |--------------------------|----------------------------------------------------------------|
+ * | 0                        | Recording_IndexHeader                                          |
+ * | 16 + i * 32              | Recording_IndexEntry of frame i                                |
+ *
+ * Both files are only appended to, so memory usage of the recorder does not
+ * grow with the length of a recording and a recording interrupted by a crash
+ * stays readable up to the last complete index entry. Every frame starts at a
+ * multiple of the alignment (by default the page size), so frames can be
+ * mapped and handed out without copying; with frames of constant length the
+ * payloads form a regularly strided array (see scripts/recording.py).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of the recording format.
+ */
+#define RECORDING_VERSION               (1U)
+
+/**
+ * @brief Magic words at the start of the data file and the index.
+ */
+#define RECORDING_MAGIC                 "RADARREC"
+#define RECORDING_INDEX_MAGIC           "RADARIDX"
+
+/**
+ * @brief Default alignment of the frames in the data file.
+ */
+#define RECORDING_DEFAULT_ALIGNMENT     (4096U)
+
+/*!
+ * @brief Sensor configuration of the recording (from defines.h).
+ */
+typedef struct Recording_Config_t
+{
+    /*! @brief Number of ADC samples per chirp (CLI_NUM_ADC_SAMPLES) */
+    uint32_t numAdcSamples;
+
+    /*! @brief Number of range bins (CLI_NUM_RBINS times APP_RANGE_FFT_ZERO_PAD) */
+    uint32_t numRangeBins;
+
+    /*! @brief RX channel mask (CLI_CHA_CFG_RX_BITMASK) */
+    uint32_t rxChannelMask;
+
+    /*! @brief TX channel mask (CLI_CHA_CFG_TX_BITMASK) */
+    uint32_t txChannelMask;
+
+    /*! @brief Number of virtual antennas (RX x TX) */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of chirps per burst (CLI_NUM_CHIRPS_PER_BURST) */
+    uint32_t numChirpsPerBurst;
+
+    /*! @brief Number of bursts per frame (CLI_NUM_BURSTS_PER_FRAME) */
+    uint32_t numBurstsPerFrame;
+
+    /*! @brief Number of Doppler chirps per frame (chirps of ADC data per frame / TX antennas) */
+    uint32_t numDopplerChirps;
+
+    /*! @brief Number of accumulated chirps (CLI_NUM_CHIRPS_ACCUM) */
+    uint32_t numChirpsAccum;
+
+    /*! @brief Frame period in ms (CLI_FRAME_PERIOD) */
+    float    framePeriodMs;
+
+    /*! @brief Start frequency in GHz (CLI_START_FREQ) */
+    float    startFreqGHz;
+
+    /*! @brief Chirp slope in MHz/us (CLI_CHIRP_SLOPE) */
+    float    chirpSlopeMHzPerUs;
+
+    /*! @brief Ramp end time in us (CLI_CHIRP_RAMP_END_TIME) */
+    float    rampEndTimeUs;
+
+    /*! @brief Chirp idle time in us (CLI_CHIRP_IDLE_TIME) */
+    float    idleTimeUs;
+
+    /*! @brief ADC sampling rate in Msps (CLI_ADC_SAMPLING_RATE) */
+    float    adcSamplingRateMsps;
+
+    /*! @brief Reserved, set to 0 */
+    uint32_t reserved;
+} Recording_Config;
+
+/*!
+ * @brief Header at the start of the data file.
+ */
+typedef struct Recording_Header_t
+{
+    /*! @brief RECORDING_MAGIC (not zero terminated) */
+    char     magic[8];
+
+    /*! @brief RECORDING_VERSION */
+    uint32_t version;
+
+    /*! @brief Offset of the first frame, a multiple of alignment */
+    uint32_t headerSize;
+
+    /*! @brief Every frame starts at a multiple of this, a power of two */
+    uint32_t alignment;
+
+    /*! @brief Reserved, set to 0 */
+    uint32_t reserved;
+
+    /*! @brief Host time at the start of the recording in ns since the Unix epoch */
+    uint64_t startTimeNs;
+
+    /*! @brief Sensor configuration */
+    Recording_Config config;
+
+    /*! @brief Source of the frames (device or file name), zero terminated */
+    char     source[64];
+} Recording_Header;
+
+/*!
+ * @brief Header of the index file.
+ */
+typedef struct Recording_IndexHeader_t
+{
+    /*! @brief RECORDING_INDEX_MAGIC (not zero terminated) */
+    char     magic[8];
+
+    /*! @brief RECORDING_VERSION */
+    uint32_t version;
+
+    /*! @brief Size of Recording_IndexEntry in bytes */
+    uint32_t entrySize;
+} Recording_IndexHeader;
+
+/*!
+ * @brief Index entry of one frame.
+ */
+typedef struct Recording_IndexEntry_t
+{
+    /*! @brief Offset of the frame in the data file */
+    uint64_t offset;
+
+    /*! @brief Length of the frame in bytes */
+    uint32_t length;
+
+    /*! @brief Frame counter from the frame header */
+    uint32_t frameCount;
+
+    /*! @brief Device timestamp from the frame header */
+    uint32_t timestamp;
+
+    /*! @brief Reserved, set to 0 */
+    uint32_t reserved;
+
+    /*! @brief Host time of reception in ns since the Unix epoch */
+    uint64_t hostTimeNs;
+} Recording_IndexEntry;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RECORDING_FORMAT_H */
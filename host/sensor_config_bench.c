@@ -0,0 +1,341 @@
+/**
+ * @file sensor_config_bench.c
+ * @brief Host check and benchmark of the .cfg parser (SensorConfig_parseLine() in sensor_config.c).
+ *
+ * - defaults: the .cfg file defines.h was generated from (PresenceDetect.cfg,
+ *   with the other commands of the SDK demo in between) has to give exactly
+ *   the parameters of defines.h and pass SensorConfig_check(),
+ * - lines: malformed lines (wrong number of parameters, signs, values out of
+ *   range, garbage after a number, too long) are rejected and leave the
+ *   configuration unchanged; comments, blank lines, CR LF and hexadecimal
+ *   values are accepted,
+ * - checks: configurations outside the limits of the device (channel masks,
+ *   MIMO, RF band, burst and frame timing) fail SensorConfig_check(),
+ * - run time per line.
+ *
+ * With a .cfg file as argument it is parsed instead, e.g. before it is sent to
+ * a device: the resulting configuration is printed and checked against the
+ * device and the firmware build of defines.h and proc_config.h (ADC samples,
+ * TX and RX channels and chirps per frame, as rangeProc_checkConfig()).
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -I minimal_rangeproc_impl/include host/sensor_config_bench.c \
+ *     minimal_rangeproc_impl/src/sensor_config.c -o sensor_config_bench
+ * ./sensor_config_bench [file.cfg]
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "defines.h"
+#include "proc_config.h"
+#include "range_window.h"
+#include "sensor_config.h"
+
+#define NUM_TIMING_RUNS     (20000U)
+
+/* PresenceDetect.cfg, which defines.h was generated from */
+static const char *gDefaultCfg[] = {
+    "% PresenceDetect.cfg\r\n",
+    "sensorStop 0\r\n",
+    "channelCfg 7 3 0\r\n",
+    "chirpComnCfg 20 0 0 128 4 30 0\r\n",
+    "chirpTimingCfg 6 28 0 90 59.75\r\n",
+    "frameCfg 8 0 403 1 250 0\r\n",
+    "guiMonitor 1 1 0 0 0 1\r\n",
+    "cfarProcCfg 0 2 8 4 3 0 9.0 0\r\n",
+    "\r\n",
+    "factoryCalibCfg 1 0 40 0 0x1ff000\r\n",
+    "  % indented comment\n",
+    "sensorStart 0 0 0 0\r\n"
+};
+
+typedef struct LineCase_t
+{
+    const char *line;
+    int32_t     result;
+} LineCase;
+
+static const LineCase gLineCases[] = {
+    { "channelCfg 7 3", SENSOR_CONFIG_EINVAL },                         /* too few parameters */
+    { "channelCfg 7 3 0 0", SENSOR_CONFIG_EINVAL },                     /* too many parameters */
+    { "channelCfg 7 3 0 0 0 0 0 0 0 0", SENSOR_CONFIG_EINVAL },         /* more than SENSOR_CONFIG_MAX_PARAMS */
+    { "channelCfg -7 3 0", SENSOR_CONFIG_EINVAL },                      /* sign */
+    { "channelCfg +7 3 0", SENSOR_CONFIG_EINVAL },
+    { "channelCfg 7x 3 0", SENSOR_CONFIG_EINVAL },                      /* garbage after the number */
+    { "channelCfg 7.0 3 0", SENSOR_CONFIG_EINVAL },                     /* float for an integer */
+    { "channelCfg 0x 3 0", SENSOR_CONFIG_EINVAL },
+    { "channelCfg 65536 3 0", SENSOR_CONFIG_EINVAL },                   /* beyond uint16_t */
+    { "chirpComnCfg 256 0 0 128 4 30 0", SENSOR_CONFIG_EINVAL },        /* beyond uint8_t */
+    { "chirpComnCfg 20 0 0 128 4 30us 0", SENSOR_CONFIG_EINVAL },
+    { "chirpComnCfg 20 0 0 128 4 nan 0", SENSOR_CONFIG_EINVAL },
+    { "chirpComnCfg 20 0 0 128 4 1e30 0", SENSOR_CONFIG_EINVAL },
+    { "factoryCalibCfg 2 0 40 0 0x1ff000", SENSOR_CONFIG_EINVAL },      /* saveEnable 0 or 1 */
+    { "factoryCalibCfg 1 0 40 0 0x100000000", SENSOR_CONFIG_EINVAL },   /* beyond uint32_t */
+    { "ChannelCfg 7 3 0", SENSOR_CONFIG_SUCCESS },                      /* other command, case sensitive */
+    { "channelCfg\t5 1 0", SENSOR_CONFIG_SUCCESS },
+    { "factoryCalibCfg 0 1 30 3 0XFF000", SENSOR_CONFIG_SUCCESS },
+    { "chirpTimingCfg 6.5 28 -1 8.5e1 60", SENSOR_CONFIG_SUCCESS },
+    { "   ", SENSOR_CONFIG_SUCCESS },
+    { "%channelCfg 7 3", SENSOR_CONFIG_SUCCESS }
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* parameters of defines.h in .cfg units, as Mmwave_populateDefaultSensorCfg() */
+static void defaultConfig(SensorConfig *cfg) {
+    memset(cfg, 0, sizeof(SensorConfig));
+    cfg->rxChCtrlBitMask     = CLI_CHA_CFG_RX_BITMASK;
+    cfg->txChCtrlBitMask     = CLI_CHA_CFG_TX_BITMASK;
+    cfg->miscCtrl            = CLI_CHA_CFG_MISC_CTRL;
+    cfg->digOutputSampRate   = CLI_DIG_OUT_SAMPLING_RATE;
+    cfg->digOutputBitsSel    = CLI_DIG_OUT_BITS_SEL;
+    cfg->dfeFirSel           = CLI_DFE_FIR_SEL;
+    cfg->numOfAdcSamples     = CLI_NUM_ADC_SAMPLES;
+    cfg->chirpTxMimoPatSel   = CLI_MIMO_SEL;
+    cfg->chirpRampEndTime    = CLI_CHIRP_RAMP_END_TIME / 10.0;
+    cfg->chirpRxHpfSel       = CLI_CHIRP_RX_HPF_SEL;
+    cfg->chirpIdleTime       = CLI_CHIRP_IDLE_TIME / 10.0;
+    cfg->chirpAdcSkipSamples = CLI_CHIRP_ADC_START_TIME >> 10;
+    cfg->chirpTxStartTime    = CLI_CHIRP_TX_START_TIME / 50.0;
+    cfg->chirpRfFreqSlope    = CLI_CHIRP_SLOPE;
+    cfg->chirpRfFreqStart    = CLI_START_FREQ;
+    cfg->numOfChirpsInBurst  = CLI_NUM_CHIRPS_PER_BURST;
+    cfg->numOfChirpsAccum    = CLI_NUM_CHIRPS_ACCUM;
+    cfg->burstPeriodicity    = CLI_BURST_PERIOD;
+    cfg->numOfBurstsInFrame  = CLI_NUM_BURSTS_PER_FRAME;
+    cfg->framePeriodicity    = CLI_FRAME_PERIOD / 40000.0;
+    cfg->numOfFrames         = CLI_NUM_FRAMES;
+    cfg->rxGain              = CLI_FACCALCFG_RX_GAIN;
+    cfg->txBackoff           = (CLI_FACCALCFG_TX_BACKOFF_SEL) / 2;
+    cfg->flashOffset         = CLI_FACCALCFG_FLASH_OFFSET;
+    cfg->frameTrigMode       = CLI_SENSOR_START_FRM_TRIG;
+    cfg->chirpStartSigLbEn   = CLI_SENSOR_START_LB_EN;
+    cfg->frameLivMonEn       = CLI_SENSOR_START_MON_EN;
+    cfg->frameTrigTimerVal   = CLI_SENSOR_START_TRIG_TIMER;
+}
+
+/* field by field, the padding of the structs is not defined */
+static int sameConfig(const SensorConfig *a, const SensorConfig *b) {
+    return (a->rxChCtrlBitMask == b->rxChCtrlBitMask) && (a->txChCtrlBitMask == b->txChCtrlBitMask) &&
+           (a->miscCtrl == b->miscCtrl) && (a->digOutputSampRate == b->digOutputSampRate) &&
+           (a->digOutputBitsSel == b->digOutputBitsSel) && (a->dfeFirSel == b->dfeFirSel) &&
+           (a->numOfAdcSamples == b->numOfAdcSamples) && (a->chirpTxMimoPatSel == b->chirpTxMimoPatSel) &&
+           (a->chirpRampEndTime == b->chirpRampEndTime) && (a->chirpRxHpfSel == b->chirpRxHpfSel) &&
+           (a->chirpIdleTime == b->chirpIdleTime) && (a->chirpAdcSkipSamples == b->chirpAdcSkipSamples) &&
+           (a->chirpTxStartTime == b->chirpTxStartTime) && (a->chirpRfFreqSlope == b->chirpRfFreqSlope) &&
+           (a->chirpRfFreqStart == b->chirpRfFreqStart) && (a->numOfChirpsInBurst == b->numOfChirpsInBurst) &&
+           (a->numOfChirpsAccum == b->numOfChirpsAccum) && (a->burstPeriodicity == b->burstPeriodicity) &&
+           (a->numOfBurstsInFrame == b->numOfBurstsInFrame) && (a->framePeriodicity == b->framePeriodicity) &&
+           (a->numOfFrames == b->numOfFrames) && (a->rxGain == b->rxGain) && (a->txBackoff == b->txBackoff) &&
+           (a->flashOffset == b->flashOffset) && (a->frameTrigMode == b->frameTrigMode) &&
+           (a->chirpStartSigLbEn == b->chirpStartSigLbEn) && (a->frameLivMonEn == b->frameLivMonEn) &&
+           (a->frameTrigTimerVal == b->frameTrigTimerVal);
+}
+
+static void printConfig(const SensorConfig *cfg) {
+    printf("channelCfg %u %u %u\n", cfg->rxChCtrlBitMask, cfg->txChCtrlBitMask, cfg->miscCtrl);
+    printf("chirpComnCfg %u %u %u %u %u %g %u\n", cfg->digOutputSampRate, cfg->digOutputBitsSel, cfg->dfeFirSel,
+           cfg->numOfAdcSamples, cfg->chirpTxMimoPatSel, cfg->chirpRampEndTime, cfg->chirpRxHpfSel);
+    printf("chirpTimingCfg %g %u %g %g %g\n", cfg->chirpIdleTime, cfg->chirpAdcSkipSamples, cfg->chirpTxStartTime,
+           cfg->chirpRfFreqSlope, cfg->chirpRfFreqStart);
+    printf("frameCfg %u %u %g %u %g %u\n", cfg->numOfChirpsInBurst, cfg->numOfChirpsAccum, cfg->burstPeriodicity,
+           cfg->numOfBurstsInFrame, cfg->framePeriodicity, cfg->numOfFrames);
+    printf("factoryCalibCfg - - %u %u 0x%x\n", cfg->rxGain, cfg->txBackoff, cfg->flashOffset);
+    printf("sensorStart %u %u %u %u\n", cfg->frameTrigMode, cfg->chirpStartSigLbEn, cfg->frameLivMonEn,
+           cfg->frameTrigTimerVal);
+}
+
+/* limits of the firmware build, as rangeProc_checkConfig() */
+static int checkBuild(const SensorConfig *cfg) {
+    uint32_t numTx     = SensorConfig_numChannels(cfg->txChCtrlBitMask);
+    uint32_t numChirps = (uint32_t) cfg->numOfChirpsInBurst * cfg->numOfBurstsInFrame;
+    int      ok        = 1;
+
+    if (SensorConfig_check(cfg) != SENSOR_CONFIG_SUCCESS) {
+        printf("outside the limits of the device\n");
+        return 0;
+    }
+    if ((cfg->numOfAdcSamples != RANGE_WINDOW_NUM_SAMPLES) ||
+        (numTx != SensorConfig_numChannels(CLI_CHA_CFG_TX_BITMASK)) ||
+        (SensorConfig_numChannels(cfg->rxChCtrlBitMask) != SensorConfig_numChannels(CLI_CHA_CFG_RX_BITMASK))) {
+        printf("ADC samples and number of TX/RX channels must match defines.h\n");
+        ok = 0;
+    }
+    if ((numChirps > CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST) || (numChirps / numTx <= APP_TX_CHIRP_IDX)) {
+        printf("%u chirps per frame, at most %u and more than APP_TX_CHIRP_IDX\n", numChirps,
+               CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST);
+        ok = 0;
+    }
+#if APP_MINOR_MOTION_ENABLE
+    if (numChirps < APP_MINOR_MOTION_CHIRPS_PER_FRAME) {
+        printf("fewer chirps per frame than APP_MINOR_MOTION_CHIRPS_PER_FRAME\n");
+        ok = 0;
+    }
+#endif
+    return ok;
+}
+
+static int parseFile(const char *path) {
+    SensorConfig         cfg;
+    SensorConfig_Command cmd;
+    char                 line[1024];
+    uint32_t             lineNo = 0U, numErrors = 0U, started = 0U;
+    FILE                *f = fopen(path, "r");
+
+    if (f == NULL) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    defaultConfig(&cfg);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        lineNo++;
+        if (SensorConfig_parseLine(&cfg, line, &cmd) != SENSOR_CONFIG_SUCCESS) {
+            printf("%s:%u: error: %s", path, lineNo, line);
+            numErrors++;
+        }
+        started |= (cmd == SENSOR_CONFIG_CMD_SENSOR_START) ? 1U : 0U;
+    }
+    fclose(f);
+
+    printConfig(&cfg);
+    if (started == 0U) {
+        printf("no sensorStart, the device would not apply the configuration\n");
+    }
+    if (!checkBuild(&cfg) || (numErrors != 0U) || (started == 0U)) {
+        printf("configuration rejected\n");
+        return 1;
+    }
+    printf("configuration accepted\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    SensorConfig         cfg, expected, before;
+    SensorConfig_Command cmd;
+    char                 longLine[SENSOR_CONFIG_MAX_LINE_LEN + 16U];
+    uint32_t             numLines = sizeof(gDefaultCfg) / sizeof(gDefaultCfg[0]);
+    uint32_t             failures = 0U, i, run;
+    double               t0, time;
+
+    if (argc > 1) {
+        return parseFile(argv[1]);
+    }
+
+    /* defaults: start from zero, so every field has to come from the file */
+    memset(&cfg, 0, sizeof(cfg));
+    defaultConfig(&expected);
+    for (i = 0; i < numLines; i++) {
+        if (SensorConfig_parseLine(&cfg, gDefaultCfg[i], &cmd) != SENSOR_CONFIG_SUCCESS) {
+            printf("defaults: error in %s", gDefaultCfg[i]);
+            failures++;
+        }
+    }
+    if (!sameConfig(&cfg, &expected) || (SensorConfig_check(&cfg) != SENSOR_CONFIG_SUCCESS)) {
+        printf("defaults: configuration differs from defines.h or fails SensorConfig_check()\n");
+        printConfig(&cfg);
+        failures++;
+    }
+    printf("defaults: %s\n", (failures == 0U) ? "match defines.h" : "MISMATCH");
+
+    /* lines: errors leave the configuration unchanged */
+    for (i = 0; i < sizeof(gLineCases) / sizeof(gLineCases[0]); i++) {
+        int32_t result;
+
+        defaultConfig(&cfg);
+        before = cfg;
+        result = SensorConfig_parseLine(&cfg, gLineCases[i].line, &cmd);
+        if ((result != gLineCases[i].result) || ((result != SENSOR_CONFIG_SUCCESS) && !sameConfig(&cfg, &before))) {
+            printf("lines: '%s' gives %d, expected %d\n", gLineCases[i].line, result, gLineCases[i].result);
+            failures++;
+        }
+    }
+    memset(longLine, 0, sizeof(longLine));
+    memcpy(longLine, "channelCfg 7 3 0", strlen("channelCfg 7 3 0"));
+    memset(longLine + strlen(longLine), ' ', SENSOR_CONFIG_MAX_LINE_LEN);
+    if (SensorConfig_parseLine(&cfg, longLine, &cmd) != SENSOR_CONFIG_EINVAL) {
+        printf("lines: line of %u characters accepted\n", (uint32_t) strlen(longLine));
+        failures++;
+    }
+
+    /* checks: one parameter at a time outside the limits of the device */
+    {
+        static const char *badLines[] = {
+            "channelCfg 0 3 0",                     /* no RX */
+            "channelCfg 8 3 0",                     /* RX beyond the device */
+            "channelCfg 7 4 0",                     /* TX beyond the device */
+            "channelCfg 7 1 0\nchirpComnCfg 20 0 0 128 4 30 0",    /* BPM with one TX */
+            "chirpComnCfg 20 0 0 128 2 30 0",       /* MIMO pattern */
+            "chirpComnCfg 0 0 0 128 4 30 0",        /* sampling rate */
+            "chirpComnCfg 20 0 0 0 4 30 0",         /* ADC samples */
+            "chirpTimingCfg 6 28 0 90 56.5",        /* start below the band */
+            "chirpTimingCfg 6 28 0 150 59.75",      /* end above the band */
+            "chirpTimingCfg 6 28 0 0 59.75",        /* slope */
+            "frameCfg 7 0 403 1 250 0",             /* chirps not a multiple of the TX */
+            "frameCfg 12 0 403 1 250 0",            /* chirps longer than the burst */
+            "frameCfg 8 3 403 1 250 0",             /* chirps not a multiple of the accumulation */
+            "frameCfg 6 2 403 1 250 0",             /* accumulated chirps not a multiple of the TX */
+            "frameCfg 8 0 403 2 0.5 0"              /* bursts longer than the frame */
+        };
+
+        for (i = 0; i < sizeof(badLines) / sizeof(badLines[0]); i++) {
+            char        line[128];
+            const char *c = badLines[i];
+
+            defaultConfig(&cfg);
+            /* one or two lines */
+            while (*c != '\0') {
+                size_t len = strcspn(c, "\n");
+
+                memcpy(line, c, len);
+                line[len] = '\0';
+                if (SensorConfig_parseLine(&cfg, line, &cmd) != SENSOR_CONFIG_SUCCESS) {
+                    printf("checks: '%s' not parsed\n", line);
+                    failures++;
+                }
+                c += len + ((c[len] == '\n') ? 1U : 0U);
+            }
+            if (SensorConfig_check(&cfg) != SENSOR_CONFIG_EINVAL) {
+                printf("checks: '%s' passes SensorConfig_check()\n", badLines[i]);
+                failures++;
+            }
+        }
+    }
+
+    /* hardware chirp accumulation: the accumulated chirps take burst time, the DPU only sees their sum */
+    defaultConfig(&cfg);
+    if ((SensorConfig_parseLine(&cfg, "frameCfg 8 4 403 1 250 0", &cmd) != SENSOR_CONFIG_SUCCESS) ||
+        (SensorConfig_check(&cfg) != SENSOR_CONFIG_SUCCESS) || (SensorConfig_numAdcChirps(&cfg) != 2U) ||
+        (SensorConfig_accumGrowthBits(&cfg) != 2U)) {
+        printf("checks: 'frameCfg 8 4 403 1 250 0' not accepted as 2 chirps of ADC data with 2 bits growth\n");
+        failures++;
+    }
+    cfg.numOfChirpsAccum = 1U;
+    if ((SensorConfig_numAdcChirps(&cfg) != 8U) || (SensorConfig_accumGrowthBits(&cfg) != 0U)) {
+        printf("checks: accumulation of 1 chirp not treated as none\n");
+        failures++;
+    }
+    printf("lines and checks: %s\n", (failures == 0U) ? "as expected" : "FAILED");
+
+    /* run time */
+    t0 = now();
+    for (run = 0; run < NUM_TIMING_RUNS; run++) {
+        for (i = 0; i < numLines; i++) {
+            SensorConfig_parseLine(&cfg, gDefaultCfg[i], &cmd);
+        }
+    }
+    time = (now() - t0) / (NUM_TIMING_RUNS * numLines);
+    printf("%.3f us/line\n", time * 1e6);
+
+    printf("%u failures\n", failures);
+    return (failures != 0U) ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Lock-free single producer / single consumer queue of preallocated slots.
+ *
+ * The elements are constructed once and reused: the producer fills the slot
+ * returned by beginPush() in place and publishes it with endPush(), the consumer
+ * processes front() in place and releases it with pop(). Nothing is allocated
+ * or copied by the queue itself after construction.
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace radar {
+
+template <class T>
+class SpscQueue {
+public:
+    /**
+     * @param[in] capacity Number of slots, rounded up to a power of two.
+     * @param[in] init     Value every slot is initialized with.
+     */
+    explicit SpscQueue(size_t capacity, const T &init = T()) : slots_(roundUp(capacity), init), mask_(slots_.size() - 1U) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /** @brief Producer: returns the next free slot, nullptr if the queue is full. */
+    T *beginPush() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots_.size()) {
+            return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    /** @brief Producer: publishes the slot returned by beginPush(). */
+    void endPush() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    }
+
+    /** @brief Consumer: returns the oldest published slot, nullptr if the queue is empty. */
+    T *front() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    /** @brief Consumer: releases the slot returned by front(). */
+    void pop() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t roundUp(size_t n) {
+        size_t r = 1U;
+        while (r < n) {
+            r <<= 1;
+        }
+        return r;
+    }
+
+    std::vector<T> slots_;
+    size_t         mask_;
+
+    /* producer and consumer indices on separate cache lines */
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+} // namespace radar
+
+#endif /* SPSC_QUEUE_HPP */
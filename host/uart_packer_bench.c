@@ -0,0 +1,170 @@
+/**
+ * @file uart_packer_bench.c
+ * @brief Host benchmark of the UART frame transmission against a mock UART.
+ *
+ * Compares the former transmission (one UART_write() per range bin plus header
+ * and footer) with the packed transmission (whole frame assembled by the frame
+ * packer and sent in one UART_write()) and with the TLV frame format of
+ * frame_protocol.h, which is what the firmware sends. The mock UART counts
+ * calls and bytes per frame and charges a configurable fixed cost per call,
+ * which models the driver overhead (transaction setup, semaphore handling, ...)
+ * on the device.
+ *
+ * Build and run from the repository root:
+ * @code
+ * gcc -O2 -Wall -I minimal_rangeproc_impl/include host/uart_packer_bench.c \
+ *     minimal_rangeproc_impl/src/frame_packer.c minimal_rangeproc_impl/src/frame_protocol.c \
+ *     -o uart_packer_bench
+ * ./uart_packer_bench [num range bins] [baud rate] [per call overhead in us]
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "frame_packer.h"
+#include "frame_protocol.h"
+
+#define NUM_FRAMES      (100000U)
+#define MAX_RANGE_BINS  (1024U)
+#define SAMPLE_SIZE     (4U)        // cmplx16ImRe_t
+
+/*! @brief Statistics gathered by the mock UART */
+typedef struct {
+    uint64_t numCalls;
+    uint64_t numBytes;
+    uint32_t checksum;
+} MockUart;
+
+static const uint8_t header[4] = {0xAA, 0xBB, 0xCC, 0xDD};
+static const uint8_t footer[4] = {0xDD, 0xCC, 0xBB, 0xAA};
+
+static uint8_t gRadarCube[MAX_RANGE_BINS * SAMPLE_SIZE];
+static uint8_t gUartBuffer[1024U + MAX_RANGE_BINS * SAMPLE_SIZE];
+
+/* Replacement of UART_write(), touches every byte so the transfer cannot be optimized away */
+static void mockUart_write(MockUart *uart, const void *buf, uint32_t count) {
+    const uint8_t *bytes = (const uint8_t *) buf;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        uart->checksum = (uart->checksum * 31U) + bytes[i];
+    }
+    uart->numCalls++;
+    uart->numBytes += count;
+}
+
+static void transmitPerBin(MockUart *uart, uint32_t numRangeBins) {
+    uint32_t i;
+
+    mockUart_write(uart, header, sizeof(header));
+    for (i = 0; i < numRangeBins; i++) {
+        mockUart_write(uart, &gRadarCube[i * SAMPLE_SIZE], SAMPLE_SIZE);
+    }
+    mockUart_write(uart, footer, sizeof(footer));
+}
+
+static void transmitPacked(MockUart *uart, uint32_t numRangeBins) {
+    FramePacker packer;
+    int32_t retVal;
+
+    FramePacker_init(&packer, gUartBuffer, sizeof(gUartBuffer));
+    retVal  = FramePacker_append(&packer, header, sizeof(header));
+    retVal |= FramePacker_append(&packer, gRadarCube, numRangeBins * SAMPLE_SIZE);
+    retVal |= FramePacker_append(&packer, footer, sizeof(footer));
+    if (retVal != FRAME_PACKER_SUCCESS) {
+        fprintf(stderr, "frame does not fit into transmit buffer\n");
+        exit(1);
+    }
+    mockUart_write(uart, gUartBuffer, packer.len);
+}
+
+static void transmitTlv(MockUart *uart, uint32_t numRangeBins) {
+    FramePacker              packer;
+    FrameProto_Header        header;
+    FrameProto_RangeProfile *rangeProfile;
+    uint32_t                 frameLen;
+
+    memset(&header, 0, sizeof(header));
+    header.numRangeBins       = (uint16_t) numRangeBins;
+    header.numDopplerChirps   = 4U;
+    header.numVirtualAntennas = 6U;
+
+    FramePacker_init(&packer, gUartBuffer, sizeof(gUartBuffer));
+    FrameProto_begin(&packer, &header);
+    rangeProfile = (FrameProto_RangeProfile *) FrameProto_addTlv(&packer, FRAME_PROTO_TLV_RANGE_PROFILE,
+                                                                sizeof(FrameProto_RangeProfile) + numRangeBins * SAMPLE_SIZE);
+    if (rangeProfile != NULL) {
+        memset(rangeProfile, 0, sizeof(FrameProto_RangeProfile));
+        rangeProfile->numBins = (uint16_t) numRangeBins;
+        memcpy(rangeProfile + 1, gRadarCube, numRangeBins * SAMPLE_SIZE);
+    }
+    frameLen = FrameProto_end(&packer);
+    if ((rangeProfile == NULL) || (frameLen == 0U)) {
+        fprintf(stderr, "frame does not fit into transmit buffer\n");
+        exit(1);
+    }
+    mockUart_write(uart, gUartBuffer, frameLen);
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void runBenchmark(const char *name,
+                         void (*transmit)(MockUart *, uint32_t),
+                         uint32_t numRangeBins,
+                         double baudRate,
+                         double callOverheadUs) {
+    MockUart uart;
+    double   start, elapsed;
+    double   callsPerFrame, bytesPerFrame, linkTimeUs;
+    uint32_t frame;
+
+    memset(&uart, 0, sizeof(uart));
+
+    start = nowSeconds();
+    for (frame = 0; frame < NUM_FRAMES; frame++) {
+        transmit(&uart, numRangeBins);
+    }
+    elapsed = nowSeconds() - start;
+
+    callsPerFrame = (double) uart.numCalls / NUM_FRAMES;
+    bytesPerFrame = (double) uart.numBytes / NUM_FRAMES;
+    /* 8N1: 10 bits on the wire per byte */
+    linkTimeUs = (bytesPerFrame * 10.0 * 1e6 / baudRate) + (callsPerFrame * callOverheadUs);
+
+    printf("%-8s calls/frame: %6.1f  bytes/frame: %6.1f  host time/frame: %7.3f us  "
+           "modeled link time/frame: %9.1f us  max frame rate: %7.1f Hz  (checksum %08x)\n",
+           name, callsPerFrame, bytesPerFrame, elapsed * 1e6 / NUM_FRAMES,
+           linkTimeUs, 1e6 / linkTimeUs, uart.checksum);
+}
+
+int main(int argc, char **argv) {
+    uint32_t numRangeBins   = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : 64U;
+    double   baudRate       = (argc > 2) ? strtod(argv[2], NULL) : 115200.0;
+    double   callOverheadUs = (argc > 3) ? strtod(argv[3], NULL) : 20.0;
+    uint32_t i;
+
+    if ((numRangeBins == 0U) || (numRangeBins > MAX_RANGE_BINS)) {
+        fprintf(stderr, "number of range bins must be in [1, %u]\n", MAX_RANGE_BINS);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(gRadarCube); i++) {
+        gRadarCube[i] = (uint8_t) (i * 7U);
+    }
+
+    printf("range bins: %u, baud rate: %.0f, per call overhead: %.1f us, frames: %u\n",
+           numRangeBins, baudRate, callOverheadUs, NUM_FRAMES);
+    runBenchmark("per-bin", transmitPerBin, numRangeBins, baudRate, callOverheadUs);
+    runBenchmark("packed", transmitPacked, numRangeBins, baudRate, callOverheadUs);
+    runBenchmark("tlv", transmitTlv, numRangeBins, baudRate, callOverheadUs);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#ifndef CFAR_H
+#define CFAR_H
+
+/**
+ * @file cfar.h
+ * @brief CFAR detection on a range profile or range-Doppler heat map.
+ *
+ * The input is a map of magnitudes Map[range][doppler] of uint16_t (the heat
+ * map of doppler_proc.h, or a range profile with numDopplerBins = 1). Every
+ * cell is compared with a noise estimate from the training cells on both sides
+ * along the range axis, guard cells next to the cell under test are skipped:
+ *
+ *     | train | guard | CUT | guard | train |      -> range
+ *
+ * - CFAR_MODE_CA:   mean of all training cells
+ * - CFAR_MODE_CAGO: greater of the means of the two sides (clutter edges)
+ * - CFAR_MODE_CASO: smaller of the means of the two sides (closely spaced targets)
+ * - CFAR_MODE_OS:   osRank-th smallest training cell (robust against interfering targets)
+ *
+ * At the ends of the range axis only the existing training cells are used (the
+ * OS rank is scaled accordingly). A cell is detected if it exceeds the noise
+ * estimate times thresholdScaleQ8 / 256. Optionally the detection is confirmed
+ * by the same test along the (cyclic) Doppler axis and reduced to local maxima.
+ *
+ * The mean of the training cells is computed from prefix sums, so the cost per
+ * cell does not depend on the window length. CFAR_MODE_OS selects the rank per
+ * cell, with peak grouping only for the local maxima.
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/` (see `host/cfar_bench.c`).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define CFAR_SUCCESS            (0)
+#define CFAR_EINVAL             (-1)
+
+/**
+ * @brief Maximum number of training cells per side.
+ */
+#define CFAR_MAX_TRAIN_LEN      (32U)
+
+/**
+ * @brief Noise estimators.
+ */
+typedef enum Cfar_Mode_e
+{
+    /*! @brief Cell averaging */
+    CFAR_MODE_CA = 0,
+
+    /*! @brief Cell averaging, greater of the two sides */
+    CFAR_MODE_CAGO,
+
+    /*! @brief Cell averaging, smaller of the two sides */
+    CFAR_MODE_CASO,
+
+    /*! @brief Ordered statistic */
+    CFAR_MODE_OS
+} Cfar_Mode;
+
+/*!
+ * @brief Detector configuration.
+ */
+typedef struct Cfar_Config_t
+{
+    /*! @brief Noise estimator */
+    Cfar_Mode mode;
+
+    /*! @brief Number of guard cells on each side of the cell under test */
+    uint32_t guardLen;
+
+    /*! @brief Number of training cells on each side (1..CFAR_MAX_TRAIN_LEN) */
+    uint32_t trainLen;
+
+    /*! @brief CFAR_MODE_OS: 0-based rank of the noise estimate among the 2 * trainLen sorted training cells */
+    uint32_t osRank;
+
+    /*! @brief Threshold as ratio of cell and noise estimate in Q8 (e.g. 1024: 4.0, 12 dB) */
+    uint32_t thresholdScaleQ8;
+
+    /*! @brief 1: confirm detections with the same test along the Doppler axis (cyclic) */
+    uint32_t dopplerCheck;
+
+    /*! @brief 1: only report cells which are local maxima along range (and Doppler) */
+    uint32_t peakGrouping;
+} Cfar_Config;
+
+/*!
+ * @brief One detected cell.
+ */
+typedef struct Cfar_Detection_t
+{
+    /*! @brief Range bin */
+    uint16_t rangeBin;
+
+    /*! @brief Doppler bin (FFT order), 0 for range profiles */
+    uint16_t dopplerBin;
+
+    /*! @brief Magnitude of the cell */
+    uint16_t magnitude;
+
+    /*! @brief Ratio of magnitude and noise estimate in dB, Q8 */
+    int16_t snrDbQ8;
+} Cfar_Detection;
+
+/*!
+ * @brief Summary of one run.
+ */
+typedef struct Cfar_Result_t
+{
+    /*! @brief Number of detections written to the list */
+    uint32_t numDetections;
+
+    /*! @brief Number of detections which did not fit into the list */
+    uint32_t numDiscarded;
+} Cfar_Result;
+
+/**
+ * @brief Checks a configuration.
+ *
+ * @return CFAR_SUCCESS or CFAR_EINVAL.
+ */
+int32_t Cfar_checkConfig(const Cfar_Config *cfg);
+
+/**
+ * @brief Size of the workspace needed by Cfar_process() in bytes.
+ *
+ * @param[in] numRangeBins Number of range bins of the map.
+ */
+uint32_t Cfar_workspaceSize(uint32_t numRangeBins);
+
+/**
+ * @brief Detects the cells of a map which stand out of the noise.
+ *
+ * Detections are reported in the order of the map (range major).
+ *
+ * @param[in]  cfg            Configuration (see Cfar_checkConfig()).
+ * @param[in]  map            Map[numRangeBins][numDopplerBins] of magnitudes.
+ * @param[in]  numRangeBins   Number of range bins (rows).
+ * @param[in]  numDopplerBins Number of Doppler bins (columns), 1 for a range profile.
+ * @param[in]  workspace      Cfar_workspaceSize() bytes, 4 byte aligned.
+ * @param[out] detections     Detection list.
+ * @param[in]  maxDetections  Capacity of the detection list.
+ * @param[out] result         Number of detections.
+ *
+ * @return CFAR_SUCCESS or CFAR_EINVAL.
+ */
+int32_t Cfar_process(const Cfar_Config *cfg, const uint16_t *map, uint32_t numRangeBins, uint32_t numDopplerBins,
+                     void *workspace, Cfar_Detection *detections, uint32_t maxDetections, Cfar_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CFAR_H */
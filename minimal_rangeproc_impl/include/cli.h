@@ -0,0 +1,60 @@
+#ifndef CLI_H
+#define CLI_H
+
+/**
+ * @file cli.h
+ * @brief Command line interface: .cfg commands received over the UART (APP_CLI_ENABLE).
+ *
+ * The CLI task reads the UART byte by byte into lines and parses them with
+ * SensorConfig_parseLine() into a pending copy of the sensor configuration,
+ * starting from the active one. `sensorStart` completes a configuration: it
+ * is checked with rangeProc_checkConfig() and
+ *
+ * - during start-up (cli_waitForStart()) taken over as gSysContext.sensorCfg
+ *   before the sensor is set up,
+ * - once the sensor runs (cli_sensorRunning()) applied with
+ *   rangeProc_reconfigure().
+ *
+ * A line with an error (unknown parameters of a known command, values out of
+ * range, too long) invalidates the pending configuration up to the next
+ * `sensorStart`, which is then rejected; other commands of the SDK demos are
+ * ignored. Results are logged with DebugP_log(), the UART itself only carries
+ * the binary frames. The task runs below the DPC and UART tasks and only blocks
+ * itself while it waits for input or a reconfiguration.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Initializes the CLI, before its task is created.
+ *
+ * The pending configuration starts from gSysContext.sensorCfg, which has to
+ * hold the defaults of defines.h by then.
+ */
+void cli_init(void);
+
+/**
+ * @brief Task function of the CLI.
+ */
+void cliTask();
+
+/**
+ * @brief Waits for a configuration completed with `sensorStart` during start-up.
+ *
+ * Called by the main task after the CLI task has been created and before the
+ * sensor is set up from gSysContext.sensorCfg. A configuration received in time
+ * replaces gSysContext.sensorCfg, otherwise the defaults of defines.h remain.
+ * Until cli_sensorRunning(), further `sensorStart` commands are rejected.
+ *
+ * @param[in] timeoutMs Time to wait in ms, 0 to go on with the defaults right away.
+ *
+ * @return 1 if a configuration has been received, 0 if the defaults are used.
+ */
+uint32_t cli_waitForStart(uint32_t timeoutMs);
+
+/**
+ * @brief Signals that the sensor runs, later configurations are applied with rangeProc_reconfigure().
+ */
+void cli_sensorRunning(void);
+
+#endif /* CLI_H */
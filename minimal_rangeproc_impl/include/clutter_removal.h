@@ -0,0 +1,133 @@
+#ifndef CLUTTER_REMOVAL_H
+#define CLUTTER_REMOVAL_H
+
+/**
+ * @file clutter_removal.h
+ * @brief Static clutter removal on the radar cube.
+ *
+ * Static reflectors (walls, furniture) have the same complex value in every
+ * chirp of a range bin and virtual antenna, so they end up in the zero Doppler
+ * bin and their sidelobes swamp movers. This stage subtracts a background per
+ * range bin and antenna from every chirp of the radar cube (DPIF_RADARCUBE_FORMAT_6,
+ * see radar_cube.h), in place:
+ *
+ * - CLUTTER_REMOVAL_MODE_MEAN: the mean over the chirps of the current frame.
+ * - CLUTTER_REMOVAL_MODE_EMA:  an exponential average of the per-frame means,
+ *                              background += (mean - background) / 2^emaShift,
+ *                              kept in Q8 in the state buffer. Slow movers whose
+ *                              Doppler falls into the zero bin within one frame
+ *                              survive until the background has adapted.
+ *
+ * The means are rounded to the nearest integer (halves away from zero), the
+ * subtraction saturates to 16 bit. The subtraction works on both 16-bit halves
+ * of a sample at once, with the DSP extension of the M4F (__qsub16 of ACLE) or
+ * a plain C equivalent elsewhere, so the results are bit-exact on all targets.
+ *
+ * Only depends on the C standard library (radar_cube.h needs HOST_BUILD on the
+ * host), so this file is shared between the firmware and the host tools in
+ * `host/` (see `host/clutter_bench.c`).
+ */
+
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define CLUTTER_REMOVAL_SUCCESS         (0)
+#define CLUTTER_REMOVAL_EINVAL          (-1)
+
+/**
+ * @brief Maximum exponent of the averaging factor of CLUTTER_REMOVAL_MODE_EMA.
+ */
+#define CLUTTER_REMOVAL_MAX_EMA_SHIFT   (15U)
+
+/**
+ * @brief Background estimators.
+ */
+typedef enum ClutterRemoval_Mode_e
+{
+    /*! @brief Mean over the chirps of the frame */
+    CLUTTER_REMOVAL_MODE_MEAN = 0,
+
+    /*! @brief Exponential average of the per-frame means */
+    CLUTTER_REMOVAL_MODE_EMA
+} ClutterRemoval_Mode;
+
+/*!
+ * @brief Configuration of the clutter removal.
+ */
+typedef struct ClutterRemoval_Config_t
+{
+    /*! @brief Background estimator */
+    ClutterRemoval_Mode mode;
+
+    /*! @brief CLUTTER_REMOVAL_MODE_EMA: averaging factor 2^-emaShift (0..CLUTTER_REMOVAL_MAX_EMA_SHIFT) */
+    uint32_t emaShift;
+
+    /*! @brief Number of (Doppler) chirps of the radar cube */
+    uint32_t numChirps;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint32_t numAntennas;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint32_t numRangeBins;
+} ClutterRemoval_Config;
+
+/*!
+ * @brief State of the clutter removal.
+ */
+typedef struct ClutterRemoval_Obj_t
+{
+    /*! @brief Configuration */
+    ClutterRemoval_Config cfg;
+
+    /*! @brief CLUTTER_REMOVAL_MODE_EMA: background [antenna][range] as (imag, real) pairs in Q8, NULL otherwise */
+    int32_t *background;
+
+    /*! @brief The background holds at least one frame */
+    uint32_t backgroundValid;
+} ClutterRemoval_Obj;
+
+/**
+ * @brief Size of the state buffer needed by ClutterRemoval_init() in bytes (0 for CLUTTER_REMOVAL_MODE_MEAN).
+ */
+uint32_t ClutterRemoval_stateSize(const ClutterRemoval_Config *cfg);
+
+/**
+ * @brief Checks the configuration and attaches the state buffer.
+ *
+ * @param[out] obj   Clutter removal to initialize.
+ * @param[in]  cfg   Configuration.
+ * @param[in]  state ClutterRemoval_stateSize() bytes, 4 byte aligned (may be NULL if the size is 0).
+ *
+ * @return CLUTTER_REMOVAL_SUCCESS or CLUTTER_REMOVAL_EINVAL.
+ */
+int32_t ClutterRemoval_init(ClutterRemoval_Obj *obj, const ClutterRemoval_Config *cfg, void *state);
+
+/**
+ * @brief Forgets the background, the next frame starts the exponential average from its own mean.
+ */
+void ClutterRemoval_reset(ClutterRemoval_Obj *obj);
+
+/**
+ * @brief Subtracts the background from every chirp of the radar cube, in place.
+ *
+ * @param[in,out] obj  Initialized clutter removal.
+ * @param[in,out] cube Radar cube matching the configuration, 4 byte aligned.
+ *
+ * @return CLUTTER_REMOVAL_SUCCESS, CLUTTER_REMOVAL_EINVAL if the cube does not match the configuration.
+ */
+int32_t ClutterRemoval_process(ClutterRemoval_Obj *obj, RadarCube_View *cube);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLUTTER_REMOVAL_H */
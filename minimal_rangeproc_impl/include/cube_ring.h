@@ -0,0 +1,188 @@
+#ifndef CUBE_RING_H
+#define CUBE_RING_H
+
+/**
+ * @file cube_ring.h
+ * @brief Ring of the radar cubes of the last frames with pinned read handles.
+ *
+ * Slow-time processing (vital signs, long integration, micro-Doppler) needs
+ * the radar cubes (DPIF_RADARCUBE_FORMAT_6, see radar_cube.h) of several
+ * frames. The ring holds `depth` slots of one frame each; the producer writes
+ * the current frame into the write slot and publishes it with
+ * CubeRing_publish(), which numbers the frames 1, 2, 3, ... and moves on to the
+ * oldest slot that nobody reads. Readers pin a published frame with
+ * CubeRing_acquire() and get a view on it that stays valid until
+ * CubeRing_release(), no matter how many frames are published meanwhile.
+ *
+ * The slots can hold whole radar cubes or fewer chirps (numChirps = 1: the
+ * range profiles of all antennas of one chirp per frame).
+ *
+ * There is no lock: every slot has the sequence number of its frame (0 while it
+ * is written) and a pin count. A reader increments the pin count and then
+ * checks the sequence number, the producer clears the sequence number and then
+ * checks the pin count (sequentially consistent atomics), so at most one of
+ * them proceeds on the same slot. If all other slots are pinned, the producer
+ * drops the frame instead of waiting: CubeRing_publish() returns
+ * CUBE_RING_EBUSY and the write slot is written again. Readers must therefore
+ * pin at most depth - 1 frames at a time. There is a single producer, readers
+ * may run in any task.
+ *
+ * Only depends on the C standard library and the __atomic builtins of GCC and
+ * Clang (radar_cube.h needs HOST_BUILD on the host), so this file is shared
+ * between the firmware and the host tools in `host/` (see
+ * `host/cube_ring_bench.c`).
+ */
+
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define CUBE_RING_SUCCESS               (0)
+#define CUBE_RING_EINVAL                (-1)
+#define CUBE_RING_EBUSY                 (-2)
+#define CUBE_RING_ENOENT                (-3)
+
+/**
+ * @brief Maximum number of slots.
+ */
+#define CUBE_RING_MAX_DEPTH             (16U)
+
+/*!
+ * @brief Configuration of the ring.
+ */
+typedef struct CubeRing_Config_t
+{
+    /*! @brief Number of slots (2..CUBE_RING_MAX_DEPTH), one frame each */
+    uint32_t depth;
+
+    /*! @brief Number of (Doppler) chirps per slot */
+    uint32_t numChirps;
+
+    /*! @brief Number of virtual antennas per slot */
+    uint32_t numAntennas;
+
+    /*! @brief Number of range bins per slot */
+    uint32_t numRangeBins;
+} CubeRing_Config;
+
+/*!
+ * @brief State of a slot, accessed atomically.
+ */
+typedef struct CubeRing_Slot_t
+{
+    /*! @brief Sequence number of the frame in the slot, 0 for none or while it is written */
+    volatile uint32_t seq;
+
+    /*! @brief Number of readers holding the frame */
+    volatile uint32_t pins;
+} CubeRing_Slot;
+
+/*!
+ * @brief State of the ring.
+ */
+typedef struct CubeRing_Obj_t
+{
+    /*! @brief Configuration */
+    CubeRing_Config cfg;
+
+    /*! @brief Memory of all slots, one after the other */
+    cmplx16ImRe_t *mem;
+
+    /*! @brief Number of samples per slot */
+    uint32_t slotLen;
+
+    /*! @brief Slots */
+    CubeRing_Slot slot[CUBE_RING_MAX_DEPTH];
+
+    /*! @brief Sequence number of the latest published frame, 0 for none */
+    volatile uint32_t latestSeq;
+
+    /*! @brief Slot being written by the producer */
+    uint32_t writeIdx;
+
+    /*! @brief Number of frames dropped since all other slots were pinned */
+    uint32_t numDropped;
+} CubeRing_Obj;
+
+/*!
+ * @brief Read handle on a pinned frame.
+ */
+typedef struct CubeRing_Handle_t
+{
+    /*! @brief View on the frame, valid until CubeRing_release() */
+    RadarCube_View cube;
+
+    /*! @brief Sequence number of the frame */
+    uint32_t seq;
+
+    /*! @brief Slot of the frame */
+    uint32_t idx;
+} CubeRing_Handle;
+
+/**
+ * @brief Size of the memory needed by CubeRing_init() in bytes.
+ */
+uint32_t CubeRing_memSize(const CubeRing_Config *cfg);
+
+/**
+ * @brief Checks the configuration and attaches the memory, the ring starts empty with slot 0 as write slot.
+ *
+ * @param[out] obj Ring to initialize.
+ * @param[in]  cfg Configuration.
+ * @param[in]  mem CubeRing_memSize() bytes, 4 byte aligned.
+ *
+ * @return CUBE_RING_SUCCESS or CUBE_RING_EINVAL.
+ */
+int32_t CubeRing_init(CubeRing_Obj *obj, const CubeRing_Config *cfg, void *mem);
+
+/**
+ * @brief View on the write slot, into which the producer writes the next frame.
+ */
+void CubeRing_writeView(const CubeRing_Obj *obj, RadarCube_View *cube);
+
+/**
+ * @brief Publishes the write slot as the latest frame and claims the oldest slot without readers for the next one.
+ *
+ * Producer only. The write slot may change, get it again with CubeRing_writeView().
+ *
+ * @return CUBE_RING_SUCCESS, CUBE_RING_EBUSY if all other slots are pinned: the
+ *         frame is dropped and the write slot stays the same.
+ */
+int32_t CubeRing_publish(CubeRing_Obj *obj);
+
+/**
+ * @brief Sequence number of the latest published frame, 0 if there is none yet.
+ *
+ * Frame latest - k is the one published k frames earlier.
+ */
+uint32_t CubeRing_latest(const CubeRing_Obj *obj);
+
+/**
+ * @brief Pins a published frame.
+ *
+ * @param[in]  obj    Ring.
+ * @param[in]  seq    Sequence number of the frame.
+ * @param[out] handle Read handle, release it with CubeRing_release().
+ *
+ * @return CUBE_RING_SUCCESS, CUBE_RING_ENOENT if the frame has not been
+ *         published or its slot has been reused.
+ */
+int32_t CubeRing_acquire(CubeRing_Obj *obj, uint32_t seq, CubeRing_Handle *handle);
+
+/**
+ * @brief Unpins a frame, its slot may be reused by the producer afterwards.
+ */
+void CubeRing_release(CubeRing_Obj *obj, CubeRing_Handle *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUBE_RING_H */
@@ -0,0 +1,159 @@
+#ifndef DOA_H
+#define DOA_H
+
+/**
+ * @file doa.h
+ * @brief Direction of arrival of the CFAR detections from the virtual antenna array.
+ *
+ * For every detection (range bin, Doppler bin) the complex signal of each
+ * virtual antenna is taken from the radar cube (DPIF_RADARCUBE_FORMAT_6, see
+ * radar_cube.h) and turned into an azimuth and elevation estimate:
+ *
+ * 1. Doppler DFT of the numDopplerChirps samples of the antenna at the
+ *    detected Doppler bin (one bin of the dopplerFftSize point FFT).
+ * 2. TDM MIMO only: compensation of the phase a moving target accumulates
+ *    between the transmitters, virtual antenna a belongs to TX a / numRxAntennas.
+ * 3. The antennas are placed on a grid of rows (elevation) and columns
+ *    (azimuth) with half a wavelength spacing, as the antGeometryCfg of the TI
+ *    demos. Every row is transformed with a zero-padded azimuth DFT of
+ *    azimuthFftSize points, the power of the rows is summed.
+ * 4. Azimuth: peak of the power spectrum, refined by parabolic interpolation
+ *    of the magnitudes. sin(azimuth) = 2 * k / azimuthFftSize, positive towards
+ *    increasing column index.
+ * 5. Elevation: phase difference of rows 1 and 0 at the azimuth peak,
+ *    sin(elevation) = phase / pi, positive towards increasing row index. Zero
+ *    if the geometry has a single row.
+ *
+ * With the range r of the detection, the point is at
+ * x = r * cos(el) * sin(az), y = r * cos(el) * cos(az), z = r * sin(el).
+ *
+ * Everything is computed in fixed point (the twiddle factors are the only
+ * values derived from floating point math), so the firmware and the host tools
+ * in `host/` produce the same points. Only depends on the C standard library
+ * (radar_cube.h needs HOST_BUILD on the host), see `host/doa_bench.c`.
+ */
+
+#include <stdint.h>
+
+#include "cfar.h"
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define DOA_SUCCESS                 (0)
+#define DOA_EINVAL                  (-1)
+
+/**
+ * @brief Limits of the configuration.
+ */
+#define DOA_MAX_VIRTUAL_ANTENNAS    (16U)
+#define DOA_MAX_ROWS                (4U)
+#define DOA_MAX_AZIMUTH_FFT_SIZE    (64U)
+
+/**
+ * @brief Number of entries of the twiddle table, the Doppler FFT size times
+ *        the number of TX antennas and the azimuth FFT size have to divide it.
+ */
+#define DOA_TWIDDLE_TABLE_SIZE      (256U)
+
+/*!
+ * @brief Configuration of the DoA estimation.
+ */
+typedef struct Doa_Config_t
+{
+    /*! @brief Number of virtual antennas of the radar cube (numTxAntennas * numRxAntennas) */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of RX antennas, virtual antenna a is RX a % numRxAntennas of TX a / numRxAntennas */
+    uint32_t numRxAntennas;
+
+    /*! @brief Number of Doppler chirps of the radar cube */
+    uint32_t numDopplerChirps;
+
+    /*! @brief Size of the Doppler FFT the Doppler bins of the detections refer to */
+    uint32_t dopplerFftSize;
+
+    /*! @brief Size of the azimuth DFT, a power of two (4..DOA_MAX_AZIMUTH_FFT_SIZE) */
+    uint32_t azimuthFftSize;
+
+    /*! @brief 1: TDM MIMO, compensate the Doppler phase between the transmitters. 0: BPM or single TX */
+    uint32_t tdmCompensation;
+
+    /*! @brief Row of each virtual antenna in half wavelengths (0..DOA_MAX_ROWS - 1) */
+    uint8_t antRow[DOA_MAX_VIRTUAL_ANTENNAS];
+
+    /*! @brief Column of each virtual antenna in half wavelengths (0..azimuthFftSize - 1) */
+    uint8_t antCol[DOA_MAX_VIRTUAL_ANTENNAS];
+} Doa_Config;
+
+/*!
+ * @brief State of the DoA estimation.
+ */
+typedef struct Doa_Obj_t
+{
+    /*! @brief Configuration */
+    Doa_Config cfg;
+
+    /*! @brief exp(-j 2 pi n / DOA_TWIDDLE_TABLE_SIZE) in Q15 */
+    int16_t twiddleRe[DOA_TWIDDLE_TABLE_SIZE];
+    int16_t twiddleIm[DOA_TWIDDLE_TABLE_SIZE];
+
+    /*! @brief Number of rows of the geometry */
+    uint32_t numRows;
+} Doa_Obj;
+
+/*!
+ * @brief One point of the point cloud.
+ */
+typedef struct Doa_Point_t
+{
+    /*! @brief Range bin */
+    uint16_t rangeBin;
+
+    /*! @brief Doppler bin (FFT order) */
+    uint16_t dopplerBin;
+
+    /*! @brief sin(azimuth) in Q15 */
+    int16_t sinAzimuthQ15;
+
+    /*! @brief sin(elevation) in Q15 */
+    int16_t sinElevationQ15;
+
+    /*! @brief Magnitude of the cell in the detection map */
+    uint16_t magnitude;
+
+    /*! @brief SNR of the detection in dB, Q8 */
+    int16_t snrDbQ8;
+} Doa_Point;
+
+/**
+ * @brief Checks the configuration and generates the twiddle table.
+ *
+ * @return DOA_SUCCESS or DOA_EINVAL.
+ */
+int32_t Doa_init(Doa_Obj *obj, const Doa_Config *cfg);
+
+/**
+ * @brief Estimates the direction of arrival of detections.
+ *
+ * @param[in]  obj           Initialized DoA estimation.
+ * @param[in]  cube          Radar cube the detections were found in.
+ * @param[in]  detections    Detections (range bin, Doppler bin of the Doppler FFT).
+ * @param[in]  numDetections Number of detections.
+ * @param[out] points        One point per detection, in the order of the detections.
+ *
+ * @return DOA_SUCCESS, DOA_EINVAL if the cube or a detection does not match the configuration.
+ */
+int32_t Doa_process(const Doa_Obj *obj, const RadarCube_View *cube, const Cfar_Detection *detections,
+                    uint32_t numDetections, Doa_Point *points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DOA_H */
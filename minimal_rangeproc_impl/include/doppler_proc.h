@@ -0,0 +1,125 @@
+#ifndef DOPPLER_PROC_H
+#define DOPPLER_PROC_H
+
+/**
+ * @file doppler_proc.h
+ * @brief Doppler stage: range-Doppler heat map computed on the HWA.
+ *
+ * Runs after the Rangeproc DPU on the radar cube (DPIF_RADARCUBE_FORMAT_6, see
+ * radar_cube.h), between DPU_RangeProcHWA_process() and the next trigger of the
+ * Rangeproc DPU, while the HWA is idle:
+ *
+ * 1. A block of range bins is copied from the radar cube in L3 into the HWA
+ *    memory banks M0/M1 as [chirp][antenna][bin].
+ * 2. One HWA param set (after the ones of the Rangeproc DPU) windows the
+ *    numDopplerChirps samples of every (antenna, bin) pair, computes the Doppler
+ *    FFT of size fftSize (zero-padded) and writes the 16-bit magnitude into the
+ *    banks M2/M3 as [antenna][bin][doppler].
+ * 3. The CPU averages the magnitudes over the virtual antennas (non-coherent
+ *    integration) into the heat map Heatmap[range][doppler] in L3.
+ *
+ * The Doppler bins are in FFT order, bin 0 is zero velocity. The fixed-point
+ * host reference model is `host/dopplerproc_ref.h`.
+ */
+
+#include <stdint.h>
+#include <drivers/hwa.h>
+#include "kernel/dpl/SemaphoreP.h"
+
+#include "radar_cube.h"
+
+/* MemPoolObj of system.h, which includes this header */
+struct MemPoolObj_t;
+
+/*!
+ * @brief Static configuration of the Doppler stage.
+ */
+typedef struct DopplerProc_Config_t
+{
+    /*! @brief HWA handle (shared with the Rangeproc DPU) */
+    HWA_Handle hwaHandle;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of Doppler chirps of the radar cube */
+    uint32_t numDopplerChirps;
+
+    /*! @brief Doppler FFT size, a power of two >= numDopplerChirps */
+    uint32_t fftSize;
+
+    /*! @brief Window type (MATHUTILS_WIN_*) */
+    uint32_t windowType;
+
+    /*! @brief Right shift of the 16-bit magnitudes (0..8) */
+    uint32_t fftOutputDivShift;
+
+    /*! @brief Index of the HWA param set to use */
+    uint32_t hwaParamSetIdx;
+
+    /*! @brief Offset of the window in the HWA window RAM in entries */
+    uint32_t hwaWinRamOffset;
+} DopplerProc_Config;
+
+/*!
+ * @brief State of the Doppler stage.
+ */
+typedef struct DopplerProc_Obj_t
+{
+    /*! @brief Configuration */
+    DopplerProc_Config cfg;
+
+    /*! @brief Heat map [numRangeBins][fftSize] (allocated from the L3 memory pool) */
+    uint16_t *heatmap;
+
+    /*! @brief Number of range bins processed per HWA run */
+    uint32_t numBinsPerBlock;
+
+    /*! @brief HWA param set is configured for this number of range bins, 0 if not configured */
+    uint32_t numBinsConfigured;
+
+    /*! @brief Window, first half of the symmetric window (allocated from the local memory pool) */
+    int32_t *window;
+
+    /*! @brief CPU address of the HWA input (bank M0) */
+    cmplx16ImRe_t *hwaIn;
+
+    /*! @brief CPU address of the HWA output (bank M2) */
+    uint16_t *hwaOut;
+
+    /*! @brief Posted by the HWA done interrupt */
+    SemaphoreP_Object hwaDoneSem;
+} DopplerProc_Obj;
+
+/**
+ * @brief Configures the Doppler stage: generates the window, loads it into the
+ *        HWA window RAM and allocates the heat map.
+ *
+ * @param[out] obj       Doppler stage to configure.
+ * @param[in]  cfg       Configuration.
+ * @param[in]  l3Pool    Memory pool the heat map is allocated from.
+ * @param[in]  localPool Memory pool the window is allocated from.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE on invalid configuration or exhausted pools.
+ */
+int32_t DopplerProc_config(DopplerProc_Obj *obj, const DopplerProc_Config *cfg, struct MemPoolObj_t *l3Pool,
+                           struct MemPoolObj_t *localPool);
+
+/**
+ * @brief Computes the heat map of a radar cube into obj->heatmap. Blocks until the HWA is done.
+ *
+ * Must be called while the Rangeproc DPU is not active (after
+ * DPU_RangeProcHWA_process(), before the next trigger), the HWA common
+ * configuration is programmed again by the next trigger of the Rangeproc DPU.
+ *
+ * @param[in,out] obj  Configured Doppler stage.
+ * @param[in]     cube Radar cube matching the configuration.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE on HWA errors.
+ */
+int32_t DopplerProc_process(DopplerProc_Obj *obj, const RadarCube_View *cube);
+
+#endif /* DOPPLER_PROC_H */
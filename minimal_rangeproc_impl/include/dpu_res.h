@@ -101,6 +101,15 @@ extern "C" {
 #define DPC_OBJDET_DPU_RANGEPROC_EVT_DECIM_PONG_SHADOW_1               (DPC_OBJDET_EDMA_SHADOW_BASE + 10)
 #define DPC_OBJDET_DPU_RANGEPROC_EVT_DECIM_PONG_EVENT_QUE              0
 
+/* Doppler stage (doppler_proc.h): param set after the ones of the Range DPU, window after the range window */
+#define DPC_OBJDET_DOPPLERPROC_HWA_PARAMSET_IDX                        DPU_RANGEPROCHWA_NUM_HWA_PARAM_SETS
+#define DPC_OBJDET_DOPPLERPROC_HWA_WINDOW_RAM_OFFSET                   (DPC_OBJDET_HWA_WINDOW_RAM_OFFSET + (CLI_NUM_ADC_SAMPLES + 1) / 2)
+
+/* Minor motion Doppler stage: next param set, window after the major motion Doppler window (at most one Doppler chirp per chirp) */
+#define DPC_OBJDET_DOPPLERPROC_MINOR_HWA_PARAMSET_IDX                  (DPC_OBJDET_DOPPLERPROC_HWA_PARAMSET_IDX + 1)
+#define DPC_OBJDET_DOPPLERPROC_MINOR_HWA_WINDOW_RAM_OFFSET             (DPC_OBJDET_DOPPLERPROC_HWA_WINDOW_RAM_OFFSET + \
+                                                                        (CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST + 1) / 2)
+
 /* DoA DPU */
 #define DPC_OBJDET_DPU_DOAPROC_EDMAIN_PING_CH                         EDMA_APPSS_TPCC_B_EVT_FREE_5
 #define DPC_OBJDET_DPU_DOAPROC_EDMAIN_PING_SHADOW                     (DPC_OBJDET_EDMA_SHADOW_BASE + 11)
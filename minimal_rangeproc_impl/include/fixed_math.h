@@ -0,0 +1,53 @@
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+/**
+ * @file fixed_math.h
+ * @brief Fixed point math shared by the processing stages.
+ *
+ * Integer square root, CORDIC arctangent, logarithm and the Q15 twiddle
+ * tables of the DFTs computed in software (doa.c, micro_doppler.c). The
+ * results are bit-exact on the firmware and on the host, only the twiddle
+ * tables are derived from floating point math.
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief floor(sqrt(x)).
+ */
+uint32_t FixedMath_isqrt(uint64_t x);
+
+/**
+ * @brief atan2(y, x) / pi in Q15 (-32768..32767), 0 for x = y = 0.
+ *
+ * 20 CORDIC iterations; small vectors lose precision, scale them up first.
+ */
+int16_t FixedMath_atan2Q15(int64_t y, int64_t x);
+
+/**
+ * @brief log2(x) in Q8, rounded down (x > 0).
+ */
+int32_t FixedMath_log2Q8(uint64_t x);
+
+/**
+ * @brief Twiddle factors exp(-j 2 pi n / size) in Q15 of an n = 0..size - 1 point DFT.
+ *
+ * @param[out] re   size real parts.
+ * @param[out] im   size imaginary parts.
+ * @param[in]  size Number of entries.
+ */
+void FixedMath_twiddleTable(int16_t *re, int16_t *im, uint32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXED_MATH_H */
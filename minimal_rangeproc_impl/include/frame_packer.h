@@ -0,0 +1,87 @@
+#ifndef FRAME_PACKER_H
+#define FRAME_PACKER_H
+
+/**
+ * @file frame_packer.h
+ * @brief Assembly of complete UART frames in a contiguous transmit buffer.
+ *
+ * Instead of handing every header, sample and footer to the UART driver
+ * separately, the frame is first assembled in one buffer and then sent with a
+ * single UART_write() call. This keeps the per-call driver overhead at one
+ * transaction per frame and allows the transfer to be carried out by the EDMA.
+ *
+ * The packer only depends on the C standard library, so it can also be built
+ * on the host (see `host/uart_packer_bench.c`).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return value of the packer functions on success.
+ */
+#define FRAME_PACKER_SUCCESS    (0)
+
+/**
+ * @brief Return value of the packer functions if the data does not fit into the buffer.
+ */
+#define FRAME_PACKER_EOVERFLOW  (-1)
+
+/*!
+ * @brief State of a frame which is being assembled.
+ */
+typedef struct FramePacker_t
+{
+    /*! @brief Start of the transmit buffer */
+    uint8_t *buf;
+
+    /*! @brief Size of the transmit buffer in bytes */
+    uint32_t size;
+
+    /*! @brief Number of bytes already written to the buffer */
+    uint32_t len;
+} FramePacker;
+
+/**
+ * @brief Initializes a packer on top of a transmit buffer.
+ *
+ * @param[out] packer Packer to initialize.
+ * @param[in]  buf    Transmit buffer the frame is assembled in.
+ * @param[in]  size   Size of the transmit buffer in bytes.
+ */
+void FramePacker_init(FramePacker *packer, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Appends a block of bytes to the frame.
+ *
+ * The frame is left untouched if the block does not fit.
+ *
+ * @param[in,out] packer   Packer to append to.
+ * @param[in]     data     Data to append.
+ * @param[in]     numBytes Number of bytes to append.
+ *
+ * @return FRAME_PACKER_SUCCESS on success, FRAME_PACKER_EOVERFLOW if the buffer is too small.
+ */
+int32_t FramePacker_append(FramePacker *packer, const void *data, uint32_t numBytes);
+
+/**
+ * @brief Reserves a block of bytes in the frame, to be filled in by the caller.
+ *
+ * This allows producers to write directly into the transmit buffer instead of
+ * going through an intermediate copy.
+ *
+ * @param[in,out] packer   Packer to reserve space in.
+ * @param[in]     numBytes Number of bytes to reserve.
+ *
+ * @return Pointer to the reserved block, NULL if the buffer is too small.
+ */
+void *FramePacker_reserve(FramePacker *packer, uint32_t numBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_PACKER_H */
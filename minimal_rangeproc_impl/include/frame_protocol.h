@@ -0,0 +1,609 @@
+#ifndef FRAME_PROTOCOL_H
+#define FRAME_PROTOCOL_H
+
+/**
+ * @file frame_protocol.h
+ * @brief Versioned binary frame format of the UART output.
+ *
+ * Every frame sent over UART has the following layout (all fields little endian):
+ *
+ * | Part                | Size                | Content                                          |
+ * |---------------------|---------------------|--------------------------------------------------|
+ * | FrameProto_Header   | 32 bytes            | magic word, version, lengths, frame counter, timestamp, radar cube dimensions, header check |
+ * | TLV 0 .. numTlvs-1  | 8 bytes + length    | FrameProto_TlvHeader followed by the payload, padded to 4 bytes |
+ * | CRC32               | 4 bytes             | CRC-32 (IEEE 802.3, as zlib.crc32) over header and all TLVs |
+ *
+ * The magic word marks a frame start, the header then gives the total frame
+ * length. A receiver thus only has to search for the magic word once after a
+ * transmission error and can skip whole frames afterwards. The header check
+ * byte protects the length: a corrupted header is rejected right away instead
+ * of making the receiver wait for up to its maximum frame length until the
+ * CRC32 fails. Receivers must skip
+ * TLVs with unknown types, so new payloads can be added without breaking them.
+ * The version is only incremented on incompatible changes of the header.
+ *
+ * This file only depends on the C standard library and is shared with the host
+ * tools in `host/`.
+ */
+
+#include <stdint.h>
+
+#include "frame_packer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of the frame header.
+ */
+#define FRAME_PROTO_VERSION             (2U)
+
+/**
+ * @brief Number of 16-bit words in the magic word.
+ */
+#define FRAME_PROTO_MAGIC_WORDS         (4U)
+
+/**
+ * @brief Words of the magic word at the start of every frame.
+ */
+#define FRAME_PROTO_MAGIC_0             (0x0102U)
+#define FRAME_PROTO_MAGIC_1             (0x0304U)
+#define FRAME_PROTO_MAGIC_2             (0x0506U)
+#define FRAME_PROTO_MAGIC_3             (0x0708U)
+
+/**
+ * @brief Size of the CRC32 at the end of every frame in bytes.
+ */
+#define FRAME_PROTO_CRC_SIZE            (4U)
+
+/**
+ * @brief Alignment of the TLVs within a frame.
+ */
+#define FRAME_PROTO_TLV_ALIGN           (4U)
+
+/**
+ * @brief Size of a TLV with a payload of the given length in bytes, including header and padding.
+ */
+#define FRAME_PROTO_TLV_SIZE(length)    (sizeof(FrameProto_TlvHeader) + (((length) + FRAME_PROTO_TLV_ALIGN - 1U) & ~(FRAME_PROTO_TLV_ALIGN - 1U)))
+
+/**
+ * @brief Types of the TLVs following the frame header.
+ */
+typedef enum FrameProto_TlvType_e
+{
+    /*! @brief Range profile (FrameProto_RangeProfile followed by cmplx16ImRe_t samples) */
+    FRAME_PROTO_TLV_RANGE_PROFILE = 1,
+
+    /*! @brief Transmission statistics (FrameProto_TxStats) */
+    FRAME_PROTO_TLV_TX_STATS = 2,
+
+    /*! @brief Range-Doppler heat map (FrameProto_Heatmap followed by uint16_t cells) */
+    FRAME_PROTO_TLV_RANGE_DOPPLER_HEATMAP = 3,
+
+    /*! @brief CFAR detections (FrameProto_DetectionList followed by FrameProto_Detection entries) */
+    FRAME_PROTO_TLV_DETECTIONS = 4,
+
+    /*! @brief CFAR detections with direction of arrival (FrameProto_PointCloud followed by FrameProto_Point entries) */
+    FRAME_PROTO_TLV_POINT_CLOUD = 5,
+
+    /*! @brief Micro-Doppler features of one range gate (FrameProto_MicroDoppler followed by numBins uint8_t) */
+    FRAME_PROTO_TLV_MICRO_DOPPLER = 6,
+
+    /*! @brief Detections on the minor motion heat map (FrameProto_DetectionList followed by FrameProto_Detection entries) */
+    FRAME_PROTO_TLV_MINOR_MOTION_DETECTIONS = 7,
+
+    /*! @brief Range profile integrated over all chirps and virtual antennas (FrameProto_IntegratedProfile followed by numBins values) */
+    FRAME_PROTO_TLV_INTEGRATED_RANGE_PROFILE = 8,
+
+    /*! @brief Active and idle time of the previous frame (FrameProto_DutyCycle) */
+    FRAME_PROTO_TLV_DUTY_CYCLE = 9,
+
+    /*! @brief Strongest peaks of the range profile (FrameProto_PeakList followed by numPeaks FrameProto_Peak) */
+    FRAME_PROTO_TLV_RANGE_PEAKS = 10,
+
+    /*! @brief Range region of interest covered by the radar cube (FrameProto_RangeRoi) */
+    FRAME_PROTO_TLV_RANGE_ROI = 11,
+
+    /*! @brief Latest reconfiguration of the sensor without reboot and its duration (FrameProto_Reconfig) */
+    FRAME_PROTO_TLV_RECONFIG = 12,
+
+    /*! @brief Sub-frame the frame was acquired in, with APP_NUM_SUBFRAMES > 1 (FrameProto_SubFrame) */
+    FRAME_PROTO_TLV_SUBFRAME = 13
+} FrameProto_TlvType;
+
+/*!
+ * @brief Header at the start of every frame.
+ */
+typedef struct FrameProto_Header_t
+{
+    /*! @brief Magic word (FRAME_PROTO_MAGIC_0 .. FRAME_PROTO_MAGIC_3) */
+    uint16_t magic[FRAME_PROTO_MAGIC_WORDS];
+
+    /*! @brief Header version (FRAME_PROTO_VERSION) */
+    uint16_t version;
+
+    /*! @brief Size of this header in bytes */
+    uint16_t headerLen;
+
+    /*! @brief Size of the whole frame in bytes, including header and CRC */
+    uint32_t totalLen;
+
+    /*! @brief Number of the frame (frame start interrupt counter) */
+    uint32_t frameCount;
+
+    /*! @brief Time of the end of processing of the frame in 40 MHz FRAME_REF_TIMER ticks */
+    uint32_t timestamp;
+
+    /*! @brief Number of TLVs following the header */
+    uint16_t numTlvs;
+
+    /*! @brief Number of range bins of the radar cube (of the range region of interest, see FRAME_PROTO_TLV_RANGE_ROI) */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of Doppler chirps of the radar cube */
+    uint16_t numDopplerChirps;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint8_t  numVirtualAntennas;
+
+    /*! @brief FrameProto_headerCheck() of the fields before this one */
+    uint8_t  headerCheck;
+} FrameProto_Header;
+
+/*!
+ * @brief Header of every TLV.
+ */
+typedef struct FrameProto_TlvHeader_t
+{
+    /*! @brief Payload type (FrameProto_TlvType) */
+    uint32_t type;
+
+    /*! @brief Payload size in bytes, excluding this header and the padding */
+    uint32_t length;
+} FrameProto_TlvHeader;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_RANGE_PROFILE, followed by numBins samples.
+ */
+typedef struct FrameProto_RangeProfile_t
+{
+    /*! @brief Doppler chirp the profile belongs to */
+    uint16_t chirpIdx;
+
+    /*! @brief Virtual antenna the profile belongs to */
+    uint16_t antennaIdx;
+
+    /*! @brief Range bin of the first sample */
+    uint16_t startBin;
+
+    /*! @brief Number of samples */
+    uint16_t numBins;
+} FrameProto_RangeProfile;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_INTEGRATED_RANGE_PROFILE, followed by numBins values.
+ *
+ * Power |x|^2 summed over numIntegrated samples (all Doppler chirps and virtual
+ * antennas) per range bin. Format 0: uint16_t log2 of the magnitude sqrt(sum)
+ * in Q8 (0 for no power). Format 1: uint32_t sum >> powerShift.
+ */
+typedef struct FrameProto_IntegratedProfile_t
+{
+    /*! @brief Range bin of the first value */
+    uint16_t startBin;
+
+    /*! @brief Number of values */
+    uint16_t numBins;
+
+    /*! @brief Number of samples summed per range bin */
+    uint16_t numIntegrated;
+
+    /*! @brief Value format: 0 uint16_t log2 magnitude in Q8, 1 uint32_t power */
+    uint8_t  format;
+
+    /*! @brief Format 1: right shift applied to the sums */
+    uint8_t  powerShift;
+} FrameProto_IntegratedProfile;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_RANGE_PEAKS, followed by numPeaks FrameProto_Peak.
+ *
+ * Strongest local maxima of the range profile of one chirp and antenna (see
+ * peak_picker.h), strongest first.
+ */
+typedef struct FrameProto_PeakList_t
+{
+    /*! @brief Number of peaks that follow */
+    uint16_t numPeaks;
+
+    /*! @brief Number of local maxima above the threshold, including the ones not sent */
+    uint16_t numCandidates;
+
+    /*! @brief Number of range bins of the profile */
+    uint16_t numRangeBins;
+
+    /*! @brief Chirp index of the profile */
+    uint8_t  chirpIdx;
+
+    /*! @brief Virtual antenna index of the profile */
+    uint8_t  antennaIdx;
+} FrameProto_PeakList;
+
+/*!
+ * @brief One peak of FRAME_PROTO_TLV_RANGE_PEAKS, at range bin rangeBin + offsetQ15 / 32768.
+ */
+typedef struct FrameProto_Peak_t
+{
+    /*! @brief Range bin of the local maximum */
+    uint16_t rangeBin;
+
+    /*! @brief Sub-bin offset of the interpolated peak, Q15 (-0.5..0.5 bins) */
+    int16_t  offsetQ15;
+
+    /*! @brief log2 of the interpolated magnitude in Q8 (1 LSB = 6.02 / 256 dB) */
+    uint16_t log2MagQ8;
+
+    /*! @brief Phase of rangeBin, atan2(imag, real) / pi in Q15 */
+    int16_t  phaseQ15;
+} FrameProto_Peak;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_RANGE_DOPPLER_HEATMAP.
+ *
+ * Followed by numRangeBins * numDopplerBins uint16_t cells [range][doppler]:
+ * magnitude of the Doppler FFT averaged over all virtual antennas. The Doppler
+ * bins are in FFT order, bin 0 is zero velocity, bins >= numDopplerBins / 2 are
+ * negative velocities.
+ */
+typedef struct FrameProto_Heatmap_t
+{
+    /*! @brief Range bin of the first row */
+    uint16_t startBin;
+
+    /*! @brief Number of rows (range bins) */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of columns (Doppler bins, the Doppler FFT size) */
+    uint16_t numDopplerBins;
+
+    /*! @brief Right shift applied to the magnitudes */
+    uint16_t divShift;
+} FrameProto_Heatmap;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_DETECTIONS, followed by numDetections FrameProto_Detection entries.
+ */
+typedef struct FrameProto_DetectionList_t
+{
+    /*! @brief Number of detections in this TLV */
+    uint16_t numDetections;
+
+    /*! @brief Number of further detections which exceeded the maximum list length */
+    uint16_t numDiscarded;
+
+    /*! @brief Number of range bins of the detection map */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of Doppler bins of the detection map, 1 if detected on a range profile */
+    uint16_t numDopplerBins;
+} FrameProto_DetectionList;
+
+/*!
+ * @brief One detection of FRAME_PROTO_TLV_DETECTIONS.
+ */
+typedef struct FrameProto_Detection_t
+{
+    /*! @brief Range bin */
+    uint16_t rangeBin;
+
+    /*! @brief Doppler bin in FFT order (bins >= numDopplerBins / 2 are negative velocities) */
+    uint16_t dopplerBin;
+
+    /*! @brief Magnitude of the cell */
+    uint16_t magnitude;
+
+    /*! @brief Ratio of magnitude and CFAR noise estimate in dB, Q8 (signed) */
+    int16_t  snrDbQ8;
+} FrameProto_Detection;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_POINT_CLOUD, followed by numPoints FrameProto_Point entries.
+ */
+typedef struct FrameProto_PointCloud_t
+{
+    /*! @brief Number of points in this TLV */
+    uint16_t numPoints;
+
+    /*! @brief Number of further detections which exceeded the maximum list length */
+    uint16_t numDiscarded;
+
+    /*! @brief Number of range bins of the detection map */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of Doppler bins of the detection map, 1 if detected on a range profile */
+    uint16_t numDopplerBins;
+} FrameProto_PointCloud;
+
+/*!
+ * @brief One point of FRAME_PROTO_TLV_POINT_CLOUD: a detection and its direction of arrival.
+ *
+ * With the range r of the range bin: x = r * cos(el) * sin(az),
+ * y = r * cos(el) * cos(az), z = r * sin(el).
+ */
+typedef struct FrameProto_Point_t
+{
+    /*! @brief Range bin */
+    uint16_t rangeBin;
+
+    /*! @brief Doppler bin in FFT order (bins >= numDopplerBins / 2 are negative velocities) */
+    uint16_t dopplerBin;
+
+    /*! @brief sin(azimuth) in Q15 */
+    int16_t  sinAzimuthQ15;
+
+    /*! @brief sin(elevation) in Q15 */
+    int16_t  sinElevationQ15;
+
+    /*! @brief Magnitude of the cell */
+    uint16_t magnitude;
+
+    /*! @brief Ratio of magnitude and CFAR noise estimate in dB, Q8 (signed) */
+    int16_t  snrDbQ8;
+} FrameProto_Point;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_MICRO_DOPPLER, followed by the latest
+ *        spectrogram column (numBins bytes, power in 0.5 dB steps).
+ *
+ * Doppler bins are signed and centered (0 is zero velocity), all in Q8 bins of
+ * a DFT of fftSize points.
+ */
+typedef struct FrameProto_MicroDoppler_t
+{
+    /*! @brief Center range bin of the gate */
+    uint16_t rangeBin;
+
+    /*! @brief Number of frames in the spectrogram window */
+    uint16_t numFrames;
+
+    /*! @brief Size of the Doppler DFT */
+    uint16_t fftSize;
+
+    /*! @brief Number of column bytes following this header (fftSize or 0) */
+    uint16_t numBins;
+
+    /*! @brief Power weighted mean Doppler bin, Q8 */
+    int16_t  centroidQ8;
+
+    /*! @brief Power weighted RMS spread around the centroid, Q8 */
+    uint16_t bandwidthQ8;
+
+    /*! @brief Lowest and highest bin within the envelope level of the peak, Q8 */
+    int16_t  envelopeLowQ8;
+    int16_t  envelopeHighQ8;
+
+    /*! @brief Total power of the gate in dB, Q8 */
+    int16_t  energyDbQ8;
+
+    /*! @brief Mean of the centroids of the window, Q8 */
+    int16_t  meanCentroidQ8;
+
+    /*! @brief RMS spread of the centroids of the window, Q8 */
+    uint16_t centroidSpreadQ8;
+
+    /*! @brief Padding, 0 */
+    uint16_t reserved;
+} FrameProto_MicroDoppler;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_DUTY_CYCLE: where the time of the previous frame went, in microseconds.
+ *
+ * Measured with the 40 MHz frame reference timer from one frame start
+ * interrupt to the next. Acquisition: frame start until the Rangeproc DPU has
+ * written the radar cube (chirps and range FFT, the M4F waits). Processing:
+ * from then until the DPU is triggered for the next frame (all stages, the
+ * assembly of the UART frame and, without APP_PIPELINED_TX, its
+ * transmission). Idle: the rest of the frame period, in which
+ * the M4F waits in the idle task (no sleep state is configured) and the
+ * transmission of the UART frame runs on the EDMA. The energy per frame is the sum of each time multiplied by the
+ * power drawn in that state. All 0 until two frames have been processed.
+ */
+typedef struct FrameProto_DutyCycle_t
+{
+    /*! @brief Time between the frame start of the previous and the current frame */
+    uint32_t framePeriodUs;
+
+    /*! @brief Frame start until the radar cube was complete */
+    uint32_t acquisitionUs;
+
+    /*! @brief Radar cube complete until the DPU was triggered for the next frame */
+    uint32_t processingUs;
+
+    /*! @brief Rest of the frame period */
+    uint32_t idleUs;
+
+    /*! @brief APP_DPU_LOW_POWER_MODE of the firmware (lowPowerMode of the Rangeproc DPU) */
+    uint8_t  lowPowerMode;
+
+    /*! @brief Reserved, 0 */
+    uint8_t  reserved[3];
+} FrameProto_DutyCycle;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_RANGE_ROI: range bins of the range FFT kept in the radar cube.
+ *
+ * The radar cube and all range dimensions of the other TLVs cover the range
+ * bins startBin..startBin + numBins - 1 only. Range bins in TLVs are always
+ * absolute (range bins of the range FFT), range = rangeBin * binSizeUm.
+ */
+typedef struct FrameProto_RangeRoi_t
+{
+    /*! @brief First range bin of the radar cube */
+    uint16_t startBin;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint16_t numBins;
+
+    /*! @brief Number of range bins of the range FFT (half of the FFT size) */
+    uint16_t numRangeBinsTotal;
+
+    /*! @brief Reserved, 0 */
+    uint16_t reserved;
+
+    /*! @brief Size of a range bin in micrometres */
+    uint32_t binSizeUm;
+} FrameProto_RangeRoi;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_RECONFIG: the latest reconfiguration without reboot (rangeProc_reconfigure()).
+ *
+ * Sent with every frame once a reconfiguration has been applied or rejected.
+ * The frames after frameCount are acquired with the new configuration, their
+ * headers give the new radar cube dimensions. Times in microseconds from the
+ * frame boundary at which the request was taken up: wait for the UART task to
+ * finish the queued frame, stop the sensor (MMWave_stop(), MMWave_close(),
+ * MMWave_deinit()), bring it up with the new configuration (init, RF power on,
+ * open, config, factory calibration), configure the DPUs from the rewound memory
+ * pools and start the sensor again.
+ */
+typedef struct FrameProto_Reconfig_t
+{
+    /*! @brief Number of reconfigurations applied */
+    uint16_t numReconfigs;
+
+    /*! @brief Number of requests rejected by the checks, the sensor kept running with the previous configuration */
+    uint16_t numRejected;
+
+    /*! @brief Frame counter when the sensor was stopped */
+    uint32_t frameCount;
+
+    /*! @brief Whole reconfiguration, the sum of the steps below */
+    uint32_t totalUs;
+
+    /*! @brief Waiting for the UART task */
+    uint32_t uartDrainUs;
+
+    /*! @brief Stop, close and deinit of the sensor */
+    uint32_t sensorStopUs;
+
+    /*! @brief Init, RF power on, open, config and factory calibration of the sensor */
+    uint32_t sensorSetupUs;
+
+    /*! @brief Configuration of all DPUs and the UART snapshots */
+    uint32_t dpcConfigUs;
+
+    /*! @brief Trigger of the Rangeproc DPU and start of the sensor */
+    uint32_t sensorStartUs;
+} FrameProto_Reconfig;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_SUBFRAME: sub-frame the frame was acquired in.
+ *
+ * The sub-frames take turns frame by frame, each with its own chirp slope and
+ * start frequency. All other TLVs of the frame belong to subFrame, its range
+ * bin size is the one of FRAME_PROTO_TLV_RANGE_ROI. Between two frames the
+ * sensor is stopped and set up with the profile of the next sub-frame
+ * (APP_SUBFRAME_SWITCH); switchUs is the time this took in front of this frame.
+ * The sensor is then started one frame period after the previous start, or
+ * late if processing and switch did not fit (numOverruns); framePeriodUs is the
+ * resulting time between the two starts.
+ */
+typedef struct FrameProto_SubFrame_t
+{
+    /*! @brief Sub-frame of this frame, 0..numSubFrames - 1 */
+    uint8_t subFrame;
+
+    /*! @brief Number of sub-frames */
+    uint8_t numSubFrames;
+
+    /*! @brief Number of switches which started the sensor later than one frame period after the previous start,
+               saturates at 0xFFFF */
+    uint16_t numOverruns;
+
+    /*! @brief Stop of the sensor and setup with the profile of this sub-frame */
+    uint32_t switchUs;
+
+    /*! @brief Chirp slope in kHz/us */
+    uint32_t slopeKhzPerUs;
+
+    /*! @brief Start frequency in MHz */
+    uint32_t startFreqMhz;
+
+    /*! @brief Start of the sensor for the previous frame until the start for this frame, 0 for the first switch after
+               the sensor has been set up */
+    uint32_t framePeriodUs;
+} FrameProto_SubFrame;
+
+/*!
+ * @brief Payload of FRAME_PROTO_TLV_TX_STATS.
+ */
+typedef struct FrameProto_TxStats_t
+{
+    /*! @brief Number of frames handed to the UART task */
+    uint32_t numFramesQueued;
+
+    /*! @brief Number of frames transmitted before this one */
+    uint32_t numFramesSent;
+
+    /*! @brief Number of frames dropped because the UART fell behind */
+    uint32_t numFramesDropped;
+} FrameProto_TxStats;
+
+/**
+ * @brief Updates a CRC-32 (IEEE 802.3, reflected, as zlib.crc32) with a block of data.
+ *
+ * @param[in] crc      CRC of the preceding data, 0 for the first block.
+ * @param[in] data     Data to add.
+ * @param[in] numBytes Number of bytes to add.
+ *
+ * @return Updated CRC.
+ */
+uint32_t FrameProto_crc32(uint32_t crc, const void *data, uint32_t numBytes);
+
+/**
+ * @brief Check byte of a frame header: low byte of the CRC-32 of all fields before headerCheck.
+ *
+ * @param[in] header Header with totalLen and numTlvs filled in.
+ *
+ * @return Value of headerCheck.
+ */
+uint8_t FrameProto_headerCheck(const FrameProto_Header *header);
+
+/**
+ * @brief Starts a new frame in an empty packer by writing the frame header.
+ *
+ * Lengths, number of TLVs, header check and CRC are filled in by FrameProto_end().
+ *
+ * @param[in,out] packer Empty packer to write the frame to.
+ * @param[in]     header Header fields frameCount, timestamp and radar cube dimensions.
+ *
+ * @return FRAME_PACKER_SUCCESS on success, FRAME_PACKER_EOVERFLOW if the buffer is too small.
+ */
+int32_t FrameProto_begin(FramePacker *packer, const FrameProto_Header *header);
+
+/**
+ * @brief Appends a TLV and returns its payload area, to be filled in by the caller.
+ *
+ * @param[in,out] packer Packer holding a frame started with FrameProto_begin().
+ * @param[in]     type   Payload type.
+ * @param[in]     length Payload size in bytes.
+ *
+ * @return Pointer to the payload (4 byte aligned), NULL if the buffer is too small.
+ */
+void *FrameProto_addTlv(FramePacker *packer, uint32_t type, uint32_t length);
+
+/**
+ * @brief Finishes a frame by filling in lengths, number of TLVs, the header check and the CRC.
+ *
+ * @param[in,out] packer Packer holding a frame started with FrameProto_begin().
+ *
+ * @return Size of the frame in bytes, 0 if the buffer is too small.
+ */
+uint32_t FrameProto_end(FramePacker *packer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_PROTOCOL_H */
@@ -0,0 +1,180 @@
+#ifndef MICRO_DOPPLER_H
+#define MICRO_DOPPLER_H
+
+/**
+ * @file micro_doppler.h
+ * @brief Micro-Doppler stage: spectrogram and features of one range gate.
+ *
+ * Once per frame the Doppler spectrum of a range gate (gateLen range bins
+ * around a center bin, either fixed or following the strongest detection) is
+ * computed from the radar cube (DPIF_RADARCUBE_FORMAT_6, see radar_cube.h):
+ *
+ * 1. Window (Hann without the zero end points) over the numDopplerChirps
+ *    samples of every range bin of the gate and virtual antenna.
+ * 2. DFT of fftSize points (zero-padded), power |X|^2.
+ * 3. Non-coherent integration: sum of the powers over the gate and antennas.
+ *    The spectrum is centered: column index fftSize / 2 is zero velocity.
+ *
+ * The spectra of the last windowLen frames are kept in a ring buffer as 8-bit
+ * columns (power in 0.5 dB steps), the spectrogram. Per frame the stage reports
+ * (Doppler bins signed, 0 = zero velocity, all in Q8 bins):
+ *
+ * - centroid:  power weighted mean Doppler bin,
+ * - bandwidth: power weighted RMS spread around the centroid,
+ * - envelope:  lowest and highest bin of the spectrum within envelopeDb of its peak,
+ * - energy:    total power in dB,
+ *
+ * and over the window the mean and the spread (RMS) of the centroid, e.g. the
+ * periodic swing of the limbs of a walking person.
+ *
+ * The Doppler resolution of one column is set by the number of chirps per
+ * frame; zero-padding only interpolates. Micro-Doppler classification usually
+ * needs 32 or more chirps per frame (defines.h).
+ *
+ * Only depends on the C standard library (radar_cube.h needs HOST_BUILD on the
+ * host), so this file is shared between the firmware and the host tools in
+ * `host/` (see `host/micro_doppler_bench.c`).
+ */
+
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define MICRO_DOPPLER_SUCCESS           (0)
+#define MICRO_DOPPLER_EINVAL            (-1)
+
+/**
+ * @brief Limits of the configuration.
+ */
+#define MICRO_DOPPLER_MAX_FFT_SIZE      (64U)
+#define MICRO_DOPPLER_MAX_CHIRPS        (64U)
+#define MICRO_DOPPLER_MAX_WINDOW_LEN    (64U)
+
+/*!
+ * @brief Configuration of the micro-Doppler stage.
+ */
+typedef struct MicroDoppler_Config_t
+{
+    /*! @brief Number of Doppler chirps of the radar cube (1..MICRO_DOPPLER_MAX_CHIRPS) */
+    uint32_t numDopplerChirps;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint32_t numRangeBins;
+
+    /*! @brief DFT size, a power of two, numDopplerChirps..MICRO_DOPPLER_MAX_FFT_SIZE */
+    uint32_t fftSize;
+
+    /*! @brief Number of range bins of the gate (odd numbers center the gate) */
+    uint32_t gateLen;
+
+    /*! @brief Number of frames of the spectrogram (1..MICRO_DOPPLER_MAX_WINDOW_LEN) */
+    uint32_t windowLen;
+
+    /*! @brief Envelope: level below the peak of the spectrum in dB */
+    uint32_t envelopeDb;
+} MicroDoppler_Config;
+
+/*!
+ * @brief Features of one frame.
+ */
+typedef struct MicroDoppler_Features_t
+{
+    /*! @brief Center range bin of the gate */
+    uint16_t rangeBin;
+
+    /*! @brief Number of frames in the spectrogram (up to windowLen) */
+    uint16_t numFrames;
+
+    /*! @brief Power weighted mean Doppler bin, Q8 */
+    int16_t centroidQ8;
+
+    /*! @brief Power weighted RMS spread around the centroid in bins, Q8 */
+    uint16_t bandwidthQ8;
+
+    /*! @brief Lowest and highest bin within envelopeDb of the peak, Q8 */
+    int16_t envelopeLowQ8;
+    int16_t envelopeHighQ8;
+
+    /*! @brief Total power in dB, Q8 */
+    int16_t energyDbQ8;
+
+    /*! @brief Mean of the centroids of the window, Q8 */
+    int16_t meanCentroidQ8;
+
+    /*! @brief RMS spread of the centroids of the window, Q8 */
+    uint16_t centroidSpreadQ8;
+} MicroDoppler_Features;
+
+/*!
+ * @brief State of the micro-Doppler stage.
+ */
+typedef struct MicroDoppler_Obj_t
+{
+    /*! @brief Configuration */
+    MicroDoppler_Config cfg;
+
+    /*! @brief Window over the chirps in Q15 */
+    int16_t window[MICRO_DOPPLER_MAX_CHIRPS];
+
+    /*! @brief exp(-j 2 pi n / fftSize) in Q15 */
+    int16_t twiddleRe[MICRO_DOPPLER_MAX_FFT_SIZE];
+    int16_t twiddleIm[MICRO_DOPPLER_MAX_FFT_SIZE];
+
+    /*! @brief Spectrum of the current frame, centered */
+    uint64_t power[MICRO_DOPPLER_MAX_FFT_SIZE];
+
+    /*! @brief Spectrogram: ring buffer of windowLen columns of fftSize bytes (0.5 dB steps), centered */
+    uint8_t spectrogram[MICRO_DOPPLER_MAX_WINDOW_LEN * MICRO_DOPPLER_MAX_FFT_SIZE];
+
+    /*! @brief Centroids of the frames in the spectrogram, Q8 */
+    int16_t centroids[MICRO_DOPPLER_MAX_WINDOW_LEN];
+
+    /*! @brief Column the next frame is written to */
+    uint32_t head;
+
+    /*! @brief Number of valid columns */
+    uint32_t numFrames;
+} MicroDoppler_Obj;
+
+/**
+ * @brief Checks the configuration, generates the window and twiddle tables, empties the spectrogram.
+ *
+ * @return MICRO_DOPPLER_SUCCESS or MICRO_DOPPLER_EINVAL.
+ */
+int32_t MicroDoppler_init(MicroDoppler_Obj *obj, const MicroDoppler_Config *cfg);
+
+/**
+ * @brief Computes the spectrum of the gate around rangeBin, appends it to the spectrogram and extracts the features.
+ *
+ * The gate is clipped to the range bins of the cube.
+ *
+ * @param[in,out] obj      Initialized stage.
+ * @param[in]     cube     Radar cube matching the configuration.
+ * @param[in]     rangeBin Center range bin of the gate.
+ * @param[out]    features Features of this frame and the window.
+ *
+ * @return MICRO_DOPPLER_SUCCESS, MICRO_DOPPLER_EINVAL if the cube does not match the configuration.
+ */
+int32_t MicroDoppler_process(MicroDoppler_Obj *obj, const RadarCube_View *cube, uint32_t rangeBin,
+                             MicroDoppler_Features *features);
+
+/**
+ * @brief Latest column of the spectrogram (fftSize bytes, centered, 0.5 dB steps), NULL if empty.
+ */
+const uint8_t *MicroDoppler_latestColumn(const MicroDoppler_Obj *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MICRO_DOPPLER_H */
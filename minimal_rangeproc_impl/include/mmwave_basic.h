@@ -66,11 +66,29 @@ int32_t mmwave_openSensor(void);
 */
 int32_t mmwave_configSensor(void);
 
+/**
+ * @brief brings the initialized sensor up to the configured state: channel configuration and RF power on,
+ *        mmwave_openSensor(), mmwave_configSensor() and restore of the factory calibration, all from
+ *        gSysContext.sensorCfg. A failed restore of the calibration is logged only.
+*/
+int32_t mmwave_setupSensor(void);
+
 /**
  * @brief calls the MMWave_start() function, requires the configuration for start (MMWave_StartCfg)
 */
 int32_t mmwave_startSensor(void);
 
+/**
+ * @brief calls the MMWave_stop() function, the sensor stays open and configured
+*/
+int32_t mmwave_stopSensor(void);
+
+/**
+ * @brief replaces the chirp profile of the stopped sensor: MMWave_delProfile() of the current one, then
+ *        mmwave_configSensor() with gSysContext.sensorCfg
+*/
+int32_t mmwave_reconfigSensor(void);
+
 /**
  * @brief calls the MMWave_stop(), MMWave_close() and MMWave_deinit() function
 */
@@ -49,6 +49,7 @@ typedef struct
 
 static void Mmwave_populateDefaultProfileCfg (T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg);
 static void Mmwave_populateDefaultChirpCfg (T_RL_API_SENS_PER_CHIRP_CFG* ptrChirpCfg, T_RL_API_SENS_PER_CHIRP_CTRL* ptrChirpCtrl);
+void Mmwave_populateDefaultSensorCfg (SensorConfig* cfg);
 void MMWave_populateChannelCfg();
 void Mmwave_populateDefaultCalibrationCfg (MMWave_CalibrationCfg* ptrCalibrationCfg);
 void Mmwave_populateDefaultStartCfg (MMWave_StrtCfg* ptrStartCfg);
@@ -0,0 +1,149 @@
+#ifndef PEAK_PICKER_H
+#define PEAK_PICKER_H
+
+/**
+ * @file peak_picker.h
+ * @brief Top-K peaks of a complex range profile with sub-bin interpolation.
+ *
+ * Most frames only need the location of a few targets, not the whole range
+ * profile. This stage searches the local maxima of the power |x|^2 of a
+ * complex range profile (one chirp and antenna of the radar cube, see
+ * RadarCube_rangeProfile()), keeps the maxPeaks strongest ones and describes
+ * each with four numbers: range bin, fractional offset to the true peak,
+ * magnitude and phase. With 8 bytes per peak a handful of targets costs a few
+ * dozen bytes instead of 4 bytes per range bin.
+ *
+ * A bin k is a local maximum if p[k - 1] < p[k] >= p[k + 1] (a plateau counts
+ * once), k >= firstBin, p[k] >= minPower. The first and last bin have only one
+ * neighbour and are never reported. The power of each sample is computed with
+ * one dual 16-bit multiply-accumulate (__smuad of ACLE with the DSP extension
+ * of the M4F, a plain C equivalent elsewhere) while the profile is streamed
+ * once, the strongest maxima are kept sorted by insertion.
+ *
+ * The offset in [-0.5, 0.5] bins is the vertex of the parabola through the
+ * peak and its neighbours:
+ * - PEAK_PICKER_INTERP_PARABOLIC: through the magnitudes |x|, exact for the
+ *   triangle-like main lobe of a rectangular window.
+ * - PEAK_PICKER_INTERP_GAUSSIAN: through the log magnitudes, exact for a
+ *   Gaussian main lobe and the better choice for the Hann, Blackman and
+ *   Kaiser range windows (the main lobe of a tapered window is close to a
+ *   Gaussian).
+ * The magnitude is taken at the vertex of the log parabola, the phase is the
+ * phase of the peak bin.
+ *
+ * Everything is computed in fixed point. Only depends on the C standard library
+ * (and the portable fixed_math.c for logarithm and phase; radar_cube.h
+ * needs HOST_BUILD on the host), so this file is shared between the firmware
+ * and the host tools in `host/` (see `host/peak_picker_bench.c`).
+ */
+
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define PEAK_PICKER_SUCCESS             (0)
+#define PEAK_PICKER_EINVAL              (-1)
+
+/**
+ * @brief Maximum number of peaks per profile.
+ */
+#define PEAK_PICKER_MAX_PEAKS           (16U)
+
+/**
+ * @brief Sub-bin interpolation.
+ */
+typedef enum PeakPicker_Interp_e
+{
+    /*! @brief No interpolation, offset 0 */
+    PEAK_PICKER_INTERP_NONE = 0,
+
+    /*! @brief Parabola through the magnitudes */
+    PEAK_PICKER_INTERP_PARABOLIC,
+
+    /*! @brief Parabola through the log magnitudes */
+    PEAK_PICKER_INTERP_GAUSSIAN
+} PeakPicker_Interp;
+
+/*!
+ * @brief Peak picker configuration.
+ */
+typedef struct PeakPicker_Config_t
+{
+    /*! @brief Sub-bin interpolation */
+    PeakPicker_Interp interp;
+
+    /*! @brief Number of range bins of the profile (3..65535) */
+    uint32_t numRangeBins;
+
+    /*! @brief Maximum number of peaks reported (1..PEAK_PICKER_MAX_PEAKS) */
+    uint32_t maxPeaks;
+
+    /*! @brief First range bin searched, skips the leakage around zero range */
+    uint32_t firstBin;
+
+    /*! @brief Minimum power |x|^2 of a peak, 0 for the strongest maxima regardless of their level */
+    uint32_t minPower;
+} PeakPicker_Config;
+
+/*!
+ * @brief One peak.
+ */
+typedef struct PeakPicker_Peak_t
+{
+    /*! @brief Range bin of the local maximum */
+    uint16_t rangeBin;
+
+    /*! @brief Offset of the interpolated peak from rangeBin in bins, Q15 (-16384..16384 for -0.5..0.5) */
+    int16_t offsetQ15;
+
+    /*! @brief log2 of the interpolated magnitude in Q8 (1 LSB = 6.02 / 256 dB) */
+    uint16_t log2MagQ8;
+
+    /*! @brief Phase of rangeBin, atan2(imag, real) / pi in Q15 */
+    int16_t phaseQ15;
+} PeakPicker_Peak;
+
+/*!
+ * @brief Summary of one run.
+ */
+typedef struct PeakPicker_Result_t
+{
+    /*! @brief Number of peaks written, strongest first */
+    uint32_t numPeaks;
+
+    /*! @brief Number of local maxima above minPower, including the ones not reported */
+    uint32_t numCandidates;
+} PeakPicker_Result;
+
+/**
+ * @brief Checks a configuration.
+ *
+ * @return PEAK_PICKER_SUCCESS or PEAK_PICKER_EINVAL.
+ */
+int32_t PeakPicker_checkConfig(const PeakPicker_Config *cfg);
+
+/**
+ * @brief Finds the strongest local maxima of a range profile.
+ *
+ * @param[in]  cfg     Checked configuration.
+ * @param[in]  profile numRangeBins complex samples, 4 byte aligned.
+ * @param[out] peaks   maxPeaks entries, the first numPeaks are written, strongest first.
+ * @param[out] result  Number of peaks and candidates.
+ *
+ * @return PEAK_PICKER_SUCCESS or PEAK_PICKER_EINVAL.
+ */
+int32_t PeakPicker_process(const PeakPicker_Config *cfg, const cmplx16ImRe_t *profile, PeakPicker_Peak *peaks,
+                           PeakPicker_Result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PEAK_PICKER_H */
@@ -0,0 +1,616 @@
+#ifndef PROC_CONFIG_H
+#define PROC_CONFIG_H
+
+/**
+ * @file proc_config.h
+ *
+ * @brief Build-time options of the processing chain and the UART output.
+ *
+ * In contrast to defines.h, which holds the sensor front-end parameters and is
+ * generated from a chirp configuration, this file holds the options of the
+ * processing chain itself. It is maintained by hand. Every option can also be
+ * overridden from the compiler command line (-D<option>=<value>).
+ */
+
+/**
+ * @brief Pipelined processing and transmission.
+ *
+ * 1: After each frame the DPC copies the transmitted part of the radar cube into
+ *    one of two snapshot buffers and re-arms the Rangeproc DPU right away, while
+ *    the UART task drains the other snapshot. If the UART falls behind, frames
+ *    are dropped (see gUartTxSnapshots.numFramesDropped), processing never stalls.
+ * 0: The DPC waits for the UART transmission to complete before the next frame
+ *    is processed.
+ */
+#ifndef APP_PIPELINED_TX
+#define APP_PIPELINED_TX                1
+#endif
+
+/**
+ * @brief Low-power mode of the Rangeproc DPU and no chirp debug interrupts.
+ *
+ * 1: The Rangeproc DPU runs with lowPowerMode, i.e. it restores its HWA and
+ *    EDMA configuration for every frame instead of relying on them being
+ *    retained, and the chirp start/end and chirp available interrupts, which
+ *    only count chirps for debugging, are not registered, so the M4F is not
+ *    woken for every chirp.
+ * 0: All interrupts registered, the DPU assumes the HWA keeps its state.
+ *
+ * This is a prerequisite for, not an implementation of, low-power operation.
+ * Sleeping between frames is not part of this firmware: tickless idle (or a
+ * WFI idle hook woken by frameStartISR) and gating of the HWA and UART clocks
+ * need a FreeRTOS and SOC/Power configuration of the SDK build that this
+ * project does not carry. The M4F waits in the FreeRTOS idle task between
+ * frames; the time it spends there is reported by APP_TX_DUTY_CYCLE, which is
+ * the baseline to measure such a change against.
+ */
+#ifndef APP_DPU_LOW_POWER_MODE
+#define APP_DPU_LOW_POWER_MODE          0
+#endif
+
+/**
+ * @brief Command line interface for .cfg commands over the UART (cli.c).
+ *
+ * 1: A CLI task parses the channelCfg, chirpComnCfg, chirpTimingCfg, frameCfg,
+ *    factoryCalibCfg and sensorStart commands received over the UART. During
+ *    start-up the firmware waits up to APP_CLI_START_TIMEOUT_MS for a
+ *    configuration completed with sensorStart before the sensor is set up,
+ *    later ones are applied with rangeProc_reconfigure().
+ * 0: The sensor always runs with the parameters of defines.h.
+ */
+#ifndef APP_CLI_ENABLE
+#define APP_CLI_ENABLE                  1
+#endif
+
+/**
+ * @brief Time to wait for a configuration during start-up in ms, 0 to start with defines.h right away.
+ */
+#ifndef APP_CLI_START_TIMEOUT_MS
+#define APP_CLI_START_TIMEOUT_MS        1000
+#endif
+
+/**
+ * @brief Number of sub-frames taking turns frame by frame (1..4), each with its own chirp profile.
+ *
+ * The front end of the xWRL6432 runs one chirp profile per frame
+ * configuration, so sub-frames are time-multiplexed: after every frame the DPC
+ * stops the sensor and sets it up with the profile of the next sub-frame
+ * (APP_SUBFRAME_SWITCH, which has to be chosen explicitly). Sub-frame 0
+ * runs the configuration of defines.h (or the CLI), the others differ in the
+ * chirp slope and start frequency (APP_SUBFRAME_SLOPES_MHZ_US,
+ * APP_SUBFRAME_START_FREQS_GHZ), e.g. a long-range and a short-range profile.
+ * Each sub-frame has its own radar cube in L3 and its own Rangeproc DPU
+ * configuration, prepared by dpc_config(); switching neither allocates nor
+ * reconfigures the other stages. Every frame carries FRAME_PROTO_TLV_SUBFRAME.
+ *
+ * The radar cube dimensions are shared, so the range ROI has to be given in
+ * bins. Stages that accumulate over frames would mix the sub-frames: more than
+ * one sub-frame needs APP_CUBE_RING_DEPTH 0, APP_CLUTTER_REMOVAL_MODE
+ * CLUTTER_REMOVAL_MODE_MEAN and neither minor motion nor micro-Doppler.
+ */
+#ifndef APP_NUM_SUBFRAMES
+#define APP_NUM_SUBFRAMES               1
+#endif
+
+/**
+ * @brief Chirp slope per sub-frame in MHz/us, 0 for the slope of sub-frame 0 (first APP_NUM_SUBFRAMES entries used).
+ */
+#ifndef APP_SUBFRAME_SLOPES_MHZ_US
+#define APP_SUBFRAME_SLOPES_MHZ_US      { 0.0f, 0.0f, 0.0f, 0.0f }
+#endif
+
+/**
+ * @brief Start frequency per sub-frame in GHz, 0 for the start frequency of sub-frame 0.
+ */
+#ifndef APP_SUBFRAME_START_FREQS_GHZ
+#define APP_SUBFRAME_START_FREQS_GHZ    { 0.0f, 0.0f, 0.0f, 0.0f }
+#endif
+
+/**
+ * @brief How the sensor is switched to the profile of the next sub-frame, opt-in for APP_NUM_SUBFRAMES > 1.
+ *
+ * Every switch stops the sensor after a frame and starts it again, which
+ * restarts the frame period; the DPC delays the start until one frame period
+ * (framePeriodicity) after the previous one, so frames stay periodic as long
+ * as processing and switch fit into the idle time of the frame.
+ *
+ * 0: no switching, APP_NUM_SUBFRAMES > 1 does not build.
+ * 1: MMWave_stop(), the chirp profile is replaced with MMWave_config() and the
+ *    sensor started again; RF power, MMWave_open() and the factory calibration
+ *    of the start-up are kept.
+ * 2: full restart as in rangeProc_reconfigure(): MMWave_stop(), close, deinit,
+ *    init, RF power on, open, config and factory calibration before every frame.
+ */
+#ifndef APP_SUBFRAME_SWITCH
+#define APP_SUBFRAME_SWITCH             0
+#endif
+
+/**
+ * @brief Time reserved for a sub-frame switch in us.
+ *
+ * Configurations whose idle time per frame (frame period minus the bursts) is
+ * shorter are rejected. Switches which nevertheless start the sensor later than
+ * one frame period after the previous start are counted in
+ * FRAME_PROTO_TLV_SUBFRAME.
+ */
+#ifndef APP_SUBFRAME_SWITCH_BUDGET_US
+#define APP_SUBFRAME_SWITCH_BUDGET_US   10000
+#endif
+
+/**
+ * @brief Send the acquisition, processing and idle time of the previous frame as FRAME_PROTO_TLV_DUTY_CYCLE.
+ */
+#ifndef APP_TX_DUTY_CYCLE
+#define APP_TX_DUTY_CYCLE               1
+#endif
+
+/**
+ * @brief Chirp of the radar cube whose range profile is sent over UART.
+ *
+ * Index of the Doppler chirp, i.e. in [0, number of chirps per frame / number of TX antennas).
+ */
+#ifndef APP_TX_CHIRP_IDX
+#define APP_TX_CHIRP_IDX                1
+#endif
+
+/**
+ * @brief Virtual antenna of the radar cube whose range profile is sent over UART.
+ *
+ * Index in [0, number of TX antennas * number of RX antennas).
+ */
+#ifndef APP_TX_ANTENNA_IDX
+#define APP_TX_ANTENNA_IDX              0
+#endif
+
+/**
+ * @brief Zero-padding factor of the range FFT (1, 2 or 4).
+ *
+ * The range FFT size is APP_RANGE_FFT_ZERO_PAD times the number of ADC samples
+ * rounded up to a power of 2, the HWA fills the rest of the FFT input with
+ * zeros. The window still covers the ADC samples only. The number of range bins
+ * and with it the radar cube, all stages and the UART payloads grow by the same
+ * factor, the bin spacing shrinks by it: an interpolated profile for finer peak
+ * localization without longer chirps, not a higher range resolution. Options
+ * counted in range bins (CFAR guard and training cells, micro-Doppler gate)
+ * are not scaled.
+ */
+#ifndef APP_RANGE_FFT_ZERO_PAD
+#define APP_RANGE_FFT_ZERO_PAD          1
+#endif
+
+/**
+ * @brief Window of the range FFT, one of the RANGE_WINDOW_* types of range_window.h.
+ *
+ * RANGE_WINDOW_HANN, RANGE_WINDOW_HAMMING, RANGE_WINDOW_BLACKMAN,
+ * RANGE_WINDOW_BLACKMAN_HARRIS or RANGE_WINDOW_KAISER. The tables are generated
+ * together with defines.h by scripts/chirp_config_to_defines.py (the Kaiser
+ * beta is an option of the script) and read from flash, nothing is computed
+ * at startup. Lower sidelobes (Blackman-Harris, Kaiser with a large beta) keep
+ * weak targets next to strong ones visible at the cost of a wider main lobe.
+ */
+#ifndef APP_RANGE_WINDOW
+#define APP_RANGE_WINDOW                RANGE_WINDOW_BLACKMAN
+#endif
+
+/**
+ * @brief Right shift of the range window with hardware chirp accumulation (numOfChirpsAccum > 1), -1: automatic.
+ *
+ * The front end adds up the ADC samples of the accumulated chirps, so the
+ * samples grow by up to log2(numOfChirpsAccum) bits into the 4 bits above the
+ * 12-bit ADC (at most 16 chirps, see rangeProc_checkConfig()). -1 scales the
+ * window down by that growth, rounded up: the 24-bit HWA datapath keeps its 8
+ * bits of headroom for the range FFT and the radar cube keeps the scale of a
+ * single chirp, the averaging gain shows as a lower noise floor. The scaled
+ * window is copied from flash into the core local memory pool; without
+ * accumulation, or with a shift of 0 for a front end that normalizes the sum,
+ * the table is used in place.
+ */
+#ifndef APP_CHIRP_ACCUM_WINDOW_SHIFT
+#define APP_CHIRP_ACCUM_WINDOW_SHIFT    (-1)
+#endif
+
+/**
+ * @brief Range region of interest: first range bin kept in the radar cube.
+ *
+ * Only the range bins APP_RANGE_ROI_START_BIN..APP_RANGE_ROI_STOP_BIN of the
+ * range FFT are kept. The Rangeproc DPU writes the bins up to the stop bin
+ * only (its EDMA output is shortened), the bins in front of the start bin are
+ * dropped by moving the range profiles together right after the DPU. The radar
+ * cube, all stages and the UART payloads then cover the ROI only, range bins
+ * are relative to the start bin (RadarCube_View.rangeOffset) on the device and
+ * absolute in all transmitted TLVs, FRAME_PROTO_TLV_RANGE_ROI tells the host
+ * where the ROI is. With a ring of whole radar cubes (APP_CUBE_RING_DEPTH) and
+ * a start bin > 0 the DPU writes into an extra buffer of the bins up to the
+ * stop bin, the ring slots hold the ROI only. The minor motion radar cube is
+ * written by the DPU for the bins up to the stop bin, the bins in front of the
+ * start bin are not searched.
+ */
+#ifndef APP_RANGE_ROI_START_BIN
+#define APP_RANGE_ROI_START_BIN         0
+#endif
+
+/**
+ * @brief Range region of interest: last range bin kept in the radar cube (inclusive), -1 for the last range bin.
+ */
+#ifndef APP_RANGE_ROI_STOP_BIN
+#define APP_RANGE_ROI_STOP_BIN          (-1)
+#endif
+
+/**
+ * @brief Range region of interest in metres: near end, used instead of the bins if APP_RANGE_ROI_MAX_M > 0.
+ *
+ * Converted to range bins at startup with the chirp slope and the ADC sampling
+ * rate of defines.h: the ROI covers every bin with a part of [min, max].
+ */
+#ifndef APP_RANGE_ROI_MIN_M
+#define APP_RANGE_ROI_MIN_M             0.0f
+#endif
+
+/**
+ * @brief Range region of interest in metres: far end, 0 to use APP_RANGE_ROI_START_BIN / APP_RANGE_ROI_STOP_BIN.
+ */
+#ifndef APP_RANGE_ROI_MAX_M
+#define APP_RANGE_ROI_MAX_M             0.0f
+#endif
+
+/**
+ * @brief Number of frames kept in the ring of the last radar cubes (cube_ring.h) in L3, 0 for a single radar cube.
+ *
+ * 2..CUBE_RING_MAX_DEPTH: Every processed frame is published in the ring
+ * (gSysContext.cubeRing) after the UART frame has been submitted. Slow-time
+ * processing pins the frames it needs with CubeRing_acquire() and reads them
+ * in place while newer frames go to the other slots. At most depth - 1 frames
+ * may be pinned at a time, otherwise frames are dropped from the ring.
+ *
+ * Opt-in: none of the processing in this application reads the ring, it is
+ * provided for slow-time extensions. With whole cubes the ring also costs a
+ * DPU_RangeProcHWA_config() per frame and depth times the radar cube in L3.
+ */
+#ifndef APP_CUBE_RING_DEPTH
+#define APP_CUBE_RING_DEPTH             0
+#endif
+
+/**
+ * @brief Content of the ring slots (APP_CUBE_RING_DEPTH > 0).
+ *
+ * 0: Whole radar cubes. The Rangeproc DPU writes directly into the ring, its
+ *    output is moved to the next slot by reconfiguring it between frames.
+ * 1: Range profiles of all virtual antennas of chirp APP_TX_CHIRP_IDX (one
+ *    chirp per slot), copied from the single radar cube. Much smaller slots,
+ *    for deep histories such as vital signs.
+ */
+#ifndef APP_CUBE_RING_PROFILES
+#define APP_CUBE_RING_PROFILES          0
+#endif
+
+/**
+ * @brief Static clutter removal (clutter_removal.h) on the radar cube, right after the Rangeproc DPU.
+ *
+ * 1: A background per range bin and virtual antenna is subtracted from every
+ *    chirp, before any other stage and the transmitted range profile.
+ * 0: The radar cube is used as written by the Rangeproc DPU.
+ */
+#ifndef APP_CLUTTER_REMOVAL_ENABLE
+#define APP_CLUTTER_REMOVAL_ENABLE      1
+#endif
+
+/**
+ * @brief Background estimator (CLUTTER_REMOVAL_MODE_MEAN or CLUTTER_REMOVAL_MODE_EMA).
+ *
+ * CLUTTER_REMOVAL_MODE_MEAN removes everything at zero Doppler within the
+ * frame, CLUTTER_REMOVAL_MODE_EMA only what stays for several frames.
+ */
+#ifndef APP_CLUTTER_REMOVAL_MODE
+#define APP_CLUTTER_REMOVAL_MODE        CLUTTER_REMOVAL_MODE_MEAN
+#endif
+
+/**
+ * @brief CLUTTER_REMOVAL_MODE_EMA: averaging factor 2^-shift per frame (time constant about 2^shift frames).
+ */
+#ifndef APP_CLUTTER_REMOVAL_EMA_SHIFT
+#define APP_CLUTTER_REMOVAL_EMA_SHIFT   4
+#endif
+
+/**
+ * @brief Non-coherent integration (range_integration.h) of all chirps and virtual antennas into one range profile.
+ *
+ * Sent as FRAME_PROTO_TLV_INTEGRATED_RANGE_PROFILE, numRangeBins values per
+ * frame instead of the complex profile of a single chirp and antenna.
+ */
+#ifndef APP_RANGE_INTEGRATION_ENABLE
+#define APP_RANGE_INTEGRATION_ENABLE    1
+#endif
+
+/**
+ * @brief Format of the integrated range profile (RANGE_INTEGRATION_OUTPUT_LOG2_MAG or RANGE_INTEGRATION_OUTPUT_POWER).
+ *
+ * RANGE_INTEGRATION_OUTPUT_LOG2_MAG: 2 bytes per range bin, log2 of the magnitude in Q8.
+ * RANGE_INTEGRATION_OUTPUT_POWER:    4 bytes per range bin, linear power.
+ */
+#ifndef APP_RANGE_INTEGRATION_OUTPUT
+#define APP_RANGE_INTEGRATION_OUTPUT    RANGE_INTEGRATION_OUTPUT_LOG2_MAG
+#endif
+
+/**
+ * @brief Strongest peaks (peak_picker.h) of the range profile of APP_TX_CHIRP_IDX / APP_TX_ANTENNA_IDX.
+ *
+ * Sent as FRAME_PROTO_TLV_RANGE_PEAKS: range bin, sub-bin offset, magnitude
+ * and phase of up to APP_PEAKS_MAX peaks, 8 bytes each. With
+ * APP_TX_RANGE_PROFILE 0 this replaces the 4 bytes per range bin of the dense
+ * profile.
+ */
+#ifndef APP_PEAKS_ENABLE
+#define APP_PEAKS_ENABLE                1
+#endif
+
+/**
+ * @brief Maximum number of peaks per frame, 1..PEAK_PICKER_MAX_PEAKS.
+ */
+#ifndef APP_PEAKS_MAX
+#define APP_PEAKS_MAX                   8
+#endif
+
+/**
+ * @brief Sub-bin interpolation (PEAK_PICKER_INTERP_NONE, PEAK_PICKER_INTERP_PARABOLIC or PEAK_PICKER_INTERP_GAUSSIAN).
+ *
+ * PEAK_PICKER_INTERP_GAUSSIAN suits the tapered range windows (APP_RANGE_WINDOW),
+ * PEAK_PICKER_INTERP_PARABOLIC a rectangular one.
+ */
+#ifndef APP_PEAKS_INTERP
+#define APP_PEAKS_INTERP                PEAK_PICKER_INTERP_GAUSSIAN
+#endif
+
+/**
+ * @brief First range bin searched for peaks, skips the leakage around zero range.
+ */
+#ifndef APP_PEAKS_FIRST_BIN
+#define APP_PEAKS_FIRST_BIN             2
+#endif
+
+/**
+ * @brief Minimum power |x|^2 of a peak, 0 to always send the APP_PEAKS_MAX strongest local maxima.
+ */
+#ifndef APP_PEAKS_MIN_POWER
+#define APP_PEAKS_MIN_POWER             0
+#endif
+
+/**
+ * @brief Doppler stage (doppler_proc.h) after the Rangeproc DPU.
+ *
+ * 1: A range-Doppler heat map is computed on the HWA after each frame.
+ * 0: The chain stops at the radar cube.
+ */
+#ifndef APP_DOPPLER_ENABLE
+#define APP_DOPPLER_ENABLE              1
+#endif
+
+/**
+ * @brief Window of the Doppler FFT (MATHUTILS_WIN_HANNING, MATHUTILS_WIN_BLACKMAN or MATHUTILS_WIN_RECT).
+ */
+#ifndef APP_DOPPLER_WINDOW
+#define APP_DOPPLER_WINDOW              MATHUTILS_WIN_HANNING
+#endif
+
+/**
+ * @brief Right shift of the 16-bit Doppler FFT magnitudes, in [0, 8].
+ *
+ * Increase if strong targets saturate the heat map at 0xFFFF.
+ */
+#ifndef APP_DOPPLER_FFT_OUTPUT_DIV_SHIFT
+#define APP_DOPPLER_FFT_OUTPUT_DIV_SHIFT 0
+#endif
+
+/**
+ * @brief Send the range-Doppler heat map over UART (needs APP_DOPPLER_ENABLE).
+ *
+ * numRangeBins * Doppler FFT size * 2 bytes per frame, see FRAME_PROTO_TLV_RANGE_DOPPLER_HEATMAP.
+ */
+#ifndef APP_TX_HEATMAP
+#define APP_TX_HEATMAP                  1
+#endif
+
+/**
+ * @brief CFAR detection (cfar.h) on the range-Doppler heat map.
+ *
+ * Without APP_DOPPLER_ENABLE the detection runs on the magnitude of the
+ * transmitted range profile. The detections are sent as FRAME_PROTO_TLV_DETECTIONS.
+ */
+#ifndef APP_CFAR_ENABLE
+#define APP_CFAR_ENABLE                 1
+#endif
+
+/**
+ * @brief CFAR noise estimator (CFAR_MODE_CA, CFAR_MODE_CAGO, CFAR_MODE_CASO or CFAR_MODE_OS).
+ */
+#ifndef APP_CFAR_MODE
+#define APP_CFAR_MODE                   CFAR_MODE_CASO
+#endif
+
+/**
+ * @brief Number of CFAR guard cells on each side of the cell under test.
+ */
+#ifndef APP_CFAR_GUARD_LEN
+#define APP_CFAR_GUARD_LEN              2
+#endif
+
+/**
+ * @brief Number of CFAR training cells on each side (at most CFAR_MAX_TRAIN_LEN).
+ */
+#ifndef APP_CFAR_TRAIN_LEN
+#define APP_CFAR_TRAIN_LEN              8
+#endif
+
+/**
+ * @brief CFAR_MODE_OS: rank of the noise estimate among the 2 * APP_CFAR_TRAIN_LEN training cells (0-based).
+ */
+#ifndef APP_CFAR_OS_RANK
+#define APP_CFAR_OS_RANK                12
+#endif
+
+/**
+ * @brief CFAR threshold, ratio of cell and noise estimate in Q8 (1024: 4.0 = 12 dB in magnitude).
+ * CFAR_MODE_OS estimates a higher noise level, about 8 dB (644) gives a similar false alarm rate.
+ */
+#ifndef APP_CFAR_THRESHOLD_Q8
+#define APP_CFAR_THRESHOLD_Q8           1024
+#endif
+
+/**
+ * @brief Confirm CFAR detections with the same test along the Doppler axis, cyclic (1) or not (0).
+ */
+#ifndef APP_CFAR_DOPPLER_CHECK
+#define APP_CFAR_DOPPLER_CHECK          1
+#endif
+
+/**
+ * @brief Only report detections which are local maxima along range and Doppler (1) or all cells above the
+ * threshold (0).
+ */
+#ifndef APP_CFAR_PEAK_GROUPING
+#define APP_CFAR_PEAK_GROUPING          1
+#endif
+
+/**
+ * @brief Maximum number of detections sent per frame.
+ */
+#ifndef APP_CFAR_MAX_DETECTIONS
+#define APP_CFAR_MAX_DETECTIONS         64
+#endif
+
+/**
+ * @brief Send the dense range profile of APP_TX_CHIRP_IDX / APP_TX_ANTENNA_IDX over UART.
+ *
+ * Set to 0 (together with APP_TX_HEATMAP) to send only the detection list,
+ * which shrinks the frames by orders of magnitude.
+ */
+#ifndef APP_TX_RANGE_PROFILE
+#define APP_TX_RANGE_PROFILE            1
+#endif
+
+/**
+ * @brief Direction of arrival (doa.h) of the CFAR detections (needs APP_CFAR_ENABLE).
+ *
+ * 1: Every detection gets an azimuth and elevation estimate from the virtual
+ *    antennas, the points are sent as FRAME_PROTO_TLV_POINT_CLOUD instead of
+ *    FRAME_PROTO_TLV_DETECTIONS.
+ * 0: Only the detection list is sent.
+ */
+#ifndef APP_DOA_ENABLE
+#define APP_DOA_ENABLE                  1
+#endif
+
+/**
+ * @brief Size of the zero-padded azimuth DFT (power of two, 4..DOA_MAX_AZIMUTH_FFT_SIZE).
+ */
+#ifndef APP_DOA_AZIMUTH_FFT_SIZE
+#define APP_DOA_AZIMUTH_FFT_SIZE        32
+#endif
+
+/**
+ * @brief Position of the virtual antennas in half wavelengths, one entry per
+ *        virtual antenna (TX major: TX0 RX0..RX2, TX1 RX0..RX2).
+ *
+ * Same values as the antGeometryCfg of the TI demos, the defaults are the ones
+ * of the IWRL6432BOOST: TX1 is offset by one row and one column against TX0.
+ */
+#ifndef APP_DOA_ANT_ROWS
+#define APP_DOA_ANT_ROWS                {1, 1, 1, 0, 0, 0}
+#endif
+#ifndef APP_DOA_ANT_COLS
+#define APP_DOA_ANT_COLS                {0, 1, 2, 1, 2, 3}
+#endif
+
+/**
+ * @brief Micro-Doppler spectrogram and features (micro_doppler.h) of one range gate.
+ *
+ * 1: Every frame the Doppler spectrum of the gate is appended to the
+ *    spectrogram and FRAME_PROTO_TLV_MICRO_DOPPLER is sent.
+ * 0: Disabled.
+ */
+#ifndef APP_UDOP_ENABLE
+#define APP_UDOP_ENABLE                 1
+#endif
+
+/**
+ * @brief Center range bin of the gate, -1: the range bin of the strongest
+ *        detection (needs APP_CFAR_ENABLE, the gate stays put in frames without detections).
+ */
+#ifndef APP_UDOP_RANGE_BIN
+#define APP_UDOP_RANGE_BIN              (-1)
+#endif
+
+/**
+ * @brief Number of range bins of the gate.
+ */
+#ifndef APP_UDOP_GATE_LEN
+#define APP_UDOP_GATE_LEN               3
+#endif
+
+/**
+ * @brief Size of the zero-padded Doppler DFT (power of two, number of Doppler chirps..MICRO_DOPPLER_MAX_FFT_SIZE).
+ */
+#ifndef APP_UDOP_FFT_SIZE
+#define APP_UDOP_FFT_SIZE               16
+#endif
+
+/**
+ * @brief Number of frames of the spectrogram (1..MICRO_DOPPLER_MAX_WINDOW_LEN).
+ */
+#ifndef APP_UDOP_WINDOW_LEN
+#define APP_UDOP_WINDOW_LEN             32
+#endif
+
+/**
+ * @brief Level below the peak of the spectrum defining the envelope in dB.
+ */
+#ifndef APP_UDOP_ENVELOPE_DB
+#define APP_UDOP_ENVELOPE_DB            20
+#endif
+
+/**
+ * @brief Append the latest spectrogram column to FRAME_PROTO_TLV_MICRO_DOPPLER (1) or only send the features (0).
+ */
+#ifndef APP_UDOP_TX_COLUMN
+#define APP_UDOP_TX_COLUMN              1
+#endif
+
+/**
+ * @brief Minor motion mode next to major motion (e.g. seated or breathing people).
+ *
+ * 1: The Rangeproc DPU additionally writes the first APP_MINOR_MOTION_CHIRPS_PER_FRAME
+ *    chirps of every frame into a separate minor motion radar cube in L3, which
+ *    holds the chirps of the last APP_MINOR_MOTION_NUM_FRAMES frames (sliding
+ *    window). Once the window is filled, a second Doppler stage computes a
+ *    minor motion heat map from it every frame and a second CFAR pass (zero
+ *    Doppler bin cleared) sends the moving cells as FRAME_PROTO_TLV_MINOR_MOTION_DETECTIONS.
+ *    Needs APP_DOPPLER_ENABLE and APP_CFAR_ENABLE; processing can be paused at
+ *    run time with rangeProc_setMinorMotion().
+ * 0: Major motion only.
+ *
+ * The L3 and core local memory used per stage is logged at start-up.
+ */
+#ifndef APP_MINOR_MOTION_ENABLE
+#define APP_MINOR_MOTION_ENABLE         0
+#endif
+
+/**
+ * @brief Chirps of ADC data per frame going into the minor motion radar cube (a multiple of the number of TX antennas).
+ *
+ * Default: one burst, after the hardware chirp accumulation (CLI_NUM_CHIRPS_ACCUM).
+ */
+#ifndef APP_MINOR_MOTION_CHIRPS_PER_FRAME
+#define APP_MINOR_MOTION_CHIRPS_PER_FRAME   (CLI_NUM_CHIRPS_PER_BURST / ((CLI_NUM_CHIRPS_ACCUM > 1) ? CLI_NUM_CHIRPS_ACCUM : 1))
+#endif
+
+/**
+ * @brief Frames accumulated in the minor motion radar cube.
+ *
+ * The minor motion cube holds APP_MINOR_MOTION_NUM_FRAMES * APP_MINOR_MOTION_CHIRPS_PER_FRAME /
+ * number of TX antennas Doppler chirps (at most 256 for the Doppler FFT); the
+ * integration time is APP_MINOR_MOTION_NUM_FRAMES frame periods.
+ */
+#ifndef APP_MINOR_MOTION_NUM_FRAMES
+#define APP_MINOR_MOTION_NUM_FRAMES     8
+#endif
+
+#endif /* PROC_CONFIG_H */
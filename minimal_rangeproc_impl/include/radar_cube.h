@@ -0,0 +1,226 @@
+#ifndef RADAR_CUBE_H
+#define RADAR_CUBE_H
+
+/**
+ * @file radar_cube.h
+ * @brief Typed view on the radar cube in DPIF_RADARCUBE_FORMAT_6.
+ *
+ * The Rangeproc DPU writes the radar cube as Cube[chirp][antenna][range], i.e.
+ * the range bins of one (Doppler) chirp and virtual antenna are contiguous,
+ * followed by the next antenna, followed by the next chirp:
+ *
+ * @code
+ * index = (chirp * numAntennas + antenna) * numRangeBins + rangeBin
+ * @endcode
+ *
+ * With a range region of interest the cube only holds the range bins
+ * [rangeOffset, rangeOffset + numRangeBins) of the range FFT: all indices of
+ * the view are relative to rangeOffset, the absolute range bin of a sample is
+ * rangeBin + rangeOffset.
+ *
+ * All stages access the cube through this view instead of deriving the strides
+ * themselves. There are three kinds of one-dimensional slices:
+ * - range slice:   all range bins of one chirp and antenna (contiguous)
+ * - antenna slice: all virtual antennas of one chirp and range bin (stride numRangeBins)
+ * - chirp slice:   all chirps of one antenna and range bin (stride numAntennas * numRangeBins)
+ *
+ * Header only. Apart from cmplx16ImRe_t it only depends on the C standard
+ * library; host builds define HOST_BUILD to get a layout compatible definition
+ * of cmplx16ImRe_t.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef HOST_BUILD
+/*! @brief Host replacement of the SDK type (same layout: imaginary part first) */
+typedef struct cmplx16ImRe_t_
+{
+    int16_t imag;
+    int16_t real;
+} cmplx16ImRe_t;
+#else
+#include <common/syscommon.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief View on a radar cube in DPIF_RADARCUBE_FORMAT_6.
+ */
+typedef struct RadarCube_View_t
+{
+    /*! @brief First sample of the radar cube */
+    cmplx16ImRe_t *data;
+
+    /*! @brief Number of (Doppler) chirps */
+    uint32_t numChirps;
+
+    /*! @brief Number of virtual antennas */
+    uint32_t numAntennas;
+
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+
+    /*! @brief Absolute range bin (of the range FFT) of range bin 0 of the cube */
+    uint32_t rangeOffset;
+} RadarCube_View;
+
+/*!
+ * @brief One-dimensional strided slice of a radar cube.
+ */
+typedef struct RadarCube_Slice_t
+{
+    /*! @brief First sample of the slice */
+    cmplx16ImRe_t *data;
+
+    /*! @brief Distance between two consecutive samples in samples */
+    uint32_t stride;
+
+    /*! @brief Number of samples */
+    uint32_t count;
+} RadarCube_Slice;
+
+/**
+ * @brief Initializes a view on a radar cube starting at range bin 0.
+ */
+static inline void RadarCube_initView(RadarCube_View *view, cmplx16ImRe_t *data,
+                                      uint32_t numChirps, uint32_t numAntennas, uint32_t numRangeBins) {
+    view->data         = data;
+    view->numChirps    = numChirps;
+    view->numAntennas  = numAntennas;
+    view->numRangeBins = numRangeBins;
+    view->rangeOffset  = 0U;
+}
+
+/**
+ * @brief Total number of samples of the radar cube.
+ */
+static inline uint32_t RadarCube_numSamples(const RadarCube_View *view) {
+    return view->numChirps * view->numAntennas * view->numRangeBins;
+}
+
+/**
+ * @brief Distance between two chirps of the same antenna and range bin in samples.
+ */
+static inline uint32_t RadarCube_chirpStride(const RadarCube_View *view) {
+    return view->numAntennas * view->numRangeBins;
+}
+
+/**
+ * @brief Distance between two antennas of the same chirp and range bin in samples.
+ */
+static inline uint32_t RadarCube_antennaStride(const RadarCube_View *view) {
+    return view->numRangeBins;
+}
+
+/**
+ * @brief Index of a sample within the radar cube.
+ */
+static inline uint32_t RadarCube_index(const RadarCube_View *view, uint32_t chirp, uint32_t antenna, uint32_t rangeBin) {
+    return ((chirp * view->numAntennas) + antenna) * view->numRangeBins + rangeBin;
+}
+
+/**
+ * @brief Pointer to a sample of the radar cube.
+ */
+static inline cmplx16ImRe_t *RadarCube_at(const RadarCube_View *view, uint32_t chirp, uint32_t antenna, uint32_t rangeBin) {
+    return &view->data[RadarCube_index(view, chirp, antenna, rangeBin)];
+}
+
+/**
+ * @brief Range profile (all range bins) of one chirp and antenna, contiguous in memory.
+ */
+static inline cmplx16ImRe_t *RadarCube_rangeProfile(const RadarCube_View *view, uint32_t chirp, uint32_t antenna) {
+    return RadarCube_at(view, chirp, antenna, 0U);
+}
+
+/**
+ * @brief Slice over all range bins of one chirp and antenna.
+ */
+static inline RadarCube_Slice RadarCube_rangeSlice(const RadarCube_View *view, uint32_t chirp, uint32_t antenna) {
+    RadarCube_Slice slice;
+
+    slice.data   = RadarCube_at(view, chirp, antenna, 0U);
+    slice.stride = 1U;
+    slice.count  = view->numRangeBins;
+    return slice;
+}
+
+/**
+ * @brief Slice over all virtual antennas of one chirp and range bin.
+ */
+static inline RadarCube_Slice RadarCube_antennaSlice(const RadarCube_View *view, uint32_t chirp, uint32_t rangeBin) {
+    RadarCube_Slice slice;
+
+    slice.data   = RadarCube_at(view, chirp, 0U, rangeBin);
+    slice.stride = RadarCube_antennaStride(view);
+    slice.count  = view->numAntennas;
+    return slice;
+}
+
+/**
+ * @brief Slice over all chirps (slow time) of one antenna and range bin.
+ */
+static inline RadarCube_Slice RadarCube_chirpSlice(const RadarCube_View *view, uint32_t antenna, uint32_t rangeBin) {
+    RadarCube_Slice slice;
+
+    slice.data   = RadarCube_at(view, 0U, antenna, rangeBin);
+    slice.stride = RadarCube_chirpStride(view);
+    slice.count  = view->numChirps;
+    return slice;
+}
+
+/**
+ * @brief Pointer to the i-th sample of a slice.
+ */
+static inline cmplx16ImRe_t *RadarCube_sliceAt(const RadarCube_Slice *slice, uint32_t i) {
+    return &slice->data[i * slice->stride];
+}
+
+/**
+ * @brief Copies a slice into a contiguous buffer.
+ *
+ * Contiguous slices are copied with memcpy(). Strided slices are copied as
+ * 32-bit words (one sample each), unrolled by four so the M4F can keep four
+ * independent loads in flight; the same code is used on the host.
+ *
+ * @param[in]  slice Slice to copy.
+ * @param[out] dst   Destination buffer of at least slice->count samples.
+ */
+static inline void RadarCube_copySlice(const RadarCube_Slice *slice, cmplx16ImRe_t *dst) {
+    const uint32_t *src    = (const uint32_t *) slice->data;
+    uint32_t       *out    = (uint32_t *) dst;
+    uint32_t        stride = slice->stride;
+    uint32_t        count  = slice->count;
+    uint32_t        i;
+
+    if (stride == 1U) {
+        memcpy(dst, slice->data, count * sizeof(cmplx16ImRe_t));
+        return;
+    }
+
+    for (i = 0; (i + 4U) <= count; i += 4U) {
+        uint32_t s0 = src[0];
+        uint32_t s1 = src[stride];
+        uint32_t s2 = src[2U * stride];
+        uint32_t s3 = src[3U * stride];
+        out[i]      = s0;
+        out[i + 1U] = s1;
+        out[i + 2U] = s2;
+        out[i + 3U] = s3;
+        src += 4U * stride;
+    }
+    for (; i < count; i++) {
+        out[i] = *src;
+        src += stride;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RADAR_CUBE_H */
@@ -0,0 +1,124 @@
+#ifndef RANGE_INTEGRATION_H
+#define RANGE_INTEGRATION_H
+
+/**
+ * @file range_integration.h
+ * @brief Non-coherent integration of the radar cube into one range profile.
+ *
+ * A single chirp of a single antenna is a noisy range profile. This stage sums
+ * the power |x|^2 of every sample of the radar cube (DPIF_RADARCUBE_FORMAT_6,
+ * see radar_cube.h) over all Doppler chirps and virtual antennas per range bin,
+ * the profile keeps numRangeBins values. Target and noise both grow with the
+ * number N = numChirps * numAntennas of summed samples, but the fluctuation of
+ * the noise only with sqrt(N): the deflection (target excess over the standard
+ * deviation of the noise) improves by 5 * log10(N) dB, about 8.4 dB for the
+ * default 48 samples. That is less than the 10 * log10(N) dB of a coherent sum,
+ * which needs the phase of the target (Doppler and angle) to be known.
+ *
+ * The power of a sample is computed and accumulated in one step on both 16-bit
+ * halves of the sample (__smlald of ACLE with the DSP extension of the M4F, a
+ * plain C equivalent elsewhere) into 64-bit sums, so nothing saturates.
+ *
+ * Output formats:
+ * - RANGE_INTEGRATION_OUTPUT_LOG2_MAG: uint16_t log2 of the integrated
+ *   magnitude sqrt(sum) in Q8 (1 LSB = 6.02 / 256 dB), 0 for no power.
+ * - RANGE_INTEGRATION_OUTPUT_POWER:    uint32_t sum >> powerShift, where
+ *   powerShift = ceil(log2(numChirps * numAntennas)) keeps every possible sum
+ *   in range.
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c for
+ * the logarithm; radar_cube.h needs HOST_BUILD on the host), so this file is
+ * shared between the firmware and the host tools in `host/` (see
+ * `host/range_integration_bench.c`).
+ */
+
+#include <stdint.h>
+
+#include "radar_cube.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define RANGE_INTEGRATION_SUCCESS       (0)
+#define RANGE_INTEGRATION_EINVAL        (-1)
+
+/**
+ * @brief Output formats of the integrated range profile.
+ */
+typedef enum RangeIntegration_Output_e
+{
+    /*! @brief uint16_t log2 of the integrated magnitude, Q8 */
+    RANGE_INTEGRATION_OUTPUT_LOG2_MAG = 0,
+
+    /*! @brief uint32_t integrated power >> powerShift */
+    RANGE_INTEGRATION_OUTPUT_POWER = 1
+} RangeIntegration_Output;
+
+/*!
+ * @brief Configuration of the range integration.
+ */
+typedef struct RangeIntegration_Config_t
+{
+    /*! @brief Output format */
+    RangeIntegration_Output output;
+
+    /*! @brief Number of (Doppler) chirps of the radar cube */
+    uint32_t numChirps;
+
+    /*! @brief Number of virtual antennas of the radar cube */
+    uint32_t numAntennas;
+
+    /*! @brief Number of range bins of the radar cube */
+    uint32_t numRangeBins;
+} RangeIntegration_Config;
+
+/*!
+ * @brief State of the range integration.
+ */
+typedef struct RangeIntegration_Obj_t
+{
+    /*! @brief Configuration */
+    RangeIntegration_Config cfg;
+
+    /*! @brief Number of samples summed per range bin (numChirps * numAntennas) */
+    uint32_t numIntegrated;
+
+    /*! @brief RANGE_INTEGRATION_OUTPUT_POWER: right shift applied to the sums */
+    uint32_t powerShift;
+} RangeIntegration_Obj;
+
+/**
+ * @brief Size of the output of RangeIntegration_process() in bytes.
+ */
+uint32_t RangeIntegration_outputSize(const RangeIntegration_Config *cfg);
+
+/**
+ * @brief Checks the configuration and derives the output scaling.
+ *
+ * @param[out] obj Range integration to initialize.
+ * @param[in]  cfg Configuration.
+ *
+ * @return RANGE_INTEGRATION_SUCCESS or RANGE_INTEGRATION_EINVAL.
+ */
+int32_t RangeIntegration_init(RangeIntegration_Obj *obj, const RangeIntegration_Config *cfg);
+
+/**
+ * @brief Integrates the radar cube into one range profile.
+ *
+ * @param[in]  obj  Initialized range integration.
+ * @param[in]  cube Radar cube matching the configuration, 4 byte aligned.
+ * @param[out] out  numRangeBins uint16_t or uint32_t values (RangeIntegration_outputSize() bytes), 4 byte aligned.
+ *
+ * @return RANGE_INTEGRATION_SUCCESS, RANGE_INTEGRATION_EINVAL if the cube does not match the configuration.
+ */
+int32_t RangeIntegration_process(const RangeIntegration_Obj *obj, const RadarCube_View *cube, void *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RANGE_INTEGRATION_H */
@@ -0,0 +1,88 @@
+
+#ifndef RANGE_WINDOW_H
+#define RANGE_WINDOW_H
+
+/**
+ * @file range_window.h
+ *
+ * @brief Precomputed windows of the range FFT.
+ *
+ * First half ((CLI_NUM_ADC_SAMPLES + 1) / 2 values) of symmetric windows over
+ * the ADC samples in Q17 (DPC_OBJDET_QFORMAT_RANGE_FFT), the layout the
+ * Rangeproc DPU loads into the HWA window RAM with hwaWinSym = 1. The window is
+ * selected with APP_RANGE_WINDOW in proc_config.h, the other tables are unused
+ * and dropped by the linker. Kaiser with beta = 6.0.
+ *
+ * This file was auto-generated by the script 'chirp_config_to_defines.py' from the config file 'PresenceDetect.cfg' on 2026-10-16 03:59:14
+ */
+
+#include <stdint.h>
+
+/* dimensions of the tables, must match defines.h */
+#define RANGE_WINDOW_NUM_SAMPLES     128
+#define RANGE_WINDOW_LEN             64
+#define RANGE_WINDOW_QFORMAT         17
+
+/* window types (APP_RANGE_WINDOW) */
+#define RANGE_WINDOW_HANN            0
+#define RANGE_WINDOW_HAMMING         1
+#define RANGE_WINDOW_BLACKMAN        2
+#define RANGE_WINDOW_BLACKMAN_HARRIS 3
+#define RANGE_WINDOW_KAISER          4
+
+static const uint32_t gRangeWindowHann[RANGE_WINDOW_LEN] = {
+         0,     80,    321,    721,   1279,   1995,   2866,   3891,
+      5066,   6390,   7858,   9468,  11214,  13094,  15102,  17233,
+     19483,  21845,  24314,  26884,  29548,  32301,  35135,  38044,
+     41019,  44055,  47143,  50276,  53447,  56647,  59869,  63105,
+     66347,  69586,  72816,  76028,  79215,  82367,  85479,  88542,
+     91549,  94492,  97364, 100158, 102867, 105485, 108006, 110422,
+    112729, 114920, 116990, 118934, 120748, 122426, 123966, 125362,
+    126612, 127712, 128661, 129455, 130092, 130571, 130892, 131052
+};
+
+static const uint32_t gRangeWindowHamming[RANGE_WINDOW_LEN] = {
+     10486,  10560,  10781,  11149,  11663,  12321,  13123,  14065,
+     15147,  16365,  17715,  19196,  20803,  22532,  24379,  26340,
+     28410,  30583,  32855,  35219,  37670,  40203,  42810,  45486,
+     48223,  51016,  53857,  56740,  59657,  62601,  65565,  68542,
+     71525,  74505,  77477,  80432,  83363,  86264,  89127,  91944,
+     94710,  97418, 100060, 102631, 105124, 107532, 109851, 112074,
+    114196, 116212, 118117, 119905, 121574, 123118, 124534, 125819,
+    126969, 127981, 128854, 129584, 130170, 130611, 130906, 131054
+};
+
+static const uint32_t gRangeWindowBlackman[RANGE_WINDOW_LEN] = {
+         0,     29,    116,    262,    468,    738,   1072,   1475,
+      1949,   2500,   3130,   3846,   4651,   5551,   6550,   7654,
+      8867,  10194,  11640,  13207,  14901,  16723,  18676,  20763,
+     22983,  25336,  27823,  30442,  33189,  36061,  39054,  42162,
+     45378,  48695,  52103,  55594,  59157,  62779,  66450,  70155,
+     73881,  77614,  81338,  85039,  88701,  92307,  95841,  99288,
+    102632, 105856, 108946, 111886, 114661, 117258, 119664, 121867,
+    123855, 125617, 127146, 128432, 129469, 130252, 130776, 131039
+};
+
+static const uint32_t gRangeWindowBlackmanHarris[RANGE_WINDOW_LEN] = {
+         8,     12,     26,     51,     87,    138,    206,    295,
+       409,    553,    731,    952,   1220,   1543,   1928,   2385,
+      2921,   3544,   4265,   5092,   6035,   7103,   8304,   9648,
+     11142,  12795,  14613,  16602,  18767,  21112,  23640,  26351,
+     29245,  32319,  35569,  38990,  42573,  46309,  50185,  54188,
+     58302,  62510,  66793,  71128,  75494,  79867,  84223,  88534,
+     92776,  96920, 100941, 104810, 108502, 111990, 115250, 118258,
+    120993, 123432, 125560, 127358, 128814, 129915, 130654, 131026
+};
+
+static const uint32_t gRangeWindowKaiser[RANGE_WINDOW_LEN] = {
+      1949,   2538,   3199,   3937,   4755,   5656,   6644,   7720,
+      8887,  10148,  11504,  12956,  14506,  16155,  17902,  19748,
+     21693,  23735,  25873,  28105,  30429,  32843,  35343,  37926,
+     40587,  43322,  46126,  48995,  51921,  54899,  57923,  60985,
+     64078,  67195,  70328,  73468,  76609,  79740,  82854,  85942,
+     88994,  92003,  94959,  97853, 100677, 103422, 106080, 108642,
+    111099, 113445, 115672, 117771, 119738, 121564, 123245, 124774,
+    126147, 127358, 128404, 129281, 129986, 130517, 130872, 131050
+};
+
+#endif /* RANGE_WINDOW_H */
@@ -52,7 +52,11 @@
 
 
 
+#include "sensor_config.h"
+#include "frame_protocol.h"
+
 #define DPC_OBJDET_QFORMAT_RANGE_FFT 17
+#define DPC_OBJDET_QFORMAT_DOPPLER_FFT 17
 
 extern SemaphoreP_Object dpcCfgDoneSemHandle;
 extern SemaphoreP_Object uart_tx_start_sem;
@@ -86,6 +90,76 @@ void rangeProc_dpuInit(void);
  */
 void RangeProc_config();
 
+/**
+ * @brief Pauses (0) or resumes (1) the minor motion processing (APP_MINOR_MOTION_ENABLE).
+ *
+ * The Rangeproc DPU keeps filling the minor motion radar cube; on resume the
+ * detection waits until the window holds APP_MINOR_MOTION_NUM_FRAMES new frames.
+ * Without APP_MINOR_MOTION_ENABLE the call has no effect.
+ *
+ * @param[in] enable 1 to process the minor motion radar cube, 0 to skip it.
+ */
+void rangeProc_setMinorMotion(uint8_t enable);
+
+/**
+ * @brief Checks a sensor configuration against the device and the firmware build.
+ *
+ * SensorConfig_check(), and the limits of the build: the ADC samples and the
+ * number of enabled TX and RX channels have to match defines.h (range window
+ * tables, HWA window RAM, antenna geometry), the chirps per frame must not
+ * exceed those of defines.h and have to cover the transmitted chirp
+ * (APP_TX_CHIRP_IDX) and the minor motion chirps. With APP_NUM_SUBFRAMES > 1
+ * the configurations derived for the other sub-frames are checked as well and
+ * have to give the same range ROI. Independent of the running configuration,
+ * so it can also be called before the sensor is set up.
+ *
+ * @param[in] cfg Sensor configuration.
+ *
+ * @return SystemP_SUCCESS, SystemP_FAILURE if the firmware cannot run with the configuration (logged).
+ */
+int32_t rangeProc_checkConfig(const SensorConfig *cfg);
+
+/**
+ * @brief Copies the sensor configuration the sensor runs with, once the DPC task runs.
+ *
+ * With APP_NUM_SUBFRAMES > 1 the configuration of sub-frame 0, from which the
+ * others are derived; gSysContext.sensorCfg then changes with every sub-frame.
+ *
+ * @param[out] cfg Sensor configuration.
+ */
+void rangeProc_getConfig(SensorConfig *cfg);
+
+/**
+ * @brief Applies a new sensor configuration without reboot and reports how long it took.
+ *
+ * The DPC task takes the request up after the current frame: it waits for the
+ * UART task to send the last frame, stops the sensor (mmwave_stop_close_deinit()),
+ * brings it up again from the new configuration (mmwave_initSensor(),
+ * mmwave_setupSensor(): channel, profile, frame and open configuration of
+ * mmwave_control_config.c), rewinds the memory pools, configures all DPUs
+ * (RangeProc_config() and the following stages) and restarts the sensor. The
+ * durations of these steps are logged, sent with every following frame as
+ * FRAME_PROTO_TLV_RECONFIG and returned in timing.
+ *
+ * The configuration is rejected before anything is stopped if it fails
+ * rangeProc_checkConfig(). The mmWave control API checks the rest; an error
+ * there is fatal, as at start-up.
+ *
+ * Blocks until the reconfiguration has been applied, so it must be called from
+ * another task than the DPC task, one request at a time, while the sensor runs.
+ * Read handles of the cube ring (CubeRing_acquire()) must be released before,
+ * the ring is allocated again.
+ *
+ * With APP_NUM_SUBFRAMES > 1, cfg is the configuration of sub-frame 0; the
+ * others are derived from it again and the sensor restarts with sub-frame 0.
+ *
+ * @param[in]  cfg    New sensor configuration, copied.
+ * @param[out] timing Counters and durations of the reconfiguration, may be NULL.
+ *
+ * @return SystemP_SUCCESS, SystemP_FAILURE if the configuration was rejected (the sensor keeps running unchanged).
+ */
+int32_t rangeProc_reconfigure(const SensorConfig *cfg, FrameProto_Reconfig *timing);
+
 /**
  * @brief Main function for Range Processing DPU
  *
@@ -0,0 +1,261 @@
+#ifndef SENSOR_CONFIG_H
+#define SENSOR_CONFIG_H
+
+/**
+ * @file sensor_config.h
+ * @brief Sensor front-end configuration held at run time.
+ *
+ * The parameters of the .cfg commands which `defines.h` is generated from
+ * (channelCfg, chirpComnCfg, chirpTimingCfg, frameCfg, factoryCalibCfg,
+ * sensorStart), in the units of the .cfg file (without saveEnable and
+ * restoreEnable of factoryCalibCfg, the calibration is always restored from
+ * flash). The firmware starts with the
+ * values of `defines.h` (Mmwave_populateDefaultSensorCfg()) in
+ * gSysContext.sensorCfg and derives the profile, frame and open configuration of
+ * the mmWave control API and the configuration of the Rangeproc DPU from it, so
+ * a new configuration can be applied without reboot (rangeProc_reconfigure()).
+ * SensorConfig_parseLine() reads the commands from the text of a .cfg file, as
+ * received over the UART (cli.c).
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Return values.
+ */
+#define SENSOR_CONFIG_SUCCESS           (0)
+#define SENSOR_CONFIG_EINVAL            (-1)
+
+/**
+ * @brief Maximum length of a line of a .cfg file in characters, without the line end.
+ */
+#define SENSOR_CONFIG_MAX_LINE_LEN      (127U)
+
+/**
+ * @brief Maximum number of parameters of a command, further ones are an error.
+ */
+#define SENSOR_CONFIG_MAX_PARAMS        (8U)
+
+/**
+ * @brief RF band of the device in GHz.
+ */
+#define SENSOR_CONFIG_MIN_FREQ_GHZ      (57.0f)
+#define SENSOR_CONFIG_MAX_FREQ_GHZ      (64.0f)
+
+/**
+ * @brief Number of TX and RX channels of the device.
+ */
+#define SENSOR_CONFIG_NUM_TX            (2U)
+#define SENSOR_CONFIG_NUM_RX            (3U)
+
+/*!
+ * @brief Sensor front-end configuration, one field per parameter of the .cfg commands.
+ */
+typedef struct SensorConfig_t
+{
+    /*! @brief channelCfg: enabled RX channels (bit mask) */
+    uint16_t rxChCtrlBitMask;
+
+    /*! @brief channelCfg: enabled TX channels (bit mask) */
+    uint16_t txChCtrlBitMask;
+
+    /*! @brief channelCfg: miscellaneous control */
+    uint16_t miscCtrl;
+
+    /*! @brief chirpComnCfg: decimation of the digital output sampling rate, f_s = 100 MHz / digOutputSampRate */
+    uint8_t digOutputSampRate;
+
+    /*! @brief chirpComnCfg: bits of the digital output */
+    uint8_t digOutputBitsSel;
+
+    /*! @brief chirpComnCfg: DFE FIR filter */
+    uint8_t dfeFirSel;
+
+    /*! @brief chirpComnCfg: ADC samples per chirp */
+    uint16_t numOfAdcSamples;
+
+    /*! @brief chirpComnCfg: TX MIMO pattern, 0 / 1 TDM, 4 BPM */
+    uint8_t chirpTxMimoPatSel;
+
+    /*! @brief chirpComnCfg: ramp end time in us */
+    float chirpRampEndTime;
+
+    /*! @brief chirpComnCfg: RX high pass filter */
+    uint8_t chirpRxHpfSel;
+
+    /*! @brief chirpTimingCfg: idle time in us */
+    float chirpIdleTime;
+
+    /*! @brief chirpTimingCfg: ADC samples skipped at the start of the chirp */
+    uint16_t chirpAdcSkipSamples;
+
+    /*! @brief chirpTimingCfg: TX start time in us */
+    float chirpTxStartTime;
+
+    /*! @brief chirpTimingCfg: chirp slope in MHz/us */
+    float chirpRfFreqSlope;
+
+    /*! @brief chirpTimingCfg: start frequency in GHz */
+    float chirpRfFreqStart;
+
+    /*! @brief frameCfg: chirps per burst, including the accumulated ones */
+    uint16_t numOfChirpsInBurst;
+
+    /*! @brief frameCfg: chirps accumulated in hardware into one chirp of ADC data, 0 or 1 for none */
+    uint8_t numOfChirpsAccum;
+
+    /*! @brief frameCfg: burst period in us */
+    float burstPeriodicity;
+
+    /*! @brief frameCfg: bursts per frame */
+    uint16_t numOfBurstsInFrame;
+
+    /*! @brief frameCfg: frame period in ms */
+    float framePeriodicity;
+
+    /*! @brief frameCfg: number of frames, 0 for endless */
+    uint16_t numOfFrames;
+
+    /*! @brief factoryCalibCfg: RX gain of the calibration in dB */
+    uint8_t rxGain;
+
+    /*! @brief factoryCalibCfg: TX back-off of the calibration in dB */
+    uint8_t txBackoff;
+
+    /*! @brief factoryCalibCfg: flash offset of the calibration data */
+    uint32_t flashOffset;
+
+    /*! @brief sensorStart: frame trigger mode */
+    uint8_t frameTrigMode;
+
+    /*! @brief sensorStart: loop back of the chirp start signal */
+    uint8_t chirpStartSigLbEn;
+
+    /*! @brief sensorStart: frame live monitors */
+    uint8_t frameLivMonEn;
+
+    /*! @brief sensorStart: frame trigger timer value */
+    uint32_t frameTrigTimerVal;
+} SensorConfig;
+
+/**
+ * @brief Commands of a .cfg file, as reported by SensorConfig_parseLine().
+ */
+typedef enum SensorConfig_Command_e
+{
+    /*! @brief Empty line or comment (starting with %) */
+    SENSOR_CONFIG_CMD_NONE = 0,
+
+    /*! @brief channelCfg */
+    SENSOR_CONFIG_CMD_CHANNEL,
+
+    /*! @brief chirpComnCfg */
+    SENSOR_CONFIG_CMD_CHIRP_COMN,
+
+    /*! @brief chirpTimingCfg */
+    SENSOR_CONFIG_CMD_CHIRP_TIMING,
+
+    /*! @brief frameCfg */
+    SENSOR_CONFIG_CMD_FRAME,
+
+    /*! @brief factoryCalibCfg */
+    SENSOR_CONFIG_CMD_FACTORY_CALIB,
+
+    /*! @brief sensorStart: the configuration is complete and should be applied */
+    SENSOR_CONFIG_CMD_SENSOR_START,
+
+    /*! @brief Any other command of the SDK demos (sensorStop, guiMonitor, ...), ignored */
+    SENSOR_CONFIG_CMD_UNKNOWN
+} SensorConfig_Command;
+
+/**
+ * @brief Number of set bits of a channel mask.
+ */
+static inline uint32_t SensorConfig_numChannels(uint32_t mask) {
+    uint32_t num = 0U;
+
+    for (; mask != 0U; mask &= mask - 1U) {
+        num++;
+    }
+    return num;
+}
+
+/**
+ * @brief Number of chirps the front end accumulates into one chirp of ADC data, 1 without accumulation.
+ */
+static inline uint32_t SensorConfig_numChirpsAccum(const SensorConfig *cfg) {
+    return (cfg->numOfChirpsAccum > 1U) ? cfg->numOfChirpsAccum : 1U;
+}
+
+/**
+ * @brief Number of chirps of ADC data per frame, as processed by the Rangeproc DPU.
+ *
+ * With hardware chirp accumulation every numOfChirpsAccum consecutive chirps of
+ * a burst give one chirp of ADC data, so the ADC buffer, the EDMA and the HWA
+ * only see numOfChirpsInBurst / numOfChirpsAccum chirps per burst.
+ */
+static inline uint32_t SensorConfig_numAdcChirps(const SensorConfig *cfg) {
+    return ((uint32_t) cfg->numOfChirpsInBurst / SensorConfig_numChirpsAccum(cfg)) * cfg->numOfBurstsInFrame;
+}
+
+/**
+ * @brief Growth of the ADC samples by the accumulation in bits: log2 of the accumulated chirps, rounded up.
+ */
+static inline uint32_t SensorConfig_accumGrowthBits(const SensorConfig *cfg) {
+    uint32_t bits = 0U;
+
+    while ((1U << bits) < SensorConfig_numChirpsAccum(cfg)) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * @brief Checks a configuration for values the device or the processing chain cannot run with.
+ *
+ * Channel masks within the TX and RX channels of the device and not empty, TDM
+ * (0, 1) or BPM (4, both TX) MIMO, ADC samples and chirps > 0, chirps per burst
+ * a multiple of the accumulated chirps, chirps of ADC data per frame a multiple
+ * of the enabled TX channels, sampling rate, slope and ramp end time > 0, the
+ * chirp within the RF band of the device, chirps within the burst period and
+ * bursts within the frame period.
+ * The limits of the firmware build (radar cube size, window tables) are checked
+ * by rangeProc_checkConfig().
+ *
+ * @return SENSOR_CONFIG_SUCCESS or SENSOR_CONFIG_EINVAL.
+ */
+int32_t SensorConfig_check(const SensorConfig *cfg);
+
+/**
+ * @brief Parses one line of a .cfg file into a configuration.
+ *
+ * Accepts the commands chirp_config_to_defines.py reads (channelCfg,
+ * chirpComnCfg, chirpTimingCfg, frameCfg, factoryCalibCfg, sensorStart) with
+ * their parameters in .cfg order, separated by blanks; integers decimal or
+ * hexadecimal (0x), floats in any notation of strtod(). Every parameter is
+ * checked against the range of its field (e.g. 0..255 for uint8_t), the
+ * complete configuration is only checked by SensorConfig_check(). saveEnable and
+ * restoreEnable of factoryCalibCfg are accepted (0 or 1) but not stored.
+ * Comments, empty lines and other commands leave the configuration unchanged.
+ *
+ * @param[in,out] cfg  Configuration, only modified if the line is valid.
+ * @param[in]     line Line without or with line end, NUL terminated.
+ * @param[out]    cmd  Command of the line.
+ *
+ * @return SENSOR_CONFIG_SUCCESS, SENSOR_CONFIG_EINVAL if the line is too long,
+ *         has the wrong number of parameters or a parameter is out of range.
+ */
+int32_t SensorConfig_parseLine(SensorConfig *cfg, const char *line, SensorConfig_Command *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_CONFIG_H */
@@ -40,6 +40,16 @@
 #include <datapath/dpu/rangeproc/v0/rangeprochwa.h>
 #include <drivers/hwa.h>
 #include "kernel/dpl/SemaphoreP.h"
+#include "radar_cube.h"
+#include "cube_ring.h"
+#include "doppler_proc.h"
+#include "clutter_removal.h"
+#include "range_integration.h"
+#include "peak_picker.h"
+#include "cfar.h"
+#include "doa.h"
+#include "micro_doppler.h"
+#include "sensor_config.h"
 
 
 /*!
@@ -117,6 +127,91 @@ typedef struct {
     /*! @brief Config for Rangeproc DPU */
     DPU_RangeProcHWA_Config rangeProcDpuCfg;
 
+    /*! @brief View on the radar cube of the range region of interest (APP_RANGE_ROI_*), all consumers access the cube through it */
+    RadarCube_View radarCube;
+
+    /*! @brief View on the output buffer of the Rangeproc DPU: range bins 0 up to the end of the range region of interest */
+    RadarCube_View rangeProcOutput;
+
+    /*! @brief Radar cubes or range profiles of the last frames (APP_CUBE_RING_DEPTH), read with CubeRing_acquire() */
+    CubeRing_Obj cubeRing;
+
+    /*! @brief Static clutter removal on the radar cube (background in the core local memory pool) */
+    ClutterRemoval_Obj clutterRemoval;
+
+    /*! @brief Non-coherent integration of the radar cube into one range profile */
+    RangeIntegration_Obj rangeIntegration;
+
+    /*! @brief Integrated range profile of the current frame, uint16_t or uint32_t values (core local memory) */
+    void *integratedProfile;
+
+    /*! @brief Configuration of the range peak picker */
+    PeakPicker_Config peakCfg;
+
+    /*! @brief Peaks of the range profile of the current frame, strongest first */
+    PeakPicker_Peak peaks[PEAK_PICKER_MAX_PEAKS];
+
+    /*! @brief Number of peaks of the current frame */
+    PeakPicker_Result peakResult;
+
+    /*! @brief Doppler stage, computes the range-Doppler heat map from the radar cube */
+    DopplerProc_Obj dopplerProc;
+
+    /*! @brief View on the minor motion radar cube (APP_MINOR_MOTION_ENABLE), chirps of the last frames */
+    RadarCube_View radarCubeMinor;
+
+    /*! @brief Doppler stage of the minor motion radar cube */
+    DopplerProc_Obj dopplerProcMinor;
+
+    /*! @brief Number of frames in the minor motion radar cube, up to APP_MINOR_MOTION_NUM_FRAMES */
+    uint32_t minorMotionNumFrames;
+
+    /*! @brief Slot of the next frame in the minor motion radar cube (frame counter modulo APP_MINOR_MOTION_NUM_FRAMES),
+               loaded into the DPU whenever it is reconfigured */
+    uint32_t minorMotionFrameSlot;
+
+    /*! @brief Minor motion processing active (rangeProc_setMinorMotion()) */
+    volatile uint8_t minorMotionActive;
+
+    /*! @brief Configuration of the CFAR detection */
+    Cfar_Config cfarCfg;
+
+    /*! @brief Workspace of the CFAR detection (allocated from the core local memory pool) */
+    void *cfarWorkspace;
+
+    /*! @brief Detection map without Doppler stage: magnitude of the transmitted range profile (core local memory) */
+    uint16_t *cfarMagnitude;
+
+    /*! @brief Detections of the current frame (allocated from the L3 memory pool) */
+    Cfar_Detection *detections;
+
+    /*! @brief Number of detections of the current frame */
+    Cfar_Result cfarResult;
+
+    /*! @brief Detections on the minor motion heat map (allocated from the L3 memory pool) */
+    Cfar_Detection *minorDetections;
+
+    /*! @brief Number of detections on the minor motion heat map, 0 while the window is filling */
+    Cfar_Result minorCfarResult;
+
+    /*! @brief Direction of arrival of the detections */
+    Doa_Obj doa;
+
+    /*! @brief Point cloud of the current frame, one point per detection (allocated from the L3 memory pool) */
+    Doa_Point *points;
+
+    /*! @brief Micro-Doppler stage */
+    MicroDoppler_Obj microDoppler;
+
+    /*! @brief Micro-Doppler features of the current frame */
+    MicroDoppler_Features microDopplerFeatures;
+
+    /*! @brief Center range bin of the micro-Doppler gate */
+    uint32_t microDopplerRangeBin;
+
+    /*! @brief Sensor configuration the profile, frame and channel configuration below and the DPUs are derived from */
+    SensorConfig sensorCfg;
+
     T_RL_API_SENS_CHIRP_PROF_COMN_CFG profileComCfg;
     T_RL_API_SENS_CHIRP_PROF_TIME_CFG profileTimeCfg;
     T_RL_API_FECSS_RF_PWR_CFG_CMD channelCfg;
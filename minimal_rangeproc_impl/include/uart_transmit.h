@@ -18,6 +18,8 @@
  *       for synchronization.
 */
 
+#include "frame_packer.h"
+
 /**
  * @brief Semaphore to signal the start of UART transmission.
  *
@@ -28,15 +30,143 @@ extern SemaphoreP_Object uart_tx_start_sem;
 /**
  * @brief Semaphore to signal the completion of UART transmission.
  *
- * This semaphore is posted when the UART transmission is complete.
+ * This semaphore is posted when the UART transmission is complete, only without APP_PIPELINED_TX, where the DPC
+ * waits for it after every frame.
  */
 extern SemaphoreP_Object uart_tx_done_sem;
 
+/**
+ * @brief Number of snapshot buffers the UART task transmits from.
+ */
+#define UART_TX_NUM_SNAPSHOTS   (2U)
+
+/*!
+ * @brief Double buffered snapshots of the frames to transmit.
+ *
+ * @details
+ *  The DPC assembles a frame (frame header and TLVs, see frame_protocol.h) in
+ *  one snapshot with uart_beginFrame(), uart_addTlv() and uart_commitFrame()
+ *  while the UART task drains the other one, so processing of the next frame
+ *  does not have to wait for the transmission. A snapshot which has been
+ *  committed but not yet picked up by the UART task is overwritten by the next
+ *  frame, which then counts as dropped. The UART task appends the transmission
+ *  statistics and the CRC.
+ */
+typedef struct UartTx_Snapshots_t
+{
+    /*! @brief Snapshot buffers (allocated from the L3 memory pool) */
+    uint8_t *buf[UART_TX_NUM_SNAPSHOTS];
+
+    /*! @brief Size of each snapshot buffer in bytes */
+    uint32_t bufSize;
+
+    /*! @brief Number of valid bytes in each snapshot buffer */
+    uint32_t len[UART_TX_NUM_SNAPSHOTS];
+
+    /*! @brief Transmit buffer the UART task completes the frames in (allocated from the L3 memory pool) */
+    uint8_t *txBuf;
+
+    /*! @brief Size of the transmit buffer in bytes */
+    uint32_t txBufSize;
+
+    /*! @brief Packer of the frame being assembled by the DPC */
+    FramePacker packer;
+
+    /*! @brief Index of the snapshot being assembled by the DPC, -1 if none */
+    int32_t fillIdx;
+
+    /*! @brief Index of the snapshot ready for transmission, -1 if none */
+    volatile int32_t readyIdx;
+
+    /*! @brief Index of the snapshot currently transmitted, -1 if none */
+    volatile int32_t busyIdx;
+
+    /*! @brief 1 from taking up a snapshot until its transmission has finished */
+    volatile uint8_t txActive;
+
+    /*! @brief Number of frames handed to the UART task */
+    volatile uint32_t numFramesQueued;
+
+    /*! @brief Number of frames transmitted */
+    volatile uint32_t numFramesSent;
+
+    /*! @brief Number of frames overwritten before they could be transmitted */
+    volatile uint32_t numFramesDropped;
+} UartTx_Snapshots;
+
+/**
+ * @brief Snapshot buffers shared between DPC and UART task.
+ */
+extern UartTx_Snapshots gUartTxSnapshots;
+
+/**
+ * @brief Allocates the snapshot buffers and the transmit buffer from a memory pool.
+ *
+ * Has to be called by the DPC after the memory pools have been reset, before
+ * the first frame is submitted.
+ *
+ * @param[in] pool        Memory pool to allocate from.
+ * @param[in] maxTlvBytes Maximum size of the TLVs the DPC adds to a frame in
+ *                        bytes, the sum of FRAME_PROTO_TLV_SIZE() of all of them.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE if the pool is exhausted.
+ */
+int32_t uart_allocSnapshots(MemPoolObj *pool, uint32_t maxTlvBytes);
+
+/**
+ * @brief Starts a frame in the snapshot which is not being transmitted. Never blocks.
+ *
+ * @param[in] frameCount Number of the frame.
+ * @param[in] timestamp  Time of the end of processing in FRAME_REF_TIMER ticks.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE if the frame header does not fit.
+ */
+int32_t uart_beginFrame(uint32_t frameCount, uint32_t timestamp);
+
+/**
+ * @brief Appends a TLV to the frame started with uart_beginFrame().
+ *
+ * @param[in] type   Payload type (FrameProto_TlvType).
+ * @param[in] length Payload size in bytes.
+ *
+ * @return Payload area to be filled in by the caller (4 byte aligned), NULL if
+ *         the snapshot is full or no frame has been started.
+ */
+void *uart_addTlv(uint32_t type, uint32_t length);
+
+/**
+ * @brief Hands the frame started with uart_beginFrame() to the UART task.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE if no frame has been started.
+ */
+int32_t uart_commitFrame(void);
+
+/**
+ * @brief Reads one byte from the UART, blocks until it has been received.
+ *
+ * Used by the CLI task (cli.c); the UART driver serves it next to the
+ * transmissions of the UART task.
+ *
+ * @param[out] byte Received byte.
+ *
+ * @return SystemP_SUCCESS, SystemP_FAILURE on a receive error (e.g. overrun or framing error).
+ */
+int32_t uart_receiveByte(uint8_t *byte);
+
+/**
+ * @brief Waits until the UART task has transmitted the last committed frame.
+ *
+ * Needed before the snapshot and transmit buffers are given back to the memory
+ * pool (rangeProc_reconfigure()). Polls once per millisecond, must not be called
+ * by the UART task.
+ */
+void uart_waitIdle(void);
+
 /**
  * @brief UART transmission loop function.
  *
  * This function continuously waits for a signal to start UART transmission,
- * sends radar cube data over UART, and signals completion when done.
+ * sends the latest submitted snapshot over UART, and signals completion when done.
  */
 void uart_transmit_loop();
 
@@ -0,0 +1,268 @@
+/**
+ * @file cfar.c
+ * @brief CFAR detection on a range profile or range-Doppler heat map.
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c), so
+ * this file is shared between the firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cfar.h"
+#include "fixed_math.h"
+
+/*! @brief 20 * log10(2) in Q12 */
+#define CFAR_DB_PER_LOG2_Q12    (24660)
+
+/*! @brief Noise estimate: sum of num cells */
+typedef struct Cfar_Noise_t
+{
+    uint64_t sum;
+    uint32_t num;
+} Cfar_Noise;
+
+int32_t Cfar_checkConfig(const Cfar_Config *cfg) {
+    if ((cfg->mode > CFAR_MODE_OS) || (cfg->trainLen == 0U) || (cfg->trainLen > CFAR_MAX_TRAIN_LEN) ||
+        (cfg->osRank >= 2U * cfg->trainLen) || (cfg->thresholdScaleQ8 == 0U)) {
+        return CFAR_EINVAL;
+    }
+    return CFAR_SUCCESS;
+}
+
+uint32_t Cfar_workspaceSize(uint32_t numRangeBins) {
+    /* prefix sums of one Doppler column, then the column itself */
+    return (numRangeBins + 1U) * sizeof(uint32_t) + ((numRangeBins * sizeof(uint16_t) + 3U) & ~3U);
+}
+
+/* k-th smallest of n values (0-based, quickselect), reorders the values */
+static uint16_t Cfar_select(uint16_t *v, uint32_t n, uint32_t k) {
+    uint32_t lo = 0U, hi = n - 1U;
+    uint32_t i, store;
+    uint16_t pivot, t;
+
+    while (lo < hi) {
+        /* Lomuto partition around the middle element */
+        pivot = v[(lo + hi) / 2U];
+        v[(lo + hi) / 2U] = v[hi];
+        v[hi] = pivot;
+        store = lo;
+        for (i = lo; i < hi; i++) {
+            if (v[i] < pivot) {
+                t = v[i];
+                v[i] = v[store];
+                v[store++] = t;
+            }
+        }
+        v[hi] = v[store];
+        v[store] = pivot;
+
+        if (k == store) {
+            break;
+        } else if (k < store) {
+            hi = store - 1U;
+        } else {
+            lo = store + 1U;
+        }
+    }
+    return v[k];
+}
+
+/* combines the two sides of the window according to the mode */
+static void Cfar_combine(Cfar_Mode mode, uint64_t sumL, uint32_t numL, uint64_t sumR, uint32_t numR, Cfar_Noise *noise) {
+    uint32_t useLeft;
+
+    if ((mode == CFAR_MODE_CA) || (numL == 0U) || (numR == 0U)) {
+        noise->sum = sumL + sumR;
+        noise->num = numL + numR;
+        return;
+    }
+    /* compare the means sumL / numL and sumR / numR */
+    useLeft = (sumL * numR > sumR * numL) ? 1U : 0U;
+    if (mode == CFAR_MODE_CASO) {
+        useLeft ^= 1U;
+    }
+    noise->sum = useLeft ? sumL : sumR;
+    noise->num = useLeft ? numL : numR;
+}
+
+/*
+ * Noise estimate of cell idx of a line x[0], x[stride], ... x[(n - 1) * stride]
+ * by direct summation over the window, cyclic lines wrap around.
+ */
+static void Cfar_estimate(const Cfar_Config *cfg, const uint16_t *x, uint32_t stride, uint32_t n, uint32_t idx,
+                          uint32_t guardLen, uint32_t trainLen, uint32_t cyclic, Cfar_Noise *noise) {
+    uint16_t cells[2U * CFAR_MAX_TRAIN_LEN];
+    uint64_t sumL = 0U, sumR = 0U;
+    uint32_t numL = 0U, numR = 0U;
+    uint32_t j, offset, pos;
+
+    /* the window is at most half the line, so one wrap around is enough */
+    for (j = 1U; j <= trainLen; j++) {
+        offset = guardLen + j;
+        if ((idx >= offset) || cyclic) {
+            pos = (idx >= offset) ? (idx - offset) : (idx + n - offset);
+            cells[numL + numR] = x[pos * stride];
+            sumL += x[pos * stride];
+            numL++;
+        }
+        if ((idx + offset < n) || cyclic) {
+            pos = (idx + offset < n) ? (idx + offset) : (idx + offset - n);
+            cells[numL + numR] = x[pos * stride];
+            sumR += x[pos * stride];
+            numR++;
+        }
+    }
+
+    if (cfg->mode == CFAR_MODE_OS) {
+        noise->num = (numL + numR > 0U) ? 1U : 0U;
+        noise->sum = (noise->num > 0U) ?
+                     Cfar_select(cells, numL + numR, cfg->osRank * (numL + numR) / (2U * cfg->trainLen)) : 0U;
+    } else {
+        Cfar_combine(cfg->mode, sumL, numL, sumR, numR, noise);
+    }
+}
+
+/* threshold test: cell > (noise sum / num) * thresholdScaleQ8 / 256 */
+static uint32_t Cfar_isDetected(const Cfar_Config *cfg, uint16_t cell, const Cfar_Noise *noise) {
+    return ((noise->num > 0U) &&
+            ((uint64_t) cell * noise->num * 256U > noise->sum * cfg->thresholdScaleQ8)) ? 1U : 0U;
+}
+
+static int16_t Cfar_snrDbQ8(uint16_t cell, const Cfar_Noise *noise) {
+    int32_t snr;
+
+    if (noise->sum == 0U) {
+        return INT16_MAX;
+    }
+    snr = ((FixedMath_log2Q8((uint64_t) cell * noise->num) - FixedMath_log2Q8(noise->sum)) * CFAR_DB_PER_LOG2_Q12) / 4096;
+    return (int16_t) ((snr > INT16_MAX) ? INT16_MAX : ((snr < INT16_MIN) ? INT16_MIN : snr));
+}
+
+/* local maximum along a line, ties count for the first cell of a plateau */
+static uint32_t Cfar_isPeak(const uint16_t *x, uint32_t n, uint32_t idx, uint32_t cyclic) {
+    uint16_t cell = x[idx];
+
+    if (n < 2U) {
+        return 1U;
+    }
+    if (((idx > 0U) && (x[idx - 1U] >= cell)) || ((idx == 0U) && cyclic && (x[n - 1U] >= cell))) {
+        return 0U;
+    }
+    if (((idx + 1U < n) && (x[idx + 1U] > cell)) || ((idx + 1U == n) && cyclic && (x[0] > cell))) {
+        return 0U;
+    }
+    return 1U;
+}
+
+/* local maximum along range (column of Doppler bin d) and along the cyclic Doppler axis */
+static uint32_t Cfar_isLocalMax(const uint16_t *map, const uint16_t *column, uint32_t numRangeBins,
+                                uint32_t numDopplerBins, uint32_t r, uint32_t d) {
+    return (Cfar_isPeak(column, numRangeBins, r, 0U) && Cfar_isPeak(&map[r * numDopplerBins], numDopplerBins, d, 1U)) ?
+           1U : 0U;
+}
+
+int32_t Cfar_process(const Cfar_Config *cfg, const uint16_t *map, uint32_t numRangeBins, uint32_t numDopplerBins,
+                     void *workspace, Cfar_Detection *detections, uint32_t maxDetections, Cfar_Result *result) {
+    uint32_t *prefix = (uint32_t *) workspace;
+    uint16_t *column = (uint16_t *) &prefix[numRangeBins + 1U];
+    uint32_t  dopplerTrainLen = 0U;
+    uint32_t  r, d, lo, hi;
+    Cfar_Noise noise;
+
+    result->numDetections = 0U;
+    result->numDiscarded  = 0U;
+    if ((Cfar_checkConfig(cfg) != CFAR_SUCCESS) || (numRangeBins == 0U) || (numDopplerBins == 0U) ||
+        (numRangeBins > 0xFFFFU) || (numDopplerBins > 0xFFFFU)) {
+        return CFAR_EINVAL;
+    }
+
+    /* Doppler window, shortened if the cyclic Doppler axis is too short for it */
+    if (cfg->dopplerCheck && (numDopplerBins > 1U) && ((numDopplerBins - 1U) / 2U > cfg->guardLen)) {
+        dopplerTrainLen = (numDopplerBins - 1U) / 2U - cfg->guardLen;
+        dopplerTrainLen = (dopplerTrainLen < cfg->trainLen) ? dopplerTrainLen : cfg->trainLen;
+    }
+
+    for (d = 0; d < numDopplerBins; d++) {
+        /* column of Doppler bin d and its prefix sums */
+        prefix[0] = 0U;
+        for (r = 0; r < numRangeBins; r++) {
+            column[r]     = map[r * numDopplerBins + d];
+            prefix[r + 1U] = prefix[r] + column[r];
+        }
+
+        for (r = 0; r < numRangeBins; r++) {
+            const uint16_t cell = column[r];
+            Cfar_Detection *det;
+
+            if (cfg->mode == CFAR_MODE_OS) {
+                /* the peak test is cheaper than the ordered statistic, do it first */
+                if (cfg->peakGrouping && !Cfar_isLocalMax(map, column, numRangeBins, numDopplerBins, r, d)) {
+                    continue;
+                }
+                Cfar_estimate(cfg, column, 1U, numRangeBins, r, cfg->guardLen, cfg->trainLen, 0U, &noise);
+            } else {
+                uint64_t sumL = 0U, sumR = 0U;
+                uint32_t numL = 0U, numR = 0U;
+
+                /* left window [lo, hi), right window [lo, hi) */
+                if (r > cfg->guardLen) {
+                    hi   = r - cfg->guardLen;
+                    lo   = (hi > cfg->trainLen) ? (hi - cfg->trainLen) : 0U;
+                    sumL = prefix[hi] - prefix[lo];
+                    numL = hi - lo;
+                }
+                if (r + cfg->guardLen + 1U < numRangeBins) {
+                    lo   = r + cfg->guardLen + 1U;
+                    hi   = (lo + cfg->trainLen < numRangeBins) ? (lo + cfg->trainLen) : numRangeBins;
+                    sumR = prefix[hi] - prefix[lo];
+                    numR = hi - lo;
+                }
+                Cfar_combine(cfg->mode, sumL, numL, sumR, numR, &noise);
+            }
+            if (!Cfar_isDetected(cfg, cell, &noise)) {
+                continue;
+            }
+            if (cfg->peakGrouping && (cfg->mode != CFAR_MODE_OS) &&
+                !Cfar_isLocalMax(map, column, numRangeBins, numDopplerBins, r, d)) {
+                continue;
+            }
+            if (dopplerTrainLen > 0U) {
+                Cfar_Noise dopplerNoise;
+
+                Cfar_estimate(cfg, &map[r * numDopplerBins], 1U, numDopplerBins, d, cfg->guardLen, dopplerTrainLen,
+                              1U, &dopplerNoise);
+                if (!Cfar_isDetected(cfg, cell, &dopplerNoise)) {
+                    continue;
+                }
+            }
+
+            if (result->numDetections >= maxDetections) {
+                result->numDiscarded++;
+                continue;
+            }
+            det = &detections[result->numDetections++];
+            det->rangeBin   = (uint16_t) r;
+            det->dopplerBin = (uint16_t) d;
+            det->magnitude  = cell;
+            det->snrDbQ8    = Cfar_snrDbQ8(cell, &noise);
+        }
+    }
+
+    /* detections were found column by column (on overflow the last Doppler bins lose out), sort them range major */
+    if ((numDopplerBins > 1U) && (result->numDetections > 1U)) {
+        uint32_t i, j;
+
+        for (i = 1U; i < result->numDetections; i++) {
+            Cfar_Detection t = detections[i];
+
+            for (j = i; (j > 0U) && ((detections[j - 1U].rangeBin > t.rangeBin) ||
+                                     ((detections[j - 1U].rangeBin == t.rangeBin) &&
+                                      (detections[j - 1U].dopplerBin > t.dopplerBin))); j--) {
+                detections[j] = detections[j - 1U];
+            }
+            detections[j] = t;
+        }
+    }
+    return CFAR_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file cli.c
+ * @brief Command line interface: .cfg commands received over the UART (see cli.h).
+ *
+ * Lines end with CR, LF or both; the parser itself (SensorConfig_parseLine() in
+ * sensor_config.c) is portable and checked on the host with
+ * `host/sensor_config_bench.c`.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/ClockP.h>
+#include <kernel/dpl/HwiP.h>
+#include "kernel/dpl/SemaphoreP.h"
+
+#include "system.h"
+#include "sensor_config.h"
+#include "rangeproc_dpc.h"
+#include "uart_transmit.h"
+#include "cli.h"
+
+
+/*! @brief Start-up, waiting for a configuration (cli_waitForStart()) */
+#define CLI_STATE_WAIT_START    (0U)
+
+/*! @brief Sensor being set up, configurations are rejected */
+#define CLI_STATE_STARTING      (1U)
+
+/*! @brief Sensor running, configurations are applied with rangeProc_reconfigure() */
+#define CLI_STATE_RUNNING       (2U)
+
+
+/*!
+ * @brief State of the CLI task.
+ */
+typedef struct Cli_Object_t
+{
+    /*! @brief Active configuration plus the commands since the last sensorStart */
+    SensorConfig pending;
+
+    /*! @brief 1 if a line since the last sensorStart had an error */
+    uint8_t pendingError;
+
+    /*! @brief Current line, NUL terminated */
+    char line[SENSOR_CONFIG_MAX_LINE_LEN + 1U];
+
+    /*! @brief Number of characters in line */
+    uint32_t lineLen;
+
+    /*! @brief 1 while the rest of a too long line is skipped */
+    uint8_t lineOverflow;
+
+    /*! @brief CLI_STATE_WAIT_START, CLI_STATE_STARTING or CLI_STATE_RUNNING */
+    volatile uint8_t state;
+
+    /*! @brief Posted when a configuration has been taken over during start-up */
+    SemaphoreP_Object startSem;
+
+    /*! @brief Number of lines with an error */
+    uint32_t numErrors;
+} Cli_Object;
+
+static Cli_Object gCli;
+
+
+/**
+ * @brief Takes over a completed configuration: during start-up as gSysContext.sensorCfg, later by reconfiguration.
+ */
+static void cli_applyConfig(void) {
+    uintptr_t key;
+    uint8_t   state;
+
+    if (gCli.pendingError != 0U) {
+        DebugP_log("CLI: sensorStart rejected, the configuration had errors\n");
+        return;
+    }
+    if (gCli.state == CLI_STATE_RUNNING) {
+        // checked there, a rejection is counted in FRAME_PROTO_TLV_RECONFIG
+        if (rangeProc_reconfigure(&gCli.pending, NULL) == SystemP_SUCCESS) {
+            DebugP_log("CLI: sensor reconfigured\n");
+        }
+        return;
+    }
+    if (rangeProc_checkConfig(&gCli.pending) != SystemP_SUCCESS) {
+        DebugP_log("CLI: sensorStart rejected\n");
+        return;
+    }
+
+    // main task may time out meanwhile, so take over and change state at once
+    key   = HwiP_disable();
+    state = gCli.state;
+    if (state == CLI_STATE_WAIT_START) {
+        memcpy((void *)&gSysContext.sensorCfg, (const void *)&gCli.pending, sizeof(SensorConfig));
+        gCli.state = CLI_STATE_STARTING;
+    }
+    HwiP_restore(key);
+
+    if (state == CLI_STATE_WAIT_START) {
+        DebugP_log("CLI: configuration taken over for sensor start\n");
+        SemaphoreP_post(&gCli.startSem);
+    } else {
+        DebugP_log("CLI: sensorStart rejected, the sensor is being started\n");
+    }
+}
+
+/**
+ * @brief Parses the current line and acts on sensorStart.
+ */
+static void cli_processLine(void) {
+    SensorConfig_Command cmd;
+
+    if (SensorConfig_parseLine(&gCli.pending, gCli.line, &cmd) != SENSOR_CONFIG_SUCCESS) {
+        DebugP_log("CLI: error in '%s'\n", gCli.line);
+        gCli.pendingError = 1U;
+        gCli.numErrors++;
+    } else if (cmd == SENSOR_CONFIG_CMD_UNKNOWN) {
+        DebugP_log("CLI: ignored '%s'\n", gCli.line);
+    }
+
+    if (cmd == SENSOR_CONFIG_CMD_SENSOR_START) {
+        cli_applyConfig();
+        // next configuration starts from the active one
+        if (gCli.state == CLI_STATE_RUNNING) {
+            rangeProc_getConfig(&gCli.pending);
+        } else {
+            memcpy((void *)&gCli.pending, (const void *)&gSysContext.sensorCfg, sizeof(SensorConfig));
+        }
+        gCli.pendingError = 0U;
+    }
+}
+
+void cli_init(void) {
+    memset((void *)&gCli, 0, sizeof(Cli_Object));
+    memcpy((void *)&gCli.pending, (const void *)&gSysContext.sensorCfg, sizeof(SensorConfig));
+    gCli.state = CLI_STATE_WAIT_START;
+    SemaphoreP_constructBinary(&gCli.startSem, 0);
+}
+
+uint32_t cli_waitForStart(uint32_t timeoutMs) {
+    uintptr_t key;
+    uint32_t  received;
+
+    if (timeoutMs > 0U) {
+        SemaphoreP_pend(&gCli.startSem, ClockP_usecToTicks((uint64_t) timeoutMs * 1000U));
+    }
+
+    key      = HwiP_disable();
+    received = (gCli.state == CLI_STATE_STARTING) ? 1U : 0U;
+    gCli.state = CLI_STATE_STARTING;
+    HwiP_restore(key);
+
+    if (received == 0U) {
+        DebugP_log("CLI: no configuration received, starting with defines.h\n");
+    }
+    return received;
+}
+
+void cli_sensorRunning(void) {
+    gCli.state = CLI_STATE_RUNNING;
+}
+
+void cliTask() {
+    uint8_t byte;
+
+    while (true) {
+        if (uart_receiveByte(&byte) != SystemP_SUCCESS) {
+            continue;
+        }
+
+        if ((byte != '\r') && (byte != '\n')) {
+            if (gCli.lineLen < SENSOR_CONFIG_MAX_LINE_LEN) {
+                gCli.line[gCli.lineLen++] = (char) byte;
+            } else {
+                gCli.lineOverflow = 1U;
+            }
+            continue;
+        }
+
+        // end of line, CR LF gives an empty line in between
+        gCli.line[gCli.lineLen] = '\0';
+        if (gCli.lineOverflow != 0U) {
+            DebugP_log("CLI: line longer than %u characters\n", SENSOR_CONFIG_MAX_LINE_LEN);
+            gCli.pendingError = 1U;
+            gCli.numErrors++;
+        } else if (gCli.lineLen > 0U) {
+            cli_processLine();
+        }
+        gCli.lineLen      = 0U;
+        gCli.lineOverflow = 0U;
+    }
+}
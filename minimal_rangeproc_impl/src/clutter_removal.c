@@ -0,0 +1,140 @@
+/**
+ * @file clutter_removal.c
+ * @brief Static clutter removal on the radar cube (see clutter_removal.h).
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "clutter_removal.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define CLUTTER_REMOVAL_HAVE_DSP 1
+#include <arm_acle.h>
+#endif
+
+/*! @brief Range bins processed per block, sums and packed background live on the stack */
+#define CLUTTER_REMOVAL_BLOCK_LEN   (32U)
+
+/* saturated subtraction of both 16-bit halves */
+static inline uint32_t ClutterRemoval_qsub16(uint32_t a, uint32_t b) {
+#ifdef CLUTTER_REMOVAL_HAVE_DSP
+    return (uint32_t) __qsub16((int16x2_t) a, (int16x2_t) b);
+#else
+    int32_t lo = (int32_t) (int16_t) (a & 0xFFFFU) - (int32_t) (int16_t) (b & 0xFFFFU);
+    int32_t hi = (int32_t) (int16_t) (a >> 16) - (int32_t) (int16_t) (b >> 16);
+
+    lo = (lo > INT16_MAX) ? INT16_MAX : ((lo < INT16_MIN) ? INT16_MIN : lo);
+    hi = (hi > INT16_MAX) ? INT16_MAX : ((hi < INT16_MIN) ? INT16_MIN : hi);
+    return ((uint32_t) (uint16_t) hi << 16) | (uint32_t) (uint16_t) lo;
+#endif
+}
+
+/* sum / n rounded to nearest, halves away from zero */
+static inline int32_t ClutterRemoval_divRound(int32_t sum, int32_t n) {
+    return (sum >= 0) ? ((sum + n / 2) / n) : -((-sum + n / 2) / n);
+}
+
+/* sample with the layout of cmplx16ImRe_t as one word */
+static inline uint32_t ClutterRemoval_pack(int32_t imag, int32_t real) {
+    cmplx16ImRe_t s;
+    uint32_t      word;
+
+    s.imag = (int16_t) imag;
+    s.real = (int16_t) real;
+    memcpy(&word, &s, sizeof(word));
+    return word;
+}
+
+uint32_t ClutterRemoval_stateSize(const ClutterRemoval_Config *cfg) {
+    if (cfg->mode != CLUTTER_REMOVAL_MODE_EMA) {
+        return 0U;
+    }
+    return 2U * cfg->numAntennas * cfg->numRangeBins * sizeof(int32_t);
+}
+
+int32_t ClutterRemoval_init(ClutterRemoval_Obj *obj, const ClutterRemoval_Config *cfg, void *state) {
+    memset(obj, 0, sizeof(ClutterRemoval_Obj));
+    if (((cfg->mode != CLUTTER_REMOVAL_MODE_MEAN) && (cfg->mode != CLUTTER_REMOVAL_MODE_EMA)) ||
+        (cfg->emaShift > CLUTTER_REMOVAL_MAX_EMA_SHIFT) || (cfg->numChirps == 0U) || (cfg->numChirps > 0xFFFFU) ||
+        (cfg->numAntennas == 0U) || (cfg->numRangeBins == 0U) ||
+        ((ClutterRemoval_stateSize(cfg) > 0U) && (state == NULL))) {
+        return CLUTTER_REMOVAL_EINVAL;
+    }
+    obj->cfg        = *cfg;
+    obj->background = (cfg->mode == CLUTTER_REMOVAL_MODE_EMA) ? (int32_t *) state : NULL;
+    return CLUTTER_REMOVAL_SUCCESS;
+}
+
+void ClutterRemoval_reset(ClutterRemoval_Obj *obj) {
+    obj->backgroundValid = 0U;
+}
+
+int32_t ClutterRemoval_process(ClutterRemoval_Obj *obj, RadarCube_View *cube) {
+    const ClutterRemoval_Config *cfg = &obj->cfg;
+    const uint32_t               chirpStride = RadarCube_chirpStride(cube);
+    int32_t                      sum[2U * CLUTTER_REMOVAL_BLOCK_LEN];
+    uint32_t                     packed[CLUTTER_REMOVAL_BLOCK_LEN];
+    uint32_t                     ant, first, numBins, c, i;
+
+    if ((cube->numChirps != cfg->numChirps) || (cube->numAntennas != cfg->numAntennas) ||
+        (cube->numRangeBins != cfg->numRangeBins)) {
+        return CLUTTER_REMOVAL_EINVAL;
+    }
+
+    for (ant = 0; ant < cfg->numAntennas; ant++) {
+        for (first = 0; first < cfg->numRangeBins; first += numBins) {
+            cmplx16ImRe_t *block = RadarCube_at(cube, 0, ant, first);
+            int32_t       *bg    = (obj->background != NULL) ?
+                                   &obj->background[2U * (ant * cfg->numRangeBins + first)] : NULL;
+
+            numBins = cfg->numRangeBins - first;
+            numBins = (numBins > CLUTTER_REMOVAL_BLOCK_LEN) ? CLUTTER_REMOVAL_BLOCK_LEN : numBins;
+
+            /* sums over the chirps, the range bins of a chirp are contiguous */
+            memset(sum, 0, 2U * numBins * sizeof(int32_t));
+            for (c = 0; c < cfg->numChirps; c++) {
+                const cmplx16ImRe_t *s = block + c * chirpStride;
+                for (i = 0; i < numBins; i++) {
+                    sum[2U * i]      += s[i].imag;
+                    sum[2U * i + 1U] += s[i].real;
+                }
+            }
+
+            /* background of the block */
+            for (i = 0; i < 2U * numBins; i++) {
+                int32_t mean = ClutterRemoval_divRound(sum[i], (int32_t) cfg->numChirps);
+
+                if (bg != NULL) {
+                    if (obj->backgroundValid != 0U) {
+                        bg[i] += ((mean * 256) - bg[i]) >> cfg->emaShift;
+                    } else {
+                        bg[i] = mean * 256;
+                    }
+                    sum[i] = (bg[i] + 128) >> 8;
+                } else {
+                    sum[i] = mean;
+                }
+            }
+            for (i = 0; i < numBins; i++) {
+                packed[i] = ClutterRemoval_pack(sum[2U * i], sum[2U * i + 1U]);
+            }
+
+            /* subtraction, both halves of a sample at once */
+            for (c = 0; c < cfg->numChirps; c++) {
+                cmplx16ImRe_t *s = block + c * chirpStride;
+                for (i = 0; i < numBins; i++) {
+                    uint32_t word;
+                    memcpy(&word, &s[i], sizeof(word));
+                    word = ClutterRemoval_qsub16(word, packed[i]);
+                    memcpy(&s[i], &word, sizeof(word));
+                }
+            }
+        }
+    }
+    obj->backgroundValid = (obj->background != NULL) ? 1U : 0U;
+    return CLUTTER_REMOVAL_SUCCESS;
+}
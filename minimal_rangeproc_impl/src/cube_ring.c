@@ -0,0 +1,114 @@
+/**
+ * @file cube_ring.c
+ * @brief Ring of the radar cubes of the last frames with pinned read handles (see cube_ring.h).
+ *
+ * Only depends on the C standard library and the __atomic builtins, so this
+ * file is shared between the firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cube_ring.h"
+
+#define CUBE_RING_LOAD(p)           __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define CUBE_RING_STORE(p, v)       __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+
+uint32_t CubeRing_memSize(const CubeRing_Config *cfg) {
+    return cfg->depth * cfg->numChirps * cfg->numAntennas * cfg->numRangeBins * sizeof(cmplx16ImRe_t);
+}
+
+int32_t CubeRing_init(CubeRing_Obj *obj, const CubeRing_Config *cfg, void *mem) {
+    memset(obj, 0, sizeof(CubeRing_Obj));
+    if ((cfg->depth < 2U) || (cfg->depth > CUBE_RING_MAX_DEPTH) || (cfg->numChirps == 0U) ||
+        (cfg->numAntennas == 0U) || (cfg->numRangeBins == 0U) || (mem == NULL) || (((uintptr_t) mem & 3U) != 0U)) {
+        return CUBE_RING_EINVAL;
+    }
+    obj->cfg     = *cfg;
+    obj->mem     = (cmplx16ImRe_t *) mem;
+    obj->slotLen = cfg->numChirps * cfg->numAntennas * cfg->numRangeBins;
+    return CUBE_RING_SUCCESS;
+}
+
+void CubeRing_writeView(const CubeRing_Obj *obj, RadarCube_View *cube) {
+    RadarCube_initView(cube, obj->mem + obj->writeIdx * obj->slotLen, obj->cfg.numChirps, obj->cfg.numAntennas,
+                       obj->cfg.numRangeBins);
+}
+
+/* takes a slot from the readers: clear the sequence number first, then check the pins (see CubeRing_acquire()) */
+static int32_t CubeRing_claim(CubeRing_Obj *obj, uint32_t idx) {
+    CubeRing_Slot *slot = &obj->slot[idx];
+    uint32_t       seq  = __atomic_exchange_n(&slot->seq, 0U, __ATOMIC_SEQ_CST);
+
+    if (CUBE_RING_LOAD(&slot->pins) != 0U) {
+        CUBE_RING_STORE(&slot->seq, seq);
+        return CUBE_RING_EBUSY;
+    }
+    return CUBE_RING_SUCCESS;
+}
+
+int32_t CubeRing_publish(CubeRing_Obj *obj) {
+    uint32_t latest = obj->latestSeq;
+    uint32_t seq    = (latest + 1U == 0U) ? 1U : latest + 1U;
+    uint32_t tried  = 0U;
+    uint32_t n, i;
+
+    /* oldest slot first (empty slots count as oldest), skip the ones that are pinned */
+    for (n = 1U; n < obj->cfg.depth; n++) {
+        uint32_t best = obj->cfg.depth, bestAge = 0U;
+
+        for (i = 0; i < obj->cfg.depth; i++) {
+            uint32_t slotSeq = CUBE_RING_LOAD(&obj->slot[i].seq);
+            uint32_t age     = (slotSeq == 0U) ? 0xFFFFFFFFU : latest - slotSeq;
+
+            if ((i != obj->writeIdx) && (((tried >> i) & 1U) == 0U) && ((best == obj->cfg.depth) || (age > bestAge))) {
+                best    = i;
+                bestAge = age;
+            }
+        }
+        tried |= 1U << best;
+        if (CubeRing_claim(obj, best) == CUBE_RING_SUCCESS) {
+            CUBE_RING_STORE(&obj->slot[obj->writeIdx].seq, seq);
+            CUBE_RING_STORE(&obj->latestSeq, seq);
+            obj->writeIdx = best;
+            return CUBE_RING_SUCCESS;
+        }
+    }
+    obj->numDropped++;
+    return CUBE_RING_EBUSY;
+}
+
+uint32_t CubeRing_latest(const CubeRing_Obj *obj) {
+    return CUBE_RING_LOAD(&obj->latestSeq);
+}
+
+int32_t CubeRing_acquire(CubeRing_Obj *obj, uint32_t seq, CubeRing_Handle *handle) {
+    uint32_t i;
+
+    if (seq == 0U) {
+        return CUBE_RING_ENOENT;
+    }
+    for (i = 0; i < obj->cfg.depth; i++) {
+        CubeRing_Slot *slot = &obj->slot[i];
+
+        if (CUBE_RING_LOAD(&slot->seq) == seq) {
+            /* pin first, then check that the producer has not claimed the slot meanwhile */
+            __atomic_fetch_add(&slot->pins, 1U, __ATOMIC_SEQ_CST);
+            if (CUBE_RING_LOAD(&slot->seq) != seq) {
+                __atomic_fetch_sub(&slot->pins, 1U, __ATOMIC_SEQ_CST);
+                return CUBE_RING_ENOENT;
+            }
+            RadarCube_initView(&handle->cube, obj->mem + i * obj->slotLen, obj->cfg.numChirps, obj->cfg.numAntennas,
+                               obj->cfg.numRangeBins);
+            handle->seq = seq;
+            handle->idx = i;
+            return CUBE_RING_SUCCESS;
+        }
+    }
+    return CUBE_RING_ENOENT;
+}
+
+void CubeRing_release(CubeRing_Obj *obj, CubeRing_Handle *handle) {
+    __atomic_fetch_sub(&obj->slot[handle->idx].pins, 1U, __ATOMIC_SEQ_CST);
+    handle->seq = 0U;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file doa.c
+ * @brief Direction of arrival of the CFAR detections from the virtual antenna array.
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c), so
+ * this file is shared between the firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "doa.h"
+#include "fixed_math.h"
+
+int32_t Doa_init(Doa_Obj *obj, const Doa_Config *cfg) {
+    uint32_t numTx, a;
+
+    memset(obj, 0, sizeof(Doa_Obj));
+    if ((cfg->numVirtualAntennas == 0U) || (cfg->numVirtualAntennas > DOA_MAX_VIRTUAL_ANTENNAS) ||
+        (cfg->numRxAntennas == 0U) || (cfg->numVirtualAntennas % cfg->numRxAntennas != 0U) ||
+        (cfg->numDopplerChirps == 0U) || (cfg->dopplerFftSize < cfg->numDopplerChirps) ||
+        (cfg->azimuthFftSize < 4U) || (cfg->azimuthFftSize > DOA_MAX_AZIMUTH_FFT_SIZE) ||
+        ((cfg->azimuthFftSize & (cfg->azimuthFftSize - 1U)) != 0U)) {
+        return DOA_EINVAL;
+    }
+    numTx = cfg->numVirtualAntennas / cfg->numRxAntennas;
+    if ((DOA_TWIDDLE_TABLE_SIZE % (cfg->dopplerFftSize * (cfg->tdmCompensation ? numTx : 1U))) != 0U) {
+        return DOA_EINVAL;
+    }
+    for (a = 0; a < cfg->numVirtualAntennas; a++) {
+        if ((cfg->antRow[a] >= DOA_MAX_ROWS) || (cfg->antCol[a] >= cfg->azimuthFftSize)) {
+            return DOA_EINVAL;
+        }
+        if (cfg->antRow[a] + 1U > obj->numRows) {
+            obj->numRows = cfg->antRow[a] + 1U;
+        }
+    }
+    obj->cfg = *cfg;
+
+    FixedMath_twiddleTable(obj->twiddleRe, obj->twiddleIm, DOA_TWIDDLE_TABLE_SIZE);
+    return DOA_SUCCESS;
+}
+
+/* rounds a Q15 product sum back to the sample scale */
+static int32_t Doa_roundQ15(int64_t v) {
+    return (int32_t) ((v + (1 << 14)) >> 15);
+}
+
+/*
+ * exp(-j 2 pi phase / (256 * DOA_TWIDDLE_TABLE_SIZE)) in Q15, phase in table entries in Q8: table entry
+ * times the rotation by the fraction of an entry (small angle, the error is below 1e-5)
+ */
+static void Doa_twiddle(const Doa_Obj *obj, int32_t phaseQ8, int32_t *re, int32_t *im) {
+    const uint32_t idx  = ((uint32_t) phaseQ8 >> 8) & (DOA_TWIDDLE_TABLE_SIZE - 1U);
+    const int32_t  frac = (int32_t) ((uint32_t) phaseQ8 & 0xFFU);
+    int32_t        fineSin, fineCos;
+
+    *re = obj->twiddleRe[idx];
+    *im = obj->twiddleIm[idx];
+    if (frac != 0) {
+        /* angle 2 pi frac / 2^16 in Q15: frac * pi / 2 */
+        fineSin = (frac * 205887 + (1 << 16)) >> 17;
+        fineCos = 32767 - ((fineSin * fineSin) >> 16);
+        fineSin = -fineSin;
+        *re = (int32_t) (((int64_t) obj->twiddleRe[idx] * fineCos - (int64_t) obj->twiddleIm[idx] * fineSin +
+                          (1 << 14)) >> 15);
+        *im = (int32_t) (((int64_t) obj->twiddleRe[idx] * fineSin + (int64_t) obj->twiddleIm[idx] * fineCos +
+                          (1 << 14)) >> 15);
+    }
+}
+
+/* sum of the antennas of one row, each rotated by stepQ8 * column (in table entries, Q8) */
+static void Doa_rowSum(const Doa_Obj *obj, const int32_t *xRe, const int32_t *xIm, uint32_t row, int32_t stepQ8,
+                       int32_t *yRe, int32_t *yIm) {
+    const Doa_Config *cfg = &obj->cfg;
+    int64_t           accRe = 0, accIm = 0;
+    int32_t           twRe, twIm;
+    uint32_t          a;
+
+    for (a = 0; a < cfg->numVirtualAntennas; a++) {
+        if (cfg->antRow[a] != row) {
+            continue;
+        }
+        Doa_twiddle(obj, stepQ8 * (int32_t) cfg->antCol[a], &twRe, &twIm);
+        accRe += (int64_t) xRe[a] * twRe - (int64_t) xIm[a] * twIm;
+        accIm += (int64_t) xRe[a] * twIm + (int64_t) xIm[a] * twRe;
+    }
+    *yRe = Doa_roundQ15(accRe);
+    *yIm = Doa_roundQ15(accIm);
+}
+
+/* power of the azimuth spectrum at bin k, summed over the rows */
+static uint64_t Doa_azimuthPower(const Doa_Obj *obj, const int32_t *xRe, const int32_t *xIm, uint32_t k) {
+    const int32_t stepQ8 = (int32_t) (k * (DOA_TWIDDLE_TABLE_SIZE / obj->cfg.azimuthFftSize)) * 256;
+    uint64_t      power = 0U;
+    int32_t       yRe, yIm;
+    uint32_t      row;
+
+    for (row = 0; row < obj->numRows; row++) {
+        Doa_rowSum(obj, xRe, xIm, row, stepQ8, &yRe, &yIm);
+        power += (uint64_t) ((int64_t) yRe * yRe) + (uint64_t) ((int64_t) yIm * yIm);
+    }
+    return power;
+}
+
+/* antenna signals of one cell: Doppler DFT at the detected bin, TDM phase compensation */
+static void Doa_antennaSignals(const Doa_Obj *obj, const RadarCube_View *cube, uint32_t rangeBin,
+                               uint32_t dopplerBin, int32_t *xRe, int32_t *xIm) {
+    const Doa_Config *cfg    = &obj->cfg;
+    const uint32_t    numTx  = cfg->numVirtualAntennas / cfg->numRxAntennas;
+    const uint32_t    step   = dopplerBin * (DOA_TWIDDLE_TABLE_SIZE / cfg->dopplerFftSize);
+    const int32_t     signedBin = (dopplerBin < cfg->dopplerFftSize / 2U) ?
+                                  (int32_t) dopplerBin : (int32_t) dopplerBin - (int32_t) cfg->dopplerFftSize;
+    uint32_t          a, c, idx;
+
+    for (a = 0; a < cfg->numVirtualAntennas; a++) {
+        int64_t accRe = 0, accIm = 0;
+
+        for (c = 0; c < cfg->numDopplerChirps; c++) {
+            const cmplx16ImRe_t *s = RadarCube_at(cube, c, a, rangeBin);
+
+            idx    = (step * c) & (DOA_TWIDDLE_TABLE_SIZE - 1U);
+            accRe += (int32_t) s->real * obj->twiddleRe[idx] - (int32_t) s->imag * obj->twiddleIm[idx];
+            accIm += (int32_t) s->real * obj->twiddleIm[idx] + (int32_t) s->imag * obj->twiddleRe[idx];
+        }
+        xRe[a] = Doa_roundQ15(accRe);
+        xIm[a] = Doa_roundQ15(accIm);
+
+        /* TX t transmits t / numTx of a Doppler chirp period later, undo the phase the target moved meanwhile */
+        if (cfg->tdmCompensation && (numTx > 1U)) {
+            int32_t re = xRe[a];
+            int32_t im = xIm[a];
+
+            idx = (uint32_t) (signedBin * (int32_t) (a / cfg->numRxAntennas) *
+                              (int32_t) (DOA_TWIDDLE_TABLE_SIZE / (cfg->dopplerFftSize * numTx))) &
+                  (DOA_TWIDDLE_TABLE_SIZE - 1U);
+            xRe[a] = Doa_roundQ15((int64_t) re * obj->twiddleRe[idx] - (int64_t) im * obj->twiddleIm[idx]);
+            xIm[a] = Doa_roundQ15((int64_t) re * obj->twiddleIm[idx] + (int64_t) im * obj->twiddleRe[idx]);
+        }
+    }
+}
+
+int32_t Doa_process(const Doa_Obj *obj, const RadarCube_View *cube, const Cfar_Detection *detections,
+                    uint32_t numDetections, Doa_Point *points) {
+    const Doa_Config *cfg = &obj->cfg;
+    const uint32_t    numBins = cfg->azimuthFftSize;
+    int32_t           xRe[DOA_MAX_VIRTUAL_ANTENNAS], xIm[DOA_MAX_VIRTUAL_ANTENNAS];
+    uint32_t          i, k;
+
+    if ((cube->numChirps != cfg->numDopplerChirps) || (cube->numAntennas != cfg->numVirtualAntennas)) {
+        return DOA_EINVAL;
+    }
+
+    for (i = 0; i < numDetections; i++) {
+        const Cfar_Detection *det   = &detections[i];
+        Doa_Point            *point = &points[i];
+        uint64_t              power, peakPower = 0U;
+        uint32_t              peak = 0U;
+        int32_t               mPrev, mPeak, mNext, denom, offsetQ8 = 0, binQ8, sinQ15;
+
+        if ((det->rangeBin >= cube->numRangeBins) || (det->dopplerBin >= cfg->dopplerFftSize)) {
+            return DOA_EINVAL;
+        }
+        Doa_antennaSignals(obj, cube, det->rangeBin, det->dopplerBin, xRe, xIm);
+
+        /* azimuth: peak of the power spectrum, parabolic interpolation of the magnitudes around it */
+        for (k = 0; k < numBins; k++) {
+            power = Doa_azimuthPower(obj, xRe, xIm, k);
+            if (power > peakPower) {
+                peakPower = power;
+                peak      = k;
+            }
+        }
+        mPrev = (int32_t) FixedMath_isqrt(Doa_azimuthPower(obj, xRe, xIm, (peak + numBins - 1U) & (numBins - 1U)));
+        mPeak = (int32_t) FixedMath_isqrt(peakPower);
+        mNext = (int32_t) FixedMath_isqrt(Doa_azimuthPower(obj, xRe, xIm, (peak + 1U) & (numBins - 1U)));
+        denom = mPrev - 2 * mPeak + mNext;
+        if (denom < 0) {
+            offsetQ8 = (int32_t) (((int64_t) (mPrev - mNext) * 128) / denom);
+            offsetQ8 = (offsetQ8 > 128) ? 128 : ((offsetQ8 < -128) ? -128 : offsetQ8);
+        }
+        binQ8 = ((peak < numBins / 2U) ? (int32_t) peak : (int32_t) peak - (int32_t) numBins) * 256 + offsetQ8;
+
+        /* sin(az) = 2 * bin / numBins */
+        sinQ15 = (int32_t) (((int64_t) binQ8 * 256) / (int32_t) numBins);
+        point->sinAzimuthQ15 = (int16_t) ((sinQ15 > INT16_MAX) ? INT16_MAX :
+                                          ((sinQ15 < INT16_MIN) ? INT16_MIN : sinQ15));
+
+        /* elevation: rows 0 and 1 steered to the interpolated azimuth, phase of row 1 relative to row 0 */
+        point->sinElevationQ15 = 0;
+        if (obj->numRows >= 2U) {
+            int32_t stepQ8 = binQ8 * (int32_t) (DOA_TWIDDLE_TABLE_SIZE / numBins);
+            int32_t y0Re, y0Im, y1Re, y1Im;
+
+            Doa_rowSum(obj, xRe, xIm, 0U, stepQ8, &y0Re, &y0Im);
+            Doa_rowSum(obj, xRe, xIm, 1U, stepQ8, &y1Re, &y1Im);
+            point->sinElevationQ15 = FixedMath_atan2Q15((int64_t) y1Im * y0Re - (int64_t) y1Re * y0Im,
+                                                  (int64_t) y1Re * y0Re + (int64_t) y1Im * y0Im);
+        }
+
+        point->rangeBin   = det->rangeBin;
+        point->dopplerBin = det->dopplerBin;
+        point->magnitude  = det->magnitude;
+        point->snrDbQ8    = det->snrDbQ8;
+    }
+    return DOA_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file doppler_proc.c
+ * @brief Doppler stage: range-Doppler heat map computed on the HWA (see doppler_proc.h).
+ *
+ * The radar cube is moved into the HWA memory by the CPU instead of an EDMA
+ * channel: the stage runs once per frame while the HWA is otherwise idle, and
+ * the transfer of a block is short compared to the frame period. The EDMA
+ * channels of dpu_res.h thus remain free for the later DPUs.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/CacheP.h>
+#include <utils/mathutils/mathutils.h>
+#include "kernel/dpl/SemaphoreP.h"
+#include <drivers/hwa.h>
+
+#include "system.h"
+#include "mem_pool.h"
+#include "rangeproc_dpc.h"
+#include "doppler_proc.h"
+
+
+/*! @brief Number of HWA memory banks the input block occupies (M0, M1) */
+#define DOPPLERPROC_NUM_IN_BANKS    (2U)
+
+/*! @brief Number of HWA memory banks the output block occupies (M2, M3) */
+#define DOPPLERPROC_NUM_OUT_BANKS   (2U)
+
+
+/**
+ * @brief HWA done interrupt callback, wakes up DopplerProc_process().
+ */
+static void DopplerProc_hwaDoneIsr(uint32_t threadIdx, void *arg) {
+    SemaphoreP_post((SemaphoreP_Object *) arg);
+}
+
+/**
+ * @brief Programs the param set for a block of range bins.
+ *
+ * Source: [chirp][antenna][bin] complex 16 bit, A = chirps, B = (antenna, bin).
+ * Destination: [antenna][bin][doppler] 16-bit unsigned magnitude.
+ */
+static int32_t DopplerProc_configParamSet(DopplerProc_Obj *obj, uint32_t numBins) {
+    const DopplerProc_Config *cfg = &obj->cfg;
+    HWA_ParamConfig           paramCfg;
+    int32_t                   retVal;
+
+    memset((void *)&paramCfg, 0, sizeof(HWA_ParamConfig));
+    paramCfg.triggerMode = HWA_TRIG_MODE_SOFTWARE;
+    paramCfg.accelMode   = HWA_ACCELMODE_FFT;
+
+    paramCfg.source.srcAddr        = HWADRV_ADDR_TRANSLATE_CPU_TO_HWA(obj->hwaIn);
+    paramCfg.source.srcAcnt        = cfg->numDopplerChirps - 1U;
+    paramCfg.source.srcAIdx        = cfg->numVirtualAntennas * numBins * sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcBcnt        = cfg->numVirtualAntennas * numBins - 1U;
+    paramCfg.source.srcBIdx        = sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcRealComplex = HWA_SAMPLES_FORMAT_COMPLEX;
+    paramCfg.source.srcWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.source.srcSign        = HWA_SAMPLES_SIGNED;
+    paramCfg.source.srcConjugate   = HWA_FEATURE_BIT_DISABLE;
+    paramCfg.source.srcScale       = 0;
+    paramCfg.source.srcIQSwap      = HWA_FEATURE_BIT_ENABLE; // radar cube holds cmplx16ImRe_t
+
+    paramCfg.dest.dstAddr          = HWADRV_ADDR_TRANSLATE_CPU_TO_HWA(obj->hwaOut);
+    paramCfg.dest.dstAcnt          = cfg->fftSize - 1U;
+    paramCfg.dest.dstAIdx          = sizeof(uint16_t);
+    paramCfg.dest.dstBIdx          = cfg->fftSize * sizeof(uint16_t);
+    paramCfg.dest.dstRealComplex   = HWA_SAMPLES_FORMAT_REAL;
+    paramCfg.dest.dstWidth         = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.dest.dstSign          = HWA_SAMPLES_UNSIGNED;
+    paramCfg.dest.dstConjugate     = HWA_FEATURE_BIT_DISABLE;
+    paramCfg.dest.dstScale         = 8U - cfg->fftOutputDivShift;
+    paramCfg.dest.dstSkipInit      = 0;
+
+    paramCfg.accelModeArgs.fftMode.fftEn            = HWA_FEATURE_BIT_ENABLE;
+    paramCfg.accelModeArgs.fftMode.fftSize          = mathUtils_ceilLog2(cfg->fftSize);
+    paramCfg.accelModeArgs.fftMode.butterflyScaling = 0; // no scaling, the 24-bit datapath has 8 bits to grow
+    paramCfg.accelModeArgs.fftMode.windowEn         = HWA_FEATURE_BIT_ENABLE;
+    paramCfg.accelModeArgs.fftMode.windowStart      = cfg->hwaWinRamOffset;
+    paramCfg.accelModeArgs.fftMode.winSymm          = HWA_FFT_WINDOW_SYMMETRIC;
+    paramCfg.accelModeArgs.fftMode.magLogEn         = HWA_FFT_MODE_MAGNITUDE_ONLY_ENABLED;
+    paramCfg.accelModeArgs.fftMode.fftOutMode       = HWA_FFT_MODE_OUTPUT_DEFAULT;
+    paramCfg.complexMultiply.mode                   = HWA_COMPLEX_MULTIPLY_MODE_DISABLE;
+
+    retVal = HWA_configParamSet(cfg->hwaHandle, cfg->hwaParamSetIdx, &paramCfg, NULL);
+    if (retVal != 0) {
+        DebugP_log("DopplerProc: HWA_configParamSet failed with %d\n", retVal);
+        return SystemP_FAILURE;
+    }
+    obj->numBinsConfigured = numBins;
+    return SystemP_SUCCESS;
+}
+
+int32_t DopplerProc_config(DopplerProc_Obj *obj, const DopplerProc_Config *cfg, struct MemPoolObj_t *l3Pool,
+                           struct MemPoolObj_t *localPool) {
+    HWA_MemInfo memInfo;
+    uint32_t    winLen = (cfg->numDopplerChirps + 1U) / 2U;
+    uint32_t    inBinBytes, outBinBytes, maxBins;
+    int32_t     retVal;
+
+    memset((void *)obj, 0, sizeof(DopplerProc_Obj));
+    if ((cfg->numDopplerChirps < 2U) || (cfg->fftSize < cfg->numDopplerChirps) ||
+        (cfg->fftSize != mathUtils_pow2roundup(cfg->fftSize)) || (cfg->fftOutputDivShift > 8U)) {
+        DebugP_log("DopplerProc: invalid configuration\n");
+        return SystemP_FAILURE;
+    }
+    obj->cfg = *cfg;
+
+    /* block size: as many range bins as fit into the input and output banks */
+    retVal = HWA_getHWAMemInfo(cfg->hwaHandle, &memInfo);
+    if ((retVal != 0) || (memInfo.numBanks < DOPPLERPROC_NUM_IN_BANKS + DOPPLERPROC_NUM_OUT_BANKS)) {
+        DebugP_log("DopplerProc: HWA memory info not available\n");
+        return SystemP_FAILURE;
+    }
+    inBinBytes  = cfg->numDopplerChirps * cfg->numVirtualAntennas * sizeof(cmplx16ImRe_t);
+    outBinBytes = cfg->fftSize * cfg->numVirtualAntennas * sizeof(uint16_t);
+    maxBins     = (DOPPLERPROC_NUM_IN_BANKS * memInfo.bankSize) / inBinBytes;
+    if ((DOPPLERPROC_NUM_OUT_BANKS * memInfo.bankSize) / outBinBytes < maxBins) {
+        maxBins = (DOPPLERPROC_NUM_OUT_BANKS * memInfo.bankSize) / outBinBytes;
+    }
+    if (maxBins == 0U) {
+        DebugP_log("DopplerProc: one range bin does not fit into the HWA memory\n");
+        return SystemP_FAILURE;
+    }
+    obj->numBinsPerBlock = (cfg->numRangeBins < maxBins) ? cfg->numRangeBins : maxBins;
+    obj->hwaIn  = (cmplx16ImRe_t *) memInfo.baseAddress;
+    obj->hwaOut = (uint16_t *) (memInfo.baseAddress + DOPPLERPROC_NUM_IN_BANKS * memInfo.bankSize);
+
+    /* symmetric window: only the first half is stored in the window RAM */
+    obj->window = (int32_t *) DPC_ObjDet_MemPoolAlloc(localPool, winLen * sizeof(uint32_t), sizeof(uint32_t));
+    obj->heatmap = (uint16_t *) DPC_ObjDet_MemPoolAlloc(l3Pool,
+                                                        cfg->numRangeBins * cfg->fftSize * sizeof(uint16_t),
+                                                        sizeof(uint32_t));
+    if ((obj->window == NULL) || (obj->heatmap == NULL)) {
+        DebugP_log("DopplerProc: error allocating memory\n");
+        return SystemP_FAILURE;
+    }
+    mathUtils_genWindow((uint32_t *)obj->window, cfg->numDopplerChirps, winLen, cfg->windowType,
+                        DPC_OBJDET_QFORMAT_DOPPLER_FFT);
+    retVal = HWA_configRam(cfg->hwaHandle, HWA_RAM_TYPE_WINDOW_RAM, (uint8_t *)obj->window,
+                           winLen * sizeof(uint32_t), cfg->hwaWinRamOffset * sizeof(uint32_t));
+    if (retVal != 0) {
+        DebugP_log("DopplerProc: HWA_configRam failed with %d\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    if (SemaphoreP_constructBinary(&obj->hwaDoneSem, 0) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+    return DopplerProc_configParamSet(obj, obj->numBinsPerBlock);
+}
+
+int32_t DopplerProc_process(DopplerProc_Obj *obj, const RadarCube_View *cube) {
+    const DopplerProc_Config *cfg    = &obj->cfg;
+    const uint32_t            numAnt = cfg->numVirtualAntennas;
+    HWA_CommonConfig          commonCfg;
+    uint32_t                  startBin, numBins, chirp, ant, bin, k, sum;
+    int32_t                   retVal = SystemP_SUCCESS;
+
+    if ((cube->numChirps != cfg->numDopplerChirps) || (cube->numAntennas != numAnt) ||
+        (cube->numRangeBins != cfg->numRangeBins)) {
+        return SystemP_FAILURE;
+    }
+
+    /* one param set, one loop, software triggered */
+    memset((void *)&commonCfg, 0, sizeof(HWA_CommonConfig));
+    commonCfg.configMask = HWA_COMMONCONFIG_MASK_NUMLOOPS | HWA_COMMONCONFIG_MASK_PARAMSTARTIDX |
+                           HWA_COMMONCONFIG_MASK_PARAMSTOPIDX | HWA_COMMONCONFIG_MASK_FFT1DENABLE;
+    commonCfg.numLoops      = 1;
+    commonCfg.paramStartIdx = cfg->hwaParamSetIdx;
+    commonCfg.paramStopIdx  = cfg->hwaParamSetIdx;
+    commonCfg.fftConfig.fft1DEnable = HWA_FEATURE_BIT_DISABLE;
+    if ((HWA_configCommon(cfg->hwaHandle, &commonCfg) != 0) ||
+        (HWA_enableDoneInterrupt(cfg->hwaHandle, DopplerProc_hwaDoneIsr, (void *)&obj->hwaDoneSem) != 0)) {
+        DebugP_log("DopplerProc: HWA configuration failed\n");
+        return SystemP_FAILURE;
+    }
+
+    for (startBin = 0; startBin < cfg->numRangeBins; startBin += numBins) {
+        numBins = cfg->numRangeBins - startBin;
+        numBins = (numBins < obj->numBinsPerBlock) ? numBins : obj->numBinsPerBlock;
+        if ((numBins != obj->numBinsConfigured) && (DopplerProc_configParamSet(obj, numBins) != SystemP_SUCCESS)) {
+            retVal = SystemP_FAILURE;
+            break;
+        }
+
+        /* block of the radar cube into M0/M1 as [chirp][antenna][bin] */
+        for (chirp = 0; chirp < cfg->numDopplerChirps; chirp++) {
+            for (ant = 0; ant < numAnt; ant++) {
+                memcpy((void *)&obj->hwaIn[(chirp * numAnt + ant) * numBins],
+                       (const void *)RadarCube_at(cube, chirp, ant, startBin), numBins * sizeof(cmplx16ImRe_t));
+            }
+        }
+        CacheP_wb(obj->hwaIn, cfg->numDopplerChirps * numAnt * numBins * sizeof(cmplx16ImRe_t), CacheP_TYPE_ALL);
+
+        HWA_enable(cfg->hwaHandle, 1U);
+        HWA_setSoftwareTrigger(cfg->hwaHandle);
+        SemaphoreP_pend(&obj->hwaDoneSem, SystemP_WAIT_FOREVER);
+        HWA_enable(cfg->hwaHandle, 0U);
+
+        /* non-coherent integration over the antennas: M2/M3 hold [antenna][bin][doppler] */
+        CacheP_inv(obj->hwaOut, numAnt * numBins * cfg->fftSize * sizeof(uint16_t), CacheP_TYPE_ALL);
+        for (bin = 0; bin < numBins; bin++) {
+            uint16_t *row = &obj->heatmap[(startBin + bin) * cfg->fftSize];
+
+            for (k = 0; k < cfg->fftSize; k++) {
+                sum = 0U;
+                for (ant = 0; ant < numAnt; ant++) {
+                    sum += obj->hwaOut[(ant * numBins + bin) * cfg->fftSize + k];
+                }
+                row[k] = (uint16_t) (sum / numAnt);
+            }
+        }
+    }
+
+    HWA_disableDoneInterrupt(cfg->hwaHandle);
+    return retVal;
+}
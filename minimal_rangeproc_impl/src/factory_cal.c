@@ -95,13 +95,13 @@ int32_t restoreFactoryCal(void)
     factoryCalCfg.fecRFFactoryCalCmd.h_CalCtrlBitMask = 0xCEU;
     factoryCalCfg.fecRFFactoryCalCmd.c_MiscCalCtrl = 0x0U;
 
-    factoryCalCfg.fecRFFactoryCalCmd.c_CalRxGainSel = CLI_FACCALCFG_RX_GAIN;
-    factoryCalCfg.fecRFFactoryCalCmd.c_CalTxBackOffSel[0] = CLI_FACCALCFG_TX_BACKOFF_SEL;
-    factoryCalCfg.fecRFFactoryCalCmd.c_CalTxBackOffSel[1] = CLI_FACCALCFG_TX_BACKOFF_SEL;
+    factoryCalCfg.fecRFFactoryCalCmd.c_CalRxGainSel = gSysContext.sensorCfg.rxGain;
+    factoryCalCfg.fecRFFactoryCalCmd.c_CalTxBackOffSel[0] = gSysContext.sensorCfg.txBackoff * 2U;
+    factoryCalCfg.fecRFFactoryCalCmd.c_CalTxBackOffSel[1] = gSysContext.sensorCfg.txBackoff * 2U;
 
     /* Calculate Calibration Rf Frequency. Use Center frequency of the bandwidth(being used in demo) for calibration */
     calRfFreq = (gSysContext.profileTimeCfg.w_ChirpRfFreqStart) + \
-                ((((CLI_CHIRP_SLOPE * 256.0)/300) * (gSysContext.profileComCfg.h_ChirpRampEndTime * 0.1)) / 2);
+                ((((gSysContext.sensorCfg.chirpRfFreqSlope * 256.0)/300) * (gSysContext.profileComCfg.h_ChirpRampEndTime * 0.1)) / 2);
     factoryCalCfg.fecRFFactoryCalCmd.xh_CalRfSlope = 0x4Du; /* 2.2Mhz per uSec*/
 
 
@@ -126,7 +126,7 @@ int32_t restoreFactoryCal(void)
     factoryCalCfg.isATECalibEfused  = true;
 
     /* Read flash memory */
-    retVal = Flash_read(gFlashHandle[0], CLI_FACCALCFG_FLASH_OFFSET, (uint8_t *) &calibData, sizeof(Mmw_calibData));
+    retVal = Flash_read(gFlashHandle[0], gSysContext.sensorCfg.flashOffset, (uint8_t *) &calibData, sizeof(Mmw_calibData));
     CacheP_wb((uint8_t *) &calibData, sizeof(Mmw_calibData), CacheP_TYPE_ALL);
 
     if(retVal == SystemP_FAILURE)
@@ -0,0 +1,106 @@
+/**
+ * @file fixed_math.c
+ * @brief Fixed point math shared by the processing stages (see fixed_math.h).
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <math.h>
+
+#include "fixed_math.h"
+
+/*! @brief Number of CORDIC iterations of FixedMath_atan2Q15() */
+#define FIXED_MATH_CORDIC_ITERATIONS    (20U)
+
+/*! @brief atan(2^-i) / pi in Q30 */
+static const int32_t gFixedMathAtanTable[FIXED_MATH_CORDIC_ITERATIONS] = {
+    268435456, 158466703, 83729454, 42502378, 21333666, 10677233, 5339919, 2670123, 1335082, 667543,
+    333772, 166886, 83443, 41722, 20861, 10430, 5215, 2608, 1304, 652
+};
+
+uint32_t FixedMath_isqrt(uint64_t x) {
+    uint64_t root = 0U, bit = (uint64_t) 1U << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0U) {
+        if (x >= root + bit) {
+            x    -= root + bit;
+            root  = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t) root;
+}
+
+int16_t FixedMath_atan2Q15(int64_t y, int64_t x) {
+    int32_t  xi, yi, xn, angle = 0;
+    uint32_t i;
+
+    if ((x == 0) && (y == 0)) {
+        return 0;
+    }
+    /* bring the vector into the right half plane, angle in Q30 with pi = 2^30 */
+    if (x < 0) {
+        angle = (y >= 0) ? (1 << 30) : -(1 << 30);
+        x = -x;
+        y = -y;
+    }
+    /* 2^29 leaves room for the CORDIC gain of 1.65 */
+    while ((x > ((int64_t) 1 << 29)) || (y > ((int64_t) 1 << 29)) || (y < -((int64_t) 1 << 29))) {
+        x >>= 1;
+        y >>= 1;
+    }
+    xi = (int32_t) x;
+    yi = (int32_t) y;
+    for (i = 0; i < FIXED_MATH_CORDIC_ITERATIONS; i++) {
+        if (yi > 0) {
+            xn     = xi + (yi >> i);
+            yi     = yi - (xi >> i);
+            angle += gFixedMathAtanTable[i];
+        } else {
+            xn     = xi - (yi >> i);
+            yi     = yi + (xi >> i);
+            angle -= gFixedMathAtanTable[i];
+        }
+        xi = xn;
+    }
+    angle = (angle + (1 << 14)) >> 15;
+    return (int16_t) ((angle > INT16_MAX) ? INT16_MAX : ((angle < INT16_MIN) ? INT16_MIN : angle));
+}
+
+int32_t FixedMath_log2Q8(uint64_t x) {
+    int32_t  intPart = 0;
+    int32_t  frac    = 0;
+    uint64_t m;
+    uint32_t i;
+
+    while ((x >> intPart) > 1U) {
+        intPart++;
+    }
+    /* mantissa in [1, 2) in Q30, then one fractional bit per squaring */
+    m = (intPart >= 30) ? (x >> (intPart - 30)) : (x << (30 - intPart));
+    for (i = 0; i < 8U; i++) {
+        m = (m * m) >> 30;
+        frac <<= 1;
+        if (m >= ((uint64_t) 2U << 30)) {
+            m >>= 1;
+            frac |= 1;
+        }
+    }
+    return intPart * 256 + frac;
+}
+
+void FixedMath_twiddleTable(int16_t *re, int16_t *im, uint32_t size) {
+    uint32_t n;
+
+    for (n = 0; n < size; n++) {
+        double phi = 2.0 * 3.14159265358979323846 * n / size;
+        re[n] = (int16_t) floor(cos(phi) * 32767.0 + 0.5);
+        im[n] = (int16_t) floor(-sin(phi) * 32767.0 + 0.5);
+    }
+}
@@ -0,0 +1,41 @@
+/**
+ * @file frame_packer.c
+ * @brief Assembly of complete UART frames in a contiguous transmit buffer.
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "frame_packer.h"
+
+void FramePacker_init(FramePacker *packer, uint8_t *buf, uint32_t size) {
+    packer->buf  = buf;
+    packer->size = size;
+    packer->len  = 0U;
+}
+
+void *FramePacker_reserve(FramePacker *packer, uint32_t numBytes) {
+    void *block;
+
+    if (numBytes > (packer->size - packer->len)) {
+        return NULL;
+    }
+
+    block = &packer->buf[packer->len];
+    packer->len += numBytes;
+    return block;
+}
+
+int32_t FramePacker_append(FramePacker *packer, const void *data, uint32_t numBytes) {
+    void *block = FramePacker_reserve(packer, numBytes);
+
+    if (block == NULL) {
+        return FRAME_PACKER_EOVERFLOW;
+    }
+
+    memcpy(block, data, numBytes);
+    return FRAME_PACKER_SUCCESS;
+}
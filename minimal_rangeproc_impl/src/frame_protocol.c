@@ -0,0 +1,104 @@
+/**
+ * @file frame_protocol.c
+ * @brief Versioned binary frame format of the UART output.
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "frame_packer.h"
+#include "frame_protocol.h"
+
+/*! @brief CRC-32 lookup table, one entry per nibble (keeps the table at 64 bytes) */
+static const uint32_t gCrc32NibbleTable[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+uint32_t FrameProto_crc32(uint32_t crc, const void *data, uint32_t numBytes) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint32_t i;
+
+    crc = ~crc;
+    for (i = 0; i < numBytes; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ gCrc32NibbleTable[crc & 0xFU];
+        crc = (crc >> 4) ^ gCrc32NibbleTable[crc & 0xFU];
+    }
+    return ~crc;
+}
+
+uint8_t FrameProto_headerCheck(const FrameProto_Header *header) {
+    return (uint8_t) FrameProto_crc32(0U, header, (uint32_t) offsetof(FrameProto_Header, headerCheck));
+}
+
+int32_t FrameProto_begin(FramePacker *packer, const FrameProto_Header *header) {
+    FrameProto_Header *frameHeader;
+
+    frameHeader = (FrameProto_Header *) FramePacker_reserve(packer, sizeof(FrameProto_Header));
+    if (frameHeader == NULL) {
+        return FRAME_PACKER_EOVERFLOW;
+    }
+
+    *frameHeader = *header;
+    frameHeader->magic[0]  = FRAME_PROTO_MAGIC_0;
+    frameHeader->magic[1]  = FRAME_PROTO_MAGIC_1;
+    frameHeader->magic[2]  = FRAME_PROTO_MAGIC_2;
+    frameHeader->magic[3]  = FRAME_PROTO_MAGIC_3;
+    frameHeader->version   = FRAME_PROTO_VERSION;
+    frameHeader->headerLen = sizeof(FrameProto_Header);
+    frameHeader->totalLen  = 0U;
+    frameHeader->numTlvs   = 0U;
+    frameHeader->headerCheck = 0U;
+
+    return FRAME_PACKER_SUCCESS;
+}
+
+void *FrameProto_addTlv(FramePacker *packer, uint32_t type, uint32_t length) {
+    FrameProto_Header    *frameHeader = (FrameProto_Header *) packer->buf;
+    FrameProto_TlvHeader *tlvHeader;
+    uint32_t              paddedLength;
+    uint8_t              *payload;
+
+    paddedLength = (length + FRAME_PROTO_TLV_ALIGN - 1U) & ~(FRAME_PROTO_TLV_ALIGN - 1U);
+
+    tlvHeader = (FrameProto_TlvHeader *) FramePacker_reserve(packer, sizeof(FrameProto_TlvHeader) + paddedLength);
+    if (tlvHeader == NULL) {
+        return NULL;
+    }
+
+    tlvHeader->type   = type;
+    tlvHeader->length = length;
+    frameHeader->numTlvs++;
+
+    payload = (uint8_t *) (tlvHeader + 1);
+    memset(&payload[length], 0, paddedLength - length);
+    return payload;
+}
+
+uint32_t FrameProto_end(FramePacker *packer) {
+    FrameProto_Header *frameHeader = (FrameProto_Header *) packer->buf;
+    uint32_t           crc;
+    uint8_t           *crcField;
+
+    crcField = (uint8_t *) FramePacker_reserve(packer, FRAME_PROTO_CRC_SIZE);
+    if (crcField == NULL) {
+        return 0U;
+    }
+
+    frameHeader->totalLen    = packer->len;
+    frameHeader->headerCheck = FrameProto_headerCheck(frameHeader);
+
+    crc = FrameProto_crc32(0U, packer->buf, packer->len - FRAME_PROTO_CRC_SIZE);
+    crcField[0] = (uint8_t) (crc);
+    crcField[1] = (uint8_t) (crc >> 8);
+    crcField[2] = (uint8_t) (crc >> 16);
+    crcField[3] = (uint8_t) (crc >> 24);
+
+    return packer->len;
+}
@@ -9,7 +9,8 @@
  *
  * The application performs the following key steps:
  * 1. Initializes the hardware and drivers.
- * 2. Configures the radar sensor and performs factory calibration.
+ * 2. Configures the radar sensor (from defines.h or .cfg commands received over
+ *    the UART, see cli.h) and performs factory calibration.
  * 3. Initializes the DPUs for range processing.
  * 4. Creates FreeRTOS tasks for radar processing (DPC) and UART communication.
  * 5. Starts the radar sensor and enters the FreeRTOS scheduler.
@@ -73,6 +74,8 @@
 #include "mmwave_basic.h"
 #include "mmwave_control_config.h"
 #include "factory_cal.h"
+#include "proc_config.h"
+#include "cli.h"
 
 
 // --- FRERTOS
@@ -82,9 +85,11 @@
 #define MAIN_TASK_SIZE (16384U/sizeof(configSTACK_DEPTH_TYPE))
 #define DPC_TASK_STACK_SIZE 8192
 #define UART_TASK_STACK_SIZE 2048
+#define CLI_TASK_STACK_SIZE 2048
 
 #define DPC_TASK_PRI 5
 #define UART_TASK_PRI 10
+#define CLI_TASK_PRI 2
 
 
 SystemContext_t gSysContext;
@@ -100,6 +105,12 @@ StackType_t  gDpcTaskStack[DPC_TASK_STACK_SIZE] __attribute__((aligned(32)));
 StaticTask_t gUartTaskObj;
 TaskHandle_t gUartTask;
 StackType_t  gUartTaskStack[UART_TASK_STACK_SIZE] __attribute__((aligned(32)));
+// ---
+#if APP_CLI_ENABLE
+StaticTask_t gCliTaskObj;
+TaskHandle_t gCliTask;
+StackType_t  gCliTaskStack[CLI_TASK_STACK_SIZE] __attribute__((aligned(32)));
+#endif
 
 // Semaphores
 SemaphoreP_Object pend_main_sem;
@@ -141,6 +152,21 @@ void freertos_main(void *args) {
     // initialize memory segments from memory pools
     mempool_init();
 
+    // sensor configuration of defines.h, replaced by the CLI or at run time by rangeProc_reconfigure()
+    Mmwave_populateDefaultSensorCfg(&gSysContext.sensorCfg);
+
+#if APP_CLI_ENABLE
+    cli_init();
+    gCliTask = xTaskCreateStatic(cliTask,      /* Pointer to the function that implements the task. */
+                                 "cli_task",      /* Text name for the task.  This is to facilitate debugging only. */
+                                 CLI_TASK_STACK_SIZE,   /* Stack depth in units of StackType_t typically uint32_t on 32b CPUs */
+                                 NULL,                  /* We are not using the task parameter. */
+                                 CLI_TASK_PRI,          /* task priority, 0 is lowest priority, configMAX_PRIORITIES-1 is highest */
+                                 gCliTaskStack,      /* pointer to stack base */
+                                 &gCliTaskObj);         /* pointer to statically allocated task object memory */
+    configASSERT(gCliTask != NULL);
+#endif
+
     // TODO: initialize default antenna geometry
     
     if (mmwave_initSensor() == SystemP_FAILURE) {
@@ -156,17 +182,6 @@ void freertos_main(void *args) {
     // TODO: init rest of DPUs as required
     DebugP_log("init passed");
 
-    MMWave_populateChannelCfg();
-
-    /* FECSS RF Power ON (turns on antennas) */
-    int32_t retVal;
-    retVal = rl_fecssRfPwrOnOff(M_DFP_DEVICE_INDEX_0, &gSysContext.channelCfg);
-    if (retVal != M_DFP_RET_CODE_OK) {
-        DebugP_log("Error: FECSS RF Power ON/OFF failed\r\n");
-        retVal = SystemP_FAILURE;
-        exit(1);
-    }
-
     /* Check if the device is RF-Trimmed */
     /* Checking one Trim is enough */
     if(SOC_rcmReadSynthTrimValid() != 1U) { // 1 is valid
@@ -175,20 +190,14 @@ void freertos_main(void *args) {
     }
 
     /*** CONFIG ***/
-    // TODO: factory calibration (mmwDemo_factoryCal()) 
-    if(mmwave_openSensor() == SystemP_FAILURE){
-        exit(1);
-    }
-    if(mmwave_configSensor() == SystemP_FAILURE){
-        exit(1);
-    }
+#if APP_CLI_ENABLE
+    /* .cfg commands received until now replace the defaults */
+    cli_waitForStart(APP_CLI_START_TIMEOUT_MS);
+#endif
 
-    // /* Perform factory Calibrations. */
-    retVal = restoreFactoryCal();
-    if(retVal != SystemP_SUCCESS)
-    {
-        DebugP_log("Error: mmWave factory calibration failed\r\n");
-        retVal = SystemP_FAILURE;
+    /* channel configuration, RF power on, open, config and factory calibration from gSysContext.sensorCfg */
+    if (mmwave_setupSensor() == SystemP_FAILURE) {
+        exit(1);
     }
 
     gDpcTask = xTaskCreateStatic(dpcTask, /* Pointer to the function that implements the task. */
@@ -214,6 +223,9 @@ void freertos_main(void *args) {
     if (mmwave_startSensor() == SystemP_FAILURE){
         exit(1);
     }
+#if APP_CLI_ENABLE
+    cli_sensorRunning();
+#endif
     
         /* Never return for this task. */
     SemaphoreP_pend(&pend_main_sem, SystemP_WAIT_FOREVER);
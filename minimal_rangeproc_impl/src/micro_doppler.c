@@ -0,0 +1,170 @@
+/**
+ * @file micro_doppler.c
+ * @brief Micro-Doppler stage: spectrogram and features of one range gate (see micro_doppler.h).
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c), so
+ * this file is shared between the firmware and the host tools in `host/`.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "fixed_math.h"
+#include "micro_doppler.h"
+
+/*! @brief 10 * log10(2) in Q12 */
+#define MICRO_DOPPLER_DB_PER_LOG2_Q12   (12330)
+
+int32_t MicroDoppler_init(MicroDoppler_Obj *obj, const MicroDoppler_Config *cfg) {
+    uint32_t n;
+
+    memset(obj, 0, sizeof(MicroDoppler_Obj));
+    if ((cfg->numDopplerChirps == 0U) || (cfg->numDopplerChirps > MICRO_DOPPLER_MAX_CHIRPS) ||
+        (cfg->fftSize < cfg->numDopplerChirps) || (cfg->fftSize < 2U) || (cfg->fftSize > MICRO_DOPPLER_MAX_FFT_SIZE) ||
+        ((cfg->fftSize & (cfg->fftSize - 1U)) != 0U) || (cfg->numVirtualAntennas == 0U) || (cfg->gateLen == 0U) ||
+        (cfg->gateLen > cfg->numRangeBins) || (cfg->windowLen == 0U) ||
+        (cfg->windowLen > MICRO_DOPPLER_MAX_WINDOW_LEN)) {
+        return MICRO_DOPPLER_EINVAL;
+    }
+    obj->cfg = *cfg;
+
+    /* Hann window of numDopplerChirps + 2 points without the zero end points */
+    for (n = 0; n < cfg->numDopplerChirps; n++) {
+        double w = 0.5 - 0.5 * cos(2.0 * 3.14159265358979323846 * (n + 1U) / (cfg->numDopplerChirps + 1U));
+        obj->window[n] = (int16_t) floor(w * 32767.0 + 0.5);
+    }
+    FixedMath_twiddleTable(obj->twiddleRe, obj->twiddleIm, cfg->fftSize);
+    return MICRO_DOPPLER_SUCCESS;
+}
+
+static int16_t MicroDoppler_sat16(int64_t v) {
+    return (int16_t) ((v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v));
+}
+
+/* power in dB, Q8 (0 for no power) */
+static int32_t MicroDoppler_dbQ8(uint64_t power) {
+    return (power == 0U) ? 0 : (int32_t) (((int64_t) FixedMath_log2Q8(power) * MICRO_DOPPLER_DB_PER_LOG2_Q12) >> 12);
+}
+
+/* spectrum of the gate into obj->power, centered */
+static void MicroDoppler_spectrum(MicroDoppler_Obj *obj, const RadarCube_View *cube, uint32_t firstBin) {
+    const MicroDoppler_Config *cfg  = &obj->cfg;
+    const uint32_t             half = cfg->fftSize / 2U;
+    int32_t                    xRe[MICRO_DOPPLER_MAX_CHIRPS], xIm[MICRO_DOPPLER_MAX_CHIRPS];
+    uint32_t                   bin, ant, c, k, idx;
+
+    memset(obj->power, 0, sizeof(obj->power));
+    for (bin = firstBin; bin < firstBin + cfg->gateLen; bin++) {
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            for (c = 0; c < cfg->numDopplerChirps; c++) {
+                const cmplx16ImRe_t *s = RadarCube_at(cube, c, ant, bin);
+
+                xRe[c] = ((int32_t) s->real * obj->window[c] + (1 << 14)) >> 15;
+                xIm[c] = ((int32_t) s->imag * obj->window[c] + (1 << 14)) >> 15;
+            }
+            for (k = 0; k < cfg->fftSize; k++) {
+                int64_t accRe = 0, accIm = 0;
+                int64_t re, im;
+
+                for (c = 0; c < cfg->numDopplerChirps; c++) {
+                    idx    = (k * c) & (cfg->fftSize - 1U);
+                    accRe += (int64_t) xRe[c] * obj->twiddleRe[idx] - (int64_t) xIm[c] * obj->twiddleIm[idx];
+                    accIm += (int64_t) xRe[c] * obj->twiddleIm[idx] + (int64_t) xIm[c] * obj->twiddleRe[idx];
+                }
+                re = (accRe + (1 << 14)) >> 15;
+                im = (accIm + (1 << 14)) >> 15;
+                obj->power[(k + half) & (cfg->fftSize - 1U)] += (uint64_t) (re * re) + (uint64_t) (im * im);
+            }
+        }
+    }
+}
+
+int32_t MicroDoppler_process(MicroDoppler_Obj *obj, const RadarCube_View *cube, uint32_t rangeBin,
+                             MicroDoppler_Features *features) {
+    const MicroDoppler_Config *cfg  = &obj->cfg;
+    const int32_t              half = (int32_t) (cfg->fftSize / 2U);
+    uint8_t                   *column;
+    uint64_t                   total = 0U, peak = 0U, scaled, sumW = 0U;
+    int64_t                    sumKW = 0, sumC = 0;
+    uint64_t                   sumVarW = 0U, sumVarC = 0U;
+    int32_t                    db, peakDb, centroid = 0, low = -1, high = -1;
+    uint32_t                   firstBin, shift = 0U, k, i;
+
+    if ((cube->numChirps != cfg->numDopplerChirps) || (cube->numAntennas != cfg->numVirtualAntennas) ||
+        (cube->numRangeBins != cfg->numRangeBins)) {
+        return MICRO_DOPPLER_EINVAL;
+    }
+
+    firstBin = (rangeBin > cfg->gateLen / 2U) ? (rangeBin - cfg->gateLen / 2U) : 0U;
+    firstBin = (firstBin + cfg->gateLen > cfg->numRangeBins) ? (cfg->numRangeBins - cfg->gateLen) : firstBin;
+    MicroDoppler_spectrum(obj, cube, firstBin);
+
+    /* spectrogram column in 0.5 dB steps */
+    column = &obj->spectrogram[obj->head * cfg->fftSize];
+    for (k = 0; k < cfg->fftSize; k++) {
+        db        = MicroDoppler_dbQ8(obj->power[k]) / 128;
+        column[k] = (uint8_t) ((db > 255) ? 255 : ((db < 0) ? 0 : db));
+        total    += obj->power[k];
+        peak      = (obj->power[k] > peak) ? obj->power[k] : peak;
+    }
+
+    memset(features, 0, sizeof(MicroDoppler_Features));
+    features->rangeBin = (uint16_t) (firstBin + cfg->gateLen / 2U);
+    if (total > 0U) {
+        /* weights below 2^32, so the weighted sums of squared Q8 bins stay below 2^63 */
+        while ((total >> shift) >= ((uint64_t) 1U << 32)) {
+            shift++;
+        }
+        for (k = 0; k < cfg->fftSize; k++) {
+            scaled = obj->power[k] >> shift;
+            sumW  += scaled;
+            sumKW += ((int64_t) k - half) * 256 * (int64_t) scaled;
+        }
+        if (sumW > 0U) {
+            centroid = (int32_t) (sumKW / (int64_t) sumW);
+            for (k = 0; k < cfg->fftSize; k++) {
+                int64_t d = ((int64_t) k - half) * 256 - centroid;
+                sumVarW += (uint64_t) (d * d) * (obj->power[k] >> shift);
+            }
+            features->bandwidthQ8 = (uint16_t) FixedMath_isqrt(sumVarW / sumW);
+        }
+
+        /* envelope: outermost bins within envelopeDb of the peak */
+        peakDb = MicroDoppler_dbQ8(peak);
+        for (k = 0; k < cfg->fftSize; k++) {
+            if ((obj->power[k] > 0U) && (MicroDoppler_dbQ8(obj->power[k]) >= peakDb - (int32_t) cfg->envelopeDb * 256)) {
+                low  = (low < 0) ? (int32_t) k : low;
+                high = (int32_t) k;
+            }
+        }
+        features->envelopeLowQ8  = MicroDoppler_sat16((int64_t) (low - half) * 256);
+        features->envelopeHighQ8 = MicroDoppler_sat16((int64_t) (high - half) * 256);
+        features->energyDbQ8     = MicroDoppler_sat16(MicroDoppler_dbQ8(total));
+    }
+    features->centroidQ8 = MicroDoppler_sat16(centroid);
+
+    /* window: mean and spread of the centroids */
+    obj->centroids[obj->head] = features->centroidQ8;
+    obj->head      = (obj->head + 1U) % cfg->windowLen;
+    obj->numFrames = (obj->numFrames < cfg->windowLen) ? (obj->numFrames + 1U) : cfg->windowLen;
+    for (i = 0; i < obj->numFrames; i++) {
+        sumC += obj->centroids[i];
+    }
+    sumC /= (int64_t) obj->numFrames;
+    for (i = 0; i < obj->numFrames; i++) {
+        int64_t d = obj->centroids[i] - sumC;
+        sumVarC += (uint64_t) (d * d);
+    }
+    features->numFrames        = (uint16_t) obj->numFrames;
+    features->meanCentroidQ8   = MicroDoppler_sat16(sumC);
+    features->centroidSpreadQ8 = (uint16_t) FixedMath_isqrt(sumVarC / obj->numFrames);
+    return MICRO_DOPPLER_SUCCESS;
+}
+
+const uint8_t *MicroDoppler_latestColumn(const MicroDoppler_Obj *obj) {
+    if (obj->numFrames == 0U) {
+        return NULL;
+    }
+    return &obj->spectrogram[((obj->head + obj->cfg.windowLen - 1U) % obj->cfg.windowLen) * obj->cfg.fftSize];
+}
@@ -50,12 +50,16 @@
 #include "ti_drivers_open_close.h"
 #include "ti_board_open_close.h"
 #include <control/mmwave/mmwave.h>
+#include <mmwavelink/mmwavelink.h>
+#include <mmwavelink/include/rl_device.h>
 #include <string.h>
 
 #include "system.h"
 #include "defines.h"
 #include "mem_pool.h"
 #include "mmwave_basic.h"
+#include "mmwave_control_config.h"
+#include "factory_cal.h"
 
 
 
@@ -179,6 +183,32 @@ int32_t mmwave_configSensor(void) {
 }
 
 
+int32_t mmwave_setupSensor(void) {
+    int32_t retVal;
+
+    MMWave_populateChannelCfg();
+
+    /* FECSS RF Power ON (turns on antennas) */
+    retVal = rl_fecssRfPwrOnOff(M_DFP_DEVICE_INDEX_0, &gSysContext.channelCfg);
+    if (retVal != M_DFP_RET_CODE_OK) {
+        DebugP_log("Error: FECSS RF Power ON/OFF failed\r\n");
+        return SystemP_FAILURE;
+    }
+
+    if (mmwave_openSensor() == SystemP_FAILURE) {
+        return SystemP_FAILURE;
+    }
+    if (mmwave_configSensor() == SystemP_FAILURE) {
+        return SystemP_FAILURE;
+    }
+
+    /* Perform factory Calibrations. */
+    if (restoreFactoryCal() != SystemP_SUCCESS) {
+        DebugP_log("Error: mmWave factory calibration failed\r\n");
+    }
+    return SystemP_SUCCESS;
+}
+
 int32_t mmwave_startSensor(void) {
     MMWave_CalibrationCfg   calibrationCfg;
     int32_t                 retVal = SystemP_SUCCESS;
@@ -214,7 +244,7 @@ int32_t mmwave_startSensor(void) {
     return retVal;
 }
 
-int32_t mmwave_stop_close_deinit(void) {
+int32_t mmwave_stopSensor(void) {
     int32_t                 errCode;
     int32_t                 retVal = SystemP_SUCCESS;
 
@@ -229,6 +259,33 @@ int32_t mmwave_stop_close_deinit(void) {
         retVal = SystemP_FAILURE;
     }
 
+    return retVal;
+}
+
+int32_t mmwave_reconfigSensor(void) {
+    int32_t                 errCode;
+
+    /* mmwave_configSensor() adds a new profile and chirp, the ones of the previous configuration go first */
+    if (MMWave_delProfile(gSysContext.gCtrlHandle, gSysContext.mmwCtrlCfg.frameCfg[0].profileHandle[0], &errCode) < 0) {
+        MMWave_ErrorLevel   errorLevel;
+        int16_t             mmWaveErrorCode;
+        int16_t             subsysErrorCode;
+
+        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
+        DebugP_log("Error: mmWave delete profile failed [Error code: %d Subsystem: %d]\n",
+                        mmWaveErrorCode, subsysErrorCode);
+        return SystemP_FAILURE;
+    }
+
+    return mmwave_configSensor();
+}
+
+int32_t mmwave_stop_close_deinit(void) {
+    int32_t                 errCode;
+    int32_t                 retVal;
+
+    retVal = mmwave_stopSensor();
+
     if (MMWave_close(gSysContext.gCtrlHandle,&errCode) < 0) {
         MMWave_ErrorLevel   errorLevel;
         int16_t             mmWaveErrorCode;
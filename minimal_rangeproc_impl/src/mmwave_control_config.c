@@ -75,8 +75,58 @@ T_SensPerChirpLut* sensPerChirpLuTable = (T_SensPerChirpLut*)(0x21880000U);
 /**
  *  @b Description
  *  @n
- *      Utility function which populates the profile configuration with
- *      well defined defaults.
+ *      Fills the sensor configuration with the values of defines.h, in the
+ *      units of the .cfg file.
+ *
+ *  @param[out]  cfg
+ *      Pointer to the sensor configuration
+ *
+ *  @retval
+ *      Not applicable
+ */
+void Mmwave_populateDefaultSensorCfg (SensorConfig* cfg) {
+    memset ((void*)cfg, 0, sizeof(SensorConfig));
+
+    cfg->rxChCtrlBitMask        = CLI_CHA_CFG_RX_BITMASK;
+    cfg->txChCtrlBitMask        = CLI_CHA_CFG_TX_BITMASK;
+    cfg->miscCtrl               = CLI_CHA_CFG_MISC_CTRL;
+
+    cfg->digOutputSampRate      = CLI_DIG_OUT_SAMPLING_RATE;
+    cfg->digOutputBitsSel       = CLI_DIG_OUT_BITS_SEL;
+    cfg->dfeFirSel              = CLI_DFE_FIR_SEL;
+    cfg->numOfAdcSamples        = CLI_NUM_ADC_SAMPLES;
+    cfg->chirpTxMimoPatSel      = CLI_MIMO_SEL;
+    cfg->chirpRampEndTime       = CLI_CHIRP_RAMP_END_TIME / 10.0;
+    cfg->chirpRxHpfSel          = CLI_CHIRP_RX_HPF_SEL;
+
+    cfg->chirpIdleTime          = CLI_CHIRP_IDLE_TIME / 10.0;
+    cfg->chirpAdcSkipSamples    = CLI_CHIRP_ADC_START_TIME >> 10;
+    cfg->chirpTxStartTime       = CLI_CHIRP_TX_START_TIME / 50.0;
+    cfg->chirpRfFreqSlope       = CLI_CHIRP_SLOPE;
+    cfg->chirpRfFreqStart       = CLI_START_FREQ;
+
+    cfg->numOfChirpsInBurst     = CLI_NUM_CHIRPS_PER_BURST;
+    cfg->numOfChirpsAccum       = CLI_NUM_CHIRPS_ACCUM;
+    cfg->burstPeriodicity       = CLI_BURST_PERIOD;
+    cfg->numOfBurstsInFrame     = CLI_NUM_BURSTS_PER_FRAME;
+    cfg->framePeriodicity       = CLI_FRAME_PERIOD / 40000.0;
+    cfg->numOfFrames            = CLI_NUM_FRAMES;
+
+    cfg->rxGain                 = CLI_FACCALCFG_RX_GAIN;
+    cfg->txBackoff              = (CLI_FACCALCFG_TX_BACKOFF_SEL) / 2;
+    cfg->flashOffset            = CLI_FACCALCFG_FLASH_OFFSET;
+
+    cfg->frameTrigMode          = CLI_SENSOR_START_FRM_TRIG;
+    cfg->chirpStartSigLbEn      = CLI_SENSOR_START_LB_EN;
+    cfg->frameLivMonEn          = CLI_SENSOR_START_MON_EN;
+    cfg->frameTrigTimerVal      = CLI_SENSOR_START_TRIG_TIMER;
+}
+
+/**
+ *  @b Description
+ *  @n
+ *      Utility function which populates the profile configuration from the
+ *      sensor configuration gSysContext.sensorCfg.
  *
  *  @param[out]  ptrProfileCfg
  *      Pointer to the populated profile configuration
@@ -85,36 +135,36 @@ T_SensPerChirpLut* sensPerChirpLuTable = (T_SensPerChirpLut*)(0x21880000U);
  *      Not applicable
  */
 static void Mmwave_populateDefaultProfileCfg (T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg) {
+    const SensorConfig *cfg = &gSysContext.sensorCfg;
     float rfBandwidth;
     float rampDownTime;
     float scale = 65536./(3*100*100);
 
-    /* Populate the *default* profile configuration: */
-    gSysContext.profileComCfg.c_DigOutputSampRate           = CLI_DIG_OUT_SAMPLING_RATE;
-    gSysContext.profileComCfg.c_DigOutputBitsSel            = CLI_DIG_OUT_BITS_SEL;
-    gSysContext.profileComCfg.c_DfeFirSel                   = CLI_DFE_FIR_SEL;
-    gSysContext.profileComCfg.h_NumOfAdcSamples             = CLI_NUM_ADC_SAMPLES;
-    gSysContext.profileComCfg.c_ChirpTxMimoPatSel           = CLI_MIMO_SEL;
+    /* Populate the profile configuration (units of the front end firmware, as the CLI_* values of defines.h): */
+    gSysContext.profileComCfg.c_DigOutputSampRate           = cfg->digOutputSampRate;
+    gSysContext.profileComCfg.c_DigOutputBitsSel            = cfg->digOutputBitsSel;
+    gSysContext.profileComCfg.c_DfeFirSel                   = cfg->dfeFirSel;
+    gSysContext.profileComCfg.h_NumOfAdcSamples             = cfg->numOfAdcSamples;
+    gSysContext.profileComCfg.c_ChirpTxMimoPatSel           = cfg->chirpTxMimoPatSel;
     gSysContext.profileComCfg.c_MiscSettings                = CLI_C_MISC_SETTINGS;
     gSysContext.profileComCfg.c_HpfFastInitDuration         = CLI_HPF_FAST_INIT_DURATION;
-    gSysContext.profileComCfg.h_ChirpRampEndTime            = CLI_CHIRP_RAMP_END_TIME;
-    gSysContext.profileComCfg.c_ChirpRxHpfSel               = CLI_CHIRP_RX_HPF_SEL;
-
-    /* Populate the *default* timing configuration: */
-    gSysContext.profileTimeCfg.h_ChirpIdleTime              = CLI_CHIRP_IDLE_TIME;
-    gSysContext.profileTimeCfg.h_ChirpAdcStartTime          = CLI_CHIRP_ADC_START_TIME;
-    gSysContext.profileTimeCfg.xh_ChirpTxStartTime          = CLI_CHIRP_TX_START_TIME;
-    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope          = CLI_CHIRP_SLOPE;
+    gSysContext.profileComCfg.h_ChirpRampEndTime            = (uint16_t) (10.0 * cfg->chirpRampEndTime + 0.5);
+    gSysContext.profileComCfg.c_ChirpRxHpfSel               = cfg->chirpRxHpfSel;
+
+    /* Populate the timing configuration: */
+    gSysContext.profileTimeCfg.h_ChirpIdleTime              = (uint16_t) (10.0 * cfg->chirpIdleTime + 0.5);
+    gSysContext.profileTimeCfg.h_ChirpAdcStartTime          = (uint16_t) (cfg->chirpAdcSkipSamples << 10);
+    gSysContext.profileTimeCfg.xh_ChirpTxStartTime          = (int16_t) lround(50.0 * cfg->chirpTxStartTime);
     /* Front End Firmware expects Start freq (MHz) as 1 LSB = (3 x APLL_FREQ / 2^16) * 2^6 resolution  */
-    gSysContext.profileTimeCfg.w_ChirpRfFreqStart           = CLI_CHIRP_START_FREQ;
-    gSysContext.profileTimeCfg.h_ChirpTxEnSel               = CLI_CHA_CFG_TX_BITMASK;
+    gSysContext.profileTimeCfg.w_ChirpRfFreqStart           = (uint32_t) ((cfg->chirpRfFreqStart * 1000.0 * 256.0) / 300);
+    gSysContext.profileTimeCfg.h_ChirpTxEnSel               = cfg->txChCtrlBitMask;
     gSysContext.profileTimeCfg.h_ChirpTxBpmEnSel            = 0x0U; // MIMO BPM enable (hardcoded to 0 in demo project);
 
-    rfBandwidth = (gSysContext.profileComCfg.h_ChirpRampEndTime*0.1) * CLI_CHIRP_SLOPE; //In MHz/usec
+    rfBandwidth = (gSysContext.profileComCfg.h_ChirpRampEndTime*0.1) * cfg->chirpRfFreqSlope; //In MHz/usec
     rampDownTime = MIN((gSysContext.profileTimeCfg.h_ChirpIdleTime*0.1-1.0), 6.0); //In usec
     gSysContext.profileComCfg.h_CrdNSlopeMag = (uint16_t) fabs((scale * rfBandwidth / rampDownTime + 0.5));
 
-    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope  = CLI_CHIRP_FREQ_SLOPE;
+    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope  = (int16_t) ((cfg->chirpRfFreqSlope * 1048576.0) / (3 * 100 * 100));
 
 
     /* Initialize the profile configuration: */
@@ -232,7 +282,7 @@ void Mmwave_populateDefaultOpenCfg (MMWave_OpenCfg* ptrOpenCfg) {
     ptrOpenCfg->ptrfecTxclpcCalCmd = &gSysContext.fecTxclpcCalCmd;
     ptrOpenCfg->customCalibrationEnableMask = 0U;
     ptrOpenCfg->fecRDIFCtrlCmd.c_RdifEnable = M_RL_FECSS_RDIF_DIS;
-    ptrOpenCfg->fecRDIFCtrlCmd.h_RdifSampleCount = CLI_NUM_ADC_SAMPLES; //profileComCfg.h_NumOfAdcSamples;
+    ptrOpenCfg->fecRDIFCtrlCmd.h_RdifSampleCount = gSysContext.sensorCfg.numOfAdcSamples; //profileComCfg.h_NumOfAdcSamples;
 }
 
 static void Mmwave_EnChannelSetOffset(
@@ -320,14 +370,14 @@ static void Mmwave_ADCBufConfig
 }
 
 /**
-  *  @brief  Populates the channel configuration structure
+  *  @brief  Populates the channel configuration structure from the sensor configuration gSysContext.sensorCfg
   *  
   *  @return None
 */
 void MMWave_populateChannelCfg() {
-    gSysContext.channelCfg.h_TxChCtrlBitMask  = CLI_CHA_CFG_TX_BITMASK;
-    gSysContext.channelCfg.h_RxChCtrlBitMask  = CLI_CHA_CFG_RX_BITMASK;
-    gSysContext.channelCfg.c_MiscCtrl         = CLI_CHA_CFG_MISC_CTRL;
+    gSysContext.channelCfg.h_TxChCtrlBitMask  = gSysContext.sensorCfg.txChCtrlBitMask;
+    gSysContext.channelCfg.h_RxChCtrlBitMask  = gSysContext.sensorCfg.rxChCtrlBitMask;
+    gSysContext.channelCfg.c_MiscCtrl         = gSysContext.sensorCfg.miscCtrl;
 
     // calculate number RX and TX antennas from bitmask
     gSysContext.numTxAntennas = 0;
@@ -374,13 +424,13 @@ void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg) {
     /* Initialize the control configuration: */
     memset ((void*)ptrCtrlCfg, 0, sizeof(MMWave_CtrlCfg));
 
-    /* Populate the frame configuration: */
-    gSysContext.frameCfg.h_NumOfChirpsInBurst      = CLI_NUM_CHIRPS_PER_BURST;
-    gSysContext.frameCfg.c_NumOfChirpsAccum        = CLI_NUM_CHIRPS_ACCUM;
-    gSysContext.frameCfg.w_BurstPeriodicity        = CLI_W_BURST_PERIOD; 
-    gSysContext.frameCfg.h_NumOfBurstsInFrame      = CLI_NUM_BURSTS_PER_FRAME;
-    gSysContext.frameCfg.w_FramePeriodicity        = CLI_FRAME_PERIOD;
-    gSysContext.frameCfg.h_NumOfFrames             = CLI_NUM_FRAMES;
+    /* Populate the frame configuration (burst period in 100 ns, frame period in 40 MHz ticks): */
+    gSysContext.frameCfg.h_NumOfChirpsInBurst      = gSysContext.sensorCfg.numOfChirpsInBurst;
+    gSysContext.frameCfg.c_NumOfChirpsAccum        = gSysContext.sensorCfg.numOfChirpsAccum;
+    gSysContext.frameCfg.w_BurstPeriodicity        = (uint32_t) (10.0 * gSysContext.sensorCfg.burstPeriodicity + 0.5);
+    gSysContext.frameCfg.h_NumOfBurstsInFrame      = gSysContext.sensorCfg.numOfBurstsInFrame;
+    gSysContext.frameCfg.w_FramePeriodicity        = (uint32_t) ((gSysContext.sensorCfg.framePeriodicity * 40000000.0) / 1000.0 + 0.5);
+    gSysContext.frameCfg.h_NumOfFrames             = gSysContext.sensorCfg.numOfFrames;
 
     /* Populate the profile configuration: */
     Mmwave_populateDefaultProfileCfg (&profileCfg, &profileTimeCfg);
@@ -457,10 +507,10 @@ void Mmwave_populateDefaultCalibrationCfg (MMWave_CalibrationCfg* ptrCalibration
  */
 void Mmwave_populateDefaultStartCfg (MMWave_StrtCfg* ptrStartCfg) {
     /* Populate the start configuration: */
-    ptrStartCfg->frameTrigMode      = CLI_SENSOR_START_FRM_TRIG;
-    ptrStartCfg->chirpStartSigLbEn  = CLI_SENSOR_START_LB_EN;
-    ptrStartCfg->frameLivMonEn      = CLI_SENSOR_START_MON_EN;
-    ptrStartCfg->frameTrigTimerVal  = CLI_SENSOR_START_TRIG_TIMER;
+    ptrStartCfg->frameTrigMode      = gSysContext.sensorCfg.frameTrigMode;
+    ptrStartCfg->chirpStartSigLbEn  = gSysContext.sensorCfg.chirpStartSigLbEn;
+    ptrStartCfg->frameLivMonEn      = gSysContext.sensorCfg.frameLivMonEn;
+    ptrStartCfg->frameTrigTimerVal  = gSysContext.sensorCfg.frameTrigTimerVal;
 
     return;
 }
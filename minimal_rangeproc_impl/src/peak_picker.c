@@ -0,0 +1,129 @@
+/**
+ * @file peak_picker.c
+ * @brief Top-K peaks of a complex range profile with sub-bin interpolation (see peak_picker.h).
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c), so
+ * this file is shared between the firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fixed_math.h"
+#include "peak_picker.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define PEAK_PICKER_HAVE_DSP 1
+#include <arm_acle.h>
+#endif
+
+/* imag^2 + real^2 of sample k, at most 2^31 (both halves -32768): exact as uint32_t */
+static inline uint32_t PeakPicker_power(const cmplx16ImRe_t *profile, uint32_t k) {
+    uint32_t word;
+
+    memcpy(&word, &profile[k], sizeof(word));
+#ifdef PEAK_PICKER_HAVE_DSP
+    return (uint32_t) __smuad((int16x2_t) word, (int16x2_t) word);
+#else
+    {
+        int32_t lo = (int16_t) (word & 0xFFFFU);
+        int32_t hi = (int16_t) (word >> 16);
+
+        return (uint32_t) lo * (uint32_t) lo + (uint32_t) hi * (uint32_t) hi;
+    }
+#endif
+}
+
+/* log2 of the power in Q8, 0 for no power */
+static inline int32_t PeakPicker_log2Q8(uint32_t power) {
+    return (power == 0U) ? 0 : FixedMath_log2Q8(power);
+}
+
+/* vertex of the parabola through (-1, a), (0, b), (1, c) with b the maximum, Q15 */
+static int32_t PeakPicker_vertexQ15(int32_t a, int32_t b, int32_t c) {
+    int32_t denom = a - 2 * b + c;
+    int32_t offsetQ15;
+
+    if (denom >= 0) {
+        return 0;
+    }
+    offsetQ15 = (int32_t) (((int64_t) (a - c) * 16384) / denom);
+    return (offsetQ15 > 16384) ? 16384 : ((offsetQ15 < -16384) ? -16384 : offsetQ15);
+}
+
+int32_t PeakPicker_checkConfig(const PeakPicker_Config *cfg) {
+    if (((cfg->interp != PEAK_PICKER_INTERP_NONE) && (cfg->interp != PEAK_PICKER_INTERP_PARABOLIC) &&
+         (cfg->interp != PEAK_PICKER_INTERP_GAUSSIAN)) ||
+        (cfg->numRangeBins < 3U) || (cfg->numRangeBins > 0xFFFFU) ||
+        (cfg->maxPeaks == 0U) || (cfg->maxPeaks > PEAK_PICKER_MAX_PEAKS) || (cfg->firstBin >= cfg->numRangeBins)) {
+        return PEAK_PICKER_EINVAL;
+    }
+    return PEAK_PICKER_SUCCESS;
+}
+
+int32_t PeakPicker_process(const PeakPicker_Config *cfg, const cmplx16ImRe_t *profile, PeakPicker_Peak *peaks,
+                           PeakPicker_Result *result) {
+    uint32_t bin[PEAK_PICKER_MAX_PEAKS], power[PEAK_PICKER_MAX_PEAKS];
+    uint32_t numPeaks = 0U, numCandidates = 0U;
+    uint32_t first, prev, cur, next, k, n;
+
+    if (PeakPicker_checkConfig(cfg) != PEAK_PICKER_SUCCESS) {
+        return PEAK_PICKER_EINVAL;
+    }
+
+    /* one pass with the powers of the previous, current and next bin; the strongest maxima sorted by insertion */
+    first = (cfg->firstBin > 1U) ? cfg->firstBin : 1U;
+    prev  = PeakPicker_power(profile, first - 1U);
+    cur   = PeakPicker_power(profile, first);
+    for (k = first; k + 1U < cfg->numRangeBins; k++) {
+        next = PeakPicker_power(profile, k + 1U);
+        if ((cur > prev) && (cur >= next) && (cur >= cfg->minPower)) {
+            numCandidates++;
+            if ((numPeaks < cfg->maxPeaks) || (cur > power[numPeaks - 1U])) {
+                n = (numPeaks < cfg->maxPeaks) ? numPeaks++ : numPeaks - 1U;
+                while ((n > 0U) && (power[n - 1U] < cur)) {
+                    bin[n]   = bin[n - 1U];
+                    power[n] = power[n - 1U];
+                    n--;
+                }
+                bin[n]   = k;
+                power[n] = cur;
+            }
+        }
+        prev = cur;
+        cur  = next;
+    }
+
+    for (n = 0; n < numPeaks; n++) {
+        PeakPicker_Peak     *peak = &peaks[n];
+        const cmplx16ImRe_t *x    = &profile[bin[n]];
+        uint32_t             pPrev = PeakPicker_power(profile, bin[n] - 1U);
+        uint32_t             pNext = PeakPicker_power(profile, bin[n] + 1U);
+        int32_t              lPrev = PeakPicker_log2Q8(pPrev);
+        int32_t              lPeak = PeakPicker_log2Q8(power[n]);
+        int32_t              lNext = PeakPicker_log2Q8(pNext);
+        int32_t              offsetQ15 = 0, log2Q8;
+
+        if (cfg->interp == PEAK_PICKER_INTERP_PARABOLIC) {
+            /* magnitudes in Q8 (below 2^24), weak peaks would otherwise lose most of their curvature to rounding */
+            offsetQ15 = PeakPicker_vertexQ15((int32_t) FixedMath_isqrt((uint64_t) pPrev << 16),
+                                             (int32_t) FixedMath_isqrt((uint64_t) power[n] << 16),
+                                             (int32_t) FixedMath_isqrt((uint64_t) pNext << 16));
+        } else if (cfg->interp == PEAK_PICKER_INTERP_GAUSSIAN) {
+            offsetQ15 = PeakPicker_vertexQ15(lPrev, lPeak, lNext);
+        }
+
+        /* value of the log parabola at the offset: lPeak - (lPrev - lNext) * offset / 4, halved for the magnitude */
+        log2Q8 = (lPeak - (int32_t) (((int64_t) (lPrev - lNext) * offsetQ15) / (4 * 32768))) / 2;
+
+        peak->rangeBin  = (uint16_t) bin[n];
+        peak->offsetQ15 = (int16_t) offsetQ15;
+        peak->log2MagQ8 = (uint16_t) ((log2Q8 < 0) ? 0 : ((log2Q8 > 0xFFFF) ? 0xFFFF : log2Q8));
+        /* scaled up, the CORDIC of FixedMath_atan2Q15() loses precision on small vectors */
+        peak->phaseQ15  = FixedMath_atan2Q15((int64_t) x->imag * 16384, (int64_t) x->real * 16384);
+    }
+
+    result->numPeaks      = numPeaks;
+    result->numCandidates = numCandidates;
+    return PEAK_PICKER_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file range_integration.c
+ * @brief Non-coherent integration of the radar cube into one range profile (see range_integration.h).
+ *
+ * Only depends on the C standard library (and the portable fixed_math.c for
+ * the logarithm), so this file is shared between the firmware and the host tools
+ * in `host/`.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "fixed_math.h"
+#include "range_integration.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define RANGE_INTEGRATION_HAVE_DSP 1
+#include <arm_acle.h>
+#endif
+
+/*! @brief Range bins processed per block, the sums live on the stack */
+#define RANGE_INTEGRATION_BLOCK_LEN     (32U)
+
+/* acc + imag^2 + real^2 of a sample given as one word */
+static inline uint64_t RangeIntegration_addPower(uint64_t acc, uint32_t word) {
+#ifdef RANGE_INTEGRATION_HAVE_DSP
+    return (uint64_t) __smlald((int16x2_t) word, (int16x2_t) word, (int64_t) acc);
+#else
+    int32_t lo = (int16_t) (word & 0xFFFFU);
+    int32_t hi = (int16_t) (word >> 16);
+
+    return acc + (uint64_t) ((int64_t) lo * lo + (int64_t) hi * hi);
+#endif
+}
+
+uint32_t RangeIntegration_outputSize(const RangeIntegration_Config *cfg) {
+    return cfg->numRangeBins * ((cfg->output == RANGE_INTEGRATION_OUTPUT_POWER) ? sizeof(uint32_t) : sizeof(uint16_t));
+}
+
+int32_t RangeIntegration_init(RangeIntegration_Obj *obj, const RangeIntegration_Config *cfg) {
+    memset(obj, 0, sizeof(RangeIntegration_Obj));
+    if (((cfg->output != RANGE_INTEGRATION_OUTPUT_LOG2_MAG) && (cfg->output != RANGE_INTEGRATION_OUTPUT_POWER)) ||
+        (cfg->numChirps == 0U) || (cfg->numAntennas == 0U) || (cfg->numRangeBins == 0U) ||
+        (cfg->numChirps > 0xFFFFU) || (cfg->numAntennas > 0xFFFFU / cfg->numChirps)) {
+        return RANGE_INTEGRATION_EINVAL;
+    }
+    obj->cfg           = *cfg;
+    obj->numIntegrated = cfg->numChirps * cfg->numAntennas;
+    /* a sample has at most 2^31 power, so sum >> ceil(log2(numIntegrated)) stays below 2^32 */
+    while (((uint32_t) 1U << obj->powerShift) < obj->numIntegrated) {
+        obj->powerShift++;
+    }
+    return RANGE_INTEGRATION_SUCCESS;
+}
+
+int32_t RangeIntegration_process(const RangeIntegration_Obj *obj, const RadarCube_View *cube, void *out) {
+    const RangeIntegration_Config *cfg = &obj->cfg;
+    uint64_t                       sum[RANGE_INTEGRATION_BLOCK_LEN];
+    uint32_t                       first, numBins, row, i;
+
+    if ((cube->numChirps != cfg->numChirps) || (cube->numAntennas != cfg->numAntennas) ||
+        (cube->numRangeBins != cfg->numRangeBins)) {
+        return RANGE_INTEGRATION_EINVAL;
+    }
+
+    for (first = 0; first < cfg->numRangeBins; first += numBins) {
+        numBins = cfg->numRangeBins - first;
+        numBins = (numBins > RANGE_INTEGRATION_BLOCK_LEN) ? RANGE_INTEGRATION_BLOCK_LEN : numBins;
+
+        /* every (chirp, antenna) pair is a contiguous range slice, one row after the other */
+        memset(sum, 0, numBins * sizeof(uint64_t));
+        for (row = 0; row < obj->numIntegrated; row++) {
+            const cmplx16ImRe_t *s = cube->data + row * cfg->numRangeBins + first;
+            for (i = 0; i < numBins; i++) {
+                uint32_t word;
+                memcpy(&word, &s[i], sizeof(word));
+                sum[i] = RangeIntegration_addPower(sum[i], word);
+            }
+        }
+
+        if (cfg->output == RANGE_INTEGRATION_OUTPUT_POWER) {
+            uint32_t *power = (uint32_t *) out + first;
+            for (i = 0; i < numBins; i++) {
+                uint64_t p = sum[i] >> obj->powerShift;
+                power[i] = (p > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t) p;
+            }
+        } else {
+            uint16_t *log2Mag = (uint16_t *) out + first;
+            for (i = 0; i < numBins; i++) {
+                log2Mag[i] = (sum[i] == 0U) ? 0U : (uint16_t) (FixedMath_log2Q8(sum[i]) / 2);
+            }
+        }
+    }
+    return RANGE_INTEGRATION_SUCCESS;
+}
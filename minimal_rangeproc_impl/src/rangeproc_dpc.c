@@ -41,10 +41,12 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <math.h>
 #include <kernel/dpl/DebugP.h>
 #include <utils/mathutils/mathutils.h>
 #include "drivers/edma/v0/edma.h"
 #include "kernel/dpl/SemaphoreP.h"
+#include "kernel/dpl/ClockP.h"
 #include "ti_drivers_config.h"
 #include "ti_drivers_open_close.h"
 #include "ti_board_open_close.h"
@@ -53,10 +55,22 @@
 
 #include "system.h"
 #include "defines.h"
+#include "range_window.h"
+#include "proc_config.h"
 #include "dpu_res.h"
 #include "mmwave_basic.h"
 #include "mem_pool.h"
+#include "frame_protocol.h"
 #include "uart_transmit.h"
+#include "doppler_proc.h"
+#include "cube_ring.h"
+#include "clutter_removal.h"
+#include "range_integration.h"
+#include "peak_picker.h"
+#include "cfar.h"
+#include "doa.h"
+#include "micro_doppler.h"
+#include "sensor_config.h"
 #include "rangeproc_dpc.h"
 
 
@@ -72,6 +86,12 @@ uint32_t gChirpCount;
 /*! @brief for debugging: Frame counter for when chirp ISR is registered */
 uint32_t gFrameCount;
 
+/*! @brief Frame reference timer at the latest frame start */
+volatile uint32_t gFrameStartTime;
+
+/*! @brief Range region of interest of the radar cube (APP_RANGE_ROI_*), sent as FRAME_PROTO_TLV_RANGE_ROI */
+FrameProto_RangeRoi gRangeRoi;
+
 /*! @brief for debugging: Pointer to radar cube data for easier debugging access */
 cmplx16ImRe_t * gRadarCubeDebugPtr = NULL;
 
@@ -87,19 +107,1266 @@ void uartTask() {
     uart_transmit_loop();
 }
 
+/**
+ * @brief Drops the range bins in front of the range region of interest from the output of the Rangeproc DPU.
+ *
+ * The DPU writes the range bins 0 up to the end of the ROI, the profiles of the ROI are moved together into
+ * the radar cube. Rows are moved in ascending order and the destination of a row always ends before the
+ * source of the next one starts, so this works in place.
+ */
+static void rangeRoi_compact(void) {
+    const RadarCube_View *out  = &gSysContext.rangeProcOutput;
+    const RadarCube_View *cube = &gSysContext.radarCube;
+    uint32_t              row, numRows = out->numChirps * out->numAntennas;
+
+    if (cube->rangeOffset == 0U) {
+        return;
+    }
+    for (row = 0; row < numRows; row++) {
+        memmove((void *)&cube->data[row * cube->numRangeBins],
+                (const void *)&out->data[row * out->numRangeBins + cube->rangeOffset],
+                cube->numRangeBins * sizeof(cmplx16ImRe_t));
+    }
+}
+
+#if (APP_CUBE_RING_DEPTH > 0)
+/**
+ * @brief Allocates the ring of the last frames from the L3 memory pool.
+ *
+ * @param[in] numChirps    Chirps per slot: all Doppler chirps, 1 with APP_CUBE_RING_PROFILES.
+ * @param[in] numAntennas  Virtual antennas of the radar cube.
+ * @param[in] numRangeBins Range bins of the radar cube.
+ */
+static void cubeRing_alloc(uint32_t numChirps, uint32_t numAntennas, uint32_t numRangeBins) {
+    CubeRing_Config cfg;
+    void           *mem;
+
+    memset((void *)&cfg, 0, sizeof(CubeRing_Config));
+    cfg.depth        = APP_CUBE_RING_DEPTH;
+    cfg.numChirps    = numChirps;
+    cfg.numAntennas  = numAntennas;
+    cfg.numRangeBins = numRangeBins;
+    mem = DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj, CubeRing_memSize(&cfg), sizeof(uint32_t));
+    if ((mem == NULL) || (CubeRing_init(&gSysContext.cubeRing, &cfg, mem) != CUBE_RING_SUCCESS)) {
+        DebugP_log("Error allocating the radar cube ring (APP_CUBE_RING_DEPTH %d)\n", APP_CUBE_RING_DEPTH);
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Publishes the processed frame in the ring, the next frame goes to the oldest slot without readers.
+ */
+static void cubeRing_publish(void) {
+#if APP_CUBE_RING_PROFILES
+    RadarCube_View slot;
+
+    // all antennas of a chirp are contiguous in the radar cube
+    CubeRing_writeView(&gSysContext.cubeRing, &slot);
+    memcpy((void *)slot.data, (const void *)RadarCube_at(&gSysContext.radarCube, APP_TX_CHIRP_IDX, 0, 0),
+           slot.numAntennas * slot.numRangeBins * sizeof(cmplx16ImRe_t));
+    // frames are only dropped if the readers pin too many, see gSysContext.cubeRing.numDropped
+    (void) CubeRing_publish(&gSysContext.cubeRing);
+#else
+    uint32_t rangeOffset = gSysContext.radarCube.rangeOffset;
+    int32_t  retVal;
+
+    if (CubeRing_publish(&gSysContext.cubeRing) == CUBE_RING_SUCCESS) {
+        CubeRing_writeView(&gSysContext.cubeRing, &gSysContext.radarCube);
+        gSysContext.radarCube.rangeOffset = rangeOffset;
+        if (rangeOffset != 0U) {
+            // the DPU keeps its own output buffer, rangeRoi_compact() writes the ROI into the new write slot
+            return;
+        }
+        // the DPU has no command to move its output, so it is reconfigured with the new write slot
+        gSysContext.rangeProcOutput.data = gSysContext.radarCube.data;
+        gSysContext.rangeProcDpuCfg.hwRes.radarCube.data = gSysContext.radarCube.data;
+        gRadarCubeDebugPtr = gSysContext.radarCube.data;
+#if APP_MINOR_MOTION_ENABLE
+        // the frame slot is static configuration, the reconfiguration would restart the minor motion cube at slot 0
+        gSysContext.rangeProcDpuCfg.staticCfg.frmCntrModNumFramesPerMinorMot = gSysContext.minorMotionFrameSlot;
+#endif
+        retVal = DPU_RangeProcHWA_config(gSysContext.rangeProcHWADpuHandle, &gSysContext.rangeProcDpuCfg);
+        if (retVal < 0) {
+            DebugP_log("RangeProc DPU reconfiguration error %d\n", retVal);
+            DebugP_assert(0);
+        }
+    }
+#endif
+}
+#endif
+
+/**
+ * @brief Configures the static clutter removal and allocates its background.
+ */
+static void clutterRemoval_dpuConfig(void) {
+    ClutterRemoval_Config cfg;
+    void                 *state = NULL;
+
+    memset((void *)&cfg, 0, sizeof(ClutterRemoval_Config));
+    cfg.mode         = APP_CLUTTER_REMOVAL_MODE;
+    cfg.emaShift     = APP_CLUTTER_REMOVAL_EMA_SHIFT;
+    cfg.numChirps    = gSysContext.radarCube.numChirps;
+    cfg.numAntennas  = gSysContext.radarCube.numAntennas;
+    cfg.numRangeBins = gSysContext.radarCube.numRangeBins;
+    if (ClutterRemoval_stateSize(&cfg) > 0U) {
+        state = DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj, ClutterRemoval_stateSize(&cfg),
+                                        sizeof(uint32_t));
+        if (state == NULL) {
+            DebugP_log("Error allocating clutter removal memory");
+            DebugP_assert(0);
+        }
+    }
+    if (ClutterRemoval_init(&gSysContext.clutterRemoval, &cfg, state) != CLUTTER_REMOVAL_SUCCESS) {
+        DebugP_log("Error: invalid clutter removal configuration\n");
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Configures the non-coherent range integration and allocates its output.
+ */
+static void rangeIntegration_dpuConfig(void) {
+    RangeIntegration_Config cfg;
+
+    memset((void *)&cfg, 0, sizeof(RangeIntegration_Config));
+    cfg.output       = APP_RANGE_INTEGRATION_OUTPUT;
+    cfg.numChirps    = gSysContext.radarCube.numChirps;
+    cfg.numAntennas  = gSysContext.radarCube.numAntennas;
+    cfg.numRangeBins = gSysContext.radarCube.numRangeBins;
+    if (RangeIntegration_init(&gSysContext.rangeIntegration, &cfg) != RANGE_INTEGRATION_SUCCESS) {
+        DebugP_log("Error: invalid range integration configuration\n");
+        DebugP_assert(0);
+    }
+    gSysContext.integratedProfile = DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj,
+                                                            RangeIntegration_outputSize(&cfg), sizeof(uint32_t));
+    if (gSysContext.integratedProfile == NULL) {
+        DebugP_log("Error allocating range integration memory");
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Configures the range peak picker.
+ */
+static void peakPicker_dpuConfig(void) {
+    PeakPicker_Config *cfg = &gSysContext.peakCfg;
+
+    memset((void *)cfg, 0, sizeof(PeakPicker_Config));
+    cfg->interp       = APP_PEAKS_INTERP;
+    cfg->numRangeBins = gSysContext.radarCube.numRangeBins;
+    cfg->maxPeaks     = APP_PEAKS_MAX;
+    // relative to the range ROI
+    cfg->firstBin     = (APP_PEAKS_FIRST_BIN > gSysContext.radarCube.rangeOffset) ?
+                        (APP_PEAKS_FIRST_BIN - gSysContext.radarCube.rangeOffset) : 0U;
+    cfg->minPower     = APP_PEAKS_MIN_POWER;
+    if (PeakPicker_checkConfig(cfg) != PEAK_PICKER_SUCCESS) {
+        DebugP_log("Error: invalid peak picker configuration\n");
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Configures the Doppler stage on the radar cube configured by RangeProc_config().
+ */
+static void dopplerProc_dpuConfig(void) {
+    DopplerProc_Config cfg;
+
+    memset((void *)&cfg, 0, sizeof(DopplerProc_Config));
+    cfg.hwaHandle          = gSysContext.hwaHandle;
+    cfg.numRangeBins       = gSysContext.radarCube.numRangeBins;
+    cfg.numVirtualAntennas = gSysContext.radarCube.numAntennas;
+    cfg.numDopplerChirps   = gSysContext.radarCube.numChirps;
+    cfg.fftSize            = mathUtils_pow2roundup(cfg.numDopplerChirps);
+    cfg.windowType         = APP_DOPPLER_WINDOW;
+    cfg.fftOutputDivShift  = APP_DOPPLER_FFT_OUTPUT_DIV_SHIFT;
+    cfg.hwaParamSetIdx     = DPC_OBJDET_DOPPLERPROC_HWA_PARAMSET_IDX;
+    cfg.hwaWinRamOffset    = DPC_OBJDET_DOPPLERPROC_HWA_WINDOW_RAM_OFFSET;
+
+    if (DopplerProc_config(&gSysContext.dopplerProc, &cfg, &gSysContext.L3RamObj,
+                           &gSysContext.CoreLocalRamObj) != SystemP_SUCCESS) {
+        DebugP_log("Error: Doppler stage configuration failed\n");
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Configures the CFAR detection and allocates its buffers.
+ */
+static void cfar_dpuConfig(void) {
+    Cfar_Config *cfg = &gSysContext.cfarCfg;
+    uint32_t     numRangeBins = gSysContext.radarCube.numRangeBins;
+
+    memset((void *)cfg, 0, sizeof(Cfar_Config));
+    cfg->mode             = APP_CFAR_MODE;
+    cfg->guardLen         = APP_CFAR_GUARD_LEN;
+    cfg->trainLen         = APP_CFAR_TRAIN_LEN;
+    cfg->osRank           = APP_CFAR_OS_RANK;
+    cfg->thresholdScaleQ8 = APP_CFAR_THRESHOLD_Q8;
+    cfg->dopplerCheck     = APP_CFAR_DOPPLER_CHECK;
+    cfg->peakGrouping     = APP_CFAR_PEAK_GROUPING;
+    if (Cfar_checkConfig(cfg) != CFAR_SUCCESS) {
+        DebugP_log("Error: invalid CFAR configuration\n");
+        DebugP_assert(0);
+    }
+
+#if APP_MINOR_MOTION_ENABLE
+    /* the workspace is shared with the minor motion pass, whose cube starts at range bin 0 and thus holds the bins in
+       front of the range ROI as well (see RangeProc_config()) */
+    if (gSysContext.radarCubeMinor.numRangeBins > numRangeBins) {
+        numRangeBins = gSysContext.radarCubeMinor.numRangeBins;
+    }
+#endif
+    gSysContext.cfarWorkspace = DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj, Cfar_workspaceSize(numRangeBins),
+                                                        sizeof(uint32_t));
+    gSysContext.detections = (Cfar_Detection *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                        APP_CFAR_MAX_DETECTIONS * sizeof(Cfar_Detection),
+                                                        sizeof(uint32_t));
+#if (APP_DOPPLER_ENABLE == 0)
+    gSysContext.cfarMagnitude = (uint16_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj,
+                                                        gSysContext.radarCube.numRangeBins * sizeof(uint16_t),
+                                                        sizeof(uint32_t));
+    if (gSysContext.cfarMagnitude == NULL) {
+        DebugP_log("Error allocating CFAR memory");
+        DebugP_assert(0);
+    }
+#endif
+    if ((gSysContext.cfarWorkspace == NULL) || (gSysContext.detections == NULL)) {
+        DebugP_log("Error allocating CFAR memory");
+        DebugP_assert(0);
+    }
+}
+
+/**
+ * @brief Runs the CFAR detection on the heat map, or on the transmitted range profile without Doppler stage.
+ */
+static void cfar_process(void) {
+    const uint16_t *map;
+    uint32_t        numDopplerBins;
+    int32_t         retVal;
+
+#if APP_DOPPLER_ENABLE
+    map            = gSysContext.dopplerProc.heatmap;
+    numDopplerBins = gSysContext.dopplerProc.cfg.fftSize;
+#else
+    {
+        const cmplx16ImRe_t *profile = RadarCube_rangeProfile(&gSysContext.radarCube, APP_TX_CHIRP_IDX,
+                                                              APP_TX_ANTENNA_IDX);
+        uint32_t             bin;
+        float                mag;
+
+        for (bin = 0; bin < gSysContext.radarCube.numRangeBins; bin++) {
+            mag = sqrtf((float) profile[bin].real * profile[bin].real + (float) profile[bin].imag * profile[bin].imag);
+            gSysContext.cfarMagnitude[bin] = (mag > 65535.0f) ? 0xFFFFU : (uint16_t) mag;
+        }
+    }
+    map            = gSysContext.cfarMagnitude;
+    numDopplerBins = 1U;
+#endif
+
+    retVal = Cfar_process(&gSysContext.cfarCfg, map, gSysContext.radarCube.numRangeBins, numDopplerBins,
+                          gSysContext.cfarWorkspace, gSysContext.detections, APP_CFAR_MAX_DETECTIONS,
+                          &gSysContext.cfarResult);
+    if (retVal != CFAR_SUCCESS) {
+        DebugP_log("CFAR process error %d\n", retVal);
+        DebugP_assert(0);
+    }
+}
+
+#if (APP_DOA_ENABLE && (APP_CFAR_ENABLE == 0))
+#error "APP_DOA_ENABLE needs APP_CFAR_ENABLE"
+#endif
+
+/**
+ * @brief Configures the direction of arrival estimation of the detections on the virtual array.
+ */
+static void doa_dpuConfig(void) {
+    static const uint8_t antRows[] = APP_DOA_ANT_ROWS;
+    static const uint8_t antCols[] = APP_DOA_ANT_COLS;
+    Doa_Config           cfg;
+
+    memset((void *)&cfg, 0, sizeof(Doa_Config));
+    cfg.numVirtualAntennas = gSysContext.radarCube.numAntennas;
+    cfg.numRxAntennas      = gSysContext.numRxAntennas;
+    cfg.numDopplerChirps   = gSysContext.radarCube.numChirps;
+    cfg.dopplerFftSize     = mathUtils_pow2roundup(cfg.numDopplerChirps); // as the Doppler stage
+    cfg.azimuthFftSize     = APP_DOA_AZIMUTH_FFT_SIZE;
+    cfg.tdmCompensation    = (gSysContext.sensorCfg.chirpTxMimoPatSel == 4U) ? 0U : 1U;  // BPM decodes both TX from the same chirp pair
+    if ((cfg.numVirtualAntennas > sizeof(antRows)) || (cfg.numVirtualAntennas > sizeof(antCols)) ||
+        (cfg.numVirtualAntennas > DOA_MAX_VIRTUAL_ANTENNAS)) {
+        DebugP_log("Error: APP_DOA_ANT_ROWS/APP_DOA_ANT_COLS need an entry per virtual antenna\n");
+        DebugP_assert(0);
+    }
+    memcpy((void *)cfg.antRow, (const void *)antRows, cfg.numVirtualAntennas);
+    memcpy((void *)cfg.antCol, (const void *)antCols, cfg.numVirtualAntennas);
+
+    if (Doa_init(&gSysContext.doa, &cfg) != DOA_SUCCESS) {
+        DebugP_log("Error: invalid DoA configuration\n");
+        DebugP_assert(0);
+    }
+    gSysContext.points = (Doa_Point *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                               APP_CFAR_MAX_DETECTIONS * sizeof(Doa_Point),
+                                                               sizeof(uint32_t));
+    if (gSysContext.points == NULL) {
+        DebugP_log("Error allocating DoA memory");
+        DebugP_assert(0);
+    }
+}
+
+#if (APP_UDOP_ENABLE && (APP_UDOP_RANGE_BIN < 0) && (APP_CFAR_ENABLE == 0))
+#error "APP_UDOP_RANGE_BIN -1 (follow the strongest detection) needs APP_CFAR_ENABLE"
+#endif
+
+/**
+ * @brief Configures the micro-Doppler stage on the range gate.
+ */
+static void microDoppler_dpuConfig(void) {
+    MicroDoppler_Config cfg;
+
+    memset((void *)&cfg, 0, sizeof(MicroDoppler_Config));
+    cfg.numDopplerChirps   = gSysContext.radarCube.numChirps;
+    cfg.numVirtualAntennas = gSysContext.radarCube.numAntennas;
+    cfg.numRangeBins       = gSysContext.radarCube.numRangeBins;
+    cfg.fftSize            = APP_UDOP_FFT_SIZE;
+    cfg.gateLen            = APP_UDOP_GATE_LEN;
+    cfg.windowLen          = APP_UDOP_WINDOW_LEN;
+    cfg.envelopeDb         = APP_UDOP_ENVELOPE_DB;
+    if (MicroDoppler_init(&gSysContext.microDoppler, &cfg) != MICRO_DOPPLER_SUCCESS) {
+        DebugP_log("Error: invalid micro-Doppler configuration\n");
+        DebugP_assert(0);
+    }
+#if (APP_UDOP_RANGE_BIN >= 0)
+    if ((APP_UDOP_RANGE_BIN < gSysContext.radarCube.rangeOffset) ||
+        (APP_UDOP_RANGE_BIN >= gSysContext.radarCube.rangeOffset + gSysContext.radarCube.numRangeBins)) {
+        DebugP_log("Error: APP_UDOP_RANGE_BIN outside of the range ROI\n");
+        DebugP_assert(0);
+    }
+    // relative to the range ROI
+    gSysContext.microDopplerRangeBin = (uint32_t) APP_UDOP_RANGE_BIN - gSysContext.radarCube.rangeOffset;
+#else
+    gSysContext.microDopplerRangeBin = 0U;
+#endif
+}
+
+/**
+ * @brief Moves the gate to the strongest detection (if configured) and runs the micro-Doppler stage.
+ */
+static void microDoppler_process(void) {
+    int32_t retVal;
+
+#if (APP_UDOP_RANGE_BIN < 0)
+    {
+        const Cfar_Detection *det;
+        uint32_t              i;
+        uint16_t              peak = 0U;
+
+        for (i = 0; i < gSysContext.cfarResult.numDetections; i++) {
+            det = &gSysContext.detections[i];
+            if (det->magnitude > peak) {
+                peak = det->magnitude;
+                gSysContext.microDopplerRangeBin = det->rangeBin;
+            }
+        }
+    }
+#endif
+    retVal = MicroDoppler_process(&gSysContext.microDoppler, &gSysContext.radarCube, gSysContext.microDopplerRangeBin,
+                                  &gSysContext.microDopplerFeatures);
+    if (retVal != MICRO_DOPPLER_SUCCESS) {
+        DebugP_log("Micro-Doppler process error %d\n", retVal);
+        DebugP_assert(0);
+    }
+}
+
+#if (APP_MINOR_MOTION_ENABLE && ((APP_DOPPLER_ENABLE == 0) || (APP_CFAR_ENABLE == 0)))
+#error "APP_MINOR_MOTION_ENABLE needs APP_DOPPLER_ENABLE and APP_CFAR_ENABLE"
+#endif
+
+/**
+ * @brief Configures the Doppler stage and the detection buffer of the minor motion radar cube.
+ */
+static void minorMotion_dpuConfig(void) {
+    DopplerProc_Config cfg;
+
+    memset((void *)&cfg, 0, sizeof(DopplerProc_Config));
+    cfg.hwaHandle          = gSysContext.hwaHandle;
+    cfg.numRangeBins       = gSysContext.radarCubeMinor.numRangeBins;
+    cfg.numVirtualAntennas = gSysContext.radarCubeMinor.numAntennas;
+    cfg.numDopplerChirps   = gSysContext.radarCubeMinor.numChirps;
+    cfg.fftSize            = mathUtils_pow2roundup(cfg.numDopplerChirps);
+    cfg.windowType         = APP_DOPPLER_WINDOW;
+    cfg.fftOutputDivShift  = APP_DOPPLER_FFT_OUTPUT_DIV_SHIFT;
+    cfg.hwaParamSetIdx     = DPC_OBJDET_DOPPLERPROC_MINOR_HWA_PARAMSET_IDX;
+    cfg.hwaWinRamOffset    = DPC_OBJDET_DOPPLERPROC_MINOR_HWA_WINDOW_RAM_OFFSET;
+
+    if (DopplerProc_config(&gSysContext.dopplerProcMinor, &cfg, &gSysContext.L3RamObj,
+                           &gSysContext.CoreLocalRamObj) != SystemP_SUCCESS) {
+        DebugP_log("Error: minor motion Doppler stage configuration failed\n");
+        DebugP_assert(0);
+    }
+    gSysContext.minorDetections = (Cfar_Detection *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                                             APP_CFAR_MAX_DETECTIONS * sizeof(Cfar_Detection),
+                                                                             sizeof(uint32_t));
+    if (gSysContext.minorDetections == NULL) {
+        DebugP_log("Error allocating minor motion memory");
+        DebugP_assert(0);
+    }
+    memset((void *)&gSysContext.minorCfarResult, 0, sizeof(Cfar_Result));
+    gSysContext.minorMotionNumFrames = 0U;
+    gSysContext.minorMotionFrameSlot = 0U; // as frmCntrModNumFramesPerMinorMot of RangeProc_config()
+    gSysContext.minorMotionActive    = 1U;
+}
+
+/**
+ * @brief Minor motion heat map and detections, once the minor motion radar cube holds APP_MINOR_MOTION_NUM_FRAMES frames.
+ *
+ * The zero Doppler bin (static reflectors) is cleared before the CFAR pass, which shares configuration and
+ * workspace with the major motion detection.
+ */
+static void minorMotion_process(void) {
+    DopplerProc_Obj *doppler = &gSysContext.dopplerProcMinor;
+    uint32_t         bin;
+    int32_t          retVal;
+
+    // the DPU has written a frame into the minor motion cube whether or not it is processed
+    gSysContext.minorMotionFrameSlot = (gSysContext.minorMotionFrameSlot + 1U) % APP_MINOR_MOTION_NUM_FRAMES;
+
+    gSysContext.minorCfarResult.numDetections = 0U;
+    gSysContext.minorCfarResult.numDiscarded  = 0U;
+    if (gSysContext.minorMotionActive == 0U) {
+        gSysContext.minorMotionNumFrames = 0U;
+        return;
+    }
+    if (gSysContext.minorMotionNumFrames < APP_MINOR_MOTION_NUM_FRAMES) {
+        gSysContext.minorMotionNumFrames++;
+    }
+    if (gSysContext.minorMotionNumFrames < APP_MINOR_MOTION_NUM_FRAMES) {
+        return;
+    }
+
+    retVal = DopplerProc_process(doppler, &gSysContext.radarCubeMinor);
+    if (retVal != SystemP_SUCCESS) {
+        DebugP_log("Minor motion Doppler stage process error %d\n", retVal);
+        DebugP_assert(0);
+    }
+    for (bin = 0; bin < doppler->cfg.numRangeBins; bin++) {
+        doppler->heatmap[bin * doppler->cfg.fftSize] = 0U;
+    }
+    // the DPU writes the minor motion radar cube from range bin 0, nothing is detected in front of the range ROI
+    memset((void *)doppler->heatmap, 0,
+           gSysContext.radarCube.rangeOffset * doppler->cfg.fftSize * sizeof(doppler->heatmap[0]));
+    retVal = Cfar_process(&gSysContext.cfarCfg, doppler->heatmap, doppler->cfg.numRangeBins, doppler->cfg.fftSize,
+                          gSysContext.cfarWorkspace, gSysContext.minorDetections, APP_CFAR_MAX_DETECTIONS,
+                          &gSysContext.minorCfarResult);
+    if (retVal != CFAR_SUCCESS) {
+        DebugP_log("Minor motion CFAR process error %d\n", retVal);
+        DebugP_assert(0);
+    }
+}
+
+void rangeProc_setMinorMotion(uint8_t enable) {
+    gSysContext.minorMotionActive = (enable != 0U) ? 1U : 0U;
+}
+
+/**
+ * @brief Logs the growth of the L3 and core local memory pools since the last call and updates the marks.
+ */
+static void logMemUsage(const char *stage, uint32_t *l3Mark, uint32_t *localMark) {
+    uint32_t l3    = DPC_ObjDet_MemPoolGetMaxUsage(&gSysContext.L3RamObj);
+    uint32_t local = DPC_ObjDet_MemPoolGetMaxUsage(&gSysContext.CoreLocalRamObj);
+
+    DebugP_log("  %-14s L3 %7u B  local %6u B\n", stage, l3 - *l3Mark, local - *localMark);
+    *l3Mark    = l3;
+    *localMark = local;
+}
+
+#if APP_TX_DUTY_CYCLE
+/*! @brief Ticks of the frame reference timer per microsecond (40 MHz) */
+#define FRAME_REF_TIMER_TICKS_PER_US    (40U)
+
+/*!
+ * @brief Timestamps of the frame being processed and the duty cycle of the previous one.
+ */
+typedef struct DutyCycle_Timer_t
+{
+    /*! @brief Frame reference timer at the frame start */
+    uint32_t frameStart;
+
+    /*! @brief Frame reference timer when the radar cube was complete */
+    uint32_t cubeReady;
+
+    /*! @brief Frame reference timer when the DPU was triggered for the next frame */
+    uint32_t processingDone;
+
+    /*! @brief Number of frames whose radar cube was complete */
+    uint32_t numFrames;
+
+    /*! @brief Duty cycle of the previous frame, sent with the current one */
+    FrameProto_DutyCycle last;
+} DutyCycle_Timer;
+
+static DutyCycle_Timer gDutyCycle;
+
+/**
+ * @brief Takes the time at which the radar cube is complete and closes the accounting of the previous frame.
+ */
+static void dutyCycle_cubeReady(void) {
+    uint32_t now        = Cycleprofiler_getTimeStamp();
+    uint32_t frameStart = gFrameStartTime;
+
+    if (gDutyCycle.numFrames > 0U) {
+        // unsigned differences are correct across the wrap of the timer
+        uint32_t period      = frameStart - gDutyCycle.frameStart;
+        uint32_t acquisition = gDutyCycle.cubeReady - gDutyCycle.frameStart;
+        uint32_t processing  = gDutyCycle.processingDone - gDutyCycle.cubeReady;
+
+        gDutyCycle.last.framePeriodUs = period / FRAME_REF_TIMER_TICKS_PER_US;
+        gDutyCycle.last.acquisitionUs = acquisition / FRAME_REF_TIMER_TICKS_PER_US;
+        gDutyCycle.last.processingUs  = processing / FRAME_REF_TIMER_TICKS_PER_US;
+        // processing overran the frame period: no idle time
+        gDutyCycle.last.idleUs = (period > acquisition + processing) ?
+                                 (period - acquisition - processing) / FRAME_REF_TIMER_TICKS_PER_US : 0U;
+        gDutyCycle.last.lowPowerMode = APP_DPU_LOW_POWER_MODE;
+    }
+    gDutyCycle.frameStart = frameStart;
+    gDutyCycle.cubeReady  = now;
+    gDutyCycle.numFrames++;
+}
+#endif
+
+/*!
+ * @brief Reconfiguration requested by rangeProc_reconfigure(), applied by the DPC task between two frames.
+ */
+typedef struct Reconfig_Request_t
+{
+    /*! @brief New sensor configuration */
+    SensorConfig cfg;
+
+    /*! @brief 1 while a request waits for the DPC task */
+    volatile uint8_t pending;
+
+    /*! @brief Posted by the DPC task when the request has been applied */
+    SemaphoreP_Object doneSem;
+
+    /*! @brief Latest reconfiguration, sent as FRAME_PROTO_TLV_RECONFIG */
+    FrameProto_Reconfig last;
+} Reconfig_Request;
+
+static Reconfig_Request gReconfig;
+
+/*! @brief Maximum number of sub-frames (APP_NUM_SUBFRAMES) */
+#define SUBFRAME_MAX_NUM                (4U)
+
+#if ((APP_NUM_SUBFRAMES < 1) || (APP_NUM_SUBFRAMES > SUBFRAME_MAX_NUM))
+#error "APP_NUM_SUBFRAMES must be 1..4"
+#endif
+
+#if ((APP_NUM_SUBFRAMES > 1) && ((APP_CUBE_RING_DEPTH > 0) || APP_MINOR_MOTION_ENABLE || APP_UDOP_ENABLE))
+#error "APP_NUM_SUBFRAMES > 1 needs APP_CUBE_RING_DEPTH 0 and neither APP_MINOR_MOTION_ENABLE nor APP_UDOP_ENABLE"
+#endif
+
+#if ((APP_NUM_SUBFRAMES > 1) && (APP_SUBFRAME_SWITCH != 1) && (APP_SUBFRAME_SWITCH != 2))
+#error "APP_NUM_SUBFRAMES > 1 restarts the sensor after every frame, choose how with APP_SUBFRAME_SWITCH 1 or 2"
+#endif
+
+static int32_t rangeRoi_compute(const SensorConfig *cfg, FrameProto_RangeRoi *roi);
+
+#if (APP_NUM_SUBFRAMES > 1)
+/*!
+ * @brief Sub-frames taking turns frame by frame (APP_NUM_SUBFRAMES), prepared by dpc_config().
+ */
+typedef struct SubFrame_Table_t
+{
+    /*! @brief Sensor configuration per sub-frame, sub-frame 0 is the one set by the CLI or rangeProc_reconfigure() */
+    SensorConfig cfg[APP_NUM_SUBFRAMES];
+
+    /*! @brief Rangeproc DPU configuration per sub-frame, they only differ in the radar cube */
+    DPU_RangeProcHWA_Config dpuCfg[APP_NUM_SUBFRAMES];
+
+    /*! @brief Range region of interest per sub-frame: the same bins, the bin size of the sub-frame */
+    FrameProto_RangeRoi roi[APP_NUM_SUBFRAMES];
+
+    /*! @brief Sub-frame of the frame being acquired */
+    uint32_t current;
+
+    /*! @brief ClockP_getTimeUsec() when the sensor was last started by subFrame_next(), 0 before */
+    uint64_t sensorStartUs;
+
+    /*! @brief Sub-frame of the frame being acquired, sent as FRAME_PROTO_TLV_SUBFRAME */
+    FrameProto_SubFrame last;
+} SubFrame_Table;
+
+static SubFrame_Table gSubFrames;
+
+/**
+ * @brief Configuration of a sub-frame: the one of sub-frame 0 with the slope and start frequency of the sub-frame.
+ */
+static void subFrame_deriveConfig(const SensorConfig *base, uint32_t subFrame, SensorConfig *cfg) {
+    static const float slopes[SUBFRAME_MAX_NUM]     = APP_SUBFRAME_SLOPES_MHZ_US;
+    static const float startFreqs[SUBFRAME_MAX_NUM] = APP_SUBFRAME_START_FREQS_GHZ;
+
+    memcpy((void *)cfg, (const void *)base, sizeof(SensorConfig));
+    if ((subFrame > 0U) && (slopes[subFrame] != 0.0f)) {
+        cfg->chirpRfFreqSlope = slopes[subFrame];
+    }
+    if ((subFrame > 0U) && (startFreqs[subFrame] != 0.0f)) {
+        cfg->chirpRfFreqStart = startFreqs[subFrame];
+    }
+}
+
+/**
+ * @brief Idle time of a frame in us: frame period minus the bursts, negative if they do not fit.
+ */
+static float subFrame_idleUs(const SensorConfig *cfg) {
+    return cfg->framePeriodicity * 1000.0f - (float) cfg->numOfBurstsInFrame * cfg->burstPeriodicity;
+}
+
+/**
+ * @brief Checks the configurations derived for the sub-frames: within the device, the range ROI of sub-frame 0 and
+ *        room for the switch (APP_SUBFRAME_SWITCH_BUDGET_US) in the idle time of every frame.
+ */
+static int32_t subFrame_checkConfig(const SensorConfig *base) {
+    FrameProto_RangeRoi roi0, roi;
+    SensorConfig        cfg;
+    uint32_t            k;
+
+    if (rangeRoi_compute(base, &roi0) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+    if (subFrame_idleUs(base) < (float) APP_SUBFRAME_SWITCH_BUDGET_US) {
+        DebugP_log("Sensor config: idle time of sub-frame 0 shorter than APP_SUBFRAME_SWITCH_BUDGET_US\n");
+        return SystemP_FAILURE;
+    }
+    for (k = 1U; k < APP_NUM_SUBFRAMES; k++) {
+        subFrame_deriveConfig(base, k, &cfg);
+        if (SensorConfig_check(&cfg) != SENSOR_CONFIG_SUCCESS) {
+            DebugP_log("Sensor config: sub-frame %u outside the limits of the device\n", k);
+            return SystemP_FAILURE;
+        }
+        if (subFrame_idleUs(&cfg) < (float) APP_SUBFRAME_SWITCH_BUDGET_US) {
+            DebugP_log("Sensor config: idle time of sub-frame %u shorter than APP_SUBFRAME_SWITCH_BUDGET_US\n", k);
+            return SystemP_FAILURE;
+        }
+        if ((rangeRoi_compute(&cfg, &roi) != SystemP_SUCCESS) ||
+            (roi.startBin != roi0.startBin) || (roi.numBins != roi0.numBins)) {
+            DebugP_log("Sensor config: range ROI of sub-frame %u differs, give APP_RANGE_ROI_* in bins\n", k);
+            return SystemP_FAILURE;
+        }
+    }
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Points the radar cube views and the range ROI at a sub-frame.
+ */
+static void subFrame_select(uint32_t subFrame) {
+    cmplx16ImRe_t *cube = (cmplx16ImRe_t *) gSubFrames.dpuCfg[subFrame].hwRes.radarCube.data;
+
+    gSysContext.rangeProcOutput.data = cube;
+    gSysContext.radarCube.data       = cube;
+    gRadarCubeDebugPtr               = cube;
+    memcpy((void *)&gRangeRoi, (const void *)&gSubFrames.roi[subFrame], sizeof(FrameProto_RangeRoi));
+
+    gSubFrames.current            = subFrame;
+    gSubFrames.last.subFrame      = (uint8_t) subFrame;
+    gSubFrames.last.slopeKhzPerUs = (uint32_t) (gSubFrames.cfg[subFrame].chirpRfFreqSlope * 1000.0f + 0.5f);
+    gSubFrames.last.startFreqMhz  = (uint32_t) (gSubFrames.cfg[subFrame].chirpRfFreqStart * 1000.0f + 0.5f);
+}
+
+/**
+ * @brief Prepares the sub-frames after RangeProc_config(): their configurations, radar cubes and DPU configurations.
+ *
+ * Sub-frame 0 is the configuration the sensor has just been set up with and keeps the radar cube of
+ * RangeProc_config(), the radar cubes of the others are allocated from the L3 memory pool.
+ */
+static void subFrame_config(void) {
+    SubFrame_Table *sf = &gSubFrames;
+    uint32_t        k;
+
+    // a background averaged over frames would mix the sub-frames
+    if (APP_CLUTTER_REMOVAL_ENABLE && (APP_CLUTTER_REMOVAL_MODE != CLUTTER_REMOVAL_MODE_MEAN)) {
+        DebugP_log("Error: APP_NUM_SUBFRAMES > 1 needs CLUTTER_REMOVAL_MODE_MEAN\n");
+        DebugP_assert(0);
+    }
+    if (subFrame_checkConfig(&gSysContext.sensorCfg) != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+
+    memset((void *)sf, 0, sizeof(SubFrame_Table));
+    for (k = 0; k < APP_NUM_SUBFRAMES; k++) {
+        subFrame_deriveConfig(&gSysContext.sensorCfg, k, &sf->cfg[k]);
+        (void) rangeRoi_compute(&sf->cfg[k], &sf->roi[k]);
+        memcpy((void *)&sf->dpuCfg[k], (const void *)&gSysContext.rangeProcDpuCfg, sizeof(DPU_RangeProcHWA_Config));
+        if (k > 0U) {
+            sf->dpuCfg[k].hwRes.radarCube.data = (cmplx16ImRe_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                                    sf->dpuCfg[k].hwRes.radarCube.dataSize,
+                                                                    sizeof(uint32_t));
+            if (sf->dpuCfg[k].hwRes.radarCube.data == NULL) {
+                DebugP_log("Error allocating the radar cube of sub-frame %u\n", k);
+                DebugP_assert(0);
+            }
+        }
+        DebugP_log("Sub-frame %u: slope %u kHz/us, start %u MHz, %u um per bin\n", k,
+                   (uint32_t) (sf->cfg[k].chirpRfFreqSlope * 1000.0f + 0.5f),
+                   (uint32_t) (sf->cfg[k].chirpRfFreqStart * 1000.0f + 0.5f), sf->roi[k].binSizeUm);
+    }
+    sf->last.numSubFrames = APP_NUM_SUBFRAMES;
+    subFrame_select(0U);
+}
+#endif
+
+/**
+ * @brief Size of the TLVs added by submitUartFrame() in bytes.
+ */
+static uint32_t uartFrameTlvBytes(void) {
+    uint32_t numBytes = FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_RangeRoi));
+
+#if APP_TX_RANGE_PROFILE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_RangeProfile) +
+                                     gSysContext.radarCube.numRangeBins * sizeof(cmplx16ImRe_t));
+#endif
+#if APP_RANGE_INTEGRATION_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_IntegratedProfile) +
+                                     RangeIntegration_outputSize(&gSysContext.rangeIntegration.cfg));
+#endif
+#if APP_PEAKS_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_PeakList) + APP_PEAKS_MAX * sizeof(FrameProto_Peak));
+#endif
+#if APP_DOA_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_PointCloud) + APP_CFAR_MAX_DETECTIONS * sizeof(FrameProto_Point));
+#elif APP_CFAR_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_DetectionList) +
+                                     APP_CFAR_MAX_DETECTIONS * sizeof(FrameProto_Detection));
+#endif
+#if APP_MINOR_MOTION_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_DetectionList) +
+                                     APP_CFAR_MAX_DETECTIONS * sizeof(FrameProto_Detection));
+#endif
+#if APP_UDOP_ENABLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_MicroDoppler) + (APP_UDOP_TX_COLUMN ? APP_UDOP_FFT_SIZE : 0U));
+#endif
+#if (APP_DOPPLER_ENABLE && APP_TX_HEATMAP)
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_Heatmap) + gSysContext.radarCube.numRangeBins *
+                                     gSysContext.dopplerProc.cfg.fftSize * sizeof(uint16_t));
+#endif
+#if APP_TX_DUTY_CYCLE
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_DutyCycle));
+#endif
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_Reconfig));
+#if (APP_NUM_SUBFRAMES > 1)
+    numBytes += FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_SubFrame));
+#endif
+    return numBytes;
+}
+
+#if ((APP_CFAR_ENABLE && (APP_DOA_ENABLE == 0)) || APP_MINOR_MOTION_ENABLE)
+/**
+ * @brief Adds a detection list TLV to the frame being assembled.
+ */
+static void addDetectionTlv(uint32_t type, const RadarCube_View *cube, const Cfar_Detection *detections,
+                            const Cfar_Result *result, uint32_t numDopplerBins) {
+    FrameProto_DetectionList *list;
+    FrameProto_Detection     *det;
+    uint32_t                  i;
+
+    list = (FrameProto_DetectionList *) uart_addTlv(type, sizeof(FrameProto_DetectionList) +
+                                                    result->numDetections * sizeof(FrameProto_Detection));
+    if (list != NULL) {
+        list->numDetections  = result->numDetections;
+        list->numDiscarded   = (result->numDiscarded > 0xFFFFU) ? 0xFFFFU : result->numDiscarded;
+        list->numRangeBins   = cube->numRangeBins;
+        list->numDopplerBins = numDopplerBins;
+        det = (FrameProto_Detection *) (list + 1);
+        for (i = 0; i < result->numDetections; i++) {
+            det[i].rangeBin   = detections[i].rangeBin + cube->rangeOffset;
+            det[i].dopplerBin = detections[i].dopplerBin;
+            det[i].magnitude  = detections[i].magnitude;
+            det[i].snrDbQ8    = detections[i].snrDbQ8;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Hands the results of the current frame to the Uart task: the range
+ *        region of interest, the sub-frame, the range profile of the selected chirp and antenna, the integrated range
+ *        profile, its peaks, the point cloud (or the detection list), the minor motion
+ *        detections, the micro-Doppler features, the range-Doppler heat map, the duty cycle and the
+ *        latest reconfiguration.
+ */
+static void submitUartFrame(void) {
+    const RadarCube_View *cube = &gSysContext.radarCube;
+
+    if (uart_beginFrame(gFrameCount, Cycleprofiler_getTimeStamp()) != SystemP_SUCCESS) {
+        return;
+    }
+
+    {
+        FrameProto_RangeRoi *roi;
+
+        roi = (FrameProto_RangeRoi *) uart_addTlv(FRAME_PROTO_TLV_RANGE_ROI, sizeof(FrameProto_RangeRoi));
+        if (roi != NULL) {
+            memcpy((void *)roi, (const void *)&gRangeRoi, sizeof(FrameProto_RangeRoi));
+        }
+    }
+#if (APP_NUM_SUBFRAMES > 1)
+    {
+        FrameProto_SubFrame *subFrame;
+
+        subFrame = (FrameProto_SubFrame *) uart_addTlv(FRAME_PROTO_TLV_SUBFRAME, sizeof(FrameProto_SubFrame));
+        if (subFrame != NULL) {
+            memcpy((void *)subFrame, (const void *)&gSubFrames.last, sizeof(FrameProto_SubFrame));
+        }
+    }
+#endif
+
+#if APP_TX_RANGE_PROFILE
+    {
+        FrameProto_RangeProfile *rangeProfile;
+        uint32_t                 numBytes = cube->numRangeBins * sizeof(cmplx16ImRe_t);
+
+        rangeProfile = (FrameProto_RangeProfile *) uart_addTlv(FRAME_PROTO_TLV_RANGE_PROFILE,
+                                                               sizeof(FrameProto_RangeProfile) + numBytes);
+        if (rangeProfile != NULL) {
+            rangeProfile->chirpIdx   = APP_TX_CHIRP_IDX;
+            rangeProfile->antennaIdx = APP_TX_ANTENNA_IDX;
+            rangeProfile->startBin   = cube->rangeOffset;
+            rangeProfile->numBins    = cube->numRangeBins;
+            memcpy((void *)(rangeProfile + 1), RadarCube_rangeProfile(cube, APP_TX_CHIRP_IDX, APP_TX_ANTENNA_IDX),
+                   numBytes);
+        }
+    }
+#endif
+
+#if APP_RANGE_INTEGRATION_ENABLE
+    {
+        const RangeIntegration_Obj   *integ = &gSysContext.rangeIntegration;
+        FrameProto_IntegratedProfile *profile;
+        uint32_t                      numBytes = RangeIntegration_outputSize(&integ->cfg);
+
+        profile = (FrameProto_IntegratedProfile *) uart_addTlv(FRAME_PROTO_TLV_INTEGRATED_RANGE_PROFILE,
+                                                               sizeof(FrameProto_IntegratedProfile) + numBytes);
+        if (profile != NULL) {
+            profile->startBin      = cube->rangeOffset;
+            profile->numBins       = integ->cfg.numRangeBins;
+            profile->numIntegrated = integ->numIntegrated;
+            profile->format        = (uint8_t) integ->cfg.output;
+            profile->powerShift    = (uint8_t) integ->powerShift;
+            memcpy((void *)(profile + 1), gSysContext.integratedProfile, numBytes);
+        }
+    }
+#endif
+
+#if APP_PEAKS_ENABLE
+    {
+        const PeakPicker_Result *result = &gSysContext.peakResult;
+        FrameProto_PeakList     *list;
+        FrameProto_Peak         *peak;
+        uint32_t                 i;
+
+        list = (FrameProto_PeakList *) uart_addTlv(FRAME_PROTO_TLV_RANGE_PEAKS, sizeof(FrameProto_PeakList) +
+                                                   result->numPeaks * sizeof(FrameProto_Peak));
+        if (list != NULL) {
+            list->numPeaks      = result->numPeaks;
+            list->numCandidates = (result->numCandidates > 0xFFFFU) ? 0xFFFFU : result->numCandidates;
+            list->numRangeBins  = cube->numRangeBins;
+            list->chirpIdx      = APP_TX_CHIRP_IDX;
+            list->antennaIdx    = APP_TX_ANTENNA_IDX;
+            peak = (FrameProto_Peak *) (list + 1);
+            for (i = 0; i < result->numPeaks; i++) {
+                peak[i].rangeBin  = gSysContext.peaks[i].rangeBin + cube->rangeOffset;
+                peak[i].offsetQ15 = gSysContext.peaks[i].offsetQ15;
+                peak[i].log2MagQ8 = gSysContext.peaks[i].log2MagQ8;
+                peak[i].phaseQ15  = gSysContext.peaks[i].phaseQ15;
+            }
+        }
+    }
+#endif
+
+#if APP_DOA_ENABLE
+    {
+        const Cfar_Result     *result = &gSysContext.cfarResult;
+        FrameProto_PointCloud *cloud;
+        FrameProto_Point      *point;
+        uint32_t               i;
+
+        cloud = (FrameProto_PointCloud *) uart_addTlv(FRAME_PROTO_TLV_POINT_CLOUD, sizeof(FrameProto_PointCloud) +
+                                                      result->numDetections * sizeof(FrameProto_Point));
+        if (cloud != NULL) {
+            cloud->numPoints      = result->numDetections;
+            cloud->numDiscarded   = (result->numDiscarded > 0xFFFFU) ? 0xFFFFU : result->numDiscarded;
+            cloud->numRangeBins   = cube->numRangeBins;
+            cloud->numDopplerBins = APP_DOPPLER_ENABLE ? gSysContext.dopplerProc.cfg.fftSize : 1U;
+            point = (FrameProto_Point *) (cloud + 1);
+            for (i = 0; i < result->numDetections; i++) {
+                point[i].rangeBin        = gSysContext.points[i].rangeBin + cube->rangeOffset;
+                point[i].dopplerBin      = gSysContext.points[i].dopplerBin;
+                point[i].sinAzimuthQ15   = gSysContext.points[i].sinAzimuthQ15;
+                point[i].sinElevationQ15 = gSysContext.points[i].sinElevationQ15;
+                point[i].magnitude       = gSysContext.points[i].magnitude;
+                point[i].snrDbQ8         = gSysContext.points[i].snrDbQ8;
+            }
+        }
+    }
+#elif APP_CFAR_ENABLE
+    addDetectionTlv(FRAME_PROTO_TLV_DETECTIONS, cube, gSysContext.detections, &gSysContext.cfarResult,
+                    APP_DOPPLER_ENABLE ? gSysContext.dopplerProc.cfg.fftSize : 1U);
+#endif
+#if APP_MINOR_MOTION_ENABLE
+    addDetectionTlv(FRAME_PROTO_TLV_MINOR_MOTION_DETECTIONS, &gSysContext.radarCubeMinor, gSysContext.minorDetections,
+                    &gSysContext.minorCfarResult, gSysContext.dopplerProcMinor.cfg.fftSize);
+#endif
+
+#if APP_UDOP_ENABLE
+    {
+        const MicroDoppler_Features *f = &gSysContext.microDopplerFeatures;
+        const uint8_t               *column = MicroDoppler_latestColumn(&gSysContext.microDoppler);
+        FrameProto_MicroDoppler     *udop;
+        uint32_t                     numBins = ((APP_UDOP_TX_COLUMN != 0) && (column != NULL)) ? APP_UDOP_FFT_SIZE : 0U;
+
+        udop = (FrameProto_MicroDoppler *) uart_addTlv(FRAME_PROTO_TLV_MICRO_DOPPLER,
+                                                       sizeof(FrameProto_MicroDoppler) + numBins);
+        if (udop != NULL) {
+            udop->rangeBin         = f->rangeBin + cube->rangeOffset;
+            udop->numFrames        = f->numFrames;
+            udop->fftSize          = APP_UDOP_FFT_SIZE;
+            udop->numBins          = numBins;
+            udop->centroidQ8       = f->centroidQ8;
+            udop->bandwidthQ8      = f->bandwidthQ8;
+            udop->envelopeLowQ8    = f->envelopeLowQ8;
+            udop->envelopeHighQ8   = f->envelopeHighQ8;
+            udop->energyDbQ8       = f->energyDbQ8;
+            udop->meanCentroidQ8   = f->meanCentroidQ8;
+            udop->centroidSpreadQ8 = f->centroidSpreadQ8;
+            udop->reserved         = 0U;
+            if (numBins > 0U) {
+                memcpy((void *)(udop + 1), column, numBins);
+            }
+        }
+    }
+#endif
+
+#if (APP_DOPPLER_ENABLE && APP_TX_HEATMAP)
+    {
+        const DopplerProc_Obj *doppler = &gSysContext.dopplerProc;
+        FrameProto_Heatmap    *heatmap;
+        uint32_t               numBytes;
+
+        numBytes = doppler->cfg.numRangeBins * doppler->cfg.fftSize * sizeof(uint16_t);
+        heatmap = (FrameProto_Heatmap *) uart_addTlv(FRAME_PROTO_TLV_RANGE_DOPPLER_HEATMAP,
+                                                     sizeof(FrameProto_Heatmap) + numBytes);
+        if (heatmap != NULL) {
+            heatmap->startBin       = cube->rangeOffset;
+            heatmap->numRangeBins   = doppler->cfg.numRangeBins;
+            heatmap->numDopplerBins = doppler->cfg.fftSize;
+            heatmap->divShift       = doppler->cfg.fftOutputDivShift;
+            memcpy((void *)(heatmap + 1), doppler->heatmap, numBytes);
+        }
+    }
+#endif
+
+#if APP_TX_DUTY_CYCLE
+    {
+        FrameProto_DutyCycle *dutyCycle;
+
+        dutyCycle = (FrameProto_DutyCycle *) uart_addTlv(FRAME_PROTO_TLV_DUTY_CYCLE, sizeof(FrameProto_DutyCycle));
+        if (dutyCycle != NULL) {
+            memcpy((void *)dutyCycle, (const void *)&gDutyCycle.last, sizeof(FrameProto_DutyCycle));
+        }
+    }
+#endif
+
+    if ((gReconfig.last.numReconfigs != 0U) || (gReconfig.last.numRejected != 0U)) {
+        FrameProto_Reconfig *reconfig;
+
+        reconfig = (FrameProto_Reconfig *) uart_addTlv(FRAME_PROTO_TLV_RECONFIG, sizeof(FrameProto_Reconfig));
+        if (reconfig != NULL) {
+            memcpy((void *)reconfig, (const void *)&gReconfig.last, sizeof(FrameProto_Reconfig));
+        }
+    }
+
+    uart_commitFrame();
+}
+
+/**
+ * @brief Configures all DPUs and the UART snapshots from the rewound memory pools, logs the memory each stage takes.
+ */
+static void dpc_config(void) {
+    uint32_t l3Mark = 0U, localMark = 0U;
+
+    DPC_ObjDet_MemPoolReset(&gSysContext.L3RamObj);
+    DPC_ObjDet_MemPoolReset(&gSysContext.CoreLocalRamObj);
+
+    /* configure DPUs, report the memory each stage takes from the pools: */
+    DebugP_log("Memory usage:\n");
+    RangeProc_config();
+    logMemUsage("rangeproc", &l3Mark, &localMark);
+#if (APP_NUM_SUBFRAMES > 1)
+    subFrame_config();
+    logMemUsage("sub-frames", &l3Mark, &localMark);
+#endif
+#if (APP_CUBE_RING_DEPTH > 0) && APP_CUBE_RING_PROFILES
+    cubeRing_alloc(1U, gSysContext.radarCube.numAntennas, gSysContext.radarCube.numRangeBins);
+    logMemUsage("cube ring", &l3Mark, &localMark);
+#endif
+#if APP_CLUTTER_REMOVAL_ENABLE
+    clutterRemoval_dpuConfig();
+    logMemUsage("clutter", &l3Mark, &localMark);
+#endif
+#if APP_RANGE_INTEGRATION_ENABLE
+    rangeIntegration_dpuConfig();
+    logMemUsage("integration", &l3Mark, &localMark);
+#endif
+#if APP_PEAKS_ENABLE
+    peakPicker_dpuConfig();
+#endif
+#if APP_DOPPLER_ENABLE
+    dopplerProc_dpuConfig();
+    logMemUsage("doppler", &l3Mark, &localMark);
+#endif
+#if APP_CFAR_ENABLE
+    cfar_dpuConfig();
+    logMemUsage("cfar", &l3Mark, &localMark);
+#endif
+#if APP_DOA_ENABLE
+    doa_dpuConfig();
+    logMemUsage("doa", &l3Mark, &localMark);
+#endif
+#if APP_MINOR_MOTION_ENABLE
+    minorMotion_dpuConfig();
+    logMemUsage("minor motion", &l3Mark, &localMark);
+#endif
+#if APP_UDOP_ENABLE
+    microDoppler_dpuConfig();
+#endif
+
+    /* snapshots of the transmitted frames */
+    if (uart_allocSnapshots(&gSysContext.L3RamObj, uartFrameTlvBytes()) != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    logMemUsage("uart", &l3Mark, &localMark);
+    DebugP_log("  %-14s L3 %7u of %u B  local %6u of %u B\n", "total", l3Mark, gSysContext.L3RamObj.cfg.size,
+               localMark, gSysContext.CoreLocalRamObj.cfg.size);
+}
+
+/**
+ * @brief Triggers the Rangeproc DPU for the next frame.
+ */
+static void rangeProc_trigger(void) {
+    int32_t retVal;
+
+    retVal = DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle, DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0);
+    if (retVal < 0) {
+        DebugP_log("Error: DPU_RangeProcHWA_control failed with error code %d", retVal);
+        DebugP_assert(0);
+    }
+}
+
+/*! @brief Chirps of ADC data per frame of defines.h, after the hardware chirp accumulation */
+#define RANGEPROC_MAX_ADC_CHIRPS        (CLI_NUM_BURSTS_PER_FRAME * \
+                                         (CLI_NUM_CHIRPS_PER_BURST / ((CLI_NUM_CHIRPS_ACCUM > 1) ? CLI_NUM_CHIRPS_ACCUM : 1)))
+
+/*! @brief Maximum number of accumulated chirps: their sum fills the 4 bits above the 12-bit ADC samples */
+#define RANGEPROC_MAX_CHIRPS_ACCUM      (16U)
+
+/*
+ * The range window tables (range_window.h) and the HWA window RAM layout (dpu_res.h) are generated for the ADC
+ * samples of defines.h; the memory pools, the DoA antenna geometry and the transmitted chirp and antenna are
+ * dimensioned for its channels and chirps of ADC data. So the ADC samples and the number of enabled TX and RX
+ * channels stay, the chirps of ADC data per frame must not grow.
+ */
+int32_t rangeProc_checkConfig(const SensorConfig *cfg) {
+    uint32_t numTx, numChirps;
+
+    if (SensorConfig_check(cfg) != SENSOR_CONFIG_SUCCESS) {
+        DebugP_log("Sensor config: outside the limits of the device\n");
+        return SystemP_FAILURE;
+    }
+    numTx     = SensorConfig_numChannels(cfg->txChCtrlBitMask);
+    numChirps = SensorConfig_numAdcChirps(cfg);
+    if ((cfg->numOfAdcSamples != RANGE_WINDOW_NUM_SAMPLES) ||
+        (numTx != SensorConfig_numChannels(CLI_CHA_CFG_TX_BITMASK)) ||
+        (SensorConfig_numChannels(cfg->rxChCtrlBitMask) != SensorConfig_numChannels(CLI_CHA_CFG_RX_BITMASK))) {
+        DebugP_log("Sensor config: ADC samples and number of TX/RX channels must match defines.h\n");
+        return SystemP_FAILURE;
+    }
+    if ((numChirps > RANGEPROC_MAX_ADC_CHIRPS) || (numChirps / numTx <= APP_TX_CHIRP_IDX)) {
+        DebugP_log("Sensor config: %u chirps of ADC data per frame, at most %u and more than APP_TX_CHIRP_IDX\n",
+                   numChirps, RANGEPROC_MAX_ADC_CHIRPS);
+        return SystemP_FAILURE;
+    }
+    if (SensorConfig_numChirpsAccum(cfg) > RANGEPROC_MAX_CHIRPS_ACCUM) {
+        DebugP_log("Sensor config: at most %u accumulated chirps\n", RANGEPROC_MAX_CHIRPS_ACCUM);
+        return SystemP_FAILURE;
+    }
+#if APP_MINOR_MOTION_ENABLE
+    if (numChirps < APP_MINOR_MOTION_CHIRPS_PER_FRAME) {
+        DebugP_log("Sensor config: fewer chirps per frame than APP_MINOR_MOTION_CHIRPS_PER_FRAME\n");
+        return SystemP_FAILURE;
+    }
+#endif
+#if (APP_NUM_SUBFRAMES > 1)
+    if (subFrame_checkConfig(cfg) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+#endif
+    return SystemP_SUCCESS;
+}
+
+void rangeProc_getConfig(SensorConfig *cfg) {
+#if (APP_NUM_SUBFRAMES > 1)
+    // gSysContext.sensorCfg follows the sub-frames, sub-frame 0 only changes in reconfig_apply()
+    memcpy((void *)cfg, (const void *)&gSubFrames.cfg[0], sizeof(SensorConfig));
+#else
+    memcpy((void *)cfg, (const void *)&gSysContext.sensorCfg, sizeof(SensorConfig));
+#endif
+}
+
+/**
+ * @brief Applies the pending reconfiguration between two frames and measures each step.
+ *
+ * Called after a frame has been processed, while the Rangeproc DPU waits for its trigger. The snapshots of the UART
+ * task live in the rewound L3 memory pool, so its last frame has to be out first. The DPU is initialized again as at
+ * start-up before it is configured with the new buffers, then triggered for the first frame of the new configuration.
+ */
+static void reconfig_apply(void) {
+    FrameProto_Reconfig *last = &gReconfig.last;
+    uint64_t             start, t0, t1, t2, t3;
+    int32_t              retVal;
+
+    start = ClockP_getTimeUsec();
+    uart_waitIdle();
+    t0 = ClockP_getTimeUsec();
+
+    if (mmwave_stop_close_deinit() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    last->frameCount = gFrameCount;
+    t1 = ClockP_getTimeUsec();
+
+    memcpy((void *)&gSysContext.sensorCfg, (const void *)&gReconfig.cfg, sizeof(SensorConfig));
+    if ((mmwave_initSensor() != SystemP_SUCCESS) || (mmwave_setupSensor() != SystemP_SUCCESS)) {
+        DebugP_log("Reconfig: sensor setup failed\n");
+        DebugP_assert(0);
+    }
+    t2 = ClockP_getTimeUsec();
+
+    retVal = DPU_RangeProcHWA_deinit(gSysContext.rangeProcHWADpuHandle);
+    if (retVal < 0) {
+        DebugP_log("Reconfig: RangeProc DPU deinit error %d\n", retVal);
+        DebugP_assert(0);
+    }
+    rangeProc_dpuInit();
+    dpc_config();
+#if APP_TX_DUTY_CYCLE
+    // the gap of the reconfiguration is not a frame period
+    gDutyCycle.numFrames = 0U;
+#endif
+    t3 = ClockP_getTimeUsec();
+
+    rangeProc_trigger();
+    if (mmwave_startSensor() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+
+    last->numReconfigs++;
+    last->uartDrainUs   = (uint32_t) (t0 - start);
+    last->sensorStopUs  = (uint32_t) (t1 - t0);
+    last->sensorSetupUs = (uint32_t) (t2 - t1);
+    last->dpcConfigUs   = (uint32_t) (t3 - t2);
+    last->sensorStartUs = (uint32_t) (ClockP_getTimeUsec() - t3);
+    last->totalUs       = last->uartDrainUs + last->sensorStopUs + last->sensorSetupUs + last->dpcConfigUs +
+                          last->sensorStartUs;
+    DebugP_log("Reconfig: %u us (uart %u, stop %u, setup %u, dpc %u, start %u), sensor stopped after frame %u\n",
+               last->totalUs, last->uartDrainUs, last->sensorStopUs, last->sensorSetupUs, last->dpcConfigUs,
+               last->sensorStartUs, last->frameCount);
+}
+
+int32_t rangeProc_reconfigure(const SensorConfig *cfg, FrameProto_Reconfig *timing) {
+    if (rangeProc_checkConfig(cfg) != SystemP_SUCCESS) {
+        gReconfig.last.numRejected++;
+        return SystemP_FAILURE;
+    }
+    memcpy((void *)&gReconfig.cfg, (const void *)cfg, sizeof(SensorConfig));
+    gReconfig.pending = 1U;
+    SemaphoreP_pend(&gReconfig.doneSem, SystemP_WAIT_FOREVER);
+    if (timing != NULL) {
+        memcpy((void *)timing, (const void *)&gReconfig.last, sizeof(FrameProto_Reconfig));
+    }
+    return SystemP_SUCCESS;
+}
+
+#if (APP_NUM_SUBFRAMES > 1)
+/**
+ * @brief Sets the sensor up with the profile of the next sub-frame and triggers the Rangeproc DPU for its frame.
+ *
+ * Called instead of rangeProc_trigger() after a frame has been processed. The front end only gets a new chirp
+ * profile (APP_SUBFRAME_SWITCH 1) or is brought up again as in reconfig_apply() (2); the DPU only gets the
+ * configuration prepared by subFrame_config() with the radar cube of the sub-frame, the memory pools and the other
+ * stages stay as they are. The UART snapshots already hold the frame. The sensor is started one frame period after
+ * its previous start, since every start restarts the frame period.
+ */
+static void subFrame_next(void) {
+    uint32_t next     = (gSubFrames.current + 1U) % APP_NUM_SUBFRAMES;
+    uint64_t periodUs = (uint64_t) (gSubFrames.cfg[gSubFrames.current].framePeriodicity * 1000.0f + 0.5f);
+    uint64_t start    = ClockP_getTimeUsec();
+    uint64_t now;
+    int32_t  retVal;
+
+#if (APP_SUBFRAME_SWITCH == 1)
+    if (mmwave_stopSensor() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    memcpy((void *)&gSysContext.sensorCfg, (const void *)&gSubFrames.cfg[next], sizeof(SensorConfig));
+    if (mmwave_reconfigSensor() != SystemP_SUCCESS) {
+        DebugP_log("Sub-frame %u: sensor configuration failed\n", next);
+        DebugP_assert(0);
+    }
+#else
+    if (mmwave_stop_close_deinit() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    memcpy((void *)&gSysContext.sensorCfg, (const void *)&gSubFrames.cfg[next], sizeof(SensorConfig));
+    if ((mmwave_initSensor() != SystemP_SUCCESS) || (mmwave_setupSensor() != SystemP_SUCCESS)) {
+        DebugP_log("Sub-frame %u: sensor setup failed\n", next);
+        DebugP_assert(0);
+    }
+#endif
+
+    retVal = DPU_RangeProcHWA_config(gSysContext.rangeProcHWADpuHandle, &gSubFrames.dpuCfg[next]);
+    if (retVal < 0) {
+        DebugP_log("RangeProc DPU reconfiguration error %d\n", retVal);
+        DebugP_assert(0);
+    }
+    subFrame_select(next);
+    rangeProc_trigger();
+
+    // keep the frames periodic, late if processing and switch took longer than the idle time
+    now = ClockP_getTimeUsec();
+    gSubFrames.last.switchUs = (uint32_t) (now - start);
+    if (gSubFrames.sensorStartUs != 0U) {
+        if (now < gSubFrames.sensorStartUs + periodUs) {
+            ClockP_usleep((uint32_t) (gSubFrames.sensorStartUs + periodUs - now));
+        } else if (gSubFrames.last.numOverruns < 0xFFFFU) {
+            gSubFrames.last.numOverruns++;
+        }
+        now = ClockP_getTimeUsec();
+        gSubFrames.last.framePeriodUs = (uint32_t) (now - gSubFrames.sensorStartUs);
+    }
+    gSubFrames.sensorStartUs = now;
+    if (mmwave_startSensor() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+}
+#endif
+
 void dpcTask() {
     int32_t retVal = -1;
     DPU_RangeProcHWA_OutParams outParams;
 
     gChirpCount = 0;
     gFrameCount = 0;
-    
-    DPC_ObjDet_MemPoolReset(&gSysContext.L3RamObj);
-    DPC_ObjDet_MemPoolReset(&gSysContext.CoreLocalRamObj);
 
-    /* configure DPUs: */
-    RangeProc_config();
-    // TODO: configure rest of DPUs if required
+    dpc_config();
+    SemaphoreP_constructBinary(&gReconfig.doneSem, 0);
 
     SemaphoreP_post(&dpcCfgDoneSemHandle);
     
@@ -109,6 +1376,7 @@ void dpcTask() {
         DebugP_assert(0);
     }
 
+#if (APP_DPU_LOW_POWER_MODE == 0)
     // for debugging: register Chirp available ISR
     if (registerChirpInterrupt() != 0) {
         DebugP_log("Error: Failed to register chirp interrupt\n");
@@ -120,14 +1388,10 @@ void dpcTask() {
         DebugP_log("Error: Failed to register chirp interrupt\n");
         DebugP_assert(0);
     }
+#endif
 
     // give initial trigger for the first frame 
-    retVal = DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle, DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0);
-    if (retVal < 0) {
-        /* Not Expected */
-        DebugP_log("RangeProc DPU control error %d\n", retVal);
-        DebugP_assert(0);
-    }
+    rangeProc_trigger();
 
     // endless loop for continuous chirping and processing of data
     while(true) {
@@ -140,19 +1404,91 @@ void dpcTask() {
             DebugP_log("RangeProc DPU process error %d\n", retVal);
             DebugP_assert(0);
         }
-        // trigger Uart transmission
-        SemaphoreP_post(&uart_tx_start_sem);
+#if APP_TX_DUTY_CYCLE
+        dutyCycle_cubeReady();
+#endif
+        rangeRoi_compact();
+
+#if APP_CLUTTER_REMOVAL_ENABLE
+        retVal = ClutterRemoval_process(&gSysContext.clutterRemoval, &gSysContext.radarCube);
+        if (retVal != CLUTTER_REMOVAL_SUCCESS) {
+            DebugP_log("Clutter removal process error %d\n", retVal);
+            DebugP_assert(0);
+        }
+#endif
+#if APP_RANGE_INTEGRATION_ENABLE
+        retVal = RangeIntegration_process(&gSysContext.rangeIntegration, &gSysContext.radarCube,
+                                          gSysContext.integratedProfile);
+        if (retVal != RANGE_INTEGRATION_SUCCESS) {
+            DebugP_log("Range integration process error %d\n", retVal);
+            DebugP_assert(0);
+        }
+#endif
+#if APP_PEAKS_ENABLE
+        retVal = PeakPicker_process(&gSysContext.peakCfg,
+                                    RadarCube_rangeProfile(&gSysContext.radarCube, APP_TX_CHIRP_IDX, APP_TX_ANTENNA_IDX),
+                                    gSysContext.peaks, &gSysContext.peakResult);
+        if (retVal != PEAK_PICKER_SUCCESS) {
+            DebugP_log("Peak picker process error %d\n", retVal);
+            DebugP_assert(0);
+        }
+#endif
 
+#if APP_DOPPLER_ENABLE
+        // HWA is idle until the next trigger of the Rangeproc DPU
+        retVal = DopplerProc_process(&gSysContext.dopplerProc, &gSysContext.radarCube);
+        if (retVal != SystemP_SUCCESS) {
+            DebugP_log("Doppler stage process error %d\n", retVal);
+            DebugP_assert(0);
+        }
+#endif
+#if APP_CFAR_ENABLE
+        cfar_process();
+#endif
+#if APP_DOA_ENABLE
+        retVal = Doa_process(&gSysContext.doa, &gSysContext.radarCube, gSysContext.detections,
+                             gSysContext.cfarResult.numDetections, gSysContext.points);
+        if (retVal != DOA_SUCCESS) {
+            DebugP_log("DoA process error %d\n", retVal);
+            DebugP_assert(0);
+        }
+#endif
+#if APP_MINOR_MOTION_ENABLE
+        minorMotion_process();
+#endif
+#if APP_UDOP_ENABLE
+        microDoppler_process();
+#endif
+
+        // hand the results to the Uart task and trigger transmission
+        submitUartFrame();
+
+#if (APP_PIPELINED_TX == 0)
         // wait for Uart transmission to complete
         SemaphoreP_pend(&uart_tx_done_sem, SystemP_WAIT_FOREVER);
+#endif
+#if (APP_CUBE_RING_DEPTH > 0)
+        // hand the processed frame to the readers of the ring, before the DPU is triggered for the next one
+        cubeRing_publish();
+#endif
 
         /* give initial trigger for the next frame */
-        retVal = DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle,
-                    DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0);
-        if (retVal < 0) {
-            DebugP_log("Error: DPU_RangeProcHWA_control failed with error code %d", retVal);
-            DebugP_assert(0);
+#if APP_TX_DUTY_CYCLE
+        gDutyCycle.processingDone = Cycleprofiler_getTimeStamp();
+#endif
+        if (gReconfig.pending != 0U) {
+            // stops the sensor, reconfigures and gives the trigger for the first frame of the new configuration
+            reconfig_apply();
+            gReconfig.pending = 0U;
+            SemaphoreP_post(&gReconfig.doneSem);
+            continue;
         }
+#if (APP_NUM_SUBFRAMES > 1)
+        // stops the sensor, sets it up with the profile of the next sub-frame and gives the trigger for its frame
+        subFrame_next();
+#else
+        rangeProc_trigger();
+#endif
     }
 }
 
@@ -169,6 +1505,119 @@ void rangeProc_dpuInit() {
     }
 }
 
+#if ((APP_CUBE_RING_DEPTH == 1) || (APP_CUBE_RING_DEPTH > CUBE_RING_MAX_DEPTH))
+#error "APP_CUBE_RING_DEPTH must be 0 or 2..CUBE_RING_MAX_DEPTH"
+#endif
+
+#if ((APP_RANGE_FFT_ZERO_PAD != 1) && (APP_RANGE_FFT_ZERO_PAD != 2) && (APP_RANGE_FFT_ZERO_PAD != 4))
+#error "APP_RANGE_FFT_ZERO_PAD must be 1, 2 or 4"
+#endif
+
+/*! @brief Size of the range FFT: ADC samples rounded up to a power of 2, zero-padded by APP_RANGE_FFT_ZERO_PAD
+           (the ADC samples of defines.h, which a reconfiguration keeps, see rangeProc_checkConfig()) */
+#define RANGEPROC_FFT_SIZE      (mathUtils_pow2roundup(CLI_NUM_ADC_SAMPLES) * APP_RANGE_FFT_ZERO_PAD)
+
+/*! @brief Number of range bins of the radar cube: half of the range FFT, since the ADC samples are real valued */
+#define RANGEPROC_NUM_RBINS     (RANGEPROC_FFT_SIZE / 2U)
+
+#if ((RANGE_WINDOW_NUM_SAMPLES != CLI_NUM_ADC_SAMPLES) || (RANGE_WINDOW_QFORMAT != DPC_OBJDET_QFORMAT_RANGE_FFT))
+#error "range_window.h does not match defines.h, regenerate both with scripts/chirp_config_to_defines.py"
+#endif
+
+/*! @brief Precomputed range window (first half, range_window.h) selected by APP_RANGE_WINDOW */
+#if (APP_RANGE_WINDOW == RANGE_WINDOW_HANN)
+#define RANGEPROC_WINDOW        gRangeWindowHann
+#elif (APP_RANGE_WINDOW == RANGE_WINDOW_HAMMING)
+#define RANGEPROC_WINDOW        gRangeWindowHamming
+#elif (APP_RANGE_WINDOW == RANGE_WINDOW_BLACKMAN)
+#define RANGEPROC_WINDOW        gRangeWindowBlackman
+#elif (APP_RANGE_WINDOW == RANGE_WINDOW_BLACKMAN_HARRIS)
+#define RANGEPROC_WINDOW        gRangeWindowBlackmanHarris
+#elif (APP_RANGE_WINDOW == RANGE_WINDOW_KAISER)
+#define RANGEPROC_WINDOW        gRangeWindowKaiser
+#else
+#error "APP_RANGE_WINDOW must be one of the RANGE_WINDOW_* types of range_window.h"
+#endif
+
+/**
+ * @brief Range bins of the range region of interest (APP_RANGE_ROI_*) for a sensor configuration.
+ *
+ * Range bin size: c * f_s / (2 * S * N_fft) with the ADC sampling rate f_s, the chirp slope S and the size of
+ * the range FFT N_fft (real ADC samples, the zero-padding makes the bins finer).
+ *
+ * @return SystemP_SUCCESS, SystemP_FAILURE if the ROI lies outside of the range bins (logged).
+ */
+static int32_t rangeRoi_compute(const SensorConfig *cfg, FrameProto_RangeRoi *roi) {
+    float    sampleRateMhz = 100.0f / (float) cfg->digOutputSampRate;
+    float    binSizeM = (3.0e8f * sampleRateMhz * 1.0e6f) /
+                        (2.0f * cfg->chirpRfFreqSlope * 1.0e12f * (float) RANGEPROC_FFT_SIZE);
+    int32_t  numBins  = (int32_t) RANGEPROC_NUM_RBINS;
+    int32_t  startBin = APP_RANGE_ROI_START_BIN;
+    int32_t  stopBin  = (APP_RANGE_ROI_STOP_BIN < 0) ? (numBins - 1) : APP_RANGE_ROI_STOP_BIN;
+
+    if (APP_RANGE_ROI_MAX_M > 0.0f) {
+        startBin = (int32_t) floorf(APP_RANGE_ROI_MIN_M / binSizeM);
+        stopBin  = (int32_t) ceilf(APP_RANGE_ROI_MAX_M / binSizeM);
+        startBin = (startBin < 0) ? 0 : startBin;
+        stopBin  = (stopBin > numBins - 1) ? (numBins - 1) : stopBin;
+    }
+    if ((startBin < 0) || (startBin > stopBin) || (stopBin >= numBins)) {
+        DebugP_log("Error: range ROI %d..%d outside of the %d range bins\n", startBin, stopBin, numBins);
+        return SystemP_FAILURE;
+    }
+    roi->startBin          = (uint16_t) startBin;
+    roi->numBins           = (uint16_t) (stopBin + 1 - startBin);
+    roi->numRangeBinsTotal = (uint16_t) numBins;
+    roi->reserved          = 0U;
+    roi->binSizeUm         = (uint32_t) (binSizeM * 1.0e6f + 0.5f);
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Range bins of the range region of interest of the running configuration, fills gRangeRoi.
+ */
+static void rangeRoi_config(void) {
+    if (rangeRoi_compute(&gSysContext.sensorCfg, &gRangeRoi) != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    DebugP_log("Range ROI: bins %u..%u of %u (%u um per bin)\n", gRangeRoi.startBin,
+               gRangeRoi.startBin + gRangeRoi.numBins - 1U, gRangeRoi.numRangeBinsTotal, gRangeRoi.binSizeUm);
+}
+
+/**
+ * @brief Range window for the DPU: the table of range_window.h, scaled down by APP_CHIRP_ACCUM_WINDOW_SHIFT with
+ *        hardware chirp accumulation.
+ *
+ * @return Window in flash, or its scaled copy in the core local memory pool (reset with the configuration).
+ */
+static int32_t *rangeWindow_config(void) {
+    uint32_t  shift;
+    uint32_t *window;
+    uint32_t  i;
+
+    if (SensorConfig_numChirpsAccum(&gSysContext.sensorCfg) == 1U) {
+        return (int32_t *) (uintptr_t) RANGEPROC_WINDOW;
+    }
+    shift = (APP_CHIRP_ACCUM_WINDOW_SHIFT < 0) ? SensorConfig_accumGrowthBits(&gSysContext.sensorCfg) :
+                                                 (uint32_t) APP_CHIRP_ACCUM_WINDOW_SHIFT;
+    if (shift == 0U) {
+        return (int32_t *) (uintptr_t) RANGEPROC_WINDOW;
+    }
+
+    window = (uint32_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj, sizeof(uint32_t) * RANGE_WINDOW_LEN,
+                                                  sizeof(uint32_t));
+    if (window == NULL) {
+        DebugP_log("Error: no memory for the scaled range window\n");
+        DebugP_assert(0);
+    }
+    for (i = 0; i < RANGE_WINDOW_LEN; i++) {
+        window[i] = (RANGEPROC_WINDOW[i] + (1U << (shift - 1U))) >> shift;
+    }
+    DebugP_log("Range window: %u accumulated chirps, scaled by 2^-%u\n",
+               SensorConfig_numChirpsAccum(&gSysContext.sensorCfg), shift);
+    return (int32_t *) window;
+}
+
 void RangeProc_config() {
     DPU_RangeProcHWA_HW_Resources *pHwConfig = &gSysContext.rangeProcDpuCfg.hwRes;
     DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
@@ -176,8 +1625,8 @@ void RangeProc_config() {
 
     memset((void *)&gSysContext.rangeProcDpuCfg, 0, sizeof(DPU_RangeProcHWA_Config));
 
-    // disable low power mode
-    params->lowPowerMode = 0;
+    // low power mode (APP_DPU_LOW_POWER_MODE): the DPU restores its HWA and EDMA configuration for every frame
+    params->lowPowerMode = APP_DPU_LOW_POWER_MODE;
 
     /*
       For values refer to "Sensor front-end parameters" in:
@@ -187,19 +1636,34 @@ void RangeProc_config() {
     params->numTxAntennas = gSysContext.numTxAntennas;
     /* number of RX antennas, product of TX- and RX-antennas (on the IWRL6432BOOST 2*3=6) */
     params->numVirtualAntennas = gSysContext.numTxAntennas * gSysContext.numRxAntennas;
-    /* size of real part of range FFT: half of the range FFT size, since the ADC samples are real valued*/
-    params->numRangeBins = CLI_NUM_RBINS; //CLI_NUM_ADC_SAMPLES/2;
-    /* number of chirps per frame (= number of chirps per burst, if Nburst = 1) */
-    params->numChirpsPerFrame = CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST;
+    /* range bins written by the DPU: half of the range FFT size, since the ADC samples are real valued, cut after the
+       range region of interest (APP_RANGE_ROI_*), which shortens the EDMA output. The bins in front of the ROI are
+       dropped by rangeRoi_compact() */
+    rangeRoi_config();
+    params->numRangeBins = gRangeRoi.startBin + gRangeRoi.numBins; // CLI_NUM_RBINS without zero-padding and ROI
+    /* number of chirps of ADC data per frame (= number of chirps per burst, if Nburst = 1): with hardware chirp
+       accumulation the front end delivers one chirp per numOfChirpsAccum chirps of a burst */
+    params->numChirpsPerFrame = SensorConfig_numAdcChirps(&gSysContext.sensorCfg);
     /* number of doppler chirps per frame (derived from rangeproc init example): one doppler chirp each set of TX antennas */
     params->numDopplerChirpsPerFrame = params->numChirpsPerFrame / gSysContext.numTxAntennas;
-    /* number of doppler chirps per processing evolution: only differs from numDopplerChirpsPerFrame with minor motion mode*/
+    /* number of doppler chirps per processing evolution: only differs from numDopplerChirpsPerFrame with minor motion mode,
+       where it is the number of Doppler chirps of the minor motion radar cube */
+#if APP_MINOR_MOTION_ENABLE
+    if ((APP_MINOR_MOTION_CHIRPS_PER_FRAME % gSysContext.numTxAntennas != 0U) ||
+        (APP_MINOR_MOTION_CHIRPS_PER_FRAME > params->numChirpsPerFrame)) {
+        DebugP_log("Error: APP_MINOR_MOTION_CHIRPS_PER_FRAME must be a multiple of the TX antennas within the frame\n");
+        DebugP_assert(0);
+    }
+    params->numDopplerChirpsPerProc = (APP_MINOR_MOTION_CHIRPS_PER_FRAME / gSysContext.numTxAntennas) *
+                                      APP_MINOR_MOTION_NUM_FRAMES;
+#else
     params->numDopplerChirpsPerProc = params->numDopplerChirpsPerFrame;
+#endif
     /* BPM / TDM MIMO enable */
-    if ((CLI_MIMO_SEL == 1) || (CLI_MIMO_SEL == 0)) {
+    if ((gSysContext.sensorCfg.chirpTxMimoPatSel == 1U) || (gSysContext.sensorCfg.chirpTxMimoPatSel == 0U)) {
         /* TDM-MIMO*/
         params->isBpmEnabled = FALSE;
-    } else if (CLI_MIMO_SEL == 4) {
+    } else if (gSysContext.sensorCfg.chirpTxMimoPatSel == 4U) {
         /* BPM-MIMO*/
         params->isBpmEnabled = TRUE;
     } else {
@@ -207,16 +1671,11 @@ void RangeProc_config() {
         exit(1);    
     }
 
-    /* windowing */
-    params->windowSize = sizeof(uint32_t) * ((CLI_NUM_ADC_SAMPLES +1 ) / 2); // symmetric window (Blackman), for real samples (therefore /2)
-    params->window =  (int32_t *)DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj,
-                                                        params->windowSize,
-                                                        sizeof(uint32_t));
-
-    if (params->window == NULL) {
-        DebugP_log("Error allocating window memory");
-        return;
-    }
+    /* windowing: first half of the symmetric window, for real samples (therefore /2). The table is const in flash,
+       the DPU only reads it to load the HWA window RAM during configuration, so no RAM copy is needed unless it is
+       scaled for hardware chirp accumulation (APP_CHIRP_ACCUM_WINDOW_SHIFT) */
+    params->windowSize = sizeof(uint32_t) * RANGE_WINDOW_LEN;
+    params->window = rangeWindow_config();
 
     /* adc buffer buffer, format fixed, interleave, size will change */
     params->ADCBufData.dataProperty.dataFmt = DPIF_DATAFORMAT_REAL16;
@@ -227,24 +1686,20 @@ void RangeProc_config() {
 
     /* dataSize defines the size of buffer that holds ADC data of every frame */
     /* ADCBufData.dataSize omitted due to forum post: https://e2e.ti.com/support/sensors-group/sensors/f/sensors-forum/1324580/awrl6432boost-adc-buffer-data-size-in-motion-and-presence-detection-demo */
-    params->ADCBufData.dataSize = CLI_NUM_ADC_SAMPLES * gSysContext.numRxAntennas * sizeof(uint16_t) * 2; // times 2, because of ping and pong C:\ti\mmwave-sdk\docs\MotionPresenceDetectionDemo_documentation.pdf 
-    params->ADCBufData.dataProperty.numAdcSamples = CLI_NUM_ADC_SAMPLES;
-    
-    mathUtils_genWindow((uint32_t *)params->window,
-                                (uint32_t) params->ADCBufData.dataProperty.numAdcSamples,
-                                params->windowSize/sizeof(uint32_t),
-                                MATHUTILS_WIN_BLACKMAN,
-                                DPC_OBJDET_QFORMAT_RANGE_FFT);
+    params->ADCBufData.dataSize = gSysContext.sensorCfg.numOfAdcSamples * gSysContext.numRxAntennas * sizeof(uint16_t) * 2; // times 2, because of ping and pong C:\ti\mmwave-sdk\docs\MotionPresenceDetectionDemo_documentation.pdf 
+    params->ADCBufData.dataProperty.numAdcSamples = gSysContext.sensorCfg.numOfAdcSamples;
+
 
     /* FFT optimizing params (derived from rangeproc DPU example) */
     params->rangeFFTtuning.fftOutputDivShift = 2;
     params->rangeFFTtuning.numLastButterflyStagesToScale = 0; /* no scaling needed as ADC is 16-bit and we have 8 bits to grow */  
 
-    /* size of range FFT: equal to number of ADC samples*/
-    params->rangeFftSize = CLI_NUM_ADC_SAMPLES;
+    /* size of range FFT: number of ADC samples rounded up to a power of 2, zero-padded by APP_RANGE_FFT_ZERO_PAD
+       (the HWA reads numAdcSamples and fills the rest of the FFT input with zeros) */
+    params->rangeFftSize = RANGEPROC_FFT_SIZE;
 
     /* bytes per RX channel (each chirp is uint_16) */
-    bytesPerRxChan = CLI_NUM_ADC_SAMPLES * sizeof(uint16_t);
+    bytesPerRxChan = gSysContext.sensorCfg.numOfAdcSamples * sizeof(uint16_t);
     bytesPerRxChan = (bytesPerRxChan + 15) / 16 * 16; // ensure that value is multiple of 16 (for EDMA?)
 
     /* initialize RX channel offsets */
@@ -258,8 +1713,20 @@ void RangeProc_config() {
 
     /* Set Motion Mode (Minor/Major) */
     params->enableMajorMotion = 1;
+#if APP_MINOR_MOTION_ENABLE
+    /* the first chirps of every frame also go into the minor motion radar cube, at the frame slot (frame counter
+       modulo APP_MINOR_MOTION_NUM_FRAMES), so the cube always holds the last frames. This relies on the SDK DPU
+       taking frmCntrModNumFramesPerMinorMot as the slot of the next frame in DPU_RangeProcHWA_config() and advancing
+       its own copy after every frame; a reconfiguration restarts it from the configured value. The DPC mirrors the
+       slot in gSysContext.minorMotionFrameSlot and loads it whenever it reconfigures the DPU between frames
+       (cubeRing_publish()), a new configuration starts at slot 0 */
+    params->enableMinorMotion = 1;
+    params->numMinorMotionChirpsPerFrame = APP_MINOR_MOTION_CHIRPS_PER_FRAME;
+    params->frmCntrModNumFramesPerMinorMot = 0;
+#else
     params->enableMinorMotion = 0;
-    params->numMinorMotionChirpsPerFrame = 0; // obsolete, not using minor motion
+    params->numMinorMotionChirpsPerFrame = 0; // not using minor motion
+#endif
 
     /* Data Input EDMA */
     pHwConfig->edmaInCfg.dataIn.channel         = DPC_OBJDET_DPU_RANGEPROC_EDMAIN_CH;
@@ -303,15 +1770,54 @@ void RangeProc_config() {
    
     /* radar cube config*/
     /* total size of radar cube in bytes (num range bins x num virtual antennas x sizeof x num doppler chirps) */
-    pHwConfig->radarCube.dataSize = CLI_NUM_RBINS * params->numVirtualAntennas * sizeof(cmplx16ReIm_t) * params->numDopplerChirpsPerFrame;
+    pHwConfig->radarCube.dataSize = params->numRangeBins * params->numVirtualAntennas * sizeof(cmplx16ReIm_t) * params->numDopplerChirpsPerFrame;
     pHwConfig->radarCube.datafmt = DPIF_RADARCUBE_FORMAT_6;
 
         /* radar cube */
+#if (APP_CUBE_RING_DEPTH > 0) && (APP_CUBE_RING_PROFILES == 0)
+    cubeRing_alloc(params->numDopplerChirpsPerFrame, params->numVirtualAntennas, gRangeRoi.numBins);
+    CubeRing_writeView(&gSysContext.cubeRing, &gSysContext.radarCube);
+    if (gRangeRoi.startBin == 0U) {
+        // the DPU writes into the write slot of the ring of radar cubes, which moves on with every frame
+        gSysContext.rangeProcDpuCfg.hwRes.radarCube.data = gSysContext.radarCube.data;
+    } else {
+        // the DPU writes into its own buffer, rangeRoi_compact() moves the ROI into the write slot
+        gSysContext.rangeProcDpuCfg.hwRes.radarCube.data = (cmplx16ImRe_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                                                        pHwConfig->radarCube.dataSize,
+                                                                                        sizeof(uint32_t));
+    }
+#else
     gSysContext.rangeProcDpuCfg.hwRes.radarCube.data  = (cmplx16ImRe_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
                                                                                         pHwConfig->radarCube.dataSize,
                                                                                         sizeof(uint32_t));
+    // the ROI is moved to the start of the DPU output, in place
+    RadarCube_initView(&gSysContext.radarCube, gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                       params->numDopplerChirpsPerFrame, params->numVirtualAntennas, gRangeRoi.numBins);
+#endif
     // bend global radar cube debug pointer to radar cube data 
     gRadarCubeDebugPtr = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+    // views on the DPU output and the radar cube of the ROI: Cube[chirp][antenna][range]
+    RadarCube_initView(&gSysContext.rangeProcOutput, gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                       params->numDopplerChirpsPerFrame, params->numVirtualAntennas, params->numRangeBins);
+    gSysContext.radarCube.rangeOffset = gRangeRoi.startBin;
+#if APP_MINOR_MOTION_ENABLE
+    /* minor motion radar cube: same layout as the DPU output, numDopplerChirpsPerProc chirps */
+    pHwConfig->radarCubeMinMot.dataSize = params->numRangeBins * params->numVirtualAntennas * sizeof(cmplx16ReIm_t) * params->numDopplerChirpsPerProc;
+    pHwConfig->radarCubeMinMot.datafmt = DPIF_RADARCUBE_FORMAT_6;
+    pHwConfig->radarCubeMinMot.data = (cmplx16ImRe_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
+                                                                             pHwConfig->radarCubeMinMot.dataSize,
+                                                                             sizeof(uint32_t));
+    if ((pHwConfig->radarCube.data == NULL) || (pHwConfig->radarCubeMinMot.data == NULL)) {
+        DebugP_log("Error allocating radar cube memory\n");
+        DebugP_assert(0);
+    }
+    RadarCube_initView(&gSysContext.radarCubeMinor, pHwConfig->radarCubeMinMot.data,
+                       params->numDopplerChirpsPerProc, params->numVirtualAntennas, params->numRangeBins);
+#endif
+    if ((APP_TX_CHIRP_IDX >= gSysContext.radarCube.numChirps) || (APP_TX_ANTENNA_IDX >= gSysContext.radarCube.numAntennas)) {
+        DebugP_log("Error: transmitted chirp/antenna outside of the radar cube\n");
+        DebugP_assert(0);
+    }
     /* Further non EDMA related HWA configurations */
     pHwConfig->hwaCfg.paramSetStartIdx = 0;
     pHwConfig->hwaCfg.numParamSet = DPU_RANGEPROCHWA_NUM_HWA_PARAM_SETS;
@@ -410,7 +1916,7 @@ static void frameStartISR(void *arg) {
     HwiP_clearInt(CSL_APPSS_INTR_FECSS_FRAMETIMER_FRAME_START);
 
     /* Record the frame start time for profiling or other processing */
-    // demoStartTime = PRCMSlowClkCtrGet();
+    gFrameStartTime = Cycleprofiler_getTimeStamp();
     gFrameCount++;
     /* Optionally, perform any other frame processing needed here */
     // For example, you might calculate the frame period or process the data further.
@@ -0,0 +1,251 @@
+/**
+ * @file sensor_config.c
+ * @brief Sensor front-end configuration held at run time and its .cfg parser (see sensor_config.h).
+ *
+ * Only depends on the C standard library, so this file is shared between the
+ * firmware and the host tools in `host/`.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sensor_config.h"
+
+/* parameter types of the .cfg commands */
+#define PARAM_U8        (0U)
+#define PARAM_U16       (1U)
+#define PARAM_U32       (2U)
+#define PARAM_FLOAT     (3U)
+#define PARAM_IGNORED   (4U)    /* checked against max, not stored */
+
+/* largest magnitude of a float parameter, beyond any time, frequency or slope of the device */
+#define PARAM_FLOAT_MAX (1.0e7)
+
+/* one parameter of a command: field of SensorConfig, type and largest value of an integer */
+typedef struct SensorConfig_Param_t
+{
+    uint16_t offset;
+    uint8_t  type;
+    uint32_t max;
+} SensorConfig_Param;
+
+typedef struct SensorConfig_CommandDesc_t
+{
+    const char               *name;
+    SensorConfig_Command      cmd;
+    const SensorConfig_Param *params;
+    uint32_t                  numParams;
+} SensorConfig_CommandDesc;
+
+#define PARAM(field, type, max)     { (uint16_t) offsetof(SensorConfig, field), (type), (max) }
+#define PARAM_SKIP(max)             { 0U, PARAM_IGNORED, (max) }
+#define COMMAND(name, cmd, params)  { (name), (cmd), (params), sizeof(params) / sizeof((params)[0]) }
+
+/* parameters in the order of the .cfg file (CONFIG_STRUCTURE of chirp_config_to_defines.py) */
+static const SensorConfig_Param gChannelParams[] = {
+    PARAM(rxChCtrlBitMask, PARAM_U16, 0xFFFFU),
+    PARAM(txChCtrlBitMask, PARAM_U16, 0xFFFFU),
+    PARAM(miscCtrl, PARAM_U16, 0xFFFFU)
+};
+
+static const SensorConfig_Param gChirpComnParams[] = {
+    PARAM(digOutputSampRate, PARAM_U8, 0xFFU),
+    PARAM(digOutputBitsSel, PARAM_U8, 0xFFU),
+    PARAM(dfeFirSel, PARAM_U8, 0xFFU),
+    PARAM(numOfAdcSamples, PARAM_U16, 0xFFFFU),
+    PARAM(chirpTxMimoPatSel, PARAM_U8, 0xFFU),
+    PARAM(chirpRampEndTime, PARAM_FLOAT, 0U),
+    PARAM(chirpRxHpfSel, PARAM_U8, 0xFFU)
+};
+
+static const SensorConfig_Param gChirpTimingParams[] = {
+    PARAM(chirpIdleTime, PARAM_FLOAT, 0U),
+    PARAM(chirpAdcSkipSamples, PARAM_U16, 0xFFFFU),
+    PARAM(chirpTxStartTime, PARAM_FLOAT, 0U),
+    PARAM(chirpRfFreqSlope, PARAM_FLOAT, 0U),
+    PARAM(chirpRfFreqStart, PARAM_FLOAT, 0U)
+};
+
+static const SensorConfig_Param gFrameParams[] = {
+    PARAM(numOfChirpsInBurst, PARAM_U16, 0xFFFFU),
+    PARAM(numOfChirpsAccum, PARAM_U8, 0xFFU),
+    PARAM(burstPeriodicity, PARAM_FLOAT, 0U),
+    PARAM(numOfBurstsInFrame, PARAM_U16, 0xFFFFU),
+    PARAM(framePeriodicity, PARAM_FLOAT, 0U),
+    PARAM(numOfFrames, PARAM_U16, 0xFFFFU)
+};
+
+static const SensorConfig_Param gFactoryCalibParams[] = {
+    PARAM_SKIP(1U),                         /* saveEnable */
+    PARAM_SKIP(1U),                         /* restoreEnable */
+    PARAM(rxGain, PARAM_U8, 0xFFU),
+    PARAM(txBackoff, PARAM_U8, 0xFFU),
+    PARAM(flashOffset, PARAM_U32, 0xFFFFFFFFU)
+};
+
+static const SensorConfig_Param gSensorStartParams[] = {
+    PARAM(frameTrigMode, PARAM_U8, 0xFFU),
+    PARAM(chirpStartSigLbEn, PARAM_U8, 0xFFU),
+    PARAM(frameLivMonEn, PARAM_U8, 0xFFU),
+    PARAM(frameTrigTimerVal, PARAM_U32, 0xFFFFFFFFU)
+};
+
+static const SensorConfig_CommandDesc gCommands[] = {
+    COMMAND("channelCfg", SENSOR_CONFIG_CMD_CHANNEL, gChannelParams),
+    COMMAND("chirpComnCfg", SENSOR_CONFIG_CMD_CHIRP_COMN, gChirpComnParams),
+    COMMAND("chirpTimingCfg", SENSOR_CONFIG_CMD_CHIRP_TIMING, gChirpTimingParams),
+    COMMAND("frameCfg", SENSOR_CONFIG_CMD_FRAME, gFrameParams),
+    COMMAND("factoryCalibCfg", SENSOR_CONFIG_CMD_FACTORY_CALIB, gFactoryCalibParams),
+    COMMAND("sensorStart", SENSOR_CONFIG_CMD_SENSOR_START, gSensorStartParams)
+};
+
+static inline int SensorConfig_isBlank(char c) {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+static inline int SensorConfig_isDigit(char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+/* parses the token [token, end) into the field of param */
+static int32_t SensorConfig_parseParam(SensorConfig *cfg, const SensorConfig_Param *param, const char *token,
+                                       const char *end) {
+    uint8_t *field = (uint8_t *) cfg + param->offset;
+    char    *stop;
+
+    if (param->type == PARAM_FLOAT) {
+        double value = strtod(token, &stop);
+        float  f;
+
+        /* also rejects nan, which fails every comparison */
+        if ((stop != end) || !((value >= -PARAM_FLOAT_MAX) && (value <= PARAM_FLOAT_MAX))) {
+            return SENSOR_CONFIG_EINVAL;
+        }
+        f = (float) value;
+        memcpy(field, &f, sizeof(f));
+    } else {
+        unsigned long value;
+        int           hex = (token[0] == '0') && ((token[1] == 'x') || (token[1] == 'X'));
+
+        /* no sign, which strtoul() would accept and wrap around */
+        if (!SensorConfig_isDigit(token[0])) {
+            return SENSOR_CONFIG_EINVAL;
+        }
+        value = strtoul(token, &stop, hex ? 16 : 10);
+        if ((stop != end) || (value > param->max)) {
+            return SENSOR_CONFIG_EINVAL;
+        }
+        if (param->type == PARAM_U8) {
+            uint8_t v = (uint8_t) value;
+            memcpy(field, &v, sizeof(v));
+        } else if (param->type == PARAM_U16) {
+            uint16_t v = (uint16_t) value;
+            memcpy(field, &v, sizeof(v));
+        } else if (param->type == PARAM_U32) {
+            uint32_t v = (uint32_t) value;
+            memcpy(field, &v, sizeof(v));
+        }
+    }
+    return SENSOR_CONFIG_SUCCESS;
+}
+
+int32_t SensorConfig_check(const SensorConfig *cfg) {
+    uint32_t numTx, numChirps;
+    float    chirpTimeUs;
+
+    if ((cfg->rxChCtrlBitMask == 0U) || (cfg->rxChCtrlBitMask >= (1U << SENSOR_CONFIG_NUM_RX)) ||
+        (cfg->txChCtrlBitMask == 0U) || (cfg->txChCtrlBitMask >= (1U << SENSOR_CONFIG_NUM_TX))) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+    numTx = SensorConfig_numChannels(cfg->txChCtrlBitMask);
+    if (((cfg->chirpTxMimoPatSel != 0U) && (cfg->chirpTxMimoPatSel != 1U) && (cfg->chirpTxMimoPatSel != 4U)) ||
+        ((cfg->chirpTxMimoPatSel == 4U) && (numTx != SENSOR_CONFIG_NUM_TX))) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+
+    /* the accumulated chirps of a chirp of ADC data lie within one burst */
+    numChirps = SensorConfig_numAdcChirps(cfg);
+    if ((cfg->numOfAdcSamples == 0U) || (numChirps == 0U) || ((numChirps % numTx) != 0U) ||
+        ((cfg->numOfChirpsInBurst % SensorConfig_numChirpsAccum(cfg)) != 0U) ||
+        (cfg->digOutputSampRate == 0U) || !(cfg->chirpRfFreqSlope > 0.0f) || !(cfg->chirpRampEndTime > 0.0f) ||
+        !(cfg->burstPeriodicity > 0.0f) || !(cfg->framePeriodicity > 0.0f)) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+
+    /* chirp within the band: the slope in MHz/us over the ramp gives the bandwidth in MHz */
+    if ((cfg->chirpRfFreqStart < SENSOR_CONFIG_MIN_FREQ_GHZ) ||
+        (cfg->chirpRfFreqStart + cfg->chirpRfFreqSlope * cfg->chirpRampEndTime / 1000.0f > SENSOR_CONFIG_MAX_FREQ_GHZ)) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+
+    /* chirps of a burst within the burst period (us), bursts within the frame period (ms) */
+    chirpTimeUs = cfg->chirpIdleTime + cfg->chirpRampEndTime;
+    if (((float) cfg->numOfChirpsInBurst * chirpTimeUs > cfg->burstPeriodicity) ||
+        ((float) cfg->numOfBurstsInFrame * cfg->burstPeriodicity > cfg->framePeriodicity * 1000.0f)) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+    return SENSOR_CONFIG_SUCCESS;
+}
+
+int32_t SensorConfig_parseLine(SensorConfig *cfg, const char *line, SensorConfig_Command *cmd) {
+    const SensorConfig_CommandDesc *desc = NULL;
+    const char                     *token[SENSOR_CONFIG_MAX_PARAMS + 1U];
+    const char                     *end[SENSOR_CONFIG_MAX_PARAMS + 1U];
+    const char                     *c = line;
+    SensorConfig                    parsed;
+    uint32_t                        numTokens = 0U, i;
+
+    *cmd = SENSOR_CONFIG_CMD_NONE;
+    if (strlen(line) > SENSOR_CONFIG_MAX_LINE_LEN + 2U) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+
+    /* split into command and parameters */
+    while (*c != '\0') {
+        while (SensorConfig_isBlank(*c)) {
+            c++;
+        }
+        if ((*c == '\0') || ((numTokens == 0U) && (*c == '%'))) {
+            break;
+        }
+        if (numTokens == SENSOR_CONFIG_MAX_PARAMS + 1U) {
+            return SENSOR_CONFIG_EINVAL;
+        }
+        token[numTokens] = c;
+        while ((*c != '\0') && !SensorConfig_isBlank(*c)) {
+            c++;
+        }
+        end[numTokens++] = c;
+    }
+    if (numTokens == 0U) {
+        return SENSOR_CONFIG_SUCCESS;
+    }
+
+    for (i = 0; i < sizeof(gCommands) / sizeof(gCommands[0]); i++) {
+        size_t len = strlen(gCommands[i].name);
+
+        if (((size_t) (end[0] - token[0]) == len) && (strncmp(token[0], gCommands[i].name, len) == 0)) {
+            desc = &gCommands[i];
+            break;
+        }
+    }
+    if (desc == NULL) {
+        *cmd = SENSOR_CONFIG_CMD_UNKNOWN;
+        return SENSOR_CONFIG_SUCCESS;
+    }
+    *cmd = desc->cmd;
+    if (numTokens - 1U != desc->numParams) {
+        return SENSOR_CONFIG_EINVAL;
+    }
+
+    /* into a copy, so a bad parameter leaves the configuration as it was */
+    memcpy(&parsed, cfg, sizeof(SensorConfig));
+    for (i = 0; i < desc->numParams; i++) {
+        if (SensorConfig_parseParam(&parsed, &desc->params[i], token[i + 1U], end[i + 1U]) != SENSOR_CONFIG_SUCCESS) {
+            return SENSOR_CONFIG_EINVAL;
+        }
+    }
+    memcpy(cfg, &parsed, sizeof(SensorConfig));
+    return SENSOR_CONFIG_SUCCESS;
+}
@@ -12,7 +12,21 @@
  *
  * The function `uart_transmit_loop()` runs continuously, waiting for
  * `uart_tx_start_sem` to be posted, transmitting radar cube data, and posting
- * `uart_tx_done_sem` upon completion.
+ * `uart_tx_done_sem` upon completion. Each frame (header, TLVs and CRC, see
+ * frame_protocol.h) is completed in a transmit buffer and sent with a single
+ * UART_write(), which is carried out by the EDMA (see `uart1.intrEnable` in
+ * example.syscfg).
+ *
+ * The transmitted data is not read from the radar cube directly: the DPC
+ * assembles frame header and TLVs in one of two snapshot buffers
+ * (`gUartTxSnapshots`) via `uart_beginFrame()`, `uart_addTlv()` and
+ * `uart_commitFrame()`, the UART task only appends the transmission statistics
+ * and the CRC. With APP_PIPELINED_TX the DPC does not wait for the
+ * transmission, so processing and transmission overlap and `uart_tx_done_sem`
+ * is not posted.
+ *
+ * The receive direction of the same UART carries the .cfg commands of the CLI
+ * task (cli.c), read one byte at a time with `uart_receiveByte()`.
  *
  * @note This module relies on the SemaphoreP API from the kernel/dpl library
  *       for synchronization.
@@ -24,36 +38,193 @@
 #include <kernel/dpl/DebugP.h>
 #include <utils/mathutils/mathutils.h>
 #include "kernel/dpl/SemaphoreP.h"
+#include <kernel/dpl/CacheP.h>
+#include <kernel/dpl/HwiP.h>
+#include <kernel/dpl/ClockP.h>
 #include "ti_drivers_open_close.h"
 #include <datapath/dpu/rangeproc/v0/rangeprochwa.h>
 
 #include "system.h"
 #include "defines.h"
+#include "proc_config.h"
+#include "mem_pool.h"
+#include "frame_packer.h"
+#include "frame_protocol.h"
 #include "uart_transmit.h"
 
 
-#define APP_UART_BUFSIZE              (1024)
 #define APP_UART_RECEIVE_BUFSIZE      (8U)
 
+/*! @brief Alignment of the transmit buffer, which is read by the EDMA */
+#define APP_UART_TXBUF_ALIGN          (32U)
+
 
-uint8_t gUartBuffer[APP_UART_BUFSIZE];
 uint8_t gUartReceiveBuffer[APP_UART_RECEIVE_BUFSIZE];
 volatile uint32_t gNumBytesRead = 0U, gNumBytesWritten = 0U;
 
+UartTx_Snapshots gUartTxSnapshots;
+
+
+int32_t uart_allocSnapshots(MemPoolObj *pool, uint32_t maxTlvBytes) {
+    uint32_t numFramesQueued  = gUartTxSnapshots.numFramesQueued;
+    uint32_t numFramesSent    = gUartTxSnapshots.numFramesSent;
+    uint32_t numFramesDropped = gUartTxSnapshots.numFramesDropped;
+    uint32_t i;
+
+    memset((void *)&gUartTxSnapshots, 0, sizeof(UartTx_Snapshots));
+    // the statistics continue across reconfigurations (rangeProc_reconfigure())
+    gUartTxSnapshots.numFramesQueued  = numFramesQueued;
+    gUartTxSnapshots.numFramesSent    = numFramesSent;
+    gUartTxSnapshots.numFramesDropped = numFramesDropped;
+    gUartTxSnapshots.fillIdx  = -1;
+    gUartTxSnapshots.readyIdx = -1;
+    gUartTxSnapshots.busyIdx  = -1;
+    gUartTxSnapshots.bufSize  = sizeof(FrameProto_Header) + maxTlvBytes;
+
+    for (i = 0; i < UART_TX_NUM_SNAPSHOTS; i++) {
+        gUartTxSnapshots.buf[i] = (uint8_t *) DPC_ObjDet_MemPoolAlloc(pool, gUartTxSnapshots.bufSize, sizeof(uint32_t));
+        if (gUartTxSnapshots.buf[i] == NULL) {
+            DebugP_log("Error allocating UART snapshot memory");
+            return SystemP_FAILURE;
+        }
+    }
+
+    // snapshot plus the TLVs and the CRC added by the UART task
+    gUartTxSnapshots.txBufSize = gUartTxSnapshots.bufSize + FRAME_PROTO_TLV_SIZE(sizeof(FrameProto_TxStats)) +
+                                 FRAME_PROTO_CRC_SIZE;
+    gUartTxSnapshots.txBuf = (uint8_t *) DPC_ObjDet_MemPoolAlloc(pool, gUartTxSnapshots.txBufSize, APP_UART_TXBUF_ALIGN);
+    if (gUartTxSnapshots.txBuf == NULL) {
+        DebugP_log("Error allocating UART transmit buffer");
+        return SystemP_FAILURE;
+    }
+    return SystemP_SUCCESS;
+}
+
+int32_t uart_beginFrame(uint32_t frameCount, uint32_t timestamp) {
+    const RadarCube_View *cube = &gSysContext.radarCube;
+    FrameProto_Header     header;
+    uintptr_t             key;
+    int32_t               fillIdx;
+
+    key = HwiP_disable();
+    // fill the snapshot which is not being transmitted
+    fillIdx = (gUartTxSnapshots.busyIdx == 0) ? 1 : 0;
+    if (gUartTxSnapshots.readyIdx == fillIdx) {
+        // UART task did not pick up the previous frame in time, overwrite it
+        gUartTxSnapshots.readyIdx = -1;
+        gUartTxSnapshots.numFramesDropped++;
+    }
+    HwiP_restore(key);
+
+    memset((void *)&header, 0, sizeof(FrameProto_Header));
+    header.frameCount         = frameCount;
+    header.timestamp          = timestamp;
+    header.numRangeBins       = cube->numRangeBins;
+    header.numDopplerChirps   = cube->numChirps;
+    header.numVirtualAntennas = cube->numAntennas;
+
+    FramePacker_init(&gUartTxSnapshots.packer, gUartTxSnapshots.buf[fillIdx], gUartTxSnapshots.bufSize);
+    if (FrameProto_begin(&gUartTxSnapshots.packer, &header) != FRAME_PACKER_SUCCESS) {
+        gUartTxSnapshots.fillIdx = -1;
+        return SystemP_FAILURE;
+    }
+    gUartTxSnapshots.fillIdx = fillIdx;
+    return SystemP_SUCCESS;
+}
+
+void *uart_addTlv(uint32_t type, uint32_t length) {
+    if (gUartTxSnapshots.fillIdx < 0) {
+        return NULL;
+    }
+    return FrameProto_addTlv(&gUartTxSnapshots.packer, type, length);
+}
+
+int32_t uart_commitFrame(void) {
+    uintptr_t key;
+    int32_t   fillIdx = gUartTxSnapshots.fillIdx;
+
+    if (fillIdx < 0) {
+        return SystemP_FAILURE;
+    }
+    gUartTxSnapshots.len[fillIdx] = gUartTxSnapshots.packer.len;
+    gUartTxSnapshots.fillIdx      = -1;
+
+    key = HwiP_disable();
+    if (gUartTxSnapshots.readyIdx >= 0) {
+        // UART task has not taken up the other snapshot yet, it is replaced by this newer frame
+        gUartTxSnapshots.numFramesDropped++;
+    }
+    gUartTxSnapshots.readyIdx = fillIdx;
+    gUartTxSnapshots.numFramesQueued++;
+    HwiP_restore(key);
+
+    SemaphoreP_post(&uart_tx_start_sem);
+    return SystemP_SUCCESS;
+}
+
+
+/**
+ * @brief Signals the end of a transmission to the DPC, which only waits for it without APP_PIPELINED_TX.
+ */
+static void uart_signalDone(void) {
+    gUartTxSnapshots.txActive = 0U;
+#if (APP_PIPELINED_TX == 0)
+    SemaphoreP_post(&uart_tx_done_sem);
+#endif
+}
+
 /**
- * @brief Header and footer for each radarCube transmission over UART.
+ * @brief Completes the frame of a snapshot (see frame_protocol.h) in the transmit buffer.
  *
- * These markers are used to indicate the start and end of each radarCube 
- * data packet during UART transmission.
+ * @param[in] idx Index of the snapshot to transmit.
+ *
+ * @return Number of bytes of the completed frame, 0 if it does not fit into the transmit buffer.
  */
-const uint8_t header[4] = {0xAA, 0xBB, 0xCC, 0xDD};
-const uint8_t footer[4] = {0xDD, 0xCC, 0xBB, 0xAA};
+static uint32_t uart_packFrame(int32_t idx) {
+    FramePacker         packer;
+    FrameProto_TxStats *txStats;
+
+    FramePacker_init(&packer, gUartTxSnapshots.txBuf, gUartTxSnapshots.txBufSize);
+    if (FramePacker_append(&packer, gUartTxSnapshots.buf[idx], gUartTxSnapshots.len[idx]) != FRAME_PACKER_SUCCESS) {
+        return 0U;
+    }
 
+    /* transmission statistics */
+    txStats = (FrameProto_TxStats *) FrameProto_addTlv(&packer, FRAME_PROTO_TLV_TX_STATS, sizeof(FrameProto_TxStats));
+    if (txStats == NULL) {
+        return 0U;
+    }
+    txStats->numFramesQueued  = gUartTxSnapshots.numFramesQueued;
+    txStats->numFramesSent    = gUartTxSnapshots.numFramesSent;
+    txStats->numFramesDropped = gUartTxSnapshots.numFramesDropped;
+
+    return FrameProto_end(&packer);
+}
+
+int32_t uart_receiveByte(uint8_t *byte) {
+    UART_Transaction trans;
+
+    UART_Transaction_init(&trans);
+    trans.buf   = gUartReceiveBuffer;
+    trans.count = 1U;
+    if (UART_read(gUartHandle[CONFIG_UART_CONSOLE], &trans) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+    gNumBytesRead++;
+    *byte = gUartReceiveBuffer[0];
+    return SystemP_SUCCESS;
+}
+
+void uart_waitIdle(void) {
+    while ((gUartTxSnapshots.readyIdx >= 0) || (gUartTxSnapshots.txActive != 0U)) {
+        ClockP_usleep(1000U);
+    }
+}
 
 void uart_transmit_loop() {
-    cmplx16ImRe_t *radarCube = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
-    
     int32_t          transferOK;
+    int32_t          idx;
+    uintptr_t        key;
     UART_Transaction trans;
 
     UART_Transaction_init(&trans);
@@ -62,48 +233,43 @@ void uart_transmit_loop() {
     while(true) {
         SemaphoreP_pend(&uart_tx_start_sem, SystemP_WAIT_FOREVER);
 
-        gNumBytesWritten = 0U;
-        trans.buf   = &gUartBuffer[0U];
+        // take the latest snapshot, so the DPC fills the other one meanwhile
+        key = HwiP_disable();
+        idx = gUartTxSnapshots.readyIdx;
+        gUartTxSnapshots.readyIdx = -1;
+        gUartTxSnapshots.busyIdx  = idx;
+        gUartTxSnapshots.txActive = (idx >= 0) ? 1U : 0U;
+        HwiP_restore(key);
 
-        // send header
-        trans.buf = (void *) &header;
-        trans.count = 4;
-        transferOK = UART_write(gUartHandle[CONFIG_UART_CONSOLE], &trans);
-        if (transferOK != SystemP_SUCCESS){
-            DebugP_log("Uart Tx failed");
+        if (idx < 0) {
+            // frame has already been picked up with an earlier post
+            continue;
         }
 
-        // send actual radar cube data
-        // only send data of one virtual antenna though, because only range fft is transmitted for now.
-        uint32_t i;
-        for (i = 0; i < CLI_NUM_RBINS; i++) {
-
-            // data structure in radarCube:
-            // Cube[chirp][antenna][range]
+        gNumBytesWritten = uart_packFrame(idx);
 
-            // calculate address offset of rangebin
-            uint8_t chirp_index = 1;
-            uint8_t antenna_index = 0;
-            uint8_t rangebin_index = i;
+        // frame is in the transmit buffer now, the snapshot can be refilled
+        gUartTxSnapshots.busyIdx = -1;
 
-            uint32_t address_offset = (chirp_index * antenna_index * rangebin_index) + (antenna_index * rangebin_index) + rangebin_index;
-
-            trans.buf = (void *) &radarCube[address_offset];
-            trans.count = 4;
-            transferOK = UART_write(gUartHandle[CONFIG_UART_CONSOLE], &trans);
-            if (transferOK != SystemP_SUCCESS) {
-                DebugP_log("Uart Tx failed");
-            }
+        if (gNumBytesWritten == 0U) {
+            DebugP_log("Uart frame exceeds transmit buffer");
+            uart_signalDone();
+            continue;
         }
 
-        // send footer
-        trans.buf = (void *) &footer;
-        trans.count = 4;
+        // the frame is read by the EDMA, so make sure it has left the cache
+        CacheP_wb(gUartTxSnapshots.txBuf, gNumBytesWritten, CacheP_TYPE_ALL);
+
+        // send whole frame in one transaction
+        trans.buf   = gUartTxSnapshots.txBuf;
+        trans.count = gNumBytesWritten;
         transferOK = UART_write(gUartHandle[CONFIG_UART_CONSOLE], &trans);
         if (transferOK != SystemP_SUCCESS) {
             DebugP_log("Uart Tx failed");
+        } else {
+            gUartTxSnapshots.numFramesSent++;
         }
 
-        SemaphoreP_post(&uart_tx_done_sem);
+        uart_signalDone();
     }
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 import argparse
 import json
+import math
 import time
 import os
 import sys
@@ -20,6 +21,15 @@ CONFIG_STRUCTURE = {
 # name of the output file
 DEFINES_HEADER_NAME= "defines.h"
 
+# name of the window table file, written next to the defines header
+WINDOW_HEADER_NAME = "range_window.h"
+
+# Q-format of the range FFT window (DPC_OBJDET_QFORMAT_RANGE_FFT in rangeproc_dpc.h)
+WINDOW_QFORMAT = 17
+
+# default shape parameter of the Kaiser window
+KAISER_BETA_DEFAULT = 6.0
+
 def print_basic_config_info(data):
     """
     Print basic info calculated from parameters
@@ -200,6 +210,104 @@ def generate_defines_file(data, script_name, base_input, output_path):
         f.write(content)
 
 
+def window_value(window, n, length, beta):
+    """
+    Value of sample n of a symmetric window of the given length (as mathUtils_genWindow())
+    """
+    if length < 2:
+        return 1.0
+    x = 2.0 * math.pi * n / (length - 1)
+    if window == 'hann':
+        return 0.5 - 0.5 * math.cos(x)
+    if window == 'hamming':
+        return 0.54 - 0.46 * math.cos(x)
+    if window == 'blackman':
+        return 0.42 - 0.5 * math.cos(x) + 0.08 * math.cos(2.0 * x)
+    if window == 'blackman_harris':
+        return 0.35875 - 0.48829 * math.cos(x) + 0.14128 * math.cos(2.0 * x) - 0.01168 * math.cos(3.0 * x)
+    if window == 'kaiser':
+        # zeroth order modified Bessel function of the first kind
+        def i0(v):
+            total, term, k = 1.0, 1.0, 1
+            while term > 1e-12 * total:
+                term *= (v / (2.0 * k)) ** 2
+                total += term
+                k += 1
+            return total
+        r = 2.0 * n / (length - 1) - 1.0
+        return i0(beta * math.sqrt(max(0.0, 1.0 - r * r))) / i0(beta)
+    raise ValueError(f"unknown window '{window}'")
+
+
+def window_table(window, length, beta):
+    """
+    First half of a symmetric window in WINDOW_QFORMAT, rounded and limited as mathUtils_genWindow()
+    """
+    one = 1 << WINDOW_QFORMAT
+    return [min(int(math.floor(one * window_value(window, n, length, beta) + 0.5)), one - 1)
+            for n in range((length + 1) // 2)]
+
+
+def generate_window_file(data, script_name, base_input, output_path, beta):
+    """
+    Generate the C header file 'range_window.h' with the precomputed range FFT windows
+    """
+    timestamp = time.strftime("%Y-%m-%d %H:%M:%S")
+    num_samples = int(data['chirpComnCfg']['numOfAdcSamples'])
+    guard_macro = os.path.splitext(WINDOW_HEADER_NAME)[0].upper() + "_H"
+
+    tables = ""
+    for window, name in (('hann', 'Hann'), ('hamming', 'Hamming'), ('blackman', 'Blackman'),
+                         ('blackman_harris', 'BlackmanHarris'), ('kaiser', 'Kaiser')):
+        values = window_table(window, num_samples, beta)
+        rows = [", ".join(f"{v:6d}" for v in values[i:i + 8]) for i in range(0, len(values), 8)]
+        body = ",\n    ".join(rows)
+        tables += f"""
+static const uint32_t gRangeWindow{name}[RANGE_WINDOW_LEN] = {{
+    {body}
+}};
+"""
+
+    # skeleton for range_window.h file
+    content = f"""
+#ifndef {guard_macro}
+#define {guard_macro}
+
+/**
+ * @file {WINDOW_HEADER_NAME}
+ *
+ * @brief Precomputed windows of the range FFT.
+ *
+ * First half ((CLI_NUM_ADC_SAMPLES + 1) / 2 values) of symmetric windows over
+ * the ADC samples in Q{WINDOW_QFORMAT} (DPC_OBJDET_QFORMAT_RANGE_FFT), the layout the
+ * Rangeproc DPU loads into the HWA window RAM with hwaWinSym = 1. The window is
+ * selected with APP_RANGE_WINDOW in proc_config.h, the other tables are unused
+ * and dropped by the linker. Kaiser with beta = {beta}.
+ *
+ * This file was auto-generated by the script '{script_name}' from the config file '{base_input}' on {timestamp}
+ */
+
+#include <stdint.h>
+
+/* dimensions of the tables, must match defines.h */
+#define RANGE_WINDOW_NUM_SAMPLES     {num_samples}
+#define RANGE_WINDOW_LEN             {(num_samples + 1) // 2}
+#define RANGE_WINDOW_QFORMAT         {WINDOW_QFORMAT}
+
+/* window types (APP_RANGE_WINDOW) */
+#define RANGE_WINDOW_HANN            0
+#define RANGE_WINDOW_HAMMING         1
+#define RANGE_WINDOW_BLACKMAN        2
+#define RANGE_WINDOW_BLACKMAN_HARRIS 3
+#define RANGE_WINDOW_KAISER          4
+{tables}
+#endif /* {guard_macro} */
+"""
+    # write file to output path
+    with open(output_path, 'w') as f:
+        f.write(content)
+
+
 def print_usage(script_name):
     """
     Print usage instructions / information
@@ -210,9 +318,10 @@ Description:
   file from it. Please note that it only processes the commands and parameters which are used within the minimal
   RangeProc DPU implementation in this repo and ignores all the others. 
   TI mmWave Sensing Estimator: https://dev.ti.com/gallery/view/mmwave/mmWaveSensingEstimator/ver/2.4.1/
+  Next to it, {WINDOW_HEADER_NAME} with the precomputed range FFT windows for the number of ADC samples is written.
 
 Usage:
-  {script_name} <path to config .cfg or .json> [-o <output header file or directory>]
+  {script_name} <path to config .cfg or .json> [-o <output header file or directory>] [--kaiser-beta <beta>]
 
 """
     print(msg)
@@ -223,6 +332,7 @@ def main():
     parser = argparse.ArgumentParser(add_help=False)
     parser.add_argument('input_file', nargs='?', help="path to config file (.cfg or .json)")
     parser.add_argument('-o', '--output', help="path to output header file or directory", default=None)
+    parser.add_argument('--kaiser-beta', type=float, default=KAISER_BETA_DEFAULT, help="shape of the Kaiser window")
     parser.add_argument('-h', '--help', action='store_true', help="show help message and exit")
     args = parser.parse_args()
 
@@ -275,6 +385,9 @@ def main():
     # generate output file
     generate_defines_file(data, script_name, os.path.basename(args.input_file), final)
     print(f"generated header: {final}")
+    window_final = os.path.join(os.path.dirname(final), WINDOW_HEADER_NAME)
+    generate_window_file(data, script_name, os.path.basename(args.input_file), window_final, args.kaiser_beta)
+    print(f"generated header: {window_final}")
 
     # output some basic info about the config
     print_basic_config_info(data)
@@ -0,0 +1,70 @@
+"""
+Python binding of the C++ frame receiver (host/frame_receiver.hpp) via ctypes.
+
+Build the library from the repository root (see host/frame_receiver_capi.cpp):
+    g++ -O2 -Wall -shared -fPIC -pthread -I minimal_rangeproc_impl/include host/frame_receiver_capi.cpp \
+        -x c minimal_rangeproc_impl/src/frame_protocol.c minimal_rangeproc_impl/src/frame_packer.c -o libframe_receiver.so
+
+The library is searched in FRAME_RECEIVER_LIB, the current directory and the
+repository root. load() returns None if it is not available.
+"""
+
+import ctypes
+import os
+
+MAX_FRAME_LEN = 64 * 1024
+STATS_NAMES = ('bytes_received', 'bytes_skipped', 'frames_valid', 'header_errors',
+               'crc_errors', 'frames_lost', 'frames_dropped')
+
+
+def load():
+    candidates = [os.environ.get('FRAME_RECEIVER_LIB'),
+                  os.path.abspath('libframe_receiver.so'),
+                  os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'libframe_receiver.so')]
+    for path in candidates:
+        if path and os.path.exists(path):
+            lib = ctypes.CDLL(path)
+            lib.frx_open.restype = ctypes.c_void_p
+            lib.frx_open.argtypes = [ctypes.c_char_p, ctypes.c_long, ctypes.c_uint32]
+            lib.frx_next.restype = ctypes.c_int32
+            lib.frx_next.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint32, ctypes.c_int32]
+            lib.frx_stats.restype = None
+            lib.frx_stats.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64)]
+            lib.frx_close.restype = None
+            lib.frx_close.argtypes = [ctypes.c_void_p]
+            return lib
+    return None
+
+
+class FrameReceiver:
+    """
+    Receives validated frames (header, TLVs and CRC as bytes) in a background thread.
+    """
+
+    def __init__(self, lib, path, baud_rate, queue_depth=16):
+        self._lib = lib
+        self._handle = lib.frx_open(path.encode(), baud_rate, queue_depth)
+        if not self._handle:
+            raise OSError(f"cannot open {path}")
+        self._buf = ctypes.create_string_buffer(MAX_FRAME_LEN)
+
+    def next(self, timeout_ms=1000):
+        """
+        Returns the next frame, None on timeout. Raises EOFError at the end of the stream.
+        """
+        n = self._lib.frx_next(self._handle, self._buf, MAX_FRAME_LEN, timeout_ms)
+        if n == -1:
+            raise EOFError()
+        if n <= 0:
+            return None
+        return self._buf.raw[:n]
+
+    def stats(self):
+        values = (ctypes.c_uint64 * len(STATS_NAMES))()
+        self._lib.frx_stats(self._handle, values)
+        return dict(zip(STATS_NAMES, values))
+
+    def close(self):
+        if self._handle:
+            self._lib.frx_close(self._handle)
+            self._handle = None
@@ -0,0 +1,346 @@
+"""
+Memory-mapped reader of frame recordings (written by host/frame_record.cpp,
+format in host/recording_format.h).
+
+Nothing is read up front: data file and index are mapped with numpy.memmap and
+frames are returned as views into the mapping, so recordings of any length can
+be opened instantly and only the accessed pages are loaded.
+
+Usage:
+    python recording.py capture.rec          # prints a summary
+
+    rec = Recording('capture.rec')
+    rec.frame(i)                # bytes of frame i (numpy uint8 view)
+    rec.range_profiles()        # (frames, bins, 2) int16 view, [..., 0] imag, [..., 1] real
+    rec.heatmap(i)              # (range bins, doppler bins) uint16 view of frame i
+    rec.integrated_profile(i)   # power in dB per range bin, integrated over chirps and antennas
+    rec.peaks(i)                # strongest peaks of the range profile of frame i
+    rec.duty_cycle(i)           # acquisition, processing and idle time of the frame before frame i
+"""
+
+import struct
+import sys
+
+import numpy as np
+
+HEADER_FORMAT = '<8s4IQ9I6fI64s'
+CONFIG_NAMES = ('num_adc_samples', 'num_range_bins', 'rx_channel_mask', 'tx_channel_mask',
+                'num_virtual_antennas', 'num_chirps_per_burst', 'num_bursts_per_frame',
+                'num_doppler_chirps', 'num_chirps_accum', 'frame_period_ms', 'start_freq_ghz',
+                'chirp_slope_mhz_per_us', 'ramp_end_time_us', 'idle_time_us', 'adc_sampling_rate_msps')
+INDEX_HEADER_SIZE = 16
+INDEX_DTYPE = np.dtype([('offset', '<u8'), ('length', '<u4'), ('frame_count', '<u4'),
+                        ('timestamp', '<u4'), ('reserved', '<u4'), ('host_time_ns', '<u8')])
+
+# frame format (see minimal_rangeproc_impl/include/frame_protocol.h)
+FRAME_HEADER_FORMAT = '<4HHHIIIHHHBB'
+TLV_RANGE_PROFILE = 1
+RANGE_PROFILE_SIZE = 8
+TLV_RANGE_DOPPLER_HEATMAP = 3
+HEATMAP_FORMAT = '<4H'             # startBin, numRangeBins, numDopplerBins, divShift
+HEATMAP_SIZE = struct.calcsize(HEATMAP_FORMAT)
+TLV_DETECTIONS = 4
+DETECTION_LIST_FORMAT = '<4H'      # numDetections, numDiscarded, numRangeBins, numDopplerBins
+DETECTION_LIST_SIZE = struct.calcsize(DETECTION_LIST_FORMAT)
+DETECTION_DTYPE = np.dtype([('range_bin', '<u2'), ('doppler_bin', '<u2'), ('magnitude', '<u2'),
+                            ('snr_db_q8', '<i2')])
+TLV_POINT_CLOUD = 5
+POINT_CLOUD_FORMAT = '<4H'         # numPoints, numDiscarded, numRangeBins, numDopplerBins
+POINT_CLOUD_SIZE = struct.calcsize(POINT_CLOUD_FORMAT)
+POINT_DTYPE = np.dtype([('range_bin', '<u2'), ('doppler_bin', '<u2'), ('sin_azimuth_q15', '<i2'),
+                        ('sin_elevation_q15', '<i2'), ('magnitude', '<u2'), ('snr_db_q8', '<i2')])
+TLV_MICRO_DOPPLER = 6
+MICRO_DOPPLER_FORMAT = '<4HhHhhhhHH'  # see FrameProto_MicroDoppler
+MICRO_DOPPLER_SIZE = struct.calcsize(MICRO_DOPPLER_FORMAT)
+MICRO_DOPPLER_NAMES = ('range_bin', 'num_frames', 'fft_size', 'num_bins', 'centroid_q8', 'bandwidth_q8',
+                       'envelope_low_q8', 'envelope_high_q8', 'energy_db_q8', 'mean_centroid_q8',
+                       'centroid_spread_q8')
+TLV_MINOR_MOTION_DETECTIONS = 7     # same payload as TLV_DETECTIONS
+TLV_INTEGRATED_RANGE_PROFILE = 8
+INTEGRATED_PROFILE_FORMAT = '<3HBB'  # startBin, numBins, numIntegrated, format, powerShift
+INTEGRATED_PROFILE_SIZE = struct.calcsize(INTEGRATED_PROFILE_FORMAT)
+TLV_DUTY_CYCLE = 9
+TLV_RANGE_PEAKS = 10
+PEAK_LIST_FORMAT = '<3HBB'         # numPeaks, numCandidates, numRangeBins, chirpIdx, antennaIdx
+PEAK_LIST_SIZE = struct.calcsize(PEAK_LIST_FORMAT)
+PEAK_DTYPE = np.dtype([('range_bin', '<u2'), ('offset_q15', '<i2'), ('log2_mag_q8', '<u2'), ('phase_q15', '<i2')])
+DUTY_CYCLE_FORMAT = '<4IB3x'       # see FrameProto_DutyCycle
+DUTY_CYCLE_SIZE = struct.calcsize(DUTY_CYCLE_FORMAT)
+DUTY_CYCLE_NAMES = ('frame_period_us', 'acquisition_us', 'processing_us', 'idle_us', 'low_power_mode')
+TLV_RANGE_ROI = 11
+RANGE_ROI_FORMAT = '<4HI'          # see FrameProto_RangeRoi
+RANGE_ROI_SIZE = struct.calcsize(RANGE_ROI_FORMAT)
+RANGE_ROI_NAMES = ('start_bin', 'num_bins', 'num_range_bins_total', 'reserved', 'bin_size_um')
+TLV_RECONFIG = 12
+RECONFIG_FORMAT = '<2H7I'          # see FrameProto_Reconfig
+RECONFIG_SIZE = struct.calcsize(RECONFIG_FORMAT)
+RECONFIG_NAMES = ('num_reconfigs', 'num_rejected', 'frame_count', 'total_us', 'uart_drain_us', 'sensor_stop_us',
+                  'sensor_setup_us', 'dpc_config_us', 'sensor_start_us')
+TLV_SUBFRAME = 13
+SUBFRAME_FORMAT = '<2BH4I'         # see FrameProto_SubFrame
+SUBFRAME_SIZE = struct.calcsize(SUBFRAME_FORMAT)
+SUBFRAME_NAMES = ('sub_frame', 'num_sub_frames', 'num_overruns', 'switch_us', 'slope_khz_per_us', 'start_freq_mhz',
+                  'frame_period_us')
+
+
+class Recording:
+    def __init__(self, path):
+        self.data = np.memmap(path, dtype=np.uint8, mode='r')
+        index = np.memmap(path + '.idx', dtype=np.uint8, mode='r')
+
+        fields = struct.unpack_from(HEADER_FORMAT, self.data)
+        magic, version, self.header_size, self.alignment = fields[0], fields[1], fields[2], fields[3]
+        if magic != b'RADARREC' or version != 1 or bytes(index[:8]) != b'RADARIDX':
+            raise ValueError(f"{path} is no recording")
+        self.start_time_ns = fields[5]
+        self.config = dict(zip(CONFIG_NAMES, fields[6:6 + len(CONFIG_NAMES)]))
+        self.source = fields[-1].split(b'\0', 1)[0].decode(errors='replace')
+
+        num_entries = (len(index) - INDEX_HEADER_SIZE) // INDEX_DTYPE.itemsize
+        self.index = index[INDEX_HEADER_SIZE:INDEX_HEADER_SIZE + num_entries * INDEX_DTYPE.itemsize].view(INDEX_DTYPE)
+        # ignore entries beyond the data file (interrupted recording)
+        valid = self.index['offset'] + self.index['length'] <= len(self.data)
+        self.num_frames = int(np.argmin(valid)) if not valid.all() else len(self.index)
+        self.index = self.index[:self.num_frames]
+
+    def __len__(self):
+        return self.num_frames
+
+    def frame(self, i):
+        """
+        Frame i as received (header, TLVs, CRC), a view into the file.
+        """
+        entry = self.index[i]
+        return self.data[int(entry['offset']):int(entry['offset']) + int(entry['length'])]
+
+    def find_tlv(self, i, tlv_type):
+        """
+        (offset, length) of the first TLV of the given type in frame i, relative to the frame start.
+        """
+        frame = self.frame(i)
+        header = struct.unpack_from(FRAME_HEADER_FORMAT, frame)
+        header_len, num_tlvs = header[5], header[9]
+        offset = header_len
+        for _ in range(num_tlvs):
+            t, length = struct.unpack_from('<2I', frame, offset)
+            if t == tlv_type:
+                return offset + 8, length
+            offset += 8 + ((length + 3) & ~3)
+        return None
+
+    def range_roi(self, i):
+        """
+        Range region of interest of frame i as dict (RANGE_ROI_NAMES). The profiles and heat maps start at range bin
+        start_bin, all range bins of the TLVs are absolute, range in metres: range_bin * bin_size_um * 1e-6.
+        """
+        tlv = self.find_tlv(i, TLV_RANGE_ROI)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no range ROI")
+        offset, length = tlv
+        if RANGE_ROI_SIZE > length:
+            raise ValueError(f"frame {i} has a truncated range ROI")
+        return dict(zip(RANGE_ROI_NAMES, struct.unpack_from(RANGE_ROI_FORMAT, self.frame(i), offset)))
+
+    def range_profile(self, i):
+        """
+        Range profile of frame i as (bins, 2) int16 view ([:, 0] imag, [:, 1] real), bin 0 is range bin start_bin
+        of range_roi().
+        """
+        tlv = self.find_tlv(i, TLV_RANGE_PROFILE)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no range profile")
+        offset, length = tlv
+        num_bins = (length - RANGE_PROFILE_SIZE) // 4
+        start = int(self.index[i]['offset']) + offset + RANGE_PROFILE_SIZE
+        return self.data[start:start + num_bins * 4].view('<i2').reshape(num_bins, 2)
+
+    def integrated_profile(self, i):
+        """
+        Range profile of frame i integrated over all chirps and virtual antennas as float64 array of the power in dB.
+        """
+        tlv = self.find_tlv(i, TLV_INTEGRATED_RANGE_PROFILE)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no integrated range profile")
+        offset, length = tlv
+        frame = self.frame(i)
+        _, num_bins, _, fmt, power_shift = struct.unpack_from(INTEGRATED_PROFILE_FORMAT, frame, offset)
+        dtype = '<u2' if fmt == 0 else '<u4'
+        if INTEGRATED_PROFILE_SIZE + num_bins * np.dtype(dtype).itemsize > length:
+            raise ValueError(f"frame {i} has a truncated integrated range profile")
+        start = int(self.index[i]['offset']) + offset + INTEGRATED_PROFILE_SIZE
+        values = self.data[start:start + num_bins * np.dtype(dtype).itemsize].view(dtype).astype(np.float64)
+        if fmt == 0:
+            return values * (20.0 * np.log10(2.0) / 256.0)    # log2 of the magnitude in Q8
+        with np.errstate(divide='ignore'):
+            return 10.0 * np.log10(values * 2.0 ** power_shift)    # -inf for no power
+
+    def peaks(self, i):
+        """
+        Strongest peaks of the range profile of frame i as structured array (PEAK_DTYPE), strongest first.
+
+        Interpolated range bin: range_bin + offset_q15 / 32768, magnitude in dB: log2_mag_q8 * 20 * log10(2) / 256,
+        phase in radians: phase_q15 * pi / 32768.
+        """
+        tlv = self.find_tlv(i, TLV_RANGE_PEAKS)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no range peaks")
+        offset, length = tlv
+        num_peaks, _, _, _, _ = struct.unpack_from(PEAK_LIST_FORMAT, self.frame(i), offset)
+        if PEAK_LIST_SIZE + num_peaks * PEAK_DTYPE.itemsize > length:
+            raise ValueError(f"frame {i} has a truncated peak list")
+        start = int(self.index[i]['offset']) + offset + PEAK_LIST_SIZE
+        return self.data[start:start + num_peaks * PEAK_DTYPE.itemsize].view(PEAK_DTYPE)
+
+    def duty_cycle(self, i):
+        """
+        Time of the frame before frame i as dict (DUTY_CYCLE_NAMES, microseconds). The energy per frame is the sum
+        of acquisition_us, processing_us and idle_us, each multiplied by the power drawn in that state.
+        """
+        tlv = self.find_tlv(i, TLV_DUTY_CYCLE)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no duty cycle")
+        offset, length = tlv
+        if DUTY_CYCLE_SIZE > length:
+            raise ValueError(f"frame {i} has a truncated duty cycle")
+        return dict(zip(DUTY_CYCLE_NAMES, struct.unpack_from(DUTY_CYCLE_FORMAT, self.frame(i), offset)))
+
+    def reconfig(self, i):
+        """
+        Latest reconfiguration without reboot before frame i as dict (RECONFIG_NAMES, microseconds), None if the
+        sensor has not been reconfigured. Frames after frame_count use the new configuration.
+        """
+        tlv = self.find_tlv(i, TLV_RECONFIG)
+        if tlv is None:
+            return None
+        offset, length = tlv
+        if RECONFIG_SIZE > length:
+            raise ValueError(f"frame {i} has a truncated reconfiguration")
+        return dict(zip(RECONFIG_NAMES, struct.unpack_from(RECONFIG_FORMAT, self.frame(i), offset)))
+
+    def sub_frame(self, i):
+        """
+        Sub-frame of frame i as dict (SUBFRAME_NAMES), None without sub-frames. The range bin size of the sub-frame is
+        the one of range_roi(), split a recording with [i for i in range(len(rec)) if rec.sub_frame(i)['sub_frame'] == k].
+        """
+        tlv = self.find_tlv(i, TLV_SUBFRAME)
+        if tlv is None:
+            return None
+        offset, length = tlv
+        if SUBFRAME_SIZE > length:
+            raise ValueError(f"frame {i} has a truncated sub-frame")
+        return dict(zip(SUBFRAME_NAMES, struct.unpack_from(SUBFRAME_FORMAT, self.frame(i), offset)))
+
+    def heatmap(self, i):
+        """
+        Range-Doppler heat map of frame i as (range bins, doppler bins) uint16 view, Doppler bins in FFT order.
+        """
+        tlv = self.find_tlv(i, TLV_RANGE_DOPPLER_HEATMAP)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no heat map")
+        offset, length = tlv
+        frame = self.frame(i)
+        _, num_range_bins, num_doppler_bins, _ = struct.unpack_from(HEATMAP_FORMAT, frame, offset)
+        if HEATMAP_SIZE + num_range_bins * num_doppler_bins * 2 > length:
+            raise ValueError(f"frame {i} has a truncated heat map")
+        start = int(self.index[i]['offset']) + offset + HEATMAP_SIZE
+        return self.data[start:start + num_range_bins * num_doppler_bins * 2].view('<u2').reshape(
+            num_range_bins, num_doppler_bins)
+
+    def detections(self, i, tlv_type=TLV_DETECTIONS):
+        """
+        CFAR detections of frame i as structured array (DETECTION_DTYPE), range major.
+
+        With tlv_type=TLV_MINOR_MOTION_DETECTIONS the detections on the minor motion heat map.
+        """
+        tlv = self.find_tlv(i, tlv_type)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no detections")
+        offset, length = tlv
+        frame = self.frame(i)
+        num_detections, _, _, _ = struct.unpack_from(DETECTION_LIST_FORMAT, frame, offset)
+        if DETECTION_LIST_SIZE + num_detections * DETECTION_DTYPE.itemsize > length:
+            raise ValueError(f"frame {i} has a truncated detection list")
+        start = int(self.index[i]['offset']) + offset + DETECTION_LIST_SIZE
+        return self.data[start:start + num_detections * DETECTION_DTYPE.itemsize].view(DETECTION_DTYPE)
+
+    def points(self, i):
+        """
+        Point cloud of frame i as structured array (POINT_DTYPE), range major.
+
+        With the range r of a point: x = r * cos(el) * sin(az), y = r * cos(el) * cos(az), z = r * sin(el),
+        sin(az) = sin_azimuth_q15 / 32768, sin(el) = sin_elevation_q15 / 32768.
+        """
+        tlv = self.find_tlv(i, TLV_POINT_CLOUD)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no point cloud")
+        offset, length = tlv
+        frame = self.frame(i)
+        num_points, _, _, _ = struct.unpack_from(POINT_CLOUD_FORMAT, frame, offset)
+        if POINT_CLOUD_SIZE + num_points * POINT_DTYPE.itemsize > length:
+            raise ValueError(f"frame {i} has a truncated point cloud")
+        start = int(self.index[i]['offset']) + offset + POINT_CLOUD_SIZE
+        return self.data[start:start + num_points * POINT_DTYPE.itemsize].view(POINT_DTYPE)
+
+    def micro_doppler(self, i):
+        """
+        Micro-Doppler features of frame i as dict (MICRO_DOPPLER_NAMES, Q8 Doppler bins, 0 = zero velocity) and the
+        latest spectrogram column as uint8 view (power in 0.5 dB steps, centered), empty if not sent.
+        """
+        tlv = self.find_tlv(i, TLV_MICRO_DOPPLER)
+        if tlv is None:
+            raise ValueError(f"frame {i} has no micro-Doppler features")
+        offset, length = tlv
+        frame = self.frame(i)
+        features = dict(zip(MICRO_DOPPLER_NAMES, struct.unpack_from(MICRO_DOPPLER_FORMAT, frame, offset)))
+        num_bins = features['num_bins']
+        if MICRO_DOPPLER_SIZE + num_bins > length:
+            raise ValueError(f"frame {i} has a truncated spectrogram column")
+        start = int(self.index[i]['offset']) + offset + MICRO_DOPPLER_SIZE
+        return features, self.data[start:start + num_bins]
+
+    def range_profiles(self):
+        """
+        Range profiles of all frames as (frames, bins, 2) int16 array.
+
+        If all frames have the same length and are evenly spaced (the normal case
+        with frames shorter than the alignment) this is a strided view into the
+        file without any copy, otherwise the profiles are copied.
+        """
+        if self.num_frames == 0:
+            return np.zeros((0, 0, 2), dtype='<i2')
+        tlv = self.find_tlv(0, TLV_RANGE_PROFILE)
+        if tlv is None:
+            raise ValueError("frame 0 has no range profile")
+        offset, length = tlv
+        num_bins = (length - RANGE_PROFILE_SIZE) // 4
+        offsets = self.index['offset'].astype(np.int64)
+        stride = int(offsets[1] - offsets[0]) if self.num_frames > 1 else self.alignment
+        regular = (np.all(self.index['length'] == self.index['length'][0]) and
+                   np.all(np.diff(offsets) == stride))
+        if not regular:
+            return np.stack([self.range_profile(i) for i in range(self.num_frames)])
+        first = int(offsets[0]) + offset + RANGE_PROFILE_SIZE
+        return np.ndarray((self.num_frames, num_bins, 2), dtype='<i2', buffer=self.data,
+                          offset=first, strides=(stride, 4, 2))
+
+
+def main():
+    rec = Recording(sys.argv[1])
+    print(f"source: {rec.source}, alignment {rec.alignment}, {len(rec)} frames")
+    for name, value in rec.config.items():
+        print(f"  {name}: {value}")
+    if len(rec):
+        counts = rec.index['frame_count']
+        print(f"frames {counts[0]} .. {counts[-1]}, {int(np.sum(np.diff(counts.astype(np.int64)) - 1))} missing")
+        profiles = rec.range_profiles()
+        magnitude = np.abs(profiles[..., 1] + 1j * profiles[..., 0])
+        print(f"range profiles {profiles.shape}, mean magnitude per bin: {np.round(magnitude.mean(axis=0)).astype(int)}")
+        if rec.find_tlv(0, TLV_RANGE_DOPPLER_HEATMAP) is not None:
+            heatmap = rec.heatmap(len(rec) - 1)
+            peak = np.unravel_index(np.argmax(heatmap), heatmap.shape)
+            print(f"heat map {heatmap.shape} of the last frame, peak {heatmap[peak]} at range bin {peak[0]}, "
+                  f"doppler bin {peak[1]}")
+
+
+if __name__ == '__main__':
+    main()
@@ -1,18 +1,39 @@
-import serial
-import binascii
+import struct
+import zlib
 import numpy as np
 import matplotlib.pyplot as plt
 import matplotlib.animation as animation
 import threading
 
+import frame_receiver
+
 # ----- Configuration Parameters -----
 SERIAL_PORT = '/dev/ttyACM1'
 BAUD_RATE = 115200
 
-DATA_LENGTH = 64         # Number of complex samples per frame
+DATA_LENGTH = 64         # Number of range bins without zero-padding (CLI_NUM_RBINS, initial plot range)
 SAMPLE_SIZE = 4           # Each complex sample: 2x int16 (2 bytes each)
-HEADER = b'\xAA\xBB\xCC\xDD'   # 4-byte header marker
-FOOTER = b'\xDD\xCC\xBB\xAA'   # 4-byte footer marker
+
+# Frame format (see minimal_rangeproc_impl/include/frame_protocol.h)
+MAGIC = struct.pack('<4H', 0x0102, 0x0304, 0x0506, 0x0708)
+PROTO_VERSION = 2
+HEADER_FORMAT = '<4HHHIIIHHHBB'     # magic, version, headerLen, totalLen, frameCount, timestamp,
+                                    # numTlvs, numRangeBins, numDopplerChirps, numVirtualAntennas, headerCheck
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+TLV_HEADER_FORMAT = '<2I'           # type, length
+TLV_HEADER_SIZE = struct.calcsize(TLV_HEADER_FORMAT)
+RANGE_PROFILE_FORMAT = '<4H'        # chirpIdx, antennaIdx, startBin, numBins
+RANGE_PROFILE_SIZE = struct.calcsize(RANGE_PROFILE_FORMAT)
+RANGE_ROI_FORMAT = '<4HI'           # startBin, numBins, numRangeBinsTotal, reserved, binSizeUm
+RANGE_ROI_SIZE = struct.calcsize(RANGE_ROI_FORMAT)
+CRC_SIZE = 4
+MAX_FRAME_LEN = 64 * 1024
+
+TLV_RANGE_PROFILE = 1
+TLV_TX_STATS = 2
+TLV_RANGE_ROI = 11
+
+READ_CHUNK_SIZE = 4096
 
 # Radar Parameters
 BANDWIDTH = 2700e6        # in Hz
@@ -23,42 +44,100 @@ x_axis_fft = np.arange(DATA_LENGTH) * range_resolution
 x_axis_time = np.arange(DATA_LENGTH)
 
 # ----- Serial Port Setup -----
-ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
+# The C++ receiver (scripts/frame_receiver.py) is used if its library has been built,
+# otherwise the frames are received by read_frame() below.
+native_lib = frame_receiver.load()
+if native_lib is None:
+    import serial
+    ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
 
 # Shared variable and lock to hold the latest received frame.
 latest_frame = None
 frame_lock = threading.Lock()
 
+rx_buffer = bytearray()
+last_frame_count = None
+frames_lost = 0
+
+def parse_frame(frame):
+    """
+    Extract the range profile from a validated frame.
+    Returns (first range bin, range bin size in meters, profile), or None if the
+    frame does not contain a range profile.
+    """
+    header = struct.unpack_from(HEADER_FORMAT, frame)
+    header_len, total_len, num_tlvs = header[5], header[6], header[9]
+
+    profile, start_bin, bin_size = None, 0, None
+    offset = header_len
+    end = total_len - CRC_SIZE
+    for _ in range(num_tlvs):
+        if offset + TLV_HEADER_SIZE > end:
+            return None
+        tlv_type, tlv_len = struct.unpack_from(TLV_HEADER_FORMAT, frame, offset)
+        offset += TLV_HEADER_SIZE
+        if offset + tlv_len > end:
+            return None
+        # skip unknown payload types
+        if tlv_type == TLV_RANGE_ROI and tlv_len >= RANGE_ROI_SIZE:
+            bin_size = struct.unpack_from(RANGE_ROI_FORMAT, frame, offset)[4] * 1e-6
+        elif tlv_type == TLV_RANGE_PROFILE and tlv_len >= RANGE_PROFILE_SIZE:
+            start_bin, num_bins = struct.unpack_from(RANGE_PROFILE_FORMAT, frame, offset)[2:4]
+            raw = np.frombuffer(frame, dtype='<i2', count=num_bins * 2, offset=offset + RANGE_PROFILE_SIZE)
+            raw = raw.reshape((num_bins, 2))
+            # cmplx16ImRe_t: imaginary part first
+            profile = raw[:, 1] + 1j * raw[:, 0]
+        offset += (tlv_len + 3) & ~3
+    if profile is None:
+        return None
+    if bin_size is None:
+        # no range ROI TLV (older firmware): the profile covers all range bins, a zero-padded range FFT
+        # (APP_RANGE_FFT_ZERO_PAD) covers the same distance with finer bins
+        bin_size = range_resolution * DATA_LENGTH / len(profile)
+    return start_bin, bin_size, profile
+
 def read_frame():
     """
     Blocking call to read a frame from Serial.
-    If header/footer or size doesn't match, returns None.
+    Reads in chunks, searches the magic word and validates header and CRC.
+    Returns None if no valid frame is available yet.
     """
-    # Wait for header
-    while True:
-        b = ser.read(1)
-        if not b:
-            continue
-        if b == HEADER[0:1]:
-            rest = ser.read(3)
-            if b + rest == HEADER:
-                # Header received; exit loop.
-                break
-
-    payload_bytes = ser.read(DATA_LENGTH * SAMPLE_SIZE)
-    if len(payload_bytes) != DATA_LENGTH * SAMPLE_SIZE:
-        return None
-    
-    footer_bytes = ser.read(4)
-    if footer_bytes != FOOTER:
-        return None
+    global last_frame_count, frames_lost
 
-    raw = np.frombuffer(payload_bytes, dtype=np.int16)
-    if raw.size != DATA_LENGTH * 2:
-        return None
-    raw = raw.reshape((DATA_LENGTH, 2))
-    data_complex = raw[:, 0] + 1j * raw[:, 1]
-    return data_complex
+    while True:
+        start = rx_buffer.find(MAGIC)
+        if start < 0:
+            # keep a possibly incomplete magic word
+            del rx_buffer[:max(0, len(rx_buffer) - len(MAGIC) + 1)]
+        elif start > 0:
+            del rx_buffer[:start]
+
+        if start >= 0 and len(rx_buffer) >= HEADER_SIZE:
+            header = struct.unpack_from(HEADER_FORMAT, rx_buffer)
+            version, header_len, total_len, frame_count = header[4], header[5], header[6], header[7]
+            if (version != PROTO_VERSION or header[-1] != (zlib.crc32(rx_buffer[:HEADER_SIZE - 1]) & 0xFF)
+                    or header_len < HEADER_SIZE or total_len < header_len + CRC_SIZE or total_len > MAX_FRAME_LEN):
+                # no valid header, resync at next magic word
+                del rx_buffer[:1]
+                continue
+            if len(rx_buffer) >= total_len:
+                frame = bytes(rx_buffer[:total_len])
+                crc = struct.unpack_from('<I', frame, total_len - CRC_SIZE)[0]
+                if zlib.crc32(frame[:total_len - CRC_SIZE]) != crc:
+                    del rx_buffer[:1]
+                    continue
+                del rx_buffer[:total_len]
+
+                if last_frame_count is not None and frame_count > last_frame_count + 1:
+                    frames_lost += frame_count - last_frame_count - 1
+                    print(f"frames lost: {frames_lost}")
+                last_frame_count = frame_count
+                return parse_frame(frame)
+
+        chunk = ser.read(max(1, ser.in_waiting or READ_CHUNK_SIZE))
+        if not chunk:
+            return None
+        rx_buffer.extend(chunk)
 
 def serial_thread():
     """
@@ -66,12 +145,39 @@ def serial_thread():
     and updates the shared latest_frame variable.
     """
     global latest_frame
+    if native_lib is not None:
+        native_thread()
+        return
     while True:
         frame_data = read_frame()
         if frame_data is not None:
             with frame_lock:
                 latest_frame = frame_data
 
+def native_thread():
+    """
+    Same as serial_thread(), with reception and validation done by the C++ receiver.
+    """
+    global latest_frame
+    rx = frame_receiver.FrameReceiver(native_lib, SERIAL_PORT, BAUD_RATE)
+    frames_lost = 0
+    while True:
+        try:
+            frame = rx.next()
+        except EOFError:
+            break
+        if frame is None:
+            continue
+        stats = rx.stats()
+        if stats['frames_lost'] + stats['frames_dropped'] != frames_lost:
+            frames_lost = stats['frames_lost'] + stats['frames_dropped']
+            print(f"frames lost: {frames_lost}")
+        frame_data = parse_frame(frame)
+        if frame_data is not None:
+            with frame_lock:
+                latest_frame = frame_data
+    rx.close()
+
 # Start the background serial thread.
 thread = threading.Thread(target=serial_thread, daemon=True)
 thread.start()
@@ -113,12 +219,16 @@ def update(frame):
 
     if current_frame is not None:
         # Update FFT plot (absolute value of data)
-        fft_magnitude = np.abs(current_frame)
-        line_fft.set_data(x_axis_fft, fft_magnitude)
+        # Range bins and bin size are taken from the frame, the profile only
+        # covers the range region of interest (APP_RANGE_ROI_*)
+        start_bin, bin_size, profile = current_frame
+        x_axis_time = start_bin + np.arange(len(profile))
+        fft_magnitude = np.abs(profile)
+        line_fft.set_data(x_axis_time * bin_size, fft_magnitude)
 
         # Update time domain plot (Real & Imaginary)
-        line_real.set_data(x_axis_time, current_frame.real)
-        line_imag.set_data(x_axis_time, current_frame.imag)
+        line_real.set_data(x_axis_time, profile.real)
+        line_imag.set_data(x_axis_time, profile.imag)
         
     return line_fft, line_real, line_imag
 